@@ -40,10 +40,16 @@
 #ifndef AS2_BEHAVIOR__BEHAVIOR_SERVER__CLASS_HPP__
 #define AS2_BEHAVIOR__BEHAVIOR_SERVER__CLASS_HPP__
 
+#include <chrono>
+#include <condition_variable>
 #include <string>
 #include <memory>
+#include <mutex>
+#include <thread>
 #include <as2_behavior/behavior_utils.hpp>
+#include <as2_behavior/run_loop_statistics.hpp>
 #include <as2_core/node.hpp>
+#include <diagnostic_msgs/msg/diagnostic_status.hpp>
 #include <rclcpp/rclcpp.hpp>
 #include <rclcpp/service.hpp>
 #include <rclcpp_action/rclcpp_action.hpp>
@@ -56,7 +62,15 @@ template<typename actionT>
 class BehaviorServer : public as2::Node
 {
 protected:
-//
+  /**
+   * @brief Lock the mutex that serializes the behavior transitions and on_run. With the run thread
+   * enabled, subscription and timer callbacks of the derived behavior that share state with on_run
+   * must hold it.
+   */
+  std::unique_lock<std::recursive_mutex> lock_behavior()
+  {
+    return std::unique_lock<std::recursive_mutex>(behavior_mutex_);
+  }
 
 public:
   using GoalHandleAction = rclcpp_action::ServerGoalHandle<actionT>;
@@ -100,8 +114,33 @@ private:
 
   rclcpp::Publisher<BehaviorStatus>::SharedPtr behavior_status_pub_;
   rclcpp::TimerBase::SharedPtr behavior_status_timer_;
+
+  // Status is published on transitions, periodically only if a heartbeat period is set
+  std::mutex behavior_status_mutex_;
+  bool behavior_status_published_ = false;
+  uint8_t published_behavior_status_ = BehaviorStatus::IDLE;
+  std::chrono::duration<double> behavior_status_heartbeat_{0.0};
+  std::chrono::steady_clock::time_point last_behavior_status_time_;
   rclcpp::TimerBase::SharedPtr run_timer_;
 
+  // Dedicated run thread with absolute deadlines, used instead of run_timer_ if enabled. Action,
+  // service and timer callbacks of the server are serialized with it through behavior_mutex_,
+  // callbacks of the derived behavior through lock_behavior().
+  bool use_run_thread_ = false;
+  std::recursive_mutex behavior_mutex_;
+  std::mutex run_thread_mutex_;
+  std::condition_variable run_thread_cv_;
+  std::thread run_thread_;
+  bool run_thread_active_ = false;
+  bool stop_run_thread_ = false;
+  uint64_t run_generation_ = 0;
+  std::chrono::nanoseconds run_period_{0};
+  RunLoopStatistics run_statistics_;
+  uint64_t published_overruns_ = 0;
+  rclcpp::Publisher<diagnostic_msgs::msg::DiagnosticStatus>::SharedPtr run_diagnostics_pub_;
+  rclcpp::TimerBase::SharedPtr run_diagnostics_timer_;
+  rclcpp::OnShutdownCallbackHandle run_thread_shutdown_handle_;
+
 private:
   std::string generate_name(const std::string & name);
 
@@ -114,11 +153,23 @@ private:
   void register_run_timer();
   void cleanup_run_timer(const ExecutionStatus & status);
 
+  void run_thread_loop();
+  void publish_run_diagnostics();
+
 public:
   BehaviorServer(
     const std::string & name,
     const rclcpp::NodeOptions & options = rclcpp::NodeOptions());
 
+  virtual ~BehaviorServer();
+
+  /**
+   * @brief Stop and join the run thread, if enabled. It is called on context shutdown. The base
+   * destructor runs after the derived behavior is destroyed, so every derived behavior must call
+   * it first thing in its destructor.
+   */
+  void stop_run_thread();
+
   // TODO(CVAR): CONVERT INTO PURE VIRTUAL FUNCTIONS
   virtual bool on_activate(std::shared_ptr<const typename actionT::Goal> goal);
   virtual bool on_modify(std::shared_ptr<const typename actionT::Goal> goal);
@@ -147,7 +198,12 @@ public:
 
   void run(const typename std::shared_ptr<GoalHandleAction> & goal_handle_action);
 
-  void timer_callback() {run(goal_handle_);}
+  void timer_callback()
+  {
+    std::lock_guard<std::recursive_mutex> lock(behavior_mutex_);
+    run(goal_handle_);
+  }
+  void set_behavior_status(uint8_t status);
   void publish_behavior_status();
 };
 }   // namespace as2_behavior
@@ -53,10 +53,50 @@ BehaviorServer<actionT>::BehaviorServer(
   if (!this->has_parameter("run_frequency")) {
     this->declare_parameter<float>("run_frequency", 10.0);
   }
+  if (!this->has_parameter("run_thread.enable")) {
+    this->declare_parameter<bool>("run_thread.enable", false);
+  }
+  this->get_parameter("run_thread.enable", use_run_thread_);
+  if (!this->has_parameter("behavior_status.heartbeat_period")) {
+    this->declare_parameter<double>("behavior_status.heartbeat_period", 0.0);
+  }
+  behavior_status_heartbeat_ = std::chrono::duration<double>(
+    this->get_parameter("behavior_status.heartbeat_period").as_double());
   register_action();
   register_service_servers();
   register_publishers();
   register_timers();
+  publish_behavior_status();
+  if (use_run_thread_) {
+    run_thread_ = std::thread(&BehaviorServer::run_thread_loop, this);
+    run_thread_shutdown_handle_ =
+      this->get_node_base_interface()->get_context()->add_on_shutdown_callback(
+      [this]() {stop_run_thread();});
+  }
+}
+
+template<typename actionT>
+BehaviorServer<actionT>::~BehaviorServer()
+{
+  if (use_run_thread_) {
+    this->get_node_base_interface()->get_context()->remove_on_shutdown_callback(
+      run_thread_shutdown_handle_);
+  }
+  stop_run_thread();
+}
+
+template<typename actionT>
+void BehaviorServer<actionT>::stop_run_thread()
+{
+  {
+    std::lock_guard<std::mutex> lock(run_thread_mutex_);
+    stop_run_thread_ = true;
+  }
+  run_thread_cv_.notify_one();
+  // From the run thread itself, on_run or on_execution_end, it exits after the current loop
+  if (run_thread_.joinable() && run_thread_.get_id() != std::this_thread::get_id()) {
+    run_thread_.join();
+  }
 }
 
 template<typename actionT>
@@ -108,6 +148,7 @@ rclcpp_action::CancelResponse BehaviorServer<actionT>::handleCancel(
 template<typename actionT>
 void BehaviorServer<actionT>::handleAccepted(const std::shared_ptr<GoalHandleAction> goal_handle)
 {
+  std::lock_guard<std::recursive_mutex> lock(behavior_mutex_);
   goal_handle_ = goal_handle;
 }
 
@@ -136,8 +177,13 @@ void BehaviorServer<actionT>::register_publishers()
 {
   // feedback_pub_    = this->create_publisher<feedback_msg>(generate_name("feedback"), 10);
   // goal_status_pub_ = this->create_publisher<goal_status_msg>(generate_name("goal_status"), 10);
-  behavior_status_pub_ =
-    this->create_publisher<BehaviorStatus>(generate_name("behavior_status"), 10);
+  // Transient local, so late joiners get the current status without waiting for a change
+  behavior_status_pub_ = this->create_publisher<BehaviorStatus>(
+    generate_name("behavior_status"), rclcpp::QoS(1).reliable().transient_local());
+  if (use_run_thread_) {
+    run_diagnostics_pub_ = this->create_publisher<diagnostic_msgs::msg::DiagnosticStatus>(
+      generate_name("run_diagnostics"), 10);
+  }
 }
 
 template<typename actionT>
@@ -145,6 +191,10 @@ void BehaviorServer<actionT>::register_timers()
 {
   behavior_status_timer_ = this->create_timer(
     std::chrono::milliseconds(100), std::bind(&BehaviorServer::publish_behavior_status, this));
+  if (use_run_thread_) {
+    run_diagnostics_timer_ = this->create_timer(
+      std::chrono::seconds(1), std::bind(&BehaviorServer::publish_run_diagnostics, this));
+  }
 }
 
 template<typename actionT>
@@ -152,6 +202,22 @@ void BehaviorServer<actionT>::register_run_timer()
 {
   float run_frequency;
   this->get_parameter("run_frequency", run_frequency);
+  if (use_run_thread_) {
+    {
+      std::lock_guard<std::mutex> lock(run_thread_mutex_);
+      const auto run_period = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::duration<double>(1.0 / run_frequency));
+      if (run_period != run_period_) {
+        run_period_ = run_period;
+        run_statistics_.reset(std::chrono::duration<double>(run_period).count());
+        published_overruns_ = 0;
+      }
+      run_thread_active_ = true;
+      run_generation_++;
+    }
+    run_thread_cv_.notify_one();
+    return;
+  }
   run_timer_ = this->create_timer(
     std::chrono::duration<double>(1.0f / run_frequency),
     std::bind(&BehaviorServer::timer_callback, this));
@@ -162,6 +228,107 @@ void BehaviorServer<actionT>::cleanup_run_timer(const ExecutionStatus & state)
   on_execution_end(state);
   goal_handle_.reset();
   run_timer_.reset();
+  if (use_run_thread_) {
+    std::lock_guard<std::mutex> lock(run_thread_mutex_);
+    run_thread_active_ = false;
+  }
+}
+
+template<typename actionT>
+void BehaviorServer<actionT>::run_thread_loop()
+{
+  using Clock = std::chrono::steady_clock;
+  std::unique_lock<std::mutex> lock(run_thread_mutex_);
+  while (true) {
+    run_thread_cv_.wait(lock, [this]() {return stop_run_thread_ || run_thread_active_;});
+    if (stop_run_thread_) {
+      return;
+    }
+
+    // Deadlines are absolute, a slow loop does not shift the following ones
+    const uint64_t generation = run_generation_;
+    const auto period = run_period_;
+    auto deadline = Clock::now() + period;
+    while (true) {
+      const bool restarted = run_thread_cv_.wait_until(
+        lock, deadline, [this, generation]() {
+          return stop_run_thread_ || !run_thread_active_ || run_generation_ != generation;
+        });
+      if (restarted) {
+        break;
+      }
+
+      lock.unlock();
+      const auto start = Clock::now();
+      {
+        std::lock_guard<std::recursive_mutex> behavior_lock(behavior_mutex_);
+        if (goal_handle_) {
+          run(goal_handle_);
+        }
+      }
+      const auto end = Clock::now();
+      lock.lock();
+
+      // Missed deadlines are skipped instead of run back to back
+      const auto wakeup_latency = start - deadline;
+      deadline += period;
+      const bool overrun = end > deadline;
+      while (deadline <= end) {
+        deadline += period;
+      }
+      run_statistics_.addLoop(
+        std::chrono::duration<double>(end - start).count(),
+        std::chrono::duration<double>(wakeup_latency).count(), overrun);
+    }
+  }
+}
+
+template<typename actionT>
+void BehaviorServer<actionT>::publish_run_diagnostics()
+{
+  RunLoopStatistics statistics;
+  uint64_t new_overruns;
+  {
+    std::lock_guard<std::mutex> lock(run_thread_mutex_);
+    statistics = run_statistics_;
+    new_overruns = statistics.getOverruns() - published_overruns_;
+    published_overruns_ = statistics.getOverruns();
+  }
+
+  diagnostic_msgs::msg::DiagnosticStatus msg;
+  msg.name = std::string(this->get_name()) + " run loop";
+  msg.hardware_id = this->get_fully_qualified_name();
+  if (new_overruns > 0) {
+    msg.level = diagnostic_msgs::msg::DiagnosticStatus::WARN;
+    msg.message = std::to_string(new_overruns) + " overruns in the last second";
+  } else {
+    msg.level = diagnostic_msgs::msg::DiagnosticStatus::OK;
+    msg.message = "OK";
+  }
+
+  auto add_value = [&msg](const std::string & key, const std::string & value) {
+      diagnostic_msgs::msg::KeyValue key_value;
+      key_value.key = key;
+      key_value.value = value;
+      msg.values.push_back(key_value);
+    };
+  add_value("period", std::to_string(statistics.getPeriod()));
+  add_value("loops", std::to_string(statistics.getLoops()));
+  add_value("overruns", std::to_string(statistics.getOverruns()));
+  add_value("mean_loop_time", std::to_string(statistics.getMeanLoopTime()));
+  add_value("max_loop_time", std::to_string(statistics.getMaxLoopTime()));
+  add_value("max_wakeup_latency", std::to_string(statistics.getMaxWakeupLatency()));
+
+  // Loop time histogram, bins labeled by their upper edge as a fraction of the period
+  const auto & histogram = statistics.getHistogram();
+  for (std::size_t i = 0; i < histogram.size(); ++i) {
+    const std::string label = i < RunLoopStatistics::kBinEdges.size() ?
+      "loop_time_below_" + std::to_string(
+      static_cast<int>(RunLoopStatistics::kBinEdges[i] * 100.0)) + "_percent" :
+      "loop_time_overrun";
+    add_value(label, std::to_string(histogram[i]));
+  }
+  run_diagnostics_pub_->publish(msg);
 }
 
 template<typename actionT>
@@ -209,10 +376,11 @@ ExecutionStatus BehaviorServer<actionT>::on_run(
 template<typename actionT>
 bool BehaviorServer<actionT>::activate(std::shared_ptr<const typename actionT::Goal> goal)
 {
+  std::lock_guard<std::recursive_mutex> lock(behavior_mutex_);
   RCLCPP_INFO(this->get_logger(), "START");
   if (on_activate(goal)) {
     register_run_timer();
-    behavior_status_.status = BehaviorStatus::RUNNING;
+    set_behavior_status(BehaviorStatus::RUNNING);
     return true;
   }
   return false;
@@ -222,19 +390,21 @@ void BehaviorServer<actionT>::deactivate(
   const typename std_srvs::srv::Trigger::Request::SharedPtr goal,
   typename std_srvs::srv::Trigger::Response::SharedPtr result)
 {
+  std::lock_guard<std::recursive_mutex> lock(behavior_mutex_);
   RCLCPP_INFO(this->get_logger(), "STOP");
   auto msg = std::make_shared<std::string>();
   result->success = on_deactivate(msg);
   result->message = *msg;
   if (result->success) {
     cleanup_run_timer(ExecutionStatus::ABORTED);
-    behavior_status_.status = BehaviorStatus::IDLE;
+    set_behavior_status(BehaviorStatus::IDLE);
   }
 }
 template<typename actionT>
 
 void BehaviorServer<actionT>::modify(std::shared_ptr<const typename actionT::Goal> goal)
 {
+  std::lock_guard<std::recursive_mutex> lock(behavior_mutex_);
   RCLCPP_INFO(this->get_logger(), "MODIFY");
   on_modify(goal);
 }
@@ -243,6 +413,7 @@ void BehaviorServer<actionT>::pause(
   const typename std_srvs::srv::Trigger::Request::SharedPtr goal,
   typename std_srvs::srv::Trigger::Response::SharedPtr result)
 {
+  std::lock_guard<std::recursive_mutex> lock(behavior_mutex_);
   RCLCPP_INFO(this->get_logger(), "PAUSE");
   if (behavior_status_.status != BehaviorStatus::RUNNING) {
     result->success = false;
@@ -253,7 +424,7 @@ void BehaviorServer<actionT>::pause(
   result->success = on_pause(msg);
   result->message = *msg;
   if (result->success) {
-    behavior_status_.status = BehaviorStatus::PAUSED;
+    set_behavior_status(BehaviorStatus::PAUSED);
   }
 }
 template<typename actionT>
@@ -261,6 +432,7 @@ void BehaviorServer<actionT>::resume(
   const typename std_srvs::srv::Trigger::Request::SharedPtr goal,
   typename std_srvs::srv::Trigger::Response::SharedPtr result)
 {
+  std::lock_guard<std::recursive_mutex> lock(behavior_mutex_);
   RCLCPP_INFO(this->get_logger(), "RESUME");
   if (behavior_status_.status != BehaviorStatus::PAUSED) {
     result->success = false;
@@ -271,7 +443,7 @@ void BehaviorServer<actionT>::resume(
   result->success = on_resume(msg);
   result->message = *msg;
   if (result->success) {
-    behavior_status_.status = BehaviorStatus::RUNNING;
+    set_behavior_status(BehaviorStatus::RUNNING);
   }
 }
 
@@ -290,23 +462,23 @@ void BehaviorServer<actionT>::run(
   switch (status) {
     case ExecutionStatus::SUCCESS: {
         RCLCPP_INFO(this->get_logger(), "SUCCESS");
-        behavior_status_.status = BehaviorStatus::IDLE;
+        set_behavior_status(BehaviorStatus::IDLE);
         goal_handle_->succeed(result);
       } break;
     case ExecutionStatus::RUNNING: {
         auto clk = this->get_clock();
         RCLCPP_INFO_THROTTLE(this->get_logger(), *clk, 5000, "RUNNING");
         goal_handle_action->publish_feedback(feedback);
-        behavior_status_.status = BehaviorStatus::RUNNING;
+        set_behavior_status(BehaviorStatus::RUNNING);
       } break;
     case ExecutionStatus::FAILURE: {
         RCLCPP_INFO(this->get_logger(), "FAILURE");
-        behavior_status_.status = BehaviorStatus::IDLE;
+        set_behavior_status(BehaviorStatus::IDLE);
         goal_handle_->abort(result);
       } break;
     case ExecutionStatus::ABORTED: {
         RCLCPP_INFO(this->get_logger(), "ABORTED");
-        behavior_status_.status = BehaviorStatus::IDLE;
+        set_behavior_status(BehaviorStatus::IDLE);
         goal_handle_->abort(result);
       } break;
   }
@@ -316,12 +488,36 @@ void BehaviorServer<actionT>::run(
   }
 }
 
+template<typename actionT>
+void BehaviorServer<actionT>::set_behavior_status(uint8_t status)
+{
+  {
+    std::lock_guard<std::mutex> lock(behavior_status_mutex_);
+    behavior_status_.status = status;
+  }
+  publish_behavior_status();
+}
+
 template<typename actionT>
 void BehaviorServer<actionT>::publish_behavior_status()
 {
+  // The timer also catches status changes not made through set_behavior_status
+  std::lock_guard<std::mutex> lock(behavior_status_mutex_);
+  const auto now = std::chrono::steady_clock::now();
+  const bool changed = !behavior_status_published_ ||
+    behavior_status_.status != published_behavior_status_;
+  const bool heartbeat = behavior_status_heartbeat_.count() > 0.0 &&
+    now - last_behavior_status_time_ >= behavior_status_heartbeat_;
+  if (!changed && !heartbeat) {
+    return;
+  }
+
   BehaviorStatus msg;
   msg.status = behavior_status_.status;
   behavior_status_pub_->publish(msg);
+  behavior_status_published_ = true;
+  published_behavior_status_ = msg.status;
+  last_behavior_status_time_ = now;
 }
 }   // namespace as2_behavior
 
@@ -0,0 +1,154 @@
+// Copyright 2024 Universidad Politécnica de Madrid
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the Universidad Politécnica de Madrid nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+* @file lazy_plugin.hpp
+*
+* @brief Class definition for a behavior plugin that can be loaded on the first activation
+*
+* @author Miguel Fernández Cortizas
+*         Pedro Arias Pérez
+*         David Pérez Saura
+*         Rafael Pérez Seguí
+*/
+
+#ifndef AS2_BEHAVIOR__LAZY_PLUGIN_HPP_
+#define AS2_BEHAVIOR__LAZY_PLUGIN_HPP_
+
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <rclcpp/rclcpp.hpp>
+
+namespace as2_behavior
+{
+
+/**
+ * @brief Plugin of a behavior, created at startup or, if the lazy_plugin_loading parameter is
+ * set, on the first activation so that idle behaviors hosted in a shared container do not pay
+ * for plugins they never run. Messages forwarded before it exists are kept, only the latest of
+ * each kind, and replayed once it is loaded.
+ *
+ * Every transition but deactivation follows a successful activation, which loads the plugin, so
+ * only on_activate (through load) and on_deactivate need to check it.
+ */
+template<typename PluginT>
+class LazyPlugin
+{
+public:
+  // Creates and initializes the plugin, pluginlib errors are thrown
+  using Factory = std::function<std::shared_ptr<PluginT>()>;
+
+  /**
+   * @brief Declare the lazy_plugin_loading parameter and load the plugin unless it is set
+   * @param node behavior node
+   * @param factory creates and initializes the plugin
+   * @return false if the plugin had to be loaded and could not
+   */
+  bool initialize(rclcpp::Node * node, Factory factory)
+  {
+    node_ = node;
+    factory_ = std::move(factory);
+    const bool lazy_loading = node_->declare_parameter<bool>("lazy_plugin_loading", false);
+    return lazy_loading || load();
+  }
+
+  /**
+   * @brief Create the plugin if it does not exist yet and replay the messages kept meanwhile
+   * @return true if the plugin is loaded
+   */
+  bool load()
+  {
+    if (*this) {
+      return true;
+    }
+    std::shared_ptr<PluginT> plugin;
+    try {
+      plugin = factory_();
+    } catch (const std::exception & ex) {
+      RCLCPP_ERROR(
+        node_->get_logger(), "The plugin failed to load for some reason. Error: %s\n",
+        ex.what());
+      return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto & [kind, callback] : pending_) {
+      callback(*plugin);
+    }
+    pending_.clear();
+    plugin_ = plugin;
+    return true;
+  }
+
+  /**
+   * @brief Pass a message to the plugin, or keep it until the plugin is loaded
+   * @param kind replaces the kept message of the same kind
+   * @param callback called with the plugin
+   */
+  template<typename CallbackT>
+  void forward(const std::string & kind, CallbackT && callback)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (plugin_) {
+      callback(*plugin_);
+      return;
+    }
+    for (auto & pending : pending_) {
+      if (pending.first == kind) {
+        pending.second = std::forward<CallbackT>(callback);
+        return;
+      }
+    }
+    pending_.emplace_back(kind, std::forward<CallbackT>(callback));
+  }
+
+  explicit operator bool() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return plugin_ != nullptr;
+  }
+
+  PluginT * operator->() const {return plugin_.get();}
+
+private:
+  rclcpp::Node * node_ = nullptr;
+  Factory factory_;
+  mutable std::mutex mutex_;
+  std::shared_ptr<PluginT> plugin_;
+  std::vector<std::pair<std::string, std::function<void(PluginT &)>>> pending_;
+};
+
+}  // namespace as2_behavior
+
+#endif  // AS2_BEHAVIOR__LAZY_PLUGIN_HPP_
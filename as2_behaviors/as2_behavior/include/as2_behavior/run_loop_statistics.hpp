@@ -0,0 +1,95 @@
+// Copyright 2024 Universidad Politécnica de Madrid
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the Universidad Politécnica de Madrid nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+* @file run_loop_statistics.hpp
+*
+* @brief Class definition for the statistics of a periodic run loop
+*
+* @author Miguel Fernández Cortizas
+*         Pedro Arias Pérez
+*         David Pérez Saura
+*         Rafael Pérez Seguí
+*/
+
+#ifndef AS2_BEHAVIOR__RUN_LOOP_STATISTICS_HPP_
+#define AS2_BEHAVIOR__RUN_LOOP_STATISTICS_HPP_
+
+#include <array>
+#include <cstdint>
+
+namespace as2_behavior
+{
+
+/**
+ * @brief Loop time histogram and overrun count of a loop run at a fixed period. Histogram bins
+ * are fractions of the period, the last one counts loops longer than the period. Not thread safe.
+ */
+class RunLoopStatistics
+{
+public:
+  static constexpr std::array<double, 5> kBinEdges = {0.1, 0.25, 0.5, 0.75, 1.0};
+  using Histogram = std::array<uint64_t, kBinEdges.size() + 1>;
+
+  explicit RunLoopStatistics(double period = 0.1);
+
+  /**
+   * @brief Clear all the statistics
+   * @param period loop period (s)
+   */
+  void reset(double period);
+
+  /**
+   * @brief Add one loop
+   * @param loop_time time spent in the loop (s)
+   * @param wakeup_latency delay between the loop deadline and its start (s)
+   * @param overrun whether the loop ended after the next deadline
+   */
+  void addLoop(double loop_time, double wakeup_latency, bool overrun);
+
+  double getPeriod() const {return period_;}
+  uint64_t getLoops() const {return loops_;}
+  uint64_t getOverruns() const {return overruns_;}
+  double getMeanLoopTime() const;
+  double getMaxLoopTime() const {return max_loop_time_;}
+  double getMaxWakeupLatency() const {return max_wakeup_latency_;}
+  const Histogram & getHistogram() const {return histogram_;}
+
+private:
+  double period_;
+  uint64_t loops_ = 0;
+  uint64_t overruns_ = 0;
+  double total_loop_time_ = 0.0;
+  double max_loop_time_ = 0.0;
+  double max_wakeup_latency_ = 0.0;
+  Histogram histogram_ = {};
+};
+
+}  // namespace as2_behavior
+
+#endif  // AS2_BEHAVIOR__RUN_LOOP_STATISTICS_HPP_
@@ -0,0 +1,79 @@
+// Copyright 2024 Universidad Politécnica de Madrid
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the Universidad Politécnica de Madrid nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+* @file run_loop_statistics.cpp
+*
+* @brief Source file for the statistics of a periodic run loop
+*
+* @author Miguel Fernández Cortizas
+*         Pedro Arias Pérez
+*         David Pérez Saura
+*         Rafael Pérez Seguí
+*/
+
+#include "as2_behavior/run_loop_statistics.hpp"
+
+#include <algorithm>
+
+namespace as2_behavior
+{
+
+constexpr std::array<double, 5> RunLoopStatistics::kBinEdges;
+
+RunLoopStatistics::RunLoopStatistics(double period)
+: period_(period) {}
+
+void RunLoopStatistics::reset(double period)
+{
+  *this = RunLoopStatistics(period);
+}
+
+void RunLoopStatistics::addLoop(double loop_time, double wakeup_latency, bool overrun)
+{
+  loops_++;
+  if (overrun) {
+    overruns_++;
+  }
+  total_loop_time_ += loop_time;
+  max_loop_time_ = std::max(max_loop_time_, loop_time);
+  max_wakeup_latency_ = std::max(max_wakeup_latency_, wakeup_latency);
+
+  std::size_t bin = 0;
+  while (bin < kBinEdges.size() && loop_time >= kBinEdges[bin] * period_) {
+    bin++;
+  }
+  histogram_[bin]++;
+}
+
+double RunLoopStatistics::getMeanLoopTime() const
+{
+  return loops_ > 0 ? total_loop_time_ / static_cast<double>(loops_) : 0.0;
+}
+
+}  // namespace as2_behavior
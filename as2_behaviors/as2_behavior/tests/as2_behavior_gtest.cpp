@@ -38,7 +38,12 @@
 */
 
 #include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
 #include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
 #include "as2_behavior/behavior_server.hpp"
 #include <ament_index_cpp/get_package_share_directory.hpp>
 
@@ -91,6 +96,203 @@ TEST(TakeoffServer, test_activate) {
   EXPECT_TRUE(node->on_activate(goal));
 }
 
+// Counts the runs and the thread they are made from
+class CountServer : public as2_behavior::BehaviorServer<as2_msgs::action::Takeoff>
+{
+public:
+  CountServer(const std::string & name, const rclcpp::NodeOptions & options, int n_runs)
+  : as2_behavior::BehaviorServer<as2_msgs::action::Takeoff>(name, options), n_runs_(n_runs)
+  {}
+
+  ~CountServer() override
+  {
+    stop_run_thread();
+  }
+
+  std::atomic<int> runs{0};
+  std::atomic<std::thread::id> run_thread_id;
+
+  as2_behavior::ExecutionStatus on_run(
+    const std::shared_ptr<const as2_msgs::action::Takeoff::Goal> & goal,
+    std::shared_ptr<as2_msgs::action::Takeoff::Feedback> & feedback_msg,
+    std::shared_ptr<as2_msgs::action::Takeoff::Result> & result_msg) override
+  {
+    run_thread_id = std::this_thread::get_id();
+    if (++runs < n_runs_) {
+      return as2_behavior::ExecutionStatus::RUNNING;
+    }
+    result_msg->takeoff_success = true;
+    return as2_behavior::ExecutionStatus::SUCCESS;
+  }
+
+private:
+  int n_runs_;
+};
+
+// Server with the run thread enabled, spun with an action client on its own thread
+class RunThreadTest : public ::testing::Test
+{
+protected:
+  void start(int n_runs)
+  {
+    server_ = std::make_shared<CountServer>(
+      "RunThreadBehavior",
+      rclcpp::NodeOptions().parameter_overrides(
+        {{"run_thread.enable", true}, {"run_frequency", 100.0}}), n_runs);
+    client_node_ = std::make_shared<rclcpp::Node>("run_thread_client");
+    client_ = rclcpp_action::create_client<as2_msgs::action::Takeoff>(
+      client_node_, "RunThreadBehavior");
+    executor_.add_node(server_->get_node_base_interface());
+    executor_.add_node(client_node_);
+    spin_thread_ = std::thread(
+      [this]() {
+        executor_thread_id_ = std::this_thread::get_id();
+        executor_.spin();
+      });
+    ASSERT_TRUE(client_->wait_for_action_server(std::chrono::seconds(5)));
+    auto goal_handle_future = client_->async_send_goal(as2_msgs::action::Takeoff::Goal());
+    ASSERT_EQ(
+      goal_handle_future.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    goal_handle_ = goal_handle_future.get();
+    ASSERT_TRUE(goal_handle_);
+  }
+
+  void TearDown() override
+  {
+    executor_.cancel();
+    if (spin_thread_.joinable()) {
+      spin_thread_.join();
+    }
+    goal_handle_.reset();
+    client_.reset();
+    client_node_.reset();
+    server_.reset();
+  }
+
+  std::shared_ptr<CountServer> server_;
+  rclcpp::Node::SharedPtr client_node_;
+  rclcpp_action::Client<as2_msgs::action::Takeoff>::SharedPtr client_;
+  rclcpp_action::ClientGoalHandle<as2_msgs::action::Takeoff>::SharedPtr goal_handle_;
+  rclcpp::executors::SingleThreadedExecutor executor_;
+  std::thread spin_thread_;
+  std::atomic<std::thread::id> executor_thread_id_;
+};
+
+TEST_F(RunThreadTest, RunsGoalToSuccess) {
+  start(20);
+  auto result_future = client_->async_get_result(goal_handle_);
+  ASSERT_EQ(result_future.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+  const auto result = result_future.get();
+  EXPECT_EQ(result.code, rclcpp_action::ResultCode::SUCCEEDED);
+  EXPECT_TRUE(result.result->takeoff_success);
+  EXPECT_EQ(server_->runs.load(), 20);
+  EXPECT_NE(server_->run_thread_id.load(), executor_thread_id_.load());
+}
+
+TEST_F(RunThreadTest, StopRunThreadWhileRunning) {
+  start(1000000);
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (server_->runs < 5 && std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  ASSERT_GE(server_->runs.load(), 5);
+
+  server_->stop_run_thread();
+  const int runs = server_->runs.load();
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  EXPECT_EQ(server_->runs.load(), runs);
+}
+
+// Server spun with a subscriber to its behavior status
+class BehaviorStatusTest : public ::testing::Test
+{
+protected:
+  using BehaviorStatus = as2_msgs::msg::BehaviorStatus;
+
+  void start(double heartbeat_period)
+  {
+    server_ = std::make_shared<CountServer>(
+      "StatusBehavior",
+      rclcpp::NodeOptions().parameter_overrides(
+        {{"behavior_status.heartbeat_period", heartbeat_period}}), 1);
+    client_node_ = std::make_shared<rclcpp::Node>("behavior_status_client");
+    status_sub_ = client_node_->create_subscription<BehaviorStatus>(
+      "StatusBehavior/_behavior/behavior_status", rclcpp::QoS(1).reliable().transient_local(),
+      [this](const BehaviorStatus::SharedPtr msg) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        received_.push_back(msg->status);
+      });
+    executor_.add_node(server_->get_node_base_interface());
+    executor_.add_node(client_node_);
+    spin_thread_ = std::thread([this]() {executor_.spin();});
+  }
+
+  std::vector<uint8_t> received()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return received_;
+  }
+
+  // Wait until n status messages are received
+  bool waitFor(std::size_t n)
+  {
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (received().size() < n) {
+      if (std::chrono::steady_clock::now() > deadline) {
+        return false;
+      }
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return true;
+  }
+
+  void TearDown() override
+  {
+    executor_.cancel();
+    if (spin_thread_.joinable()) {
+      spin_thread_.join();
+    }
+    status_sub_.reset();
+    client_node_.reset();
+    server_.reset();
+  }
+
+  std::shared_ptr<CountServer> server_;
+  rclcpp::Node::SharedPtr client_node_;
+  rclcpp::Subscription<BehaviorStatus>::SharedPtr status_sub_;
+  rclcpp::executors::SingleThreadedExecutor executor_;
+  std::thread spin_thread_;
+  std::mutex mutex_;
+  std::vector<uint8_t> received_;
+};
+
+TEST_F(BehaviorStatusTest, PublishedOnChange) {
+  start(0.0);
+  ASSERT_TRUE(waitFor(1));
+  EXPECT_EQ(received().front(), BehaviorStatus::IDLE);
+
+  // Without heartbeat, the status timer does not publish an unchanged status
+  std::this_thread::sleep_for(std::chrono::milliseconds(500));
+  EXPECT_EQ(received().size(), 1u);
+
+  server_->set_behavior_status(BehaviorStatus::RUNNING);
+  ASSERT_TRUE(waitFor(2));
+  EXPECT_EQ(received().back(), BehaviorStatus::RUNNING);
+
+  // Same status again is not published
+  server_->set_behavior_status(BehaviorStatus::RUNNING);
+  std::this_thread::sleep_for(std::chrono::milliseconds(300));
+  EXPECT_EQ(received().size(), 2u);
+}
+
+TEST_F(BehaviorStatusTest, Heartbeat) {
+  start(0.1);
+  ASSERT_TRUE(waitFor(5));
+  for (const uint8_t status : received()) {
+    EXPECT_EQ(status, BehaviorStatus::IDLE);
+  }
+}
+
 int main(int argc, char * argv[])
 {
   rclcpp::init(argc, argv);
@@ -0,0 +1,131 @@
+// Copyright 2024 Universidad Politécnica de Madrid
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the Universidad Politécnica de Madrid nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+* @file lazy_plugin_gtest.cpp
+*
+* @brief Lazy plugin loading test
+*
+* @author Miguel Fernández Cortizas
+*         Pedro Arias Pérez
+*         David Pérez Saura
+*         Rafael Pérez Seguí
+*/
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <rclcpp/rclcpp.hpp>
+
+#include "as2_behavior/lazy_plugin.hpp"
+
+struct FakePlugin
+{
+  std::vector<std::string> calls;
+};
+
+std::shared_ptr<rclcpp::Node> makeNode(bool lazy_plugin_loading)
+{
+  return std::make_shared<rclcpp::Node>(
+    "lazy_plugin_test",
+    rclcpp::NodeOptions().parameter_overrides({{"lazy_plugin_loading", lazy_plugin_loading}}));
+}
+
+TEST(LazyPlugin, LoadedAtStartupByDefault)
+{
+  auto node = makeNode(false);
+  int created = 0;
+  as2_behavior::LazyPlugin<FakePlugin> plugin;
+  ASSERT_TRUE(
+    plugin.initialize(
+      node.get(), [&created]() {
+        created++;
+        return std::make_shared<FakePlugin>();
+      }));
+  EXPECT_TRUE(static_cast<bool>(plugin));
+  EXPECT_TRUE(plugin.load());
+  EXPECT_EQ(created, 1);
+
+  plugin.forward("state", [](FakePlugin & p) {p.calls.push_back("state");});
+  EXPECT_EQ(plugin->calls, std::vector<std::string>({"state"}));
+}
+
+TEST(LazyPlugin, LatestMessagesReplayedOnLoad)
+{
+  auto node = makeNode(true);
+  as2_behavior::LazyPlugin<FakePlugin> plugin;
+  ASSERT_TRUE(plugin.initialize(node.get(), []() {return std::make_shared<FakePlugin>();}));
+  EXPECT_FALSE(static_cast<bool>(plugin));
+
+  plugin.forward("state", [](FakePlugin & p) {p.calls.push_back("state 1");});
+  plugin.forward("platform_info", [](FakePlugin & p) {p.calls.push_back("platform_info");});
+  plugin.forward("state", [](FakePlugin & p) {p.calls.push_back("state 2");});
+
+  ASSERT_TRUE(plugin.load());
+  EXPECT_EQ(plugin->calls, std::vector<std::string>({"state 2", "platform_info"}));
+
+  // Loaded plugins get the messages right away
+  plugin.forward("state", [](FakePlugin & p) {p.calls.push_back("state 3");});
+  EXPECT_EQ(plugin->calls.back(), "state 3");
+}
+
+TEST(LazyPlugin, FailedLoadCanBeRetried)
+{
+  auto node = makeNode(true);
+  bool fail = true;
+  as2_behavior::LazyPlugin<FakePlugin> plugin;
+  ASSERT_TRUE(
+    plugin.initialize(
+      node.get(), [&fail]() {
+        if (fail) {
+          throw std::runtime_error("plugin not found");
+        }
+        return std::make_shared<FakePlugin>();
+      }));
+  plugin.forward("state", [](FakePlugin & p) {p.calls.push_back("state");});
+
+  EXPECT_FALSE(plugin.load());
+  EXPECT_FALSE(static_cast<bool>(plugin));
+
+  fail = false;
+  ASSERT_TRUE(plugin.load());
+  EXPECT_EQ(plugin->calls, std::vector<std::string>({"state"}));
+}
+
+int main(int argc, char * argv[])
+{
+  rclcpp::init(argc, argv);
+  ::testing::InitGoogleTest(&argc, argv);
+  const int result = RUN_ALL_TESTS();
+  rclcpp::shutdown();
+  return result;
+}
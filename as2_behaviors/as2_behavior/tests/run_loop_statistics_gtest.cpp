@@ -0,0 +1,79 @@
+// Copyright 2024 Universidad Politécnica de Madrid
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the Universidad Politécnica de Madrid nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+* @file run_loop_statistics_gtest.cpp
+*
+* @brief Run loop statistics test
+*
+* @author Miguel Fernández Cortizas
+*         Pedro Arias Pérez
+*         David Pérez Saura
+*         Rafael Pérez Seguí
+*/
+
+#include <gtest/gtest.h>
+
+#include "as2_behavior/run_loop_statistics.hpp"
+
+TEST(RunLoopStatistics, HistogramBinsAreFractionsOfThePeriod)
+{
+  as2_behavior::RunLoopStatistics statistics(0.1);
+  statistics.addLoop(0.005, 0.0, false);
+  statistics.addLoop(0.02, 0.0, false);
+  statistics.addLoop(0.03, 0.0, false);
+  statistics.addLoop(0.06, 0.0, false);
+  statistics.addLoop(0.09, 0.0, false);
+  statistics.addLoop(0.15, 0.0, true);
+
+  const auto & histogram = statistics.getHistogram();
+  ASSERT_EQ(histogram.size(), 6u);
+  for (std::size_t i = 0; i < histogram.size(); ++i) {
+    EXPECT_EQ(histogram[i], 1u) << "bin " << i;
+  }
+  EXPECT_EQ(statistics.getLoops(), 6u);
+  EXPECT_EQ(statistics.getOverruns(), 1u);
+  EXPECT_DOUBLE_EQ(statistics.getMaxLoopTime(), 0.15);
+  EXPECT_NEAR(statistics.getMeanLoopTime(), 0.355 / 6.0, 1e-12);
+}
+
+TEST(RunLoopStatistics, ResetClearsStatistics)
+{
+  as2_behavior::RunLoopStatistics statistics(0.1);
+  statistics.addLoop(0.2, 0.01, true);
+  statistics.reset(0.02);
+
+  EXPECT_DOUBLE_EQ(statistics.getPeriod(), 0.02);
+  EXPECT_EQ(statistics.getLoops(), 0u);
+  EXPECT_EQ(statistics.getOverruns(), 0u);
+  EXPECT_DOUBLE_EQ(statistics.getMeanLoopTime(), 0.0);
+  EXPECT_DOUBLE_EQ(statistics.getMaxWakeupLatency(), 0.0);
+  for (uint64_t count : statistics.getHistogram()) {
+    EXPECT_EQ(count, 0u);
+  }
+}
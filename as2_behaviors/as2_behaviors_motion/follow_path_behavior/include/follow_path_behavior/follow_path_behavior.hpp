@@ -42,10 +42,12 @@
 #include <memory>
 #include <geometry_msgs/msg/pose_stamped.hpp>
 #include <geometry_msgs/msg/twist_stamped.hpp>
+#include <nav_msgs/msg/odometry.hpp>
 #include <pluginlib/class_loader.hpp>
 #include <rclcpp_action/rclcpp_action.hpp>
 
 #include "as2_behavior/behavior_server.hpp"
+#include "as2_behavior/lazy_plugin.hpp"
 #include "as2_core/names/actions.hpp"
 #include "as2_core/names/topics.hpp"
 #include "as2_core/utils/tf_utils.hpp"
@@ -63,6 +65,7 @@ public:
   ~FollowPathBehavior();
 
   void state_callback(const geometry_msgs::msg::TwistStamped::SharedPtr _twist_msg);
+  void odometry_callback(const nav_msgs::msg::Odometry::SharedPtr _odom_msg);
 
   void platform_info_callback(const as2_msgs::msg::PlatformInfo::SharedPtr msg);
 
@@ -82,11 +85,14 @@ public:
   void on_execution_end(const as2_behavior::ExecutionStatus & state) override;
 
 private:
+  std::shared_ptr<follow_path_base::FollowPathBase> create_plugin();
+
   std::string base_link_frame_id_;
   std::shared_ptr<pluginlib::ClassLoader<follow_path_base::FollowPathBase>> loader_;
-  std::shared_ptr<follow_path_base::FollowPathBase> follow_path_plugin_;
+  as2_behavior::LazyPlugin<follow_path_base::FollowPathBase> follow_path_plugin_;
   std::shared_ptr<as2::tf::TfHandler> tf_handler_;
   rclcpp::Subscription<geometry_msgs::msg::TwistStamped>::SharedPtr twist_sub_;
+  rclcpp::Subscription<nav_msgs::msg::Odometry>::SharedPtr odometry_sub_;
   rclcpp::Subscription<as2_msgs::msg::PlatformInfo>::SharedPtr platform_info_sub_;
 };
 
@@ -0,0 +1,115 @@
+// Copyright 2024 Universidad Politécnica de Madrid
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the Universidad Politécnica de Madrid nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+ * @file follow_path_modify.hpp
+ *
+ * Validation of the path modifications streamed to a running follow path
+ *
+ * @authors Rafael Perez-Segui
+ */
+
+#ifndef FOLLOW_PATH_BEHAVIOR__FOLLOW_PATH_MODIFY_HPP_
+#define FOLLOW_PATH_BEHAVIOR__FOLLOW_PATH_MODIFY_HPP_
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "as2_msgs/msg/pose_with_id.hpp"
+
+namespace follow_path_base
+{
+
+/**
+ * @brief Compare a modified path with the one being followed
+ *
+ * Waypoints before next_waypoint_id are already reached and ignored, the remaining ones must be
+ * kept in the same order and new waypoints can only be appended at the end of the path.
+ *
+ * @param current_path Path being followed
+ * @param next_waypoint_id Id of the next waypoint not reached yet
+ * @param new_path Modified path
+ * @param changed_waypoints Output waypoints of new_path that moved or are new
+ * @param error Output reason when the modification is rejected
+ * @return true if the modification is valid
+ */
+inline bool getPathModification(
+  const std::vector<as2_msgs::msg::PoseWithID> & current_path,
+  const std::string & next_waypoint_id,
+  const std::vector<as2_msgs::msg::PoseWithID> & new_path,
+  std::vector<as2_msgs::msg::PoseWithID> & changed_waypoints,
+  std::string & error)
+{
+  changed_waypoints.clear();
+  std::unordered_map<std::string, std::size_t> current_index;
+  for (std::size_t i = 0; i < current_path.size(); ++i) {
+    current_index[current_path[i].id] = i;
+  }
+  std::size_t next_index = 0;
+  auto next_it = current_index.find(next_waypoint_id);
+  if (next_it != current_index.end()) {
+    next_index = next_it->second;
+  }
+
+  std::size_t min_index = next_index;
+  std::size_t remaining_found = 0;
+  bool appending = false;
+  for (const auto & waypoint : new_path) {
+    auto it = current_index.find(waypoint.id);
+    if (it != current_index.end() && it->second < next_index) {
+      continue;
+    }
+    if (it == current_index.end()) {
+      appending = true;
+    } else if (appending || it->second < min_index) {
+      error = "Follow path modify can not reorder waypoint " + waypoint.id;
+      return false;
+    } else {
+      min_index = it->second + 1;
+      remaining_found++;
+      const auto & position = current_path[it->second].pose.position;
+      if (position.x == waypoint.pose.position.x && position.y == waypoint.pose.position.y &&
+        position.z == waypoint.pose.position.z)
+      {
+        continue;
+      }
+    }
+    changed_waypoints.push_back(waypoint);
+  }
+
+  if (remaining_found != current_path.size() - next_index) {
+    error = "Follow path modify can not remove waypoints not reached yet";
+    return false;
+  }
+  return true;
+}
+
+}  // namespace follow_path_base
+
+#endif  // FOLLOW_PATH_BEHAVIOR__FOLLOW_PATH_MODIFY_HPP_
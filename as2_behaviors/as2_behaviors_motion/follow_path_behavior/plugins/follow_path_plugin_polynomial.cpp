@@ -0,0 +1,277 @@
+// Copyright 2024 Universidad Politécnica de Madrid
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the Universidad Politécnica de Madrid nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+ * @file follow_path_plugin_polynomial.cpp
+ *
+ * This file contains the implementation of the follow path behavior plugin that generates the
+ * polynomial trajectory in-process
+ *
+ * @authors Rafael Perez-Segui
+ */
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "as2_core/utils/frame_utils.hpp"
+#include "as2_motion_reference_handlers/trajectory_motion.hpp"
+#include "as2_msgs/msg/pose_with_id.hpp"
+#include "as2_msgs/msg/yaw_mode.hpp"
+#include "follow_path_behavior/follow_path_base.hpp"
+#include "generate_polynomial_trajectory_behavior/polynomial_trajectory_generator.hpp"
+
+namespace follow_path_plugin_polynomial
+{
+class Plugin : public follow_path_base::FollowPathBase
+{
+public:
+  void ownInit()
+  {
+    trajectory_motion_handler_ =
+      std::make_shared<as2::motionReferenceHandlers::TrajectoryMotion>(node_ptr_);
+  }
+
+  bool own_activate(as2_msgs::action::FollowPath::Goal & _goal) override
+  {
+    if (!startTrajectory(_goal)) {
+      return false;
+    }
+    RCLCPP_INFO(node_ptr_->get_logger(), "Follow path goal accepted");
+    RCLCPP_INFO(node_ptr_->get_logger(), "Follow path with %zu waypoints", _goal.path.size());
+    RCLCPP_INFO(node_ptr_->get_logger(), "Follow path with angle mode: %d", _goal.yaw.mode);
+    RCLCPP_INFO(node_ptr_->get_logger(), "Follow path with speed: %f", _goal.max_speed);
+    return true;
+  }
+
+  bool own_modify(as2_msgs::action::FollowPath::Goal & _goal) override
+  {
+    // Same waypoints, speed and yaw mode: move them keeping the current references
+    if (trajectory_generator_.hasTrajectory() && _goal.max_speed == goal_.max_speed &&
+      _goal.yaw.mode == goal_.yaw.mode && sameWaypointIds(_goal, goal_))
+    {
+      if (_goal.yaw.mode == as2_msgs::msg::YawMode::FIXED_YAW) {
+        yaw_angle_ = _goal.yaw.angle;
+      }
+      for (const auto & waypoint : _goal.path) {
+        trajectory_generator_.modifyWaypoint(waypoint.id, toEigen(waypoint.pose.position));
+      }
+      path_ = _goal.path;
+      updateDesiredPose(feedback_.next_waypoint_id);
+    } else if (!startTrajectory(_goal)) {
+      return false;
+    }
+    RCLCPP_INFO(node_ptr_->get_logger(), "Follow path modified");
+    return true;
+  }
+
+  bool own_deactivate(const std::shared_ptr<std::string> & message) override
+  {
+    RCLCPP_INFO(node_ptr_->get_logger(), "Follow path cancel");
+    trajectory_generator_.reset();
+    return true;
+  }
+
+  bool own_pause(const std::shared_ptr<std::string> & message) override
+  {
+    RCLCPP_INFO(node_ptr_->get_logger(), "Follow path paused");
+    trajectory_generator_.reset();
+    sendHover();
+    return true;
+  }
+
+  bool own_resume(const std::shared_ptr<std::string> & message) override
+  {
+    RCLCPP_INFO(node_ptr_->get_logger(), "Follow path resumed");
+
+    // Resume from the next waypoint not reached
+    as2_msgs::action::FollowPath::Goal remaining_goal = goal_;
+    remaining_goal.path.clear();
+    bool next_waypoint_found = false;
+    for (const auto & waypoint : goal_.path) {
+      next_waypoint_found |= waypoint.id == feedback_.next_waypoint_id;
+      if (next_waypoint_found) {
+        remaining_goal.path.push_back(waypoint);
+      }
+    }
+    if (remaining_goal.path.empty()) {
+      RCLCPP_ERROR(node_ptr_->get_logger(), "No waypoint remaining");
+      return false;
+    }
+    return startTrajectory(remaining_goal);
+  }
+
+  void own_execution_end(const as2_behavior::ExecutionStatus & state) override
+  {
+    RCLCPP_INFO(node_ptr_->get_logger(), "Follow path end");
+    trajectory_generator_.reset();
+    sendHover();
+    return;
+  }
+
+  as2_behavior::ExecutionStatus own_run() override
+  {
+    trajectory_generator_.updateVehiclePosition(
+      Eigen::Vector3d(
+        actual_pose_.pose.position.x, actual_pose_.pose.position.y,
+        actual_pose_.pose.position.z));
+
+    const double time = (node_ptr_->now() - time_zero_).seconds();
+    if (time > trajectory_generator_.getMaxTime()) {
+      RCLCPP_INFO(node_ptr_->get_logger(), "Follow path successful");
+      result_.follow_path_success = true;
+      return as2_behavior::ExecutionStatus::SUCCESS;
+    }
+
+    if (!sendSetpoint(time)) {
+      RCLCPP_ERROR(node_ptr_->get_logger(), "Follow path: Could not send trajectory command");
+      result_.follow_path_success = false;
+      return as2_behavior::ExecutionStatus::FAILURE;
+    }
+    updateFeedback();
+    return as2_behavior::ExecutionStatus::RUNNING;
+  }
+
+  Eigen::Vector3d getTargetPosition() override
+  {
+    return toEigen(desired_pose_.position);
+  }
+
+private:
+  std::shared_ptr<as2::motionReferenceHandlers::TrajectoryMotion> trajectory_motion_handler_ =
+    nullptr;
+  PolynomialTrajectoryGenerator trajectory_generator_;
+  rclcpp::Time time_zero_;
+  uint8_t yaw_mode_ = as2_msgs::msg::YawMode::KEEP_YAW;
+  double yaw_angle_ = 0.0;
+  std::vector<as2_msgs::msg::PoseWithID> path_;
+  geometry_msgs::msg::Pose desired_pose_;
+
+private:
+  static Eigen::Vector3d toEigen(const geometry_msgs::msg::Point & point)
+  {
+    return Eigen::Vector3d(point.x, point.y, point.z);
+  }
+
+  static bool sameWaypointIds(
+    const as2_msgs::action::FollowPath::Goal & lhs,
+    const as2_msgs::action::FollowPath::Goal & rhs)
+  {
+    if (lhs.path.size() != rhs.path.size()) {
+      return false;
+    }
+    for (size_t i = 0; i < lhs.path.size(); i++) {
+      if (lhs.path[i].id != rhs.path[i].id) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  bool startTrajectory(const as2_msgs::action::FollowPath::Goal & _goal)
+  {
+    switch (_goal.yaw.mode) {
+      case as2_msgs::msg::YawMode::KEEP_YAW:
+      case as2_msgs::msg::YawMode::PATH_FACING:
+        yaw_angle_ = getActualYaw();
+        break;
+      case as2_msgs::msg::YawMode::FIXED_YAW:
+        yaw_angle_ = _goal.yaw.angle;
+        break;
+      default:
+        RCLCPP_ERROR(node_ptr_->get_logger(), "Yaw mode %d not supported", _goal.yaw.mode);
+        return false;
+    }
+    yaw_mode_ = _goal.yaw.mode;
+
+    std::vector<TrajectoryWaypoint> waypoints;
+    waypoints.reserve(_goal.path.size());
+    for (const auto & waypoint : _goal.path) {
+      waypoints.push_back(TrajectoryWaypoint{waypoint.id, toEigen(waypoint.pose.position)});
+    }
+    if (!trajectory_generator_.setWaypoints(
+        waypoints, _goal.max_speed, toEigen(actual_pose_.pose.position)))
+    {
+      RCLCPP_ERROR(node_ptr_->get_logger(), "Follow path: Could not generate trajectory");
+      return false;
+    }
+    path_ = _goal.path;
+    time_zero_ = node_ptr_->now();
+
+    // First setpoint right away, without waiting for the next run
+    if (!sendSetpoint(0.0)) {
+      return false;
+    }
+    updateFeedback();
+    return true;
+  }
+
+  bool sendSetpoint(double time)
+  {
+    TrajectorySample sample;
+    if (!trajectory_generator_.evaluate(time, sample)) {
+      return false;
+    }
+    if (yaw_mode_ == as2_msgs::msg::YawMode::PATH_FACING &&
+      sample.velocity.head<2>().norm() > 0.1)
+    {
+      yaw_angle_ = as2::frame::getVector2DAngle(sample.velocity.x(), sample.velocity.y());
+    }
+    return trajectory_motion_handler_->sendTrajectoryCommandWithYawAngle(
+      "earth", yaw_angle_, sample.position, sample.velocity, sample.acceleration);
+  }
+
+  void updateFeedback()
+  {
+    const std::vector<std::string> remaining_waypoints =
+      trajectory_generator_.getRemainingWaypoints();
+    feedback_.remaining_waypoints = remaining_waypoints.size();
+    const std::string next_waypoint_id =
+      remaining_waypoints.empty() ? "" : remaining_waypoints.front();
+    if (next_waypoint_id != feedback_.next_waypoint_id) {
+      RCLCPP_INFO(node_ptr_->get_logger(), "Next waypoint id: %s", next_waypoint_id.c_str());
+      updateDesiredPose(next_waypoint_id);
+    }
+    feedback_.next_waypoint_id = next_waypoint_id;
+  }
+
+  void updateDesiredPose(const std::string & waypoint_id)
+  {
+    for (const auto & waypoint : path_) {
+      if (waypoint.id == waypoint_id) {
+        desired_pose_ = waypoint.pose;
+        break;
+      }
+    }
+  }
+};  // Plugin class
+}  // namespace follow_path_plugin_polynomial
+
+#include <pluginlib/class_list_macros.hpp>
+
+PLUGINLIB_EXPORT_CLASS(follow_path_plugin_polynomial::Plugin, follow_path_base::FollowPathBase)
@@ -35,18 +35,25 @@
  */
 
 
+#include <algorithm>
+#include <string>
+#include <vector>
+
 #include <geometry_msgs/msg/point.hpp>
 #include <std_msgs/msg/header.hpp>
 #include <std_srvs/srv/trigger.hpp>
 
 #include "as2_behavior/behavior_server.hpp"
 #include "as2_core/names/actions.hpp"
+#include "as2_core/names/topics.hpp"
 #include "as2_core/synchronous_service_client.hpp"
 #include "as2_core/utils/frame_utils.hpp"
 #include "as2_msgs/action/generate_polynomial_trajectory.hpp"
+#include "as2_msgs/msg/pose_stamped_with_id_array.hpp"
 #include "as2_msgs/msg/pose_with_id.hpp"
 #include "as2_msgs/msg/yaw_mode.hpp"
 #include "follow_path_behavior/follow_path_base.hpp"
+#include "follow_path_behavior/follow_path_modify.hpp"
 #include "rclcpp/rclcpp.hpp"
 #include "rclcpp_action/rclcpp_action.hpp"
 
@@ -73,6 +80,10 @@ public:
       std::string(as2_names::actions::behaviors::trajectorygenerator) + "/_behavior/resume",
       node_ptr_);
 
+    traj_gen_modify_pub_ = node_ptr_->create_publisher<as2_msgs::msg::PoseStampedWithIDArray>(
+      as2_names::topics::motion_reference::modify_waypoint,
+      as2_names::topics::motion_reference::qos_waypoint);
+
     traj_gen_goal_options_.feedback_callback =
       std::bind(&Plugin::feedback_callback, this, std::placeholders::_1, std::placeholders::_2);
     traj_gen_goal_options_.result_callback =
@@ -115,24 +126,53 @@ public:
   bool own_modify(as2_msgs::action::FollowPath::Goal & _goal) override
   {
     RCLCPP_INFO(node_ptr_->get_logger(), "Follow path modified");
-    as2_msgs::action::GeneratePolynomialTrajectory::Goal traj_generator_goal =
-      followPathGoalToTrajectoryGeneratorGoal(_goal);
+    if (!traj_gen_goal_accepted_) {
+      RCLCPP_ERROR(node_ptr_->get_logger(), "Trajectory generator goal not accepted yet");
+      return false;
+    }
 
-    RCLCPP_INFO(
-      node_ptr_->get_logger(), "Follow path with speed: %f",
-      traj_generator_goal.max_speed);
+    // Speed and yaw are fixed for the whole trajectory, only the path can be streamed
+    if (_goal.max_speed != goal_.max_speed || _goal.yaw.mode != goal_.yaw.mode ||
+      _goal.yaw.angle != goal_.yaw.angle)
+    {
+      RCLCPP_ERROR(
+        node_ptr_->get_logger(),
+        "Follow path modify only supports path changes, cancel it to change speed or yaw");
+      return false;
+    }
 
-    RCLCPP_INFO(node_ptr_->get_logger(), "Follow path to positions:");
-    for (auto & point : traj_generator_goal.path) {
-      RCLCPP_INFO(
-        node_ptr_->get_logger(), "  x: %f, y: %f, z: %f", point.pose.position.x,
-        point.pose.position.y, point.pose.position.z);
+    std::vector<as2_msgs::msg::PoseWithID> changed_waypoints;
+    std::string error;
+    if (!follow_path_base::getPathModification(
+        goal_.path, feedback_.next_waypoint_id, _goal.path, changed_waypoints, error))
+    {
+      RCLCPP_ERROR(node_ptr_->get_logger(), "%s", error.c_str());
+      return false;
     }
 
-    // TODO(RPS98): call trajectory generator modify service with new goal
-    RCLCPP_ERROR(node_ptr_->get_logger(), "Follow path modify not implemented yet");
+    as2_msgs::msg::PoseStampedWithIDArray modify_msg;
+    for (const auto & waypoint : changed_waypoints) {
+      as2_msgs::msg::PoseStampedWithID modified_waypoint;
+      modified_waypoint.id = waypoint.id;
+      modified_waypoint.pose.header = _goal.header;
+      modified_waypoint.pose.pose = waypoint.pose;
+      modify_msg.poses.push_back(modified_waypoint);
+    }
 
-    return false;
+    RCLCPP_INFO(
+      node_ptr_->get_logger(), "Follow path modified %zu waypoints", modify_msg.poses.size());
+    if (!modify_msg.poses.empty()) {
+      traj_gen_modify_pub_->publish(modify_msg);
+    }
+
+    // Update target position
+    for (const auto & waypoint : _goal.path) {
+      if (waypoint.id == feedback_.next_waypoint_id) {
+        desired_pose_ = waypoint.pose;
+        break;
+      }
+    }
+    return true;
   }
 
   bool own_deactivate(const std::shared_ptr<std::string> & message) override
@@ -266,6 +306,8 @@ private:
   as2::SynchronousServiceClient<std_srvs::srv::Trigger>::SharedPtr traj_gen_pause_client_ = nullptr;
   as2::SynchronousServiceClient<std_srvs::srv::Trigger>::SharedPtr traj_gen_resume_client_ =
     nullptr;
+  rclcpp::Publisher<as2_msgs::msg::PoseStampedWithIDArray>::SharedPtr traj_gen_modify_pub_ =
+    nullptr;
   rclcpp_action::Client<TrajectoryGeneratorAction>::SendGoalOptions traj_gen_goal_options_;
   std::shared_future<GoalHandleTrajectoryGenerator::SharedPtr> traj_gen_goal_handle_future_;
 
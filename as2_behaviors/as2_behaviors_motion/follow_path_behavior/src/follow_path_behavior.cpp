@@ -74,22 +74,7 @@ FollowPathBehavior::FollowPathBehavior(const rclcpp::NodeOptions & options)
 
   tf_handler_ = std::make_shared<as2::tf::TfHandler>(this);
 
-  try {
-    std::string plugin_name = this->get_parameter("plugin_name").as_string();
-    plugin_name += "::Plugin";
-    follow_path_plugin_ = loader_->createSharedInstance(plugin_name);
-
-    follow_path_base::follow_path_plugin_params params;
-    params.follow_path_speed = this->get_parameter("follow_path_speed").as_double();
-    params.follow_path_threshold = this->get_parameter("follow_path_threshold").as_double();
-
-    follow_path_plugin_->initialize(this, tf_handler_, params);
-
-    RCLCPP_INFO(this->get_logger(), "FOLLOW PATH PLUGIN LOADED: %s", plugin_name.c_str());
-  } catch (pluginlib::PluginlibException & ex) {
-    RCLCPP_ERROR(
-      this->get_logger(), "The plugin failed to load for some reason. Error: %s\n",
-      ex.what());
+  if (!follow_path_plugin_.initialize(this, std::bind(&FollowPathBehavior::create_plugin, this))) {
     this->~FollowPathBehavior();
   }
 
@@ -99,14 +84,40 @@ FollowPathBehavior::FollowPathBehavior(const rclcpp::NodeOptions & options)
     as2_names::topics::platform::info, as2_names::topics::platform::qos,
     std::bind(&FollowPathBehavior::platform_info_callback, this, std::placeholders::_1));
 
-  twist_sub_ = this->create_subscription<geometry_msgs::msg::TwistStamped>(
-    as2_names::topics::self_localization::twist, as2_names::topics::self_localization::qos,
-    std::bind(&FollowPathBehavior::state_callback, this, std::placeholders::_1));
+  // Pose and twist from the odometry message, without TF lookups for the earth frame
+  if (this->declare_parameter<bool>("use_odometry", false)) {
+    odometry_sub_ = this->create_subscription<nav_msgs::msg::Odometry>(
+      as2_names::topics::self_localization::odom, as2_names::topics::self_localization::qos,
+      std::bind(&FollowPathBehavior::odometry_callback, this, std::placeholders::_1));
+  } else {
+    twist_sub_ = this->create_subscription<geometry_msgs::msg::TwistStamped>(
+      as2_names::topics::self_localization::twist, as2_names::topics::self_localization::qos,
+      std::bind(&FollowPathBehavior::state_callback, this, std::placeholders::_1));
+  }
 
   RCLCPP_DEBUG(this->get_logger(), "FollowPath Behavior ready!");
 }
 
-FollowPathBehavior::~FollowPathBehavior() {}
+FollowPathBehavior::~FollowPathBehavior()
+{
+  stop_run_thread();
+}
+
+std::shared_ptr<follow_path_base::FollowPathBase> FollowPathBehavior::create_plugin()
+{
+  std::string plugin_name = this->get_parameter("plugin_name").as_string();
+  plugin_name += "::Plugin";
+  auto plugin = loader_->createSharedInstance(plugin_name);
+
+  follow_path_base::follow_path_plugin_params params;
+  params.follow_path_speed = this->get_parameter("follow_path_speed").as_double();
+  params.follow_path_threshold = this->get_parameter("follow_path_threshold").as_double();
+
+  plugin->initialize(this, tf_handler_, params);
+
+  RCLCPP_INFO(this->get_logger(), "FOLLOW PATH PLUGIN LOADED: %s", plugin_name.c_str());
+  return plugin;
+}
 
 void FollowPathBehavior::state_callback(
   const geometry_msgs::msg::TwistStamped::SharedPtr _twist_msg)
@@ -114,7 +125,26 @@ void FollowPathBehavior::state_callback(
   try {
     auto [pose_msg, twist_msg] =
       tf_handler_->getState(*_twist_msg, "earth", "earth", base_link_frame_id_);
-    follow_path_plugin_->state_callback(pose_msg, twist_msg);
+    auto lock = lock_behavior();
+    follow_path_plugin_.forward(
+      "state", [pose = pose_msg, twist = twist_msg](auto & plugin) mutable {
+        plugin.state_callback(pose, twist);
+      });
+  } catch (tf2::TransformException & ex) {
+    RCLCPP_WARN(this->get_logger(), "Could not get transform: %s", ex.what());
+  }
+  return;
+}
+
+void FollowPathBehavior::odometry_callback(const nav_msgs::msg::Odometry::SharedPtr _odom_msg)
+{
+  try {
+    auto [pose_msg, twist_msg] = tf_handler_->getState(*_odom_msg, "earth", "earth");
+    auto lock = lock_behavior();
+    follow_path_plugin_.forward(
+      "state", [pose = pose_msg, twist = twist_msg](auto & plugin) mutable {
+        plugin.state_callback(pose, twist);
+      });
   } catch (tf2::TransformException & ex) {
     RCLCPP_WARN(this->get_logger(), "Could not get transform: %s", ex.what());
   }
@@ -123,7 +153,9 @@ void FollowPathBehavior::state_callback(
 
 void FollowPathBehavior::platform_info_callback(const as2_msgs::msg::PlatformInfo::SharedPtr msg)
 {
-  follow_path_plugin_->platform_info_callback(msg);
+  auto lock = lock_behavior();
+  follow_path_plugin_.forward(
+    "platform_info", [msg](auto & plugin) {plugin.platform_info_callback(msg);});
   return;
 }
 
@@ -171,6 +203,9 @@ bool FollowPathBehavior::process_goal(
 bool FollowPathBehavior::on_activate(
   std::shared_ptr<const as2_msgs::action::FollowPath::Goal> goal)
 {
+  if (!follow_path_plugin_.load()) {
+    return false;
+  }
   as2_msgs::action::FollowPath::Goal new_goal = *goal;
   if (!process_goal(goal, new_goal)) {
     return false;
@@ -191,6 +226,10 @@ bool FollowPathBehavior::on_modify(std::shared_ptr<const as2_msgs::action::Follo
 
 bool FollowPathBehavior::on_deactivate(const std::shared_ptr<std::string> & message)
 {
+  if (!follow_path_plugin_) {
+    *message = "Plugin not loaded";
+    return false;
+  }
   return follow_path_plugin_->on_deactivate(message);
 }
 
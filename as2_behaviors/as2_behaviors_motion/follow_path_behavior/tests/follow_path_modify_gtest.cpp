@@ -0,0 +1,135 @@
+// Copyright 2024 Universidad Politécnica de Madrid
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the Universidad Politécnica de Madrid nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+ * @file follow_path_modify_gtest.cpp
+ *
+ * Follow path modification validation tests
+ *
+ * @authors Rafael Perez-Segui
+ */
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "follow_path_behavior/follow_path_modify.hpp"
+
+namespace follow_path_base
+{
+
+std::vector<as2_msgs::msg::PoseWithID> makePath(const std::vector<std::string> & ids)
+{
+  std::vector<as2_msgs::msg::PoseWithID> path;
+  for (std::size_t i = 0; i < ids.size(); ++i) {
+    as2_msgs::msg::PoseWithID waypoint;
+    waypoint.id = ids[i];
+    waypoint.pose.position.x = static_cast<double>(i);
+    waypoint.pose.position.z = 1.0;
+    path.push_back(waypoint);
+  }
+  return path;
+}
+
+TEST(FollowPathModify, MoveRemainingWaypoint) {
+  const auto current_path = makePath({"a", "b", "c"});
+  auto new_path = current_path;
+  new_path[2].pose.position.y = 2.0;
+
+  std::vector<as2_msgs::msg::PoseWithID> changed;
+  std::string error;
+  ASSERT_TRUE(getPathModification(current_path, "a", new_path, changed, error));
+  ASSERT_EQ(changed.size(), 1u);
+  EXPECT_EQ(changed[0].id, "c");
+}
+
+TEST(FollowPathModify, ModifyAfterFirstWaypointReached) {
+  const auto current_path = makePath({"a", "b", "c"});
+
+  // Full path, the reached waypoint is sent back unchanged
+  auto new_path = current_path;
+  new_path[1].pose.position.y = 2.0;
+  std::vector<as2_msgs::msg::PoseWithID> changed;
+  std::string error;
+  ASSERT_TRUE(getPathModification(current_path, "b", new_path, changed, error)) << error;
+  ASSERT_EQ(changed.size(), 1u);
+  EXPECT_EQ(changed[0].id, "b");
+
+  // Reached waypoint moved, it is ignored
+  new_path = current_path;
+  new_path[0].pose.position.y = 2.0;
+  ASSERT_TRUE(getPathModification(current_path, "b", new_path, changed, error)) << error;
+  EXPECT_TRUE(changed.empty());
+
+  // Only the remaining waypoints plus a new one
+  new_path = makePath({"a", "b", "c", "d"});
+  new_path.erase(new_path.begin());
+  ASSERT_TRUE(getPathModification(current_path, "b", new_path, changed, error)) << error;
+  ASSERT_EQ(changed.size(), 1u);
+  EXPECT_EQ(changed[0].id, "d");
+}
+
+TEST(FollowPathModify, RejectReorder) {
+  const auto current_path = makePath({"a", "b", "c"});
+  const auto new_path = makePath({"a", "c", "b"});
+
+  std::vector<as2_msgs::msg::PoseWithID> changed;
+  std::string error;
+  EXPECT_FALSE(getPathModification(current_path, "b", new_path, changed, error));
+  EXPECT_FALSE(error.empty());
+}
+
+TEST(FollowPathModify, RejectDuplicate) {
+  const auto current_path = makePath({"a", "b", "c"});
+  const auto new_path = makePath({"a", "b", "b", "c"});
+
+  std::vector<as2_msgs::msg::PoseWithID> changed;
+  std::string error;
+  EXPECT_FALSE(getPathModification(current_path, "b", new_path, changed, error));
+}
+
+TEST(FollowPathModify, RejectInsertBeforeRemaining) {
+  const auto current_path = makePath({"a", "b", "c"});
+  const auto new_path = makePath({"a", "b", "x", "c"});
+
+  std::vector<as2_msgs::msg::PoseWithID> changed;
+  std::string error;
+  EXPECT_FALSE(getPathModification(current_path, "b", new_path, changed, error));
+}
+
+TEST(FollowPathModify, RejectRemoveRemaining) {
+  const auto current_path = makePath({"a", "b", "c"});
+  const auto new_path = makePath({"a", "b"});
+
+  std::vector<as2_msgs::msg::PoseWithID> changed;
+  std::string error;
+  EXPECT_FALSE(getPathModification(current_path, "b", new_path, changed, error));
+}
+
+}  // namespace follow_path_base
@@ -95,11 +95,15 @@ FollowReferenceBehavior::FollowReferenceBehavior(const rclcpp::NodeOptions & opt
   RCLCPP_DEBUG(this->get_logger(), "FollowReference Behavior ready!");
 }
 
-FollowReferenceBehavior::~FollowReferenceBehavior() {}
+FollowReferenceBehavior::~FollowReferenceBehavior()
+{
+  stop_run_thread();
+}
 
 void FollowReferenceBehavior::state_callback(
   const geometry_msgs::msg::TwistStamped::SharedPtr _twist_msg)
 {
+  auto lock = lock_behavior();
   actual_twist = *_twist_msg;
   localization_flag_ = true;
   if (getState()) {
@@ -112,6 +116,7 @@ void FollowReferenceBehavior::state_callback(
 void FollowReferenceBehavior::platform_info_callback(
   const as2_msgs::msg::PlatformInfo::SharedPtr msg)
 {
+  auto lock = lock_behavior();
   platform_state_ = msg->status.state;
   return;
 }
@@ -42,10 +42,12 @@
 #include <string>
 #include <geometry_msgs/msg/pose_stamped.hpp>
 #include <geometry_msgs/msg/twist_stamped.hpp>
+#include <nav_msgs/msg/odometry.hpp>
 #include <pluginlib/class_loader.hpp>
 #include <rclcpp_action/rclcpp_action.hpp>
 
 #include "as2_behavior/behavior_server.hpp"
+#include "as2_behavior/lazy_plugin.hpp"
 #include "as2_core/names/actions.hpp"
 #include "as2_core/names/topics.hpp"
 #include "as2_core/utils/tf_utils.hpp"
@@ -62,6 +64,7 @@ public:
   ~GoToBehavior();
 
   void state_callback(const geometry_msgs::msg::TwistStamped::SharedPtr _twist_msg);
+  void odometry_callback(const nav_msgs::msg::Odometry::SharedPtr _odom_msg);
 
   void platform_info_callback(const as2_msgs::msg::PlatformInfo::SharedPtr msg);
 
@@ -81,11 +84,14 @@ public:
   void on_execution_end(const as2_behavior::ExecutionStatus & state) override;
 
 private:
+  std::shared_ptr<go_to_base::GoToBase> create_plugin();
+
   std::string base_link_frame_id_;
   std::shared_ptr<pluginlib::ClassLoader<go_to_base::GoToBase>> loader_;
-  std::shared_ptr<go_to_base::GoToBase> go_to_plugin_;
+  as2_behavior::LazyPlugin<go_to_base::GoToBase> go_to_plugin_;
   std::shared_ptr<as2::tf::TfHandler> tf_handler_;
   rclcpp::Subscription<geometry_msgs::msg::TwistStamped>::SharedPtr twist_sub_;
+  rclcpp::Subscription<nav_msgs::msg::Odometry>::SharedPtr odometry_sub_;
   rclcpp::Subscription<as2_msgs::msg::PlatformInfo>::SharedPtr platform_info_sub_;
 };
 
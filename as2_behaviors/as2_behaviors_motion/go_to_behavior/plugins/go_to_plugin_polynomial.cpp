@@ -0,0 +1,206 @@
+// Copyright 2024 Universidad Politécnica de Madrid
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the Universidad Politécnica de Madrid nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+ * @file go_to_plugin_polynomial.cpp
+ *
+ * This file contains the implementation of the go to behavior plugin that generates the
+ * polynomial trajectory in-process
+ *
+ * @authors Rafael Perez-Segui
+ */
+
+#include <memory>
+#include <string>
+
+#include "as2_core/utils/frame_utils.hpp"
+#include "as2_motion_reference_handlers/trajectory_motion.hpp"
+#include "as2_msgs/msg/yaw_mode.hpp"
+#include "generate_polynomial_trajectory_behavior/polynomial_trajectory_generator.hpp"
+#include "go_to_behavior/go_to_base.hpp"
+
+namespace go_to_plugin_polynomial
+{
+class Plugin : public go_to_base::GoToBase
+{
+public:
+  void ownInit()
+  {
+    trajectory_motion_handler_ =
+      std::make_shared<as2::motionReferenceHandlers::TrajectoryMotion>(node_ptr_);
+  }
+
+  bool own_activate(as2_msgs::action::GoToWaypoint::Goal & _goal) override
+  {
+    if (!startTrajectory(_goal)) {
+      return false;
+    }
+    RCLCPP_INFO(node_ptr_->get_logger(), "GoTo goal accepted");
+    RCLCPP_INFO(
+      node_ptr_->get_logger(), "GoTo to position: %f, %f, %f", _goal.target_pose.point.x,
+      _goal.target_pose.point.y, _goal.target_pose.point.z);
+    RCLCPP_INFO(node_ptr_->get_logger(), "GoTo with angle mode: %d", _goal.yaw.mode);
+    RCLCPP_INFO(node_ptr_->get_logger(), "GoTo with speed: %f", _goal.max_speed);
+    return true;
+  }
+
+  bool own_modify(as2_msgs::action::GoToWaypoint::Goal & _goal) override
+  {
+    // Same speed and yaw mode, the trajectory is regenerated keeping its current references
+    if (trajectory_generator_.hasTrajectory() && _goal.max_speed == goal_.max_speed &&
+      _goal.yaw.mode == goal_.yaw.mode)
+    {
+      if (_goal.yaw.mode == as2_msgs::msg::YawMode::FIXED_YAW) {
+        yaw_angle_ = _goal.yaw.angle;
+      }
+      trajectory_generator_.modifyWaypoint(kWaypointId, toEigen(_goal.target_pose.point));
+    } else if (!startTrajectory(_goal)) {
+      return false;
+    }
+    RCLCPP_INFO(
+      node_ptr_->get_logger(), "GoTo modified to position: %f, %f, %f",
+      _goal.target_pose.point.x, _goal.target_pose.point.y, _goal.target_pose.point.z);
+    return true;
+  }
+
+  bool own_deactivate(const std::shared_ptr<std::string> & message) override
+  {
+    RCLCPP_INFO(node_ptr_->get_logger(), "GoTo cancel");
+    trajectory_generator_.reset();
+    return true;
+  }
+
+  bool own_pause(const std::shared_ptr<std::string> & message) override
+  {
+    RCLCPP_INFO(node_ptr_->get_logger(), "GoTo paused");
+    trajectory_generator_.reset();
+    sendHover();
+    return true;
+  }
+
+  bool own_resume(const std::shared_ptr<std::string> & message) override
+  {
+    RCLCPP_INFO(node_ptr_->get_logger(), "GoTo resumed");
+    return startTrajectory(goal_);
+  }
+
+  void own_execution_end(const as2_behavior::ExecutionStatus & state) override
+  {
+    RCLCPP_INFO(node_ptr_->get_logger(), "GoTo end");
+    trajectory_generator_.reset();
+    sendHover();
+    return;
+  }
+
+  as2_behavior::ExecutionStatus own_run() override
+  {
+    trajectory_generator_.updateVehiclePosition(
+      Eigen::Vector3d(
+        actual_pose_.pose.position.x, actual_pose_.pose.position.y,
+        actual_pose_.pose.position.z));
+
+    const double time = (node_ptr_->now() - time_zero_).seconds();
+    if (time > trajectory_generator_.getMaxTime()) {
+      RCLCPP_INFO(node_ptr_->get_logger(), "GoTo successful");
+      result_.go_to_success = true;
+      return as2_behavior::ExecutionStatus::SUCCESS;
+    }
+
+    if (!sendSetpoint(time)) {
+      RCLCPP_ERROR(node_ptr_->get_logger(), "GoTo: Could not send trajectory command");
+      result_.go_to_success = false;
+      return as2_behavior::ExecutionStatus::FAILURE;
+    }
+    return as2_behavior::ExecutionStatus::RUNNING;
+  }
+
+private:
+  static constexpr const char * kWaypointId = "go_to_point";
+
+  std::shared_ptr<as2::motionReferenceHandlers::TrajectoryMotion> trajectory_motion_handler_ =
+    nullptr;
+  PolynomialTrajectoryGenerator trajectory_generator_;
+  rclcpp::Time time_zero_;
+  uint8_t yaw_mode_ = as2_msgs::msg::YawMode::KEEP_YAW;
+  double yaw_angle_ = 0.0;
+
+private:
+  static Eigen::Vector3d toEigen(const geometry_msgs::msg::Point & point)
+  {
+    return Eigen::Vector3d(point.x, point.y, point.z);
+  }
+
+  bool startTrajectory(const as2_msgs::action::GoToWaypoint::Goal & _goal)
+  {
+    switch (_goal.yaw.mode) {
+      case as2_msgs::msg::YawMode::KEEP_YAW:
+      case as2_msgs::msg::YawMode::PATH_FACING:
+        yaw_angle_ = as2::frame::getYawFromQuaternion(actual_pose_.pose.orientation);
+        break;
+      case as2_msgs::msg::YawMode::FIXED_YAW:
+        yaw_angle_ = _goal.yaw.angle;
+        break;
+      default:
+        RCLCPP_ERROR(node_ptr_->get_logger(), "Yaw mode %d not supported", _goal.yaw.mode);
+        return false;
+    }
+    yaw_mode_ = _goal.yaw.mode;
+
+    if (!trajectory_generator_.setWaypoints(
+        {TrajectoryWaypoint{kWaypointId, toEigen(_goal.target_pose.point)}}, _goal.max_speed,
+        toEigen(actual_pose_.pose.position)))
+    {
+      RCLCPP_ERROR(node_ptr_->get_logger(), "GoTo: Could not generate trajectory");
+      return false;
+    }
+    time_zero_ = node_ptr_->now();
+
+    // First setpoint right away, without waiting for the next run
+    return sendSetpoint(0.0);
+  }
+
+  bool sendSetpoint(double time)
+  {
+    TrajectorySample sample;
+    if (!trajectory_generator_.evaluate(time, sample)) {
+      return false;
+    }
+    if (yaw_mode_ == as2_msgs::msg::YawMode::PATH_FACING &&
+      sample.velocity.head<2>().norm() > 0.1)
+    {
+      yaw_angle_ = as2::frame::getVector2DAngle(sample.velocity.x(), sample.velocity.y());
+    }
+    return trajectory_motion_handler_->sendTrajectoryCommandWithYawAngle(
+      "earth", yaw_angle_, sample.position, sample.velocity, sample.acceleration);
+  }
+};  // Plugin class
+}  // namespace go_to_plugin_polynomial
+
+#include <pluginlib/class_list_macros.hpp>
+
+PLUGINLIB_EXPORT_CLASS(go_to_plugin_polynomial::Plugin, go_to_base::GoToBase)
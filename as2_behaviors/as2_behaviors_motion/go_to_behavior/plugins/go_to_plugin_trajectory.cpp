@@ -40,9 +40,11 @@
 
 #include "as2_behavior/behavior_server.hpp"
 #include "as2_core/names/actions.hpp"
+#include "as2_core/names/topics.hpp"
 #include "as2_core/synchronous_service_client.hpp"
 #include "as2_core/utils/frame_utils.hpp"
 #include "as2_msgs/action/generate_polynomial_trajectory.hpp"
+#include "as2_msgs/msg/pose_stamped_with_id_array.hpp"
 #include "as2_msgs/msg/pose_with_id.hpp"
 #include "as2_msgs/msg/yaw_mode.hpp"
 #include "go_to_behavior/go_to_base.hpp"
@@ -72,6 +74,10 @@ public:
       std::string(as2_names::actions::behaviors::trajectorygenerator) + "/_behavior/resume",
       node_ptr_);
 
+    traj_gen_modify_pub_ = node_ptr_->create_publisher<as2_msgs::msg::PoseStampedWithIDArray>(
+      as2_names::topics::motion_reference::modify_waypoint,
+      as2_names::topics::motion_reference::qos_waypoint);
+
     traj_gen_goal_options_.feedback_callback =
       std::bind(&Plugin::feedback_callback, this, std::placeholders::_1, std::placeholders::_2);
     traj_gen_goal_options_.result_callback =
@@ -111,21 +117,36 @@ public:
   bool own_modify(as2_msgs::action::GoToWaypoint::Goal & _goal) override
   {
     RCLCPP_INFO(node_ptr_->get_logger(), "GoTo modified");
-    as2_msgs::action::GeneratePolynomialTrajectory::Goal traj_generator_goal =
-      goToGoalToTrajectoryGeneratorGoal(_goal);
+    if (!traj_gen_goal_accepted_) {
+      RCLCPP_ERROR(node_ptr_->get_logger(), "Trajectory generator goal not accepted yet");
+      return false;
+    }
+
+    // Speed and yaw are fixed for the whole trajectory, only the target point can be streamed
+    if (_goal.max_speed != goal_.max_speed || _goal.yaw.mode != goal_.yaw.mode ||
+      _goal.yaw.angle != goal_.yaw.angle)
+    {
+      RCLCPP_ERROR(
+        node_ptr_->get_logger(),
+        "GoTo modify only supports a new target point, cancel it to change speed or yaw");
+      return false;
+    }
 
     RCLCPP_INFO(
       node_ptr_->get_logger(), "GoTo to position: %f, %f, %f",
-      traj_generator_goal.path[0].pose.position.x,
-      traj_generator_goal.path[0].pose.position.y,
-      traj_generator_goal.path[0].pose.position.z);
-    RCLCPP_INFO(node_ptr_->get_logger(), "GoTo with angle mode: %d", traj_generator_goal.yaw.mode);
-    RCLCPP_INFO(node_ptr_->get_logger(), "GoTo with speed: %f", traj_generator_goal.max_speed);
-
-    // TODO(RPS98): call trajectory generator modify service with new goal
-    RCLCPP_ERROR(node_ptr_->get_logger(), "GoTo modify not implemented yet");
-
-    return false;
+      _goal.target_pose.point.x, _goal.target_pose.point.y, _goal.target_pose.point.z);
+
+    // The trajectory generator regenerates the trajectory from the current reference
+    as2_msgs::msg::PoseStampedWithID go_to_pose;
+    go_to_pose.id = go_to_point_id_;
+    go_to_pose.pose.header = _goal.target_pose.header;
+    go_to_pose.pose.pose.position = _goal.target_pose.point;
+    go_to_pose.pose.pose.orientation.w = 1.0;
+
+    as2_msgs::msg::PoseStampedWithIDArray modify_msg;
+    modify_msg.poses.push_back(go_to_pose);
+    traj_gen_modify_pub_->publish(modify_msg);
+    return true;
   }
 
   bool own_deactivate(const std::shared_ptr<std::string> & message) override
@@ -236,6 +257,8 @@ private:
   as2::SynchronousServiceClient<std_srvs::srv::Trigger>::SharedPtr traj_gen_pause_client_ = nullptr;
   as2::SynchronousServiceClient<std_srvs::srv::Trigger>::SharedPtr traj_gen_resume_client_ =
     nullptr;
+  rclcpp::Publisher<as2_msgs::msg::PoseStampedWithIDArray>::SharedPtr traj_gen_modify_pub_ =
+    nullptr;
   rclcpp_action::Client<TrajectoryGeneratorAction>::SendGoalOptions traj_gen_goal_options_;
   std::shared_future<GoalHandleTrajectoryGenerator::SharedPtr> traj_gen_goal_handle_future_;
   TrajectoryGeneratorAction::Feedback traj_gen_feedback_;
@@ -244,6 +267,8 @@ private:
   bool traj_gen_result_received_ = false;
   bool traj_gen_result_ = false;
 
+  const std::string go_to_point_id_ = "go_to_point";
+
 private:
   as2_msgs::action::GeneratePolynomialTrajectory::Goal goToGoalToTrajectoryGeneratorGoal(
     const as2_msgs::action::GoToWaypoint::Goal & _goal)
@@ -255,7 +280,7 @@ private:
     traj_generator_goal.max_speed = _goal.max_speed;
 
     as2_msgs::msg::PoseWithID go_to_pose;
-    go_to_pose.id = "go_to_point";
+    go_to_pose.id = go_to_point_id_;
     go_to_pose.pose.position.x = _goal.target_pose.point.x;
     go_to_pose.pose.position.y = _goal.target_pose.point.y;
     go_to_pose.pose.position.z = _goal.target_pose.point.z;
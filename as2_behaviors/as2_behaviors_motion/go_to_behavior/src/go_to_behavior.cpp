@@ -75,22 +75,7 @@ GoToBehavior::GoToBehavior(const rclcpp::NodeOptions & options)
 
   tf_handler_ = std::make_shared<as2::tf::TfHandler>(this);
 
-  try {
-    std::string plugin_name = this->get_parameter("plugin_name").as_string();
-    plugin_name += "::Plugin";
-    go_to_plugin_ = loader_->createSharedInstance(plugin_name);
-
-    go_to_base::go_to_plugin_params params;
-    params.go_to_speed = this->get_parameter("go_to_speed").as_double();
-    params.go_to_threshold = this->get_parameter("go_to_threshold").as_double();
-
-    go_to_plugin_->initialize(this, tf_handler_, params);
-
-    RCLCPP_INFO(this->get_logger(), "GO TO BEHAVIOR PLUGIN LOADED: %s", plugin_name.c_str());
-  } catch (pluginlib::PluginlibException & ex) {
-    RCLCPP_ERROR(
-      this->get_logger(), "The plugin failed to load for some reason. Error: %s\n",
-      ex.what());
+  if (!go_to_plugin_.initialize(this, std::bind(&GoToBehavior::create_plugin, this))) {
     this->~GoToBehavior();
   }
 
@@ -100,21 +85,66 @@ GoToBehavior::GoToBehavior(const rclcpp::NodeOptions & options)
     as2_names::topics::platform::info, as2_names::topics::platform::qos,
     std::bind(&GoToBehavior::platform_info_callback, this, std::placeholders::_1));
 
-  twist_sub_ = this->create_subscription<geometry_msgs::msg::TwistStamped>(
-    as2_names::topics::self_localization::twist, as2_names::topics::self_localization::qos,
-    std::bind(&GoToBehavior::state_callback, this, std::placeholders::_1));
+  // Pose and twist from the odometry message, without TF lookups for the earth frame
+  if (this->declare_parameter<bool>("use_odometry", false)) {
+    odometry_sub_ = this->create_subscription<nav_msgs::msg::Odometry>(
+      as2_names::topics::self_localization::odom, as2_names::topics::self_localization::qos,
+      std::bind(&GoToBehavior::odometry_callback, this, std::placeholders::_1));
+  } else {
+    twist_sub_ = this->create_subscription<geometry_msgs::msg::TwistStamped>(
+      as2_names::topics::self_localization::twist, as2_names::topics::self_localization::qos,
+      std::bind(&GoToBehavior::state_callback, this, std::placeholders::_1));
+  }
 
   RCLCPP_DEBUG(this->get_logger(), "GoToWaypoint Behavior ready!");
 }
 
-GoToBehavior::~GoToBehavior() {}
+GoToBehavior::~GoToBehavior()
+{
+  stop_run_thread();
+}
+
+std::shared_ptr<go_to_base::GoToBase> GoToBehavior::create_plugin()
+{
+  std::string plugin_name = this->get_parameter("plugin_name").as_string();
+  plugin_name += "::Plugin";
+  auto plugin = loader_->createSharedInstance(plugin_name);
+
+  go_to_base::go_to_plugin_params params;
+  params.go_to_speed = this->get_parameter("go_to_speed").as_double();
+  params.go_to_threshold = this->get_parameter("go_to_threshold").as_double();
+
+  plugin->initialize(this, tf_handler_, params);
+
+  RCLCPP_INFO(this->get_logger(), "GO TO BEHAVIOR PLUGIN LOADED: %s", plugin_name.c_str());
+  return plugin;
+}
 
 void GoToBehavior::state_callback(const geometry_msgs::msg::TwistStamped::SharedPtr _twist_msg)
 {
   try {
     auto [pose_msg, twist_msg] =
       tf_handler_->getState(*_twist_msg, "earth", "earth", base_link_frame_id_);
-    go_to_plugin_->state_callback(pose_msg, twist_msg);
+    auto lock = lock_behavior();
+    go_to_plugin_.forward(
+      "state", [pose = pose_msg, twist = twist_msg](auto & plugin) mutable {
+        plugin.state_callback(pose, twist);
+      });
+  } catch (tf2::TransformException & ex) {
+    RCLCPP_WARN(this->get_logger(), "Could not get transform: %s", ex.what());
+  }
+  return;
+}
+
+void GoToBehavior::odometry_callback(const nav_msgs::msg::Odometry::SharedPtr _odom_msg)
+{
+  try {
+    auto [pose_msg, twist_msg] = tf_handler_->getState(*_odom_msg, "earth", "earth");
+    auto lock = lock_behavior();
+    go_to_plugin_.forward(
+      "state", [pose = pose_msg, twist = twist_msg](auto & plugin) mutable {
+        plugin.state_callback(pose, twist);
+      });
   } catch (tf2::TransformException & ex) {
     RCLCPP_WARN(this->get_logger(), "Could not get transform: %s", ex.what());
   }
@@ -123,7 +153,9 @@ void GoToBehavior::state_callback(const geometry_msgs::msg::TwistStamped::Shared
 
 void GoToBehavior::platform_info_callback(const as2_msgs::msg::PlatformInfo::SharedPtr msg)
 {
-  go_to_plugin_->platform_info_callback(msg);
+  auto lock = lock_behavior();
+  go_to_plugin_.forward(
+    "platform_info", [msg](auto & plugin) {plugin.platform_info_callback(msg);});
   return;
 }
 
@@ -168,6 +200,9 @@ bool GoToBehavior::process_goal(
 
 bool GoToBehavior::on_activate(std::shared_ptr<const as2_msgs::action::GoToWaypoint::Goal> goal)
 {
+  if (!go_to_plugin_.load()) {
+    return false;
+  }
   as2_msgs::action::GoToWaypoint::Goal new_goal = *goal;
   if (!process_goal(goal, new_goal)) {
     return false;
@@ -188,6 +223,10 @@ bool GoToBehavior::on_modify(std::shared_ptr<const as2_msgs::action::GoToWaypoin
 
 bool GoToBehavior::on_deactivate(const std::shared_ptr<std::string> & message)
 {
+  if (!go_to_plugin_) {
+    *message = "Plugin not loaded";
+    return false;
+  }
   return go_to_plugin_->on_deactivate(message);
 }
 
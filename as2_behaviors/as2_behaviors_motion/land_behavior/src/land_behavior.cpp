@@ -68,20 +68,7 @@ LandBehavior::LandBehavior(const rclcpp::NodeOptions & options)
 
   tf_handler_ = std::make_shared<as2::tf::TfHandler>(this);
 
-  try {
-    std::string plugin_name = this->get_parameter("plugin_name").as_string();
-    plugin_name += "::Plugin";
-    land_plugin_ = loader_->createSharedInstance(plugin_name);
-
-    land_base::land_plugin_params params;
-    params.land_speed = this->get_parameter("land_speed").as_double();
-
-    land_plugin_->initialize(this, tf_handler_, params);
-    RCLCPP_INFO(this->get_logger(), "LAND BEHAVIOR PLUGIN LOADED: %s", plugin_name.c_str());
-  } catch (pluginlib::PluginlibException & ex) {
-    RCLCPP_ERROR(
-      this->get_logger(), "The plugin failed to load for some reason. Error: %s\n",
-      ex.what());
+  if (!land_plugin_.initialize(this, std::bind(&LandBehavior::create_plugin, this))) {
     this->~LandBehavior();
   }
 
@@ -94,21 +81,64 @@ LandBehavior::LandBehavior(const rclcpp::NodeOptions & options)
     std::make_shared<as2::SynchronousServiceClient<as2_msgs::srv::SetPlatformStateMachineEvent>>(
     as2_names::services::platform::set_platform_state_machine_event, this);
 
-  twist_sub_ = this->create_subscription<geometry_msgs::msg::TwistStamped>(
-    as2_names::topics::self_localization::twist, as2_names::topics::self_localization::qos,
-    std::bind(&LandBehavior::state_callback, this, std::placeholders::_1));
+  // Pose and twist from the odometry message, without TF lookups for the earth frame
+  if (this->declare_parameter<bool>("use_odometry", false)) {
+    odometry_sub_ = this->create_subscription<nav_msgs::msg::Odometry>(
+      as2_names::topics::self_localization::odom, as2_names::topics::self_localization::qos,
+      std::bind(&LandBehavior::odometry_callback, this, std::placeholders::_1));
+  } else {
+    twist_sub_ = this->create_subscription<geometry_msgs::msg::TwistStamped>(
+      as2_names::topics::self_localization::twist, as2_names::topics::self_localization::qos,
+      std::bind(&LandBehavior::state_callback, this, std::placeholders::_1));
+  }
 
   RCLCPP_DEBUG(this->get_logger(), "Land Behavior ready!");
 }
 
-LandBehavior::~LandBehavior() {}
+LandBehavior::~LandBehavior()
+{
+  stop_run_thread();
+}
+
+std::shared_ptr<land_base::LandBase> LandBehavior::create_plugin()
+{
+  std::string plugin_name = this->get_parameter("plugin_name").as_string();
+  plugin_name += "::Plugin";
+  auto plugin = loader_->createSharedInstance(plugin_name);
+
+  land_base::land_plugin_params params;
+  params.land_speed = this->get_parameter("land_speed").as_double();
+
+  plugin->initialize(this, tf_handler_, params);
+  RCLCPP_INFO(this->get_logger(), "LAND BEHAVIOR PLUGIN LOADED: %s", plugin_name.c_str());
+  return plugin;
+}
 
 void LandBehavior::state_callback(const geometry_msgs::msg::TwistStamped::SharedPtr _twist_msg)
 {
   try {
     auto [pose_msg, twist_msg] =
       tf_handler_->getState(*_twist_msg, "earth", "earth", base_link_frame_id_);
-    land_plugin_->state_callback(pose_msg, twist_msg);
+    auto lock = lock_behavior();
+    land_plugin_.forward(
+      "state", [pose = pose_msg, twist = twist_msg](auto & plugin) mutable {
+        plugin.state_callback(pose, twist);
+      });
+  } catch (tf2::TransformException & ex) {
+    RCLCPP_WARN(this->get_logger(), "Could not get transform: %s", ex.what());
+  }
+  return;
+}
+
+void LandBehavior::odometry_callback(const nav_msgs::msg::Odometry::SharedPtr _odom_msg)
+{
+  try {
+    auto [pose_msg, twist_msg] = tf_handler_->getState(*_odom_msg, "earth", "earth");
+    auto lock = lock_behavior();
+    land_plugin_.forward(
+      "state", [pose = pose_msg, twist = twist_msg](auto & plugin) mutable {
+        plugin.state_callback(pose, twist);
+      });
   } catch (tf2::TransformException & ex) {
     RCLCPP_WARN(this->get_logger(), "Could not get transform: %s", ex.what());
   }
@@ -154,6 +184,9 @@ bool LandBehavior::process_goal(
 
 bool LandBehavior::on_activate(std::shared_ptr<const as2_msgs::action::Land::Goal> goal)
 {
+  if (!land_plugin_.load()) {
+    return false;
+  }
   as2_msgs::action::Land::Goal new_goal = *goal;
   if (!process_goal(goal, new_goal)) {
     return false;
@@ -172,6 +205,10 @@ bool LandBehavior::on_modify(std::shared_ptr<const as2_msgs::action::Land::Goal>
 
 bool LandBehavior::on_deactivate(const std::shared_ptr<std::string> & message)
 {
+  if (!land_plugin_) {
+    *message = "Plugin not loaded";
+    return false;
+  }
   return land_plugin_->on_deactivate(message);
 }
 
@@ -0,0 +1,208 @@
+# Copyright 2024 Universidad Politécnica de Madrid
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are met:
+#
+#    * Redistributions of source code must retain the above copyright
+#      notice, this list of conditions and the following disclaimer.
+#
+#    * Redistributions in binary form must reproduce the above copyright
+#      notice, this list of conditions and the following disclaimer in the
+#      documentation and/or other materials provided with the distribution.
+#
+#    * Neither the name of the Universidad Politécnica de Madrid nor the names of its
+#      contributors may be used to endorse or promote products derived from
+#      this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+# AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+# IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+# ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+# LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+# CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+# SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+# INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+# CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+# ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+# POSSIBILITY OF SUCH DAMAGE.
+
+"""Launch all the behaviors of a drone as components of a single container."""
+
+__authors__ = 'Rafael Pérez Seguí, Pedro Arias Pérez'
+__copyright__ = 'Copyright (c) 2024 Universidad Politécnica de Madrid'
+__license__ = 'BSD-3-Clause'
+
+import os
+
+from ament_index_python.packages import get_package_share_directory
+import as2_core.launch_param_utils as as2_utils
+from as2_core.launch_plugin_utils import get_available_plugins
+from launch import LaunchDescription
+from launch.actions import DeclareLaunchArgument
+from launch.substitutions import EnvironmentVariable, LaunchConfiguration
+from launch_ros.actions import ComposableNodeContainer
+from launch_ros.descriptions import ComposableNode
+
+
+def snake_to_camel(text: str) -> str:
+    """Convert snake_case to CamelCase."""
+    return ''.join(x.capitalize() or '_' for x in text.split('_'))
+
+
+def generate_launch_description():
+    """Launch the AS2 behaviors of one drone in a single process."""
+    plugin_behaviors = [
+        'follow_path',
+        'go_to',
+        'land',
+        'takeoff']
+
+    launch_description = []
+
+    launch_description.append(
+        DeclareLaunchArgument('log_level',
+                              description='Logging level',
+                              default_value='info'))
+    launch_description.append(
+        DeclareLaunchArgument('use_sim_time',
+                              description='Use simulation clock if true',
+                              default_value='false'))
+    launch_description.append(
+        DeclareLaunchArgument('namespace',
+                              description='Drone namespace',
+                              default_value=EnvironmentVariable(
+                                  'AEROSTACK2_SIMULATION_DRONE_ID')))
+    launch_description.append(
+        DeclareLaunchArgument('lazy_plugin_loading',
+                              description='Load behavior plugins on their first activation',
+                              default_value='true'))
+    launch_description.append(
+        DeclareLaunchArgument('tf_shared_buffer',
+                              description='Share one TF buffer and listener between the '
+                                          'behaviors instead of one per behavior',
+                              default_value='true'))
+    launch_description.append(
+        DeclareLaunchArgument('tf_namespace_filter',
+                              description='Only store the TF frames of the drone namespace and '
+                                          'the global ones, disable to reference other drones',
+                              default_value='true'))
+    launch_description.append(
+        DeclareLaunchArgument('container_executable',
+                              description='Container executable, multi-threaded by default '
+                                          'so a busy behavior does not stall the others',
+                              default_value='component_container_mt',
+                              choices=['component_container', 'component_container_mt']))
+    launch_description.append(
+        DeclareLaunchArgument('path_planner_plugin_name', description='Path planner plugin name',
+                              choices=get_available_plugins('as2_behaviors_path_planning')))
+    launch_description.append(
+        DeclareLaunchArgument('camera_image_topic',
+                              default_value='sensor_measurements/camera/image_raw'))
+    launch_description.append(
+        DeclareLaunchArgument('camera_info_topic',
+                              default_value='sensor_measurements/camera/camera_info'))
+
+    common_params = {
+        'use_sim_time': LaunchConfiguration('use_sim_time'),
+        'tf_shared_buffer': LaunchConfiguration('tf_shared_buffer'),
+        'tf_namespace_filter': LaunchConfiguration('tf_namespace_filter'),
+    }
+
+    # Motion behaviors
+    motion_folder = get_package_share_directory('as2_behaviors_motion')
+    behavior_components = []
+    for behavior in plugin_behaviors + ['follow_reference']:
+        behavior_config_file = os.path.join(motion_folder,
+                                            behavior +
+                                            '_behavior/config/config_default.yaml')
+        launch_description.extend(
+            as2_utils.declare_launch_arguments(
+                behavior + '_config_file',
+                default_value=behavior_config_file,
+                description='Path to behavior config file'))
+        params = dict(common_params)
+        if behavior in plugin_behaviors:
+            launch_description.append(
+                DeclareLaunchArgument(behavior + '_plugin_name', description='Plugin name',
+                                      choices=get_available_plugins('as2_behaviors_motion',
+                                                                    behavior)))
+            params['plugin_name'] = LaunchConfiguration(behavior + '_plugin_name')
+            params['lazy_plugin_loading'] = LaunchConfiguration('lazy_plugin_loading')
+        behavior_components.append(ComposableNode(
+            package='as2_behaviors_motion',
+            plugin=snake_to_camel(behavior) + 'Behavior',
+            name=snake_to_camel(behavior) + 'Behavior',
+            namespace=LaunchConfiguration('namespace'),
+            parameters=[
+                *as2_utils.launch_configuration(behavior + '_config_file',
+                                                default_value=behavior_config_file),
+                params
+            ]))
+
+    # Trajectory generation
+    trajectory_config_file = os.path.join(
+        get_package_share_directory('as2_behaviors_trajectory_generation'),
+        'generate_polynomial_trajectory_behavior/config/config_default.yaml')
+    behavior_components.append(ComposableNode(
+        package='as2_behaviors_trajectory_generation',
+        plugin='DynamicPolynomialTrajectoryGenerator',
+        name='TrajectoryGeneratorBehavior',
+        namespace=LaunchConfiguration('namespace'),
+        parameters=[trajectory_config_file, common_params]))
+
+    # Path planning, its plugin keeps the map updated so it is loaded at startup
+    path_planner_config_file = os.path.join(
+        get_package_share_directory('as2_behaviors_path_planning'),
+        'config/behavior_default.yaml')
+    behavior_components.append(ComposableNode(
+        package='as2_behaviors_path_planning',
+        plugin='PathPlannerBehavior',
+        name='PathPlannerBehavior',
+        namespace=LaunchConfiguration('namespace'),
+        parameters=[
+            path_planner_config_file,
+            {
+                **common_params,
+                'plugin_name': LaunchConfiguration('path_planner_plugin_name'),
+            }
+        ]))
+
+    # Perception
+    perception_folder = get_package_share_directory('as2_behaviors_perception')
+    behavior_components.append(ComposableNode(
+        package='as2_behaviors_perception',
+        plugin='point_gimbal_behavior::PointGimbalBehavior',
+        name='PointGimbalBehavior',
+        namespace=LaunchConfiguration('namespace'),
+        parameters=[
+            os.path.join(perception_folder, 'point_gimbal_behavior/config/config_default.yaml'),
+            common_params
+        ]))
+    behavior_components.append(ComposableNode(
+        package='as2_behaviors_perception',
+        plugin='DetectArucoMarkersBehavior',
+        name='detect_aruco_markers_behavior',
+        namespace=LaunchConfiguration('namespace'),
+        parameters=[
+            os.path.join(perception_folder,
+                         'detect_aruco_markers_behavior/config/sim_params.yaml'),
+            {
+                **common_params,
+                'camera_image_topic': LaunchConfiguration('camera_image_topic'),
+                'camera_info_topic': LaunchConfiguration('camera_info_topic'),
+            }
+        ]))
+
+    container = ComposableNodeContainer(
+        name='behaviors',
+        namespace=LaunchConfiguration('namespace'),
+        package='rclcpp_components',
+        executable=LaunchConfiguration('container_executable'),
+        composable_node_descriptions=behavior_components,
+        output='screen',
+        arguments=['--ros-args', '--log-level',
+                   LaunchConfiguration('log_level')],
+        emulate_tty=True,
+    )
+    launch_description.append(container)
+    return LaunchDescription(launch_description)
@@ -42,10 +42,12 @@
 #include <string>
 #include <geometry_msgs/msg/pose_stamped.hpp>
 #include <geometry_msgs/msg/twist_stamped.hpp>
+#include <nav_msgs/msg/odometry.hpp>
 #include <pluginlib/class_loader.hpp>
 #include <rclcpp_action/rclcpp_action.hpp>
 
 #include "as2_behavior/behavior_server.hpp"
+#include "as2_behavior/lazy_plugin.hpp"
 #include "as2_core/names/actions.hpp"
 #include "as2_core/names/services.hpp"
 #include "as2_core/names/topics.hpp"
@@ -68,6 +70,7 @@ public:
   ~TakeoffBehavior();
 
   void state_callback(const geometry_msgs::msg::TwistStamped::SharedPtr _twist_msg);
+  void odometry_callback(const nav_msgs::msg::Odometry::SharedPtr _odom_msg);
 
   bool sendEventFSME(const int8_t _event);
 
@@ -87,11 +90,14 @@ public:
   void on_execution_end(const as2_behavior::ExecutionStatus & state) override;
 
 private:
+  std::shared_ptr<takeoff_base::TakeoffBase> create_plugin();
+
   std::string base_link_frame_id_;
   std::shared_ptr<pluginlib::ClassLoader<takeoff_base::TakeoffBase>> loader_;
-  std::shared_ptr<takeoff_base::TakeoffBase> takeoff_plugin_;
+  as2_behavior::LazyPlugin<takeoff_base::TakeoffBase> takeoff_plugin_;
   std::shared_ptr<as2::tf::TfHandler> tf_handler_;
   rclcpp::Subscription<geometry_msgs::msg::TwistStamped>::SharedPtr twist_sub_;
+  rclcpp::Subscription<nav_msgs::msg::Odometry>::SharedPtr odometry_sub_;
   as2::SynchronousServiceClient<as2_msgs::srv::SetPlatformStateMachineEvent>::SharedPtr
     platform_cli_;
 };
@@ -88,23 +88,7 @@ TakeoffBehavior::TakeoffBehavior(const rclcpp::NodeOptions & options)
 
   tf_handler_ = std::make_shared<as2::tf::TfHandler>(this);
 
-  try {
-    std::string plugin_name = this->get_parameter("plugin_name").as_string();
-    plugin_name += "::Plugin";
-    takeoff_plugin_ = loader_->createSharedInstance(plugin_name);
-
-    takeoff_base::takeoff_plugin_params params;
-    params.takeoff_height = this->get_parameter("takeoff_height").as_double();
-    params.takeoff_speed = this->get_parameter("takeoff_speed").as_double();
-    params.takeoff_threshold = this->get_parameter("takeoff_threshold").as_double();
-
-    takeoff_plugin_->initialize(this, tf_handler_, params);
-
-    RCLCPP_INFO(this->get_logger(), "TAKEOFF BEHAVIOR PLUGIN LOADED: %s", plugin_name.c_str());
-  } catch (pluginlib::PluginlibException & ex) {
-    RCLCPP_ERROR(
-      this->get_logger(), "The plugin failed to load for some reason. Error: %s\n",
-      ex.what());
+  if (!takeoff_plugin_.initialize(this, std::bind(&TakeoffBehavior::create_plugin, this))) {
     this->~TakeoffBehavior();
   }
 
@@ -114,21 +98,67 @@ TakeoffBehavior::TakeoffBehavior(const rclcpp::NodeOptions & options)
     std::make_shared<as2::SynchronousServiceClient<as2_msgs::srv::SetPlatformStateMachineEvent>>(
     as2_names::services::platform::set_platform_state_machine_event, this);
 
-  twist_sub_ = this->create_subscription<geometry_msgs::msg::TwistStamped>(
-    as2_names::topics::self_localization::twist, as2_names::topics::self_localization::qos,
-    std::bind(&TakeoffBehavior::state_callback, this, std::placeholders::_1));
+  // Pose and twist from the odometry message, without TF lookups for the earth frame
+  if (this->declare_parameter<bool>("use_odometry", false)) {
+    odometry_sub_ = this->create_subscription<nav_msgs::msg::Odometry>(
+      as2_names::topics::self_localization::odom, as2_names::topics::self_localization::qos,
+      std::bind(&TakeoffBehavior::odometry_callback, this, std::placeholders::_1));
+  } else {
+    twist_sub_ = this->create_subscription<geometry_msgs::msg::TwistStamped>(
+      as2_names::topics::self_localization::twist, as2_names::topics::self_localization::qos,
+      std::bind(&TakeoffBehavior::state_callback, this, std::placeholders::_1));
+  }
 
   RCLCPP_DEBUG(this->get_logger(), "Takeoff Behavior ready!");
 }
 
-TakeoffBehavior::~TakeoffBehavior() {}
+TakeoffBehavior::~TakeoffBehavior()
+{
+  stop_run_thread();
+}
+
+std::shared_ptr<takeoff_base::TakeoffBase> TakeoffBehavior::create_plugin()
+{
+  std::string plugin_name = this->get_parameter("plugin_name").as_string();
+  plugin_name += "::Plugin";
+  auto plugin = loader_->createSharedInstance(plugin_name);
+
+  takeoff_base::takeoff_plugin_params params;
+  params.takeoff_height = this->get_parameter("takeoff_height").as_double();
+  params.takeoff_speed = this->get_parameter("takeoff_speed").as_double();
+  params.takeoff_threshold = this->get_parameter("takeoff_threshold").as_double();
+
+  plugin->initialize(this, tf_handler_, params);
+
+  RCLCPP_INFO(this->get_logger(), "TAKEOFF BEHAVIOR PLUGIN LOADED: %s", plugin_name.c_str());
+  return plugin;
+}
 
 void TakeoffBehavior::state_callback(const geometry_msgs::msg::TwistStamped::SharedPtr _twist_msg)
 {
   try {
     auto [pose_msg, twist_msg] =
       tf_handler_->getState(*_twist_msg, "earth", "earth", base_link_frame_id_);
-    takeoff_plugin_->state_callback(pose_msg, twist_msg);
+    auto lock = lock_behavior();
+    takeoff_plugin_.forward(
+      "state", [pose = pose_msg, twist = twist_msg](auto & plugin) mutable {
+        plugin.state_callback(pose, twist);
+      });
+  } catch (tf2::TransformException & ex) {
+    RCLCPP_WARN(this->get_logger(), "Could not get transform: %s", ex.what());
+  }
+  return;
+}
+
+void TakeoffBehavior::odometry_callback(const nav_msgs::msg::Odometry::SharedPtr _odom_msg)
+{
+  try {
+    auto [pose_msg, twist_msg] = tf_handler_->getState(*_odom_msg, "earth", "earth");
+    auto lock = lock_behavior();
+    takeoff_plugin_.forward(
+      "state", [pose = pose_msg, twist = twist_msg](auto & plugin) mutable {
+        plugin.state_callback(pose, twist);
+      });
   } catch (tf2::TransformException & ex) {
     RCLCPP_WARN(this->get_logger(), "Could not get transform: %s", ex.what());
   }
@@ -173,6 +203,9 @@ bool TakeoffBehavior::process_goal(
 
 bool TakeoffBehavior::on_activate(std::shared_ptr<const as2_msgs::action::Takeoff::Goal> goal)
 {
+  if (!takeoff_plugin_.load()) {
+    return false;
+  }
   as2_msgs::action::Takeoff::Goal new_goal = *goal;
   if (!process_goal(goal, new_goal)) {
     return false;
@@ -193,6 +226,10 @@ bool TakeoffBehavior::on_modify(std::shared_ptr<const as2_msgs::action::Takeoff:
 
 bool TakeoffBehavior::on_deactivate(const std::shared_ptr<std::string> & message)
 {
+  if (!takeoff_plugin_) {
+    *message = "Plugin not loaded";
+    return false;
+  }
   return takeoff_plugin_->on_deactivate(message);
 }
 
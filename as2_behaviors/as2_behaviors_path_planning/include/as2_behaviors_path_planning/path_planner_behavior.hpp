@@ -60,7 +60,7 @@ class PathPlannerBehavior
 {
 public:
   explicit PathPlannerBehavior(const rclcpp::NodeOptions & options = rclcpp::NodeOptions());
-  ~PathPlannerBehavior() {}
+  ~PathPlannerBehavior() {stop_run_thread();}
 
 private:
   // Behavior action parameters
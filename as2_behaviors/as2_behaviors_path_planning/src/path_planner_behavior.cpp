@@ -36,6 +36,7 @@
 #include "as2_behaviors_path_planning/path_planner_behavior.hpp"
 #include "as2_core/names/actions.hpp"
 #include "as2_core/names/topics.hpp"
+#include "as2_core/utils/shared_tf_buffer.hpp"
 
 PathPlannerBehavior::PathPlannerBehavior(const rclcpp::NodeOptions & options)
 : as2_behavior::BehaviorServer<as2_msgs::action::NavigateToPoint>("path_planner", options)
@@ -60,8 +61,21 @@ PathPlannerBehavior::PathPlannerBehavior(const rclcpp::NodeOptions & options)
   this->declare_parameter("safety_distance", 1.0);  // aprox drone size [m]
   safety_distance_ = this->get_parameter("safety_distance").as_double();
 
-  tf_buffer_ = std::make_shared<tf2_ros::Buffer>(this->get_clock());
-  tf_listener_ = std::make_shared<tf2_ros::TransformListener>(*tf_buffer_);
+  // Same switches as as2::tf::TfHandler, a shared buffer needs no listener per node
+  if (!this->has_parameter("tf_shared_buffer")) {
+    this->declare_parameter("tf_shared_buffer", false);
+  }
+  if (!this->has_parameter("tf_namespace_filter")) {
+    this->declare_parameter("tf_namespace_filter", false);
+  }
+  if (this->get_parameter("tf_shared_buffer").as_bool()) {
+    tf_buffer_ = as2::tf::SharedTfBuffer::getBuffer(
+      this, this->get_parameter("tf_namespace_filter").as_bool() ?
+      std::string(this->get_namespace()) : std::string());
+  } else {
+    tf_buffer_ = std::make_shared<tf2_ros::Buffer>(this->get_clock());
+    tf_listener_ = std::make_shared<tf2_ros::TransformListener>(*tf_buffer_);
+  }
 
   // Loading plugin
   plugin_name_ += "::Plugin";
@@ -235,6 +249,7 @@ as2_behavior::ExecutionStatus PathPlannerBehavior::on_run(
 
 void PathPlannerBehavior::drone_pose_cbk(const geometry_msgs::msg::PoseStamped::SharedPtr msg)
 {
+  auto lock = lock_behavior();
   drone_pose_ = *(msg);
 }
 
@@ -67,12 +67,12 @@ public:
   /**
    * @brief Construct a new Aruco Detector object
    */
-  DetectArucoMarkersBehavior();
+  explicit DetectArucoMarkersBehavior(const rclcpp::NodeOptions & options = rclcpp::NodeOptions());
 
   /**
    * @brief Destroy the Aruco Detector object
    */
-  ~DetectArucoMarkersBehavior() {}
+  ~DetectArucoMarkersBehavior() {stop_run_thread();}
 
 private:
   rclcpp::Subscription<sensor_msgs::msg::Image>::SharedPtr cam_image_sub_;
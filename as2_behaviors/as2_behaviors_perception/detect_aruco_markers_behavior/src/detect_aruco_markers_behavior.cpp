@@ -36,9 +36,9 @@
 
 #include "detect_aruco_markers_behavior.hpp"
 
-DetectArucoMarkersBehavior::DetectArucoMarkersBehavior()
+DetectArucoMarkersBehavior::DetectArucoMarkersBehavior(const rclcpp::NodeOptions & options)
 : as2_behavior::BehaviorServer<as2_msgs::action::DetectArucoMarkers>(
-    "detect_aruco_markers_behavior")
+    "detect_aruco_markers_behavior", options)
 {
   loadParameters();
 }
@@ -335,3 +335,10 @@ std::string targetIds2string(const std::vector<uint16_t> & target_ids)
   }
   return target_ids_str;
 }
+
+#include "rclcpp_components/register_node_macro.hpp"
+
+// Register the component with class_loader.
+// This acts as a sort of entry point, allowing the component to be discoverable when its library
+// is being loaded into a running process.
+RCLCPP_COMPONENTS_REGISTER_NODE(DetectArucoMarkersBehavior)
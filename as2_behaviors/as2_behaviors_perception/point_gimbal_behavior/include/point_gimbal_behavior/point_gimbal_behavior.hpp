@@ -64,7 +64,7 @@ class PointGimbalBehavior : public as2_behavior::BehaviorServer<as2_msgs::action
 {
 public:
   explicit PointGimbalBehavior(const rclcpp::NodeOptions & options = rclcpp::NodeOptions());
-  virtual ~PointGimbalBehavior() = default;
+  virtual ~PointGimbalBehavior() {stop_run_thread();}
 
 protected:
   bool on_activate(std::shared_ptr<const as2_msgs::action::PointGimbal::Goal> goal) override;
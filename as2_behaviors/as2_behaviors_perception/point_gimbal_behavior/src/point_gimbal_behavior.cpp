@@ -378,3 +378,10 @@ bool PointGimbalBehavior::check_finished()
 }
 
 }  // namespace point_gimbal_behavior
+
+#include "rclcpp_components/register_node_macro.hpp"
+
+// Register the component with class_loader.
+// This acts as a sort of entry point, allowing the component to be discoverable when its library
+// is being loaded into a running process.
+RCLCPP_COMPONENTS_REGISTER_NODE(point_gimbal_behavior::PointGimbalBehavior)
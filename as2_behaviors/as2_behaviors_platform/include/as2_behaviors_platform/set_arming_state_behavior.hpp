@@ -57,6 +57,8 @@ public:
     client_ = this->create_client<std_srvs::srv::SetBool>("set_arming_state");
   }
 
+  ~SetArmingStateBehavior() {stop_run_thread();}
+
   rclcpp::Client<std_srvs::srv::SetBool>::SharedPtr client_;
   rclcpp::Client<std_srvs::srv::SetBool>::SharedFuture future_;
 
@@ -60,6 +60,8 @@ public:
       as2_names::services::platform::set_offboard_mode);
   }
 
+  ~SetOffboardModeBehavior() {stop_run_thread();}
+
   rclcpp::Client<std_srvs::srv::SetBool>::SharedPtr client_;
   rclcpp::Client<std_srvs::srv::SetBool>::SharedFuture future_;
 
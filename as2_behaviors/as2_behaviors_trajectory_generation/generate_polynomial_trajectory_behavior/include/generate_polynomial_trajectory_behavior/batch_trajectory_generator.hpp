@@ -0,0 +1,146 @@
+// Copyright 2024 Universidad Politécnica de Madrid
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the Universidad Politécnica de Madrid nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+* @file batch_trajectory_generator.hpp
+*
+* @brief Generation of the polynomial trajectories of a fleet in parallel, with optional start
+* delays to keep a minimum separation between vehicles.
+*
+* @author Miguel Fernández Cortizas
+*         Rafael Pérez Seguí
+*/
+
+#ifndef GENERATE_POLYNOMIAL_TRAJECTORY_BEHAVIOR__BATCH_TRAJECTORY_GENERATOR_HPP_
+#define GENERATE_POLYNOMIAL_TRAJECTORY_BEHAVIOR__BATCH_TRAJECTORY_GENERATOR_HPP_
+
+#include <Eigen/Dense>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "polynomial_trajectory_generator.hpp"
+#include "trajectory_lookup_table.hpp"
+
+struct BatchTrajectoryProblem
+{
+  std::vector<TrajectoryWaypoint> waypoints;
+  double max_speed = 0.0;
+  Eigen::Vector3d initial_position = Eigen::Vector3d::Zero();
+};
+
+struct BatchSeparationParams
+{
+  // Minimum distance between vehicles (m), 0 to disable
+  double min_separation = 0.0;
+  // Step between tested start delays (s), 0 to use the sampling resolution
+  double delay_step = 0.0;
+  // Maximum start delay of a vehicle (s), 0 to wait at most for all the others to finish
+  double max_delay = 0.0;
+};
+
+struct BatchTrajectoryResult
+{
+  // Trajectory sampled from time 0 of the vehicle
+  std::shared_ptr<const TrajectoryLookupTable> table;
+  // Time the vehicle waits at its initial position before starting the trajectory
+  double start_delay = 0.0;
+};
+
+/**
+ * @brief Solves independent trajectory problems on a pool of threads. Each problem is solved by
+ * its own PolynomialTrajectoryGenerator, so fleet planning time scales with the number of threads.
+ */
+class BatchTrajectoryGenerator
+{
+public:
+  /**
+   * @param n_threads number of solver threads, 0 for one per hardware thread
+   */
+  explicit BatchTrajectoryGenerator(std::size_t n_threads = 0);
+  ~BatchTrajectoryGenerator();
+
+  BatchTrajectoryGenerator(const BatchTrajectoryGenerator &) = delete;
+  BatchTrajectoryGenerator & operator=(const BatchTrajectoryGenerator &) = delete;
+
+  /**
+   * @brief Generate the trajectories of all problems, results are only filled if all of them
+   * are generated and, if required, separated
+   * @param problems one problem per vehicle
+   * @param resolution time between samples of the result tables (s)
+   * @param separation start delay search to keep vehicles apart
+   * @param results one result per problem, in the same order
+   * @param error reason of the failure
+   * @return true if all the trajectories were generated
+   */
+  bool generate(
+    const std::vector<BatchTrajectoryProblem> & problems,
+    double resolution,
+    const BatchSeparationParams & separation,
+    std::vector<BatchTrajectoryResult> & results,
+    std::string & error);
+
+  std::size_t getNumThreads() const {return threads_.size();}
+
+  /**
+   * @brief Delay the start of each trajectory, in order, until it keeps the minimum separation
+   * with the ones before it. Vehicles hold their first position before starting and their last
+   * one after finishing.
+   * @param tables trajectory of each vehicle
+   * @param min_separation minimum distance between vehicles (m)
+   * @param time_step time between separation checks (s)
+   * @param delay_step time between tested delays (s)
+   * @param max_delay maximum start delay of a vehicle (s)
+   * @param delays start delay of each vehicle
+   * @return false if some vehicle can not be separated within the maximum delay
+   */
+  static bool computeStartDelays(
+    const std::vector<std::shared_ptr<const TrajectoryLookupTable>> & tables,
+    double min_separation,
+    double time_step,
+    double delay_step,
+    double max_delay,
+    std::vector<double> & delays);
+
+private:
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<std::function<void()>> tasks_;
+  bool stop_ = false;
+  std::vector<std::thread> threads_;
+
+  void workerThread();
+};
+
+#endif  // GENERATE_POLYNOMIAL_TRAJECTORY_BEHAVIOR__BATCH_TRAJECTORY_GENERATOR_HPP_
@@ -0,0 +1,70 @@
+// Copyright 2024 Universidad Politécnica de Madrid
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the Universidad Politécnica de Madrid nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+* @file batch_trajectory_generator_server.hpp
+*
+* @brief Class definition for the BatchTrajectoryGeneratorServer node, which generates the
+* trajectories of a whole fleet in a single service call.
+*
+* @author Miguel Fernández Cortizas
+*         Rafael Pérez Seguí
+*/
+
+#ifndef GENERATE_POLYNOMIAL_TRAJECTORY_BEHAVIOR__BATCH_TRAJECTORY_GENERATOR_SERVER_HPP_
+#define GENERATE_POLYNOMIAL_TRAJECTORY_BEHAVIOR__BATCH_TRAJECTORY_GENERATOR_SERVER_HPP_
+
+#include <memory>
+
+#include <rclcpp/rclcpp.hpp>
+
+#include "as2_core/names/services.hpp"
+#include "as2_core/node.hpp"
+#include "as2_msgs/srv/generate_polynomial_trajectories.hpp"
+#include "batch_trajectory_generator.hpp"
+
+class BatchTrajectoryGeneratorServer : public as2::Node
+{
+public:
+  explicit BatchTrajectoryGeneratorServer(
+    const rclcpp::NodeOptions & options = rclcpp::NodeOptions());
+
+private:
+  double default_sample_dt_ = 0.05;
+  // Tested start delays are coarser than the samples, the search grows with their number
+  BatchSeparationParams separation_{0.0, 0.5, 0.0};
+  std::unique_ptr<BatchTrajectoryGenerator> batch_generator_;
+
+  rclcpp::Service<as2_msgs::srv::GeneratePolynomialTrajectories>::SharedPtr generate_srv_;
+
+  void generateCallback(
+    const std::shared_ptr<as2_msgs::srv::GeneratePolynomialTrajectories::Request> request,
+    std::shared_ptr<as2_msgs::srv::GeneratePolynomialTrajectories::Response> response);
+};
+
+#endif  // GENERATE_POLYNOMIAL_TRAJECTORY_BEHAVIOR__BATCH_TRAJECTORY_GENERATOR_SERVER_HPP_
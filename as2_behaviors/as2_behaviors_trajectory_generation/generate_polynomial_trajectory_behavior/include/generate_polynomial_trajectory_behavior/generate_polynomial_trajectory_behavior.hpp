@@ -43,8 +43,14 @@
 #include <tf2/LinearMath/Quaternion.h>
 
 #include <Eigen/Dense>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
 #include <string>
 #include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #include <rclcpp/clock.hpp>
 #include <rclcpp/rclcpp.hpp>
@@ -63,6 +69,8 @@
 #include "as2_msgs/srv/set_speed.hpp"
 #include "dynamic_trajectory_generator/dynamic_trajectory.hpp"
 #include "dynamic_trajectory_generator/dynamic_waypoint.hpp"
+#include "trajectory_cache.hpp"
+#include "trajectory_lookup_table.hpp"
 
 #include "as2_msgs/msg/pose_stamped_with_id_array.hpp"
 #include "as2_msgs/msg/pose_with_id.hpp"
@@ -86,7 +94,7 @@ class DynamicPolynomialTrajectoryGenerator
 public:
   DynamicPolynomialTrajectoryGenerator(
     const rclcpp::NodeOptions & options = rclcpp::NodeOptions());
-  ~DynamicPolynomialTrajectoryGenerator() {}
+  ~DynamicPolynomialTrajectoryGenerator();
 
 private:
   /** Subscriptions **/
@@ -113,6 +121,9 @@ private:
   std::string desired_frame_id_;
   int sampling_n_ = 1;
   double sampling_dt_ = 0.0;
+  bool use_lookup_table_ = true;
+  double lookup_table_resolution_ = 0.01;
+  bool use_trajectory_cache_ = true;
 
   // Behavior action parameters
   as2_msgs::msg::YawMode yaw_mode_;
@@ -140,8 +151,42 @@ private:
   bool first_run_ = false;
   bool has_odom_ = false;
 
+  // Pre-sampled trajectory, rebuilt in background each time the trajectory is regenerated
+  TrajectorySampler trajectory_sampler_;
+
+  // Tables of trajectories already solved. On a hit, setpoints start from the cached table while
+  // the generator solves the same waypoints on the regeneration thread.
+  TrajectoryCache trajectory_cache_;
+  TrajectoryCacheQuery cache_query_;
+  std::atomic<bool> cache_insert_pending_{false};
+  std::atomic<bool> waypoints_pending_{false};
+
+  // Waypoint modifications are solved on their own thread. The generator mutex is held for any
+  // call into the generator and any access to goal_, the setpoint stream only tries it and falls
+  // back to the table.
+  std::mutex trajectory_generator_mutex_;
+  std::atomic<bool> trajectory_running_{false};
+  std::atomic<bool> trajectory_regenerated_async_{false};
+  std::atomic<double> last_eval_time_{0.0};
+  double trajectory_max_time_ = 0.0;
+
+  std::mutex modifications_mutex_;
+  std::condition_variable modifications_cv_;
+  std::vector<std::pair<std::string, Eigen::Vector3d>> pending_modifications_;
+  std::vector<std::pair<std::string, Eigen::Vector3d>> pending_appends_;
+  dynamic_traj_generator::DynamicWaypoint::Vector pending_waypoints_;
+  float pending_max_speed_ = -1.0f;
+  bool stop_regeneration_ = false;
+  std::thread regeneration_thread_;
+
   // Debug
   bool enable_debug_ = true;
+  double debug_max_rate_ = 10.0;
+  double debug_path_step_ = 0.2;
+  double debug_path_max_angle_ = 0.05;
+  double debug_path_max_distance_ = 5.0;
+  double last_debug_time_ = 0.0;
+  bool path_plot_pending_ = false;
   std::thread plot_thread_;
 
 private:
@@ -177,7 +222,7 @@ private:
   void stateCallback(const geometry_msgs::msg::TwistStamped::SharedPtr msg);
   void yawCallback(const std_msgs::msg::Float32::SharedPtr _msg);
 
-  // For faster waypoint modified
+  // For faster waypoint modified, ignored unless a trajectory is running
   void modifyWaypointCallback(
     const as2_msgs::msg::PoseStampedWithIDArray::SharedPtr _msg);
 
@@ -188,11 +233,27 @@ private:
       const as2_msgs::action::GeneratePolynomialTrajectory::Goal>
     goal,
     dynamic_traj_generator::DynamicWaypoint::Vector & waypoints);
-  bool evaluateTrajectory(double eval_time);
+  bool evaluateTrajectory(
+    double eval_time,
+    const TrajectoryLookupTable * lookup_table = nullptr,
+    bool update_generator = true);
   bool evaluateSetpoint(
     double eval_time,
-    as2_msgs::msg::TrajectoryPoint & trajectory_command);
+    as2_msgs::msg::TrajectoryPoint & trajectory_command,
+    const TrajectoryLookupTable * lookup_table = nullptr);
   double computeYawAnglePathFacing(double vx, double vy);
+  void sampleTrajectory(bool keep_table = false);
+  void setTrajectoryWaypoints(
+    const dynamic_traj_generator::DynamicWaypoint::Vector & waypoints,
+    float max_speed);
+
+  /** Waypoint modifications, solved on the regeneration thread */
+  void requestWaypointModifications(
+    const std::vector<std::pair<std::string, Eigen::Vector3d>> & modifications,
+    float max_speed = -1.0f,
+    const std::vector<std::pair<std::string, Eigen::Vector3d>> & appends = {});
+  void clearWaypointModifications();
+  void regenerationThread();
 
   /** For debuging **/
 
@@ -201,13 +262,28 @@ private:
   rclcpp::Publisher<visualization_msgs::msg::Marker>::SharedPtr ref_point_pub;
 
   /** Debug functions **/
+  void plotDebug(bool trajectory_regenerated);
   void plotTrajectory();
-  void plotTrajectoryThread();
+  void plotTrajectoryThread(
+    std::shared_ptr<dynamic_traj_generator::DynamicTrajectory> trajectory_generator);
   void plotRefTrajPoint();
 };
 
 /** Auxiliar Functions **/
 
+/**
+ * @brief Decimate a densely sampled path, keeping a point each time the accumulated turning
+ * angle or travelled distance since the last kept point reaches its limit
+ * @param points path points, first and last are always kept
+ * @param max_angle accumulated turning angle (rad), 0 keeps every point
+ * @param max_distance travelled distance (m), 0 disables the distance limit
+ * @return std::vector<Eigen::Vector3d> decimated path
+ */
+std::vector<Eigen::Vector3d> decimatePath(
+  const std::vector<Eigen::Vector3d> & points,
+  double max_angle,
+  double max_distance);
+
 void generateDynamicPoint(
   const as2_msgs::msg::PoseWithID & msg,
   dynamic_traj_generator::DynamicWaypoint & dynamic_point);
@@ -0,0 +1,127 @@
+// Copyright 2024 Universidad Politécnica de Madrid
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the Universidad Politécnica de Madrid nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+* @file polynomial_trajectory_generator.hpp
+*
+* @brief Polynomial trajectory generator library, to generate and evaluate trajectories
+* in-process without going through the trajectory generation behavior.
+*
+* @author Miguel Fernández Cortizas
+*         Rafael Pérez Seguí
+*/
+
+#ifndef GENERATE_POLYNOMIAL_TRAJECTORY_BEHAVIOR__POLYNOMIAL_TRAJECTORY_GENERATOR_HPP_
+#define GENERATE_POLYNOMIAL_TRAJECTORY_BEHAVIOR__POLYNOMIAL_TRAJECTORY_GENERATOR_HPP_
+
+#include <Eigen/Dense>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "trajectory_lookup_table.hpp"
+
+namespace dynamic_traj_generator
+{
+class DynamicTrajectory;
+}  // namespace dynamic_traj_generator
+
+struct TrajectoryWaypoint
+{
+  std::string id;
+  Eigen::Vector3d position = Eigen::Vector3d::Zero();
+};
+
+/**
+ * @brief Minimum snap polynomial trajectory through a list of waypoints, which can be moved while
+ * the trajectory is followed. Times are relative to the start of the trajectory, and positions
+ * are in the frame of the waypoints. Not thread safe.
+ */
+class PolynomialTrajectoryGenerator
+{
+public:
+  PolynomialTrajectoryGenerator();
+  ~PolynomialTrajectoryGenerator();
+
+  PolynomialTrajectoryGenerator(const PolynomialTrajectoryGenerator &) = delete;
+  PolynomialTrajectoryGenerator & operator=(const PolynomialTrajectoryGenerator &) = delete;
+
+  /**
+   * @brief Generate a new trajectory from the vehicle position through the waypoints
+   * @param waypoints waypoints with unique, non empty ids
+   * @param max_speed maximum speed (m/s)
+   * @param vehicle_position current vehicle position
+   * @return false if the waypoints or the speed are not valid
+   */
+  bool setWaypoints(
+    const std::vector<TrajectoryWaypoint> & waypoints,
+    double max_speed,
+    const Eigen::Vector3d & vehicle_position);
+
+  /**
+   * @brief Move a waypoint not reached yet, the trajectory is regenerated from the current
+   * references on the next evaluation
+   * @return false if there is no trajectory
+   */
+  bool modifyWaypoint(const std::string & id, const Eigen::Vector3d & position);
+
+  void updateVehiclePosition(const Eigen::Vector3d & position);
+
+  /**
+   * @brief Evaluate the trajectory, times outside it are clamped. Evaluation advances the
+   * trajectory progress, use evaluateNoTracking for previews.
+   */
+  bool evaluate(double time, TrajectorySample & sample);
+  bool evaluateNoTracking(double time, TrajectorySample & sample);
+
+  double getMinTime() const;
+  double getMaxTime() const;
+
+  /**
+   * @brief Whether the trajectory was regenerated since the last call
+   */
+  bool wasRegenerated();
+
+  /**
+   * @brief Ids of the waypoints not reached yet, the next one first
+   */
+  std::vector<std::string> getRemainingWaypoints() const;
+
+  bool hasTrajectory() const {return has_trajectory_;}
+
+  void reset();
+
+private:
+  std::unique_ptr<dynamic_traj_generator::DynamicTrajectory> trajectory_;
+  bool has_trajectory_ = false;
+
+  bool evaluateTrajectory(double time, TrajectorySample & sample, bool tracking);
+};
+
+#endif  // GENERATE_POLYNOMIAL_TRAJECTORY_BEHAVIOR__POLYNOMIAL_TRAJECTORY_GENERATOR_HPP_
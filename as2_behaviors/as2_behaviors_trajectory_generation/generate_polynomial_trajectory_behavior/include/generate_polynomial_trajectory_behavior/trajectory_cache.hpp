@@ -0,0 +1,131 @@
+// Copyright 2024 Universidad Politécnica de Madrid
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the Universidad Politécnica de Madrid nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+* @file trajectory_cache.hpp
+*
+* @brief LRU cache of pre-sampled trajectories, so repeated legs of a mission are not solved
+* again before they start.
+*
+* @author Miguel Fernández Cortizas
+*         Rafael Pérez Seguí
+*/
+
+#ifndef GENERATE_POLYNOMIAL_TRAJECTORY_BEHAVIOR__TRAJECTORY_CACHE_HPP_
+#define GENERATE_POLYNOMIAL_TRAJECTORY_BEHAVIOR__TRAJECTORY_CACHE_HPP_
+
+#include <Eigen/Dense>
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "trajectory_lookup_table.hpp"
+
+/**
+ * @brief Inputs that define a solved trajectory
+ */
+struct TrajectoryCacheQuery
+{
+  std::vector<Eigen::Vector3d> waypoints;
+  double max_speed = 0.0;
+  Eigen::Vector3d initial_position = Eigen::Vector3d::Zero();
+};
+
+/**
+ * @brief Least recently used cache of trajectory tables. Entries are keyed by a hash of the
+ * waypoints and the speed limit, quantized to millimeters, and only hit if the initial position
+ * is within tolerance of the one the trajectory was solved from.
+ */
+class TrajectoryCache
+{
+public:
+  /**
+   * @param capacity maximum number of trajectories kept, 0 disables the cache
+   * @param position_tolerance maximum distance between initial positions to hit [m]
+   */
+  explicit TrajectoryCache(std::size_t capacity = 16, double position_tolerance = 0.1);
+
+  /**
+   * @brief Change the cache limits, dropping the least recently used entries that do not fit
+   */
+  void configure(std::size_t capacity, double position_tolerance);
+
+  /**
+   * @brief Look up a trajectory, counting a hit or a miss
+   * @return the cached table, null on miss
+   */
+  std::shared_ptr<const TrajectoryLookupTable> find(const TrajectoryCacheQuery & query);
+
+  /**
+   * @brief Store the table solved for a query, replacing any entry with the same key
+   */
+  void insert(
+    const TrajectoryCacheQuery & query,
+    std::shared_ptr<const TrajectoryLookupTable> table);
+
+  /**
+   * @brief Drop all entries, counters are kept
+   */
+  void clear();
+
+  std::size_t size() const;
+  uint64_t getHits() const;
+  uint64_t getMisses() const;
+
+  /**
+   * @brief Key of a query, the initial position is not part of it
+   */
+  static std::size_t hash(const TrajectoryCacheQuery & query);
+
+private:
+  struct Entry
+  {
+    std::size_t key;
+    TrajectoryCacheQuery query;
+    std::shared_ptr<const TrajectoryLookupTable> table;
+  };
+
+  mutable std::mutex mutex_;
+  std::size_t capacity_;
+  double position_tolerance_;
+  uint64_t hits_ = 0;
+  uint64_t misses_ = 0;
+
+  // Most recently used first
+  std::list<Entry> entries_;
+  std::unordered_map<std::size_t, std::list<Entry>::iterator> index_;
+
+  static bool sameTrajectory(const TrajectoryCacheQuery & a, const TrajectoryCacheQuery & b);
+  void evict();
+};
+
+#endif  // GENERATE_POLYNOMIAL_TRAJECTORY_BEHAVIOR__TRAJECTORY_CACHE_HPP_
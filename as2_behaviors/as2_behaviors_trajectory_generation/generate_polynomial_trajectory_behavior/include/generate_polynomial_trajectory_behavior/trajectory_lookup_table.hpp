@@ -0,0 +1,170 @@
+// Copyright 2024 Universidad Politécnica de Madrid
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the Universidad Politécnica de Madrid nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+* @file trajectory_lookup_table.hpp
+*
+* @brief Pre-sampled trajectory table, evaluated in constant time with cubic Hermite
+* interpolation, and the background sampler that fills it.
+*
+* @author Miguel Fernández Cortizas
+*         Rafael Pérez Seguí
+*/
+
+#ifndef GENERATE_POLYNOMIAL_TRAJECTORY_BEHAVIOR__TRAJECTORY_LOOKUP_TABLE_HPP_
+#define GENERATE_POLYNOMIAL_TRAJECTORY_BEHAVIOR__TRAJECTORY_LOOKUP_TABLE_HPP_
+
+#include <Eigen/Dense>
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct TrajectorySample
+{
+  Eigen::Vector3d position = Eigen::Vector3d::Zero();
+  Eigen::Vector3d velocity = Eigen::Vector3d::Zero();
+  Eigen::Vector3d acceleration = Eigen::Vector3d::Zero();
+};
+
+/**
+ * @brief Trajectory tabulated at a fixed resolution. Position and velocity are interpolated with
+ * cubic Hermite splines, using the tabulated velocity and acceleration as derivatives, and
+ * acceleration linearly, so evaluation cost does not depend on the trajectory length.
+ */
+class TrajectoryLookupTable
+{
+public:
+  using SampleFunction = std::function<bool (double, TrajectorySample &)>;
+
+  /**
+   * @brief Sample a trajectory between min_time and max_time, both included
+   * @param min_time trajectory start time
+   * @param max_time trajectory end time
+   * @param resolution maximum time between samples, rounded down to fit the trajectory duration
+   * @param sample_function evaluates the trajectory at a time, returns false on failure
+   * @return true if the whole trajectory was sampled
+   */
+  bool build(
+    double min_time, double max_time, double resolution,
+    const SampleFunction & sample_function);
+
+  /**
+   * @brief Interpolate the trajectory, times outside the table are clamped to it
+   * @param time evaluation time
+   * @param sample interpolated references
+   * @return false if the table is empty
+   */
+  bool evaluate(double time, TrajectorySample & sample) const;
+
+  double getMinTime() const {return min_time_;}
+  double getMaxTime() const {return max_time_;}
+  double getResolution() const {return resolution_;}
+  std::size_t size() const {return samples_.size();}
+  bool empty() const {return samples_.empty();}
+
+private:
+  double min_time_ = 0.0;
+  double max_time_ = 0.0;
+  double resolution_ = 0.0;
+  double inv_resolution_ = 0.0;
+  std::vector<TrajectorySample> samples_;
+};
+
+/**
+ * @brief Fills a TrajectoryLookupTable on its own thread. A new request supersedes any pending
+ * one and, unless asked to keep it, invalidates the current table. Readers never wait for
+ * sampling.
+ */
+class TrajectorySampler
+{
+public:
+  TrajectorySampler();
+  ~TrajectorySampler();
+
+  TrajectorySampler(const TrajectorySampler &) = delete;
+  TrajectorySampler & operator=(const TrajectorySampler &) = delete;
+
+  /**
+   * @brief Request sampling a trajectory, returns without waiting for it
+   * @param min_time trajectory start time
+   * @param max_time trajectory end time
+   * @param resolution maximum time between samples
+   * @param sample_function evaluates the trajectory, called from the sampler thread
+   * @param keep_table serve the current table until the new one replaces it
+   */
+  void request(
+    double min_time, double max_time, double resolution,
+    TrajectoryLookupTable::SampleFunction sample_function, bool keep_table = false);
+
+  /**
+   * @brief Drop the current table and any pending request
+   */
+  void reset();
+
+  /**
+   * @brief Serve an already sampled table, dropping any pending request
+   */
+  void setTable(std::shared_ptr<const TrajectoryLookupTable> table);
+
+  /**
+   * @brief Whether a requested table is still being sampled
+   */
+  bool pending() const;
+
+  /**
+   * @brief Table of the last request, null while it is being sampled or if sampling failed
+   */
+  std::shared_ptr<const TrajectoryLookupTable> getTable() const;
+
+private:
+  struct Request
+  {
+    double min_time;
+    double max_time;
+    double resolution;
+    TrajectoryLookupTable::SampleFunction sample_function;
+  };
+
+  mutable std::mutex mutex_;
+  std::condition_variable cv_;
+  std::unique_ptr<Request> pending_request_;
+  uint64_t request_id_ = 0;
+  uint64_t done_request_id_ = 0;
+  bool stop_ = false;
+  std::shared_ptr<const TrajectoryLookupTable> table_;
+  std::thread thread_;
+
+  void run();
+};
+
+#endif  // GENERATE_POLYNOMIAL_TRAJECTORY_BEHAVIOR__TRAJECTORY_LOOKUP_TABLE_HPP_
@@ -0,0 +1,231 @@
+// Copyright 2024 Universidad Politécnica de Madrid
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the Universidad Politécnica de Madrid nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+* @file batch_trajectory_generator.cpp
+*
+* @brief Source file for the BatchTrajectoryGenerator class.
+*
+* @author Miguel Fernández Cortizas
+*         Rafael Pérez Seguí
+*/
+
+#include "batch_trajectory_generator.hpp"
+
+#include <algorithm>
+#include <future>
+#include <utility>
+
+namespace
+{
+using TablePtr = std::shared_ptr<const TrajectoryLookupTable>;
+
+// Position of a vehicle at a fleet time, holding its first and last positions
+Eigen::Vector3d positionAt(const TrajectoryLookupTable & table, double delay, double time)
+{
+  TrajectorySample sample;
+  table.evaluate(table.getMinTime() + time - delay, sample);
+  return sample.position;
+}
+
+bool isSeparated(
+  const TrajectoryLookupTable & a, double delay_a,
+  const TrajectoryLookupTable & b, double delay_b,
+  double min_separation, double time_step)
+{
+  const double duration_a = a.getMaxTime() - a.getMinTime();
+  const double duration_b = b.getMaxTime() - b.getMinTime();
+  const double end_time = std::max(delay_a + duration_a, delay_b + duration_b);
+  for (double time = 0.0; ; time += time_step) {
+    time = std::min(time, end_time);
+    if ((positionAt(a, delay_a, time) - positionAt(b, delay_b, time)).norm() < min_separation) {
+      return false;
+    }
+    if (time >= end_time) {
+      return true;
+    }
+  }
+}
+}  // namespace
+
+BatchTrajectoryGenerator::BatchTrajectoryGenerator(std::size_t n_threads)
+{
+  if (n_threads == 0) {
+    n_threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  threads_.reserve(n_threads);
+  for (std::size_t i = 0; i < n_threads; ++i) {
+    threads_.emplace_back(&BatchTrajectoryGenerator::workerThread, this);
+  }
+}
+
+BatchTrajectoryGenerator::~BatchTrajectoryGenerator()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cv_.notify_all();
+  for (std::thread & thread : threads_) {
+    thread.join();
+  }
+}
+
+bool BatchTrajectoryGenerator::generate(
+  const std::vector<BatchTrajectoryProblem> & problems,
+  double resolution,
+  const BatchSeparationParams & separation,
+  std::vector<BatchTrajectoryResult> & results,
+  std::string & error)
+{
+  if (problems.empty()) {
+    error = "No trajectories requested";
+    return false;
+  }
+  if (!(resolution > 0.0)) {
+    error = "Resolution must be greater than 0";
+    return false;
+  }
+
+  // Solve and sample each problem on the pool
+  std::vector<std::future<TablePtr>> futures;
+  futures.reserve(problems.size());
+  for (const BatchTrajectoryProblem & problem : problems) {
+    auto task = std::make_shared<std::packaged_task<TablePtr()>>(
+      [&problem, resolution]() -> TablePtr {
+        PolynomialTrajectoryGenerator generator;
+        if (!generator.setWaypoints(
+            problem.waypoints, problem.max_speed, problem.initial_position))
+        {
+          return nullptr;
+        }
+        auto table = std::make_shared<TrajectoryLookupTable>();
+        if (!table->build(
+            generator.getMinTime(), generator.getMaxTime(), resolution,
+            [&generator](double time, TrajectorySample & sample) {
+              return generator.evaluateNoTracking(time, sample);
+            }))
+        {
+          return nullptr;
+        }
+        return table;
+      });
+    futures.emplace_back(task->get_future());
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      tasks_.emplace_back([task]() {(*task)();});
+    }
+    cv_.notify_one();
+  }
+
+  // All the futures are waited for, tasks reference the problems
+  std::vector<TablePtr> tables;
+  tables.reserve(problems.size());
+  for (auto & future : futures) {
+    tables.emplace_back(future.get());
+  }
+  for (std::size_t i = 0; i < tables.size(); ++i) {
+    if (!tables[i]) {
+      error = "Trajectory " + std::to_string(i) + " could not be generated";
+      return false;
+    }
+  }
+
+  std::vector<double> delays(tables.size(), 0.0);
+  if (separation.min_separation > 0.0) {
+    // Waiting for all the others to finish is always enough, unless goals are too close
+    double max_delay = separation.max_delay;
+    if (!(max_delay > 0.0)) {
+      for (const auto & table : tables) {
+        max_delay += table->getMaxTime() - table->getMinTime();
+      }
+    }
+    const double delay_step = separation.delay_step > 0.0 ? separation.delay_step : resolution;
+    if (!computeStartDelays(
+        tables, separation.min_separation, resolution, delay_step, max_delay, delays))
+    {
+      error = "Trajectories can not keep the minimum separation";
+      return false;
+    }
+  }
+
+  results.resize(tables.size());
+  for (std::size_t i = 0; i < tables.size(); ++i) {
+    results[i].table = tables[i];
+    results[i].start_delay = delays[i];
+  }
+  return true;
+}
+
+bool BatchTrajectoryGenerator::computeStartDelays(
+  const std::vector<std::shared_ptr<const TrajectoryLookupTable>> & tables,
+  double min_separation,
+  double time_step,
+  double delay_step,
+  double max_delay,
+  std::vector<double> & delays)
+{
+  if (!(time_step > 0.0) || !(delay_step > 0.0)) {
+    return false;
+  }
+  delays.assign(tables.size(), 0.0);
+  for (std::size_t i = 0; i < tables.size(); ++i) {
+    bool separated = false;
+    for (double delay = 0.0; delay <= max_delay + 0.5 * delay_step; delay += delay_step) {
+      separated = true;
+      for (std::size_t j = 0; j < i && separated; ++j) {
+        separated = isSeparated(
+          *tables[i], delay, *tables[j], delays[j], min_separation, time_step);
+      }
+      if (separated) {
+        delays[i] = delay;
+        break;
+      }
+    }
+    if (!separated) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void BatchTrajectoryGenerator::workerThread()
+{
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    cv_.wait(lock, [this]() {return stop_ || !tasks_.empty();});
+    if (stop_) {
+      return;
+    }
+    std::function<void()> task = std::move(tasks_.front());
+    tasks_.pop_front();
+    lock.unlock();
+    task();
+    lock.lock();
+  }
+}
@@ -0,0 +1,160 @@
+// Copyright 2024 Universidad Politécnica de Madrid
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the Universidad Politécnica de Madrid nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+* @file batch_trajectory_generator_server.cpp
+*
+* @brief Source file for the BatchTrajectoryGeneratorServer node.
+*
+* @author Miguel Fernández Cortizas
+*         Rafael Pérez Seguí
+*/
+
+#include "batch_trajectory_generator_server.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+BatchTrajectoryGeneratorServer::BatchTrajectoryGeneratorServer(
+  const rclcpp::NodeOptions & options)
+: as2::Node("batch_trajectory_generator", options)
+{
+  const int n_threads = this->declare_parameter<int>("n_threads", 0);
+  default_sample_dt_ = this->declare_parameter<double>("sample_dt", default_sample_dt_);
+  if (default_sample_dt_ <= 0.0) {
+    RCLCPP_WARN(this->get_logger(), "Sample dt must be greater than 0, using 0.05");
+    default_sample_dt_ = 0.05;
+  }
+  separation_.delay_step = this->declare_parameter<double>(
+    "separation.delay_step", separation_.delay_step);
+  separation_.max_delay = this->declare_parameter<double>(
+    "separation.max_delay", separation_.max_delay);
+
+  batch_generator_ = std::make_unique<BatchTrajectoryGenerator>(
+    static_cast<std::size_t>(std::max(n_threads, 0)));
+  RCLCPP_INFO(
+    this->get_logger(), "Generating trajectories with %zu threads",
+    batch_generator_->getNumThreads());
+
+  generate_srv_ = this->create_service<as2_msgs::srv::GeneratePolynomialTrajectories>(
+    as2_names::services::motion_reference::generate_polynomial_trajectories,
+    std::bind(
+      &BatchTrajectoryGeneratorServer::generateCallback, this,
+      std::placeholders::_1, std::placeholders::_2));
+}
+
+void BatchTrajectoryGeneratorServer::generateCallback(
+  const std::shared_ptr<as2_msgs::srv::GeneratePolynomialTrajectories::Request> request,
+  std::shared_ptr<as2_msgs::srv::GeneratePolynomialTrajectories::Response> response)
+{
+  const double sample_dt = request->sample_dt > 0.0f ? request->sample_dt : default_sample_dt_;
+
+  std::vector<BatchTrajectoryProblem> problems;
+  problems.reserve(request->paths.size());
+  for (const as2_msgs::msg::VehiclePath & vehicle_path : request->paths) {
+    BatchTrajectoryProblem problem;
+    problem.max_speed = vehicle_path.max_speed;
+    problem.initial_position = Eigen::Vector3d(
+      vehicle_path.initial_position.x, vehicle_path.initial_position.y,
+      vehicle_path.initial_position.z);
+    problem.waypoints.reserve(vehicle_path.path.size());
+    for (const as2_msgs::msg::PoseWithID & waypoint : vehicle_path.path) {
+      problem.waypoints.push_back(
+        TrajectoryWaypoint{waypoint.id, Eigen::Vector3d(
+            waypoint.pose.position.x, waypoint.pose.position.y, waypoint.pose.position.z)});
+    }
+    problems.emplace_back(problem);
+  }
+
+  const rclcpp::Time start_time = this->now();
+  std::vector<BatchTrajectoryResult> results;
+  std::string error;
+  BatchSeparationParams separation = separation_;
+  separation.min_separation = request->min_separation;
+  response->success = batch_generator_->generate(
+    problems, sample_dt, separation, results, error);
+  if (!response->success) {
+    RCLCPP_ERROR(this->get_logger(), "Trajectories not generated: %s", error.c_str());
+    response->message = error;
+    return;
+  }
+  RCLCPP_INFO(
+    this->get_logger(), "Generated %zu trajectories in %.3f s", results.size(),
+    (this->now() - start_time).seconds());
+
+  std_msgs::msg::Header header = request->header;
+  header.stamp = this->now();
+  response->start_delays.reserve(results.size());
+  response->trajectories.reserve(results.size());
+  for (std::size_t k = 0; k < results.size(); ++k) {
+    const BatchTrajectoryResult & result = results[k];
+    const TrajectoryLookupTable & table = *result.table;
+    as2_msgs::msg::TrajectorySetpoints trajectory;
+    trajectory.header = header;
+
+    const std::size_t n_setpoints = static_cast<std::size_t>(
+      std::ceil((table.getMaxTime() - table.getMinTime()) / sample_dt)) + 1;
+    trajectory.setpoints.reserve(n_setpoints);
+    // Path facing, the last yaw is kept while hovering. The samples before the first horizontal
+    // motion already face it, a path without horizontal motion keeps the initial yaw
+    float yaw_angle = request->paths[k].initial_yaw;
+    bool moving = false;
+    for (std::size_t i = 0; i < n_setpoints; ++i) {
+      TrajectorySample sample;
+      table.evaluate(table.getMinTime() + i * sample_dt, sample);
+
+      if (sample.velocity.head<2>().norm() > 0.1) {
+        yaw_angle = std::atan2(sample.velocity.y(), sample.velocity.x());
+        if (!moving) {
+          moving = true;
+          for (as2_msgs::msg::TrajectoryPoint & leading : trajectory.setpoints) {
+            leading.yaw_angle = yaw_angle;
+          }
+        }
+      }
+
+      as2_msgs::msg::TrajectoryPoint setpoint;
+      setpoint.position.x = sample.position.x();
+      setpoint.position.y = sample.position.y();
+      setpoint.position.z = sample.position.z();
+      setpoint.twist.x = sample.velocity.x();
+      setpoint.twist.y = sample.velocity.y();
+      setpoint.twist.z = sample.velocity.z();
+      setpoint.acceleration.x = sample.acceleration.x();
+      setpoint.acceleration.y = sample.acceleration.y();
+      setpoint.acceleration.z = sample.acceleration.z();
+      setpoint.yaw_angle = yaw_angle;
+      trajectory.setpoints.emplace_back(setpoint);
+    }
+
+    response->start_delays.push_back(result.start_delay);
+    response->trajectories.emplace_back(trajectory);
+  }
+}
@@ -39,6 +39,11 @@
 
 #include "generate_polynomial_trajectory_behavior.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
 DynamicPolynomialTrajectoryGenerator::DynamicPolynomialTrajectoryGenerator(
   const rclcpp::NodeOptions & options)
 : as2_behavior::BehaviorServer<
@@ -88,14 +93,66 @@ DynamicPolynomialTrajectoryGenerator::DynamicPolynomialTrajectoryGenerator(
   }
   RCLCPP_INFO(this->get_logger(), "Sampling with n = %d and dt = %f", sampling_n_, sampling_dt_);
 
+  use_lookup_table_ = this->declare_parameter<bool>("lookup_table.enable", use_lookup_table_);
+  lookup_table_resolution_ = this->declare_parameter<double>(
+    "lookup_table.resolution", lookup_table_resolution_);
+  if (use_lookup_table_ && lookup_table_resolution_ <= 0.0) {
+    RCLCPP_WARN(
+      this->get_logger(), "Lookup table resolution must be greater than 0, table disabled");
+    use_lookup_table_ = false;
+  }
+
+  use_trajectory_cache_ = this->declare_parameter<bool>(
+    "trajectory_cache.enable", use_trajectory_cache_);
+  const int cache_size = this->declare_parameter<int>("trajectory_cache.size", 16);
+  const double cache_position_tolerance = this->declare_parameter<double>(
+    "trajectory_cache.position_tolerance", 0.1);
+  if (use_trajectory_cache_ && !use_lookup_table_) {
+    RCLCPP_WARN(this->get_logger(), "Trajectory cache requires the lookup table, cache disabled");
+    use_trajectory_cache_ = false;
+  }
+  trajectory_cache_.configure(
+    static_cast<std::size_t>(std::max(cache_size, 0)), cache_position_tolerance);
+
+  enable_debug_ = this->declare_parameter<bool>("debug.enable", enable_debug_);
+  debug_max_rate_ = this->declare_parameter<double>("debug.max_rate", debug_max_rate_);
+  debug_path_step_ = this->declare_parameter<double>("debug.path_step", debug_path_step_);
+  debug_path_max_angle_ = this->declare_parameter<double>(
+    "debug.path_max_angle", debug_path_max_angle_);
+  debug_path_max_distance_ = this->declare_parameter<double>(
+    "debug.path_max_distance", debug_path_max_distance_);
+  if (debug_path_step_ <= 0.0) {
+    RCLCPP_WARN(this->get_logger(), "Debug path step must be greater than 0, using 0.2");
+    debug_path_step_ = 0.2;
+  }
+
   /** Debug publishers **/
   ref_point_pub = this->create_publisher<visualization_msgs::msg::Marker>(
     REF_TRAJ_TOPIC, 1);
 
   path_pub_ = this->create_publisher<nav_msgs::msg::Path>(PATH_DEBUG_TOPIC, 1);
+
+  regeneration_thread_ = std::thread(
+    &DynamicPolynomialTrajectoryGenerator::regenerationThread, this);
   return;
 }
 
+DynamicPolynomialTrajectoryGenerator::~DynamicPolynomialTrajectoryGenerator()
+{
+  stop_run_thread();
+  {
+    std::lock_guard<std::mutex> lock(modifications_mutex_);
+    stop_regeneration_ = true;
+  }
+  modifications_cv_.notify_one();
+  if (regeneration_thread_.joinable()) {
+    regeneration_thread_.join();
+  }
+  if (plot_thread_.joinable()) {
+    plot_thread_.join();
+  }
+}
+
 void DynamicPolynomialTrajectoryGenerator::stateCallback(
   const geometry_msgs::msg::TwistStamped::SharedPtr _twist_msg)
 {
@@ -105,6 +162,7 @@ void DynamicPolynomialTrajectoryGenerator::stateCallback(
       desired_frame_id_, base_link_frame_id_,
       tf2_ros::fromMsg(_twist_msg->header.stamp));
 
+    auto lock = lock_behavior();
     if (!has_odom_) {
       RCLCPP_INFO(this->get_logger(), "State callback working");
       has_odom_ = true;
@@ -115,10 +173,15 @@ void DynamicPolynomialTrajectoryGenerator::stateCallback(
       pose_msg.pose.position.x, pose_msg.pose.position.y,
       pose_msg.pose.position.z);
     current_yaw_ = as2::frame::getYawFromQuaternion(pose_msg.pose.orientation);
-    trajectory_generator_->updateVehiclePosition(
-      Eigen::Vector3d(
-        pose_msg.pose.position.x, pose_msg.pose.position.y,
-        pose_msg.pose.position.z));
+
+    // Skipped while waypoint modifications are being solved, the next state updates it
+    std::unique_lock<std::mutex> generator_lock(trajectory_generator_mutex_, std::try_to_lock);
+    if (generator_lock.owns_lock()) {
+      trajectory_generator_->updateVehiclePosition(
+        Eigen::Vector3d(
+          pose_msg.pose.position.x, pose_msg.pose.position.y,
+          pose_msg.pose.position.z));
+    }
   } catch (tf2::TransformException & ex) {
     RCLCPP_WARN(this->get_logger(), "Could not get transform: %s", ex.what());
   }
@@ -128,6 +191,7 @@ void DynamicPolynomialTrajectoryGenerator::stateCallback(
 void DynamicPolynomialTrajectoryGenerator::yawCallback(
   const std_msgs::msg::Float32::SharedPtr _msg)
 {
+  auto lock = lock_behavior();
   has_yaw_from_topic_ = true;
   yaw_from_topic_ = _msg->data;
 }
@@ -144,7 +208,6 @@ bool DynamicPolynomialTrajectoryGenerator::goalToDynamicWaypoint(
     RCLCPP_ERROR(this->get_logger(), "Goal max speed is negative");
     return false;
   }
-  trajectory_generator_->setSpeed(_goal->max_speed);
 
   for (as2_msgs::msg::PoseWithID waypoint : _goal->path) {
     // Process each waypoint id
@@ -202,6 +265,7 @@ bool DynamicPolynomialTrajectoryGenerator::on_activate(
     RCLCPP_ERROR(this->get_logger(), "No odometry information available");
     return false;
   }
+  std::lock_guard<std::mutex> generator_lock(trajectory_generator_mutex_);
   setup();
 
   // Print goal path
@@ -226,7 +290,7 @@ bool DynamicPolynomialTrajectoryGenerator::on_activate(
   if (!goalToDynamicWaypoint(goal, waypoints_to_set)) {return false;}
 
   // Set waypoints to trajectory generator
-  trajectory_generator_->setWaypoints(waypoints_to_set);
+  setTrajectoryWaypoints(waypoints_to_set, goal->max_speed);
 
   yaw_mode_ = goal->yaw;
   goal_ = *goal;
@@ -235,6 +299,45 @@ bool DynamicPolynomialTrajectoryGenerator::on_activate(
   return true;
 }
 
+void DynamicPolynomialTrajectoryGenerator::setTrajectoryWaypoints(
+  const dynamic_traj_generator::DynamicWaypoint::Vector & waypoints,
+  float max_speed)
+{
+  trajectory_generator_->setSpeed(max_speed);
+  if (!use_trajectory_cache_) {
+    trajectory_generator_->setWaypoints(waypoints);
+    return;
+  }
+
+  cache_query_ = TrajectoryCacheQuery();
+  cache_query_.waypoints.reserve(waypoints.size());
+  for (const dynamic_traj_generator::DynamicWaypoint & waypoint : waypoints) {
+    cache_query_.waypoints.emplace_back(waypoint.getOriginalPosition());
+  }
+  cache_query_.max_speed = max_speed;
+  cache_query_.initial_position = current_position_;
+
+  auto cached_table = trajectory_cache_.find(cache_query_);
+  RCLCPP_INFO(
+    this->get_logger(), "Trajectory cache %s (hits: %lu, misses: %lu)",
+    cached_table ? "hit" : "miss",
+    trajectory_cache_.getHits(), trajectory_cache_.getMisses());
+  if (!cached_table) {
+    trajectory_generator_->setWaypoints(waypoints);
+    cache_insert_pending_ = true;
+    return;
+  }
+
+  // Setpoints start from the cached table, the generator is only needed for tracking
+  trajectory_sampler_.setTable(cached_table);
+  {
+    std::lock_guard<std::mutex> lock(modifications_mutex_);
+    pending_waypoints_ = waypoints;
+    waypoints_pending_ = true;
+  }
+  modifications_cv_.notify_one();
+}
+
 void DynamicPolynomialTrajectoryGenerator::setup()
 {
   // trajectory_generator_ =
@@ -242,6 +345,12 @@ void DynamicPolynomialTrajectoryGenerator::setup()
   has_yaw_from_topic_ = false;
   has_odom_ = false;
   first_run_ = true;
+  path_plot_pending_ = false;
+  last_debug_time_ = -std::numeric_limits<double>::infinity();
+  trajectory_running_ = false;
+  cache_insert_pending_ = false;
+  clearWaypointModifications();
+  trajectory_sampler_.reset();
 
   trajectory_command_ = as2_msgs::msg::TrajectorySetpoints();
   trajectory_command_.header.frame_id = desired_frame_id_;
@@ -262,11 +371,13 @@ bool DynamicPolynomialTrajectoryGenerator::on_modify(
 
   if (!goalToDynamicWaypoint(goal, waypoints_to_set)) {return false;}
 
-  // Modify each waypoint
+  // Modify each waypoint, solved on the regeneration thread
+  std::vector<std::pair<std::string, Eigen::Vector3d>> modifications;
+  modifications.reserve(waypoints_to_set.size());
   for (dynamic_traj_generator::DynamicWaypoint dynamic_waypoint :
     waypoints_to_set)
   {
-    trajectory_generator_->modifyWaypoint(
+    modifications.emplace_back(
       dynamic_waypoint.getName(), dynamic_waypoint.getCurrentPosition());
 
     RCLCPP_INFO(
@@ -276,6 +387,7 @@ bool DynamicPolynomialTrajectoryGenerator::on_modify(
       dynamic_waypoint.getOriginalPosition().y(),
       dynamic_waypoint.getOriginalPosition().z());            // DEBUG
   }
+  requestWaypointModifications(modifications, goal->max_speed);
 
   return true;
 }
@@ -284,27 +396,197 @@ bool DynamicPolynomialTrajectoryGenerator::on_modify(
 void DynamicPolynomialTrajectoryGenerator::modifyWaypointCallback(
   const as2_msgs::msg::PoseStampedWithIDArray::SharedPtr _msg)
 {
+  std::string goal_frame_id;
+  {
+    std::lock_guard<std::mutex> generator_lock(trajectory_generator_mutex_);
+    if (!trajectory_running_) {
+      RCLCPP_DEBUG(this->get_logger(), "No trajectory running, waypoint modification ignored");
+      return;
+    }
+    goal_frame_id = goal_.header.frame_id;
+  }
+
+  // Transforms are solved before taking the generator lock again, they may wait for tf
+  std::vector<std::pair<std::string, Eigen::Vector3d>> positions;
+  std::vector<geometry_msgs::msg::Pose> goal_poses;
+  positions.reserve(_msg->poses.size());
+  goal_poses.reserve(_msg->poses.size());
   for (as2_msgs::msg::PoseStampedWithID waypoint : _msg->poses) {
     geometry_msgs::msg::PoseStamped pose_stamped = waypoint.pose;
+    geometry_msgs::msg::PoseStamped goal_pose_stamped = waypoint.pose;
 
-    if (pose_stamped.header.frame_id != desired_frame_id_) {
-      try {
+    try {
+      if (pose_stamped.header.frame_id != desired_frame_id_) {
         pose_stamped = tf_handler_.convert(pose_stamped, desired_frame_id_);
-      } catch (tf2::TransformException & ex) {
-        RCLCPP_WARN(this->get_logger(), "Could not get transform: %s", ex.what());
+      }
+      if (!goal_frame_id.empty() && goal_pose_stamped.header.frame_id != goal_frame_id) {
+        goal_pose_stamped = tf_handler_.convert(goal_pose_stamped, goal_frame_id);
+      }
+    } catch (tf2::TransformException & ex) {
+      RCLCPP_WARN(this->get_logger(), "Could not get transform: %s", ex.what());
+      return;
+    }
+
+    positions.emplace_back(
+      waypoint.id, Eigen::Vector3d(
+        pose_stamped.pose.position.x, pose_stamped.pose.position.y,
+        pose_stamped.pose.position.z));
+    goal_poses.push_back(goal_pose_stamped.pose);
+  }
+
+  std::vector<std::pair<std::string, Eigen::Vector3d>> modifications;
+  std::vector<std::pair<std::string, Eigen::Vector3d>> appends;
+  {
+    std::lock_guard<std::mutex> generator_lock(trajectory_generator_mutex_);
+    // The trajectory may have ended or been paused while transforming
+    if (!trajectory_running_) {
+      RCLCPP_DEBUG(this->get_logger(), "No trajectory running, waypoint modification ignored");
+      return;
+    }
+
+    for (std::size_t i = 0; i < positions.size(); ++i) {
+      const std::string & waypoint_id = positions[i].first;
+      const Eigen::Vector3d & position = positions[i].second;
+
+      // Keep the goal up to date, so resuming after a pause follows the modified path
+      auto it = std::find_if(
+        goal_.path.begin(), goal_.path.end(),
+        [&waypoint_id](const as2_msgs::msg::PoseWithID & goal_waypoint) {
+          return goal_waypoint.id == waypoint_id;
+        });
+      if (it != goal_.path.end()) {
+        it->pose = goal_poses[i];
+        modifications.emplace_back(positions[i]);
+        RCLCPP_DEBUG(
+          this->get_logger(), "waypoint[%s] modified: (%.2f, %.2f, %.2f)",
+          waypoint_id.c_str(), position.x(), position.y(), position.z());
+      } else {
+        // Unknown waypoints are appended at the end of the path
+        as2_msgs::msg::PoseWithID goal_waypoint;
+        goal_waypoint.id = waypoint_id;
+        goal_waypoint.pose = goal_poses[i];
+        goal_.path.push_back(goal_waypoint);
+        appends.emplace_back(positions[i]);
+        RCLCPP_DEBUG(
+          this->get_logger(), "waypoint[%s] appended: (%.2f, %.2f, %.2f)",
+          waypoint_id.c_str(), position.x(), position.y(), position.z());
+      }
+    }
+  }
+  requestWaypointModifications(modifications, -1.0f, appends);
+}
+
+void DynamicPolynomialTrajectoryGenerator::requestWaypointModifications(
+  const std::vector<std::pair<std::string, Eigen::Vector3d>> & modifications,
+  float max_speed,
+  const std::vector<std::pair<std::string, Eigen::Vector3d>> & appends)
+{
+  // The trajectory no longer matches its cache query
+  cache_insert_pending_ = false;
+  {
+    std::lock_guard<std::mutex> lock(modifications_mutex_);
+    for (const auto & modification : modifications) {
+      // Only the last position of each waypoint is solved
+      auto it = std::find_if(
+        pending_modifications_.begin(), pending_modifications_.end(),
+        [&modification](const auto & pending) {return pending.first == modification.first;});
+      if (it != pending_modifications_.end()) {
+        it->second = modification.second;
+      } else {
+        pending_modifications_.emplace_back(modification);
+      }
+    }
+    for (const auto & append : appends) {
+      auto it = std::find_if(
+        pending_appends_.begin(), pending_appends_.end(),
+        [&append](const auto & pending) {return pending.first == append.first;});
+      if (it != pending_appends_.end()) {
+        it->second = append.second;
+      } else {
+        pending_appends_.emplace_back(append);
+      }
+    }
+    if (max_speed >= 0.0f) {
+      pending_max_speed_ = max_speed;
+    }
+  }
+  modifications_cv_.notify_one();
+}
+
+void DynamicPolynomialTrajectoryGenerator::clearWaypointModifications()
+{
+  std::lock_guard<std::mutex> lock(modifications_mutex_);
+  pending_modifications_.clear();
+  pending_appends_.clear();
+  pending_waypoints_.clear();
+  waypoints_pending_ = false;
+  pending_max_speed_ = -1.0f;
+}
+
+void DynamicPolynomialTrajectoryGenerator::regenerationThread()
+{
+  std::vector<std::pair<std::string, Eigen::Vector3d>> modifications;
+  std::vector<std::pair<std::string, Eigen::Vector3d>> appends;
+  dynamic_traj_generator::DynamicWaypoint::Vector waypoints;
+  while (true) {
+    float max_speed;
+    {
+      std::unique_lock<std::mutex> lock(modifications_mutex_);
+      modifications_cv_.wait(
+        lock, [this]() {
+          return stop_regeneration_ || !pending_modifications_.empty() ||
+          !pending_appends_.empty() || !pending_waypoints_.empty() ||
+          pending_max_speed_ >= 0.0f;
+        });
+      if (stop_regeneration_) {
         return;
       }
+      modifications.clear();
+      modifications.swap(pending_modifications_);
+      appends.clear();
+      appends.swap(pending_appends_);
+      waypoints.clear();
+      waypoints.swap(pending_waypoints_);
+      max_speed = pending_max_speed_;
+      pending_max_speed_ = -1.0f;
     }
 
-    Eigen::Vector3d position;
-    position.x() = pose_stamped.pose.position.x;
-    position.y() = pose_stamped.pose.position.y;
-    position.z() = pose_stamped.pose.position.z;
-    trajectory_generator_->modifyWaypoint(waypoint.id, position);
-    RCLCPP_DEBUG(
-      this->get_logger(), "waypoint[%s] modified: %s - (%.2f, %.2f, %.2f)",
-      waypoint.id.c_str(), pose_stamped.header.frame_id.c_str(),
-      position.x(), position.y(), position.z());
+    // The setpoint stream does not wait for this lock, it keeps publishing the previous
+    // trajectory from the lookup table until the new one is sampled
+    std::lock_guard<std::mutex> generator_lock(trajectory_generator_mutex_);
+    if (!waypoints.empty()) {
+      trajectory_generator_->setWaypoints(waypoints);
+      waypoints_pending_ = false;
+    }
+    if (max_speed >= 0.0f) {
+      trajectory_generator_->setSpeed(max_speed);
+    }
+    for (const auto & [waypoint_id, position] : modifications) {
+      trajectory_generator_->modifyWaypoint(waypoint_id, position);
+    }
+    for (const auto & [waypoint_id, position] : appends) {
+      dynamic_traj_generator::DynamicWaypoint dynamic_waypoint;
+      dynamic_waypoint.setName(waypoint_id);
+      dynamic_waypoint.resetWaypoint(position);
+      trajectory_generator_->appendWaypoint(dynamic_waypoint);
+    }
+    if (!trajectory_running_) {
+      continue;
+    }
+
+    // Solve now, at the last time published, instead of on the next setpoint evaluation
+    dynamic_traj_generator::References refs;
+    trajectory_generator_->evaluateTrajectory(
+      std::clamp(
+        last_eval_time_.load(), trajectory_generator_->getMinTime(),
+        trajectory_generator_->getMaxTime()),
+      refs, true);
+    if (trajectory_generator_->getWasTrajectoryRegenerated()) {
+      trajectory_regenerated_async_ = true;
+      if (use_lookup_table_) {
+        sampleTrajectory(true);
+      }
+    }
   }
 }
 
@@ -324,8 +606,14 @@ bool DynamicPolynomialTrajectoryGenerator::on_pause(
     "to cancel it and start a new one");
 
   // Reset the trajectory generator
-  trajectory_generator_ =
-    std::make_shared<dynamic_traj_generator::DynamicTrajectory>();
+  {
+    std::lock_guard<std::mutex> generator_lock(trajectory_generator_mutex_);
+    trajectory_running_ = false;
+    clearWaypointModifications();
+    trajectory_generator_ =
+      std::make_shared<dynamic_traj_generator::DynamicTrajectory>();
+    trajectory_sampler_.reset();
+  }
 
   // Send the hover motion command
   hover_motion_handler_.sendHover();
@@ -342,6 +630,7 @@ bool DynamicPolynomialTrajectoryGenerator::on_resume(
     RCLCPP_ERROR(this->get_logger(), "No odometry information available");
     return false;
   }
+  std::lock_guard<std::mutex> generator_lock(trajectory_generator_mutex_);
   setup();
 
   // Print goal path
@@ -385,7 +674,7 @@ bool DynamicPolynomialTrajectoryGenerator::on_resume(
   }
 
   // Set waypoints to trajectory generator
-  trajectory_generator_->setWaypoints(waypoints_to_set);
+  setTrajectoryWaypoints(waypoints_to_set, paused_goal.max_speed);
 
   yaw_mode_ = paused_goal.yaw;
   goal_ = paused_goal;
@@ -400,8 +689,14 @@ void DynamicPolynomialTrajectoryGenerator::on_execution_end(
   RCLCPP_INFO(this->get_logger(), "TrajectoryGenerator end");
 
   // Reset the trajectory generator
-  trajectory_generator_ =
-    std::make_shared<dynamic_traj_generator::DynamicTrajectory>();
+  {
+    std::lock_guard<std::mutex> generator_lock(trajectory_generator_mutex_);
+    trajectory_running_ = false;
+    clearWaypointModifications();
+    trajectory_generator_ =
+      std::make_shared<dynamic_traj_generator::DynamicTrajectory>();
+    trajectory_sampler_.reset();
+  }
 
   if (state == as2_behavior::ExecutionStatus::SUCCESS ||
     state == as2_behavior::ExecutionStatus::ABORTED)
@@ -424,14 +719,67 @@ as2_behavior::ExecutionStatus DynamicPolynomialTrajectoryGenerator::on_run(
 {
   bool publish_trajectory = false;
 
+  // While waypoint modifications are being solved, the generator is busy and setpoints keep
+  // coming from the table of the previous trajectory. Without a table, wait for the generator.
+  auto lookup_table = use_lookup_table_ ? trajectory_sampler_.getTable() : nullptr;
+  std::unique_lock<std::mutex> generator_lock(trajectory_generator_mutex_, std::defer_lock);
+  if (lookup_table) {
+    generator_lock.try_lock();
+  } else {
+    generator_lock.lock();
+  }
+  // The generator is not usable until the waypoints of a cached trajectory are set
+  const bool generator_available = generator_lock.owns_lock() && !waypoints_pending_;
+
   if (first_run_) {
-    publish_trajectory = evaluateTrajectory(trajectory_generator_->getMinTime());
+    publish_trajectory = evaluateTrajectory(
+      lookup_table && !generator_available ? lookup_table->getMinTime() :
+      trajectory_generator_->getMinTime(),
+      lookup_table.get(), generator_available);
     time_zero_ = this->now();
     eval_time_ = rclcpp::Duration(0, 0);
     first_run_ = false;
+    trajectory_running_ = true;
   } else {
     eval_time_ = this->now() - time_zero_;
-    publish_trajectory = evaluateTrajectory(eval_time_.seconds());
+    publish_trajectory = evaluateTrajectory(
+      eval_time_.seconds(), lookup_table.get(), generator_available);
+  }
+  last_eval_time_ = eval_time_.seconds();
+
+  // Regenerations solved on the regeneration thread are already being sampled
+  bool trajectory_regenerated = trajectory_regenerated_async_.exchange(false);
+  if (generator_available) {
+    const bool generator_regenerated = trajectory_generator_->getWasTrajectoryRegenerated();
+    trajectory_regenerated |= generator_regenerated;
+    trajectory_max_time_ = trajectory_generator_->getMaxTime();
+
+    // Table sampled for the trajectory being followed, or resampled if it was regenerated
+    if (use_lookup_table_ && !trajectory_sampler_.pending()) {
+      if (generator_regenerated || (eval_time_.seconds() == 0.0 && !lookup_table) ||
+        (lookup_table && (lookup_table->getMinTime() != trajectory_generator_->getMinTime() ||
+        lookup_table->getMaxTime() != trajectory_generator_->getMaxTime())))
+      {
+        sampleTrajectory();
+      }
+    }
+
+    // First table of the trajectory solved from the goal
+    if (cache_insert_pending_ && lookup_table && !trajectory_sampler_.pending()) {
+      cache_insert_pending_ = false;
+      trajectory_cache_.insert(cache_query_, lookup_table);
+    }
+
+    auto next_trajectory_waypoints =
+      trajectory_generator_->getNextTrajectoryWaypoints();
+
+    feedback_.remaining_waypoints = next_trajectory_waypoints.size();
+    if (feedback_.remaining_waypoints > 0) {
+      feedback_.next_waypoint_id = next_trajectory_waypoints[0].getName();
+    } else {
+      feedback_.next_waypoint_id = "";
+    }
+    generator_lock.unlock();
   }
 
   // Check success trajectory generator evaluation
@@ -442,7 +790,7 @@ as2_behavior::ExecutionStatus DynamicPolynomialTrajectoryGenerator::on_run(
   }
 
   // Check if the trajectory generator has finished
-  if (trajectory_generator_->getMaxTime() < (eval_time_.seconds() - 0.01) &&
+  if (generator_available && trajectory_max_time_ < (eval_time_.seconds() - 0.01) &&
     !first_run_)
   {
     result_msg->trajectory_generator_success = true;
@@ -451,11 +799,7 @@ as2_behavior::ExecutionStatus DynamicPolynomialTrajectoryGenerator::on_run(
 
   // Plot debug trajectory
   if (enable_debug_) {
-    plotRefTrajPoint();
-    if (trajectory_generator_->getWasTrajectoryRegenerated()) {
-      RCLCPP_DEBUG(this->get_logger(), "Plot trajectory");
-      plotTrajectory();
-    }
+    plotDebug(trajectory_regenerated);
   }
 
   // Publish trajectory motion reference
@@ -467,27 +811,30 @@ as2_behavior::ExecutionStatus DynamicPolynomialTrajectoryGenerator::on_run(
     return as2_behavior::ExecutionStatus::FAILURE;
   }
 
-  auto next_trajectory_waypoints =
-    trajectory_generator_->getNextTrajectoryWaypoints();
-
-  feedback_.remaining_waypoints = next_trajectory_waypoints.size();
-  if (feedback_.remaining_waypoints > 0) {
-    feedback_.next_waypoint_id = next_trajectory_waypoints[0].getName();
-  } else {
-    feedback_.next_waypoint_id = "";
-  }
-
   feedback_msg->remaining_waypoints = feedback_.remaining_waypoints;
   feedback_msg->next_waypoint_id = feedback_.next_waypoint_id;
   return as2_behavior::ExecutionStatus::RUNNING;
 }
 
 bool DynamicPolynomialTrajectoryGenerator::evaluateTrajectory(
-  double eval_time)
+  double eval_time,
+  const TrajectoryLookupTable * lookup_table,
+  bool update_generator)
 {
+  if (lookup_table && update_generator) {
+    // The generator tracks progress and swaps regenerated trajectories on evaluation, so it is
+    // still evaluated once per tick, positions only. Setpoints come from the table.
+    dynamic_traj_generator::References traj_command;
+    trajectory_generator_->evaluateTrajectory(
+      std::clamp(
+        eval_time, trajectory_generator_->getMinTime(),
+        trajectory_generator_->getMaxTime()),
+      traj_command, true);
+  }
+
   as2_msgs::msg::TrajectoryPoint setpoint;
   for (int i = 0; i < sampling_n_; i++) {
-    if (!evaluateSetpoint(eval_time, setpoint)) {
+    if (!evaluateSetpoint(eval_time, setpoint, lookup_table)) {
       return false;
     }
     trajectory_command_.setpoints[i] = setpoint;
@@ -499,18 +846,27 @@ bool DynamicPolynomialTrajectoryGenerator::evaluateTrajectory(
 
 bool DynamicPolynomialTrajectoryGenerator::evaluateSetpoint(
   double eval_time,
-  as2_msgs::msg::TrajectoryPoint & setpoint)
+  as2_msgs::msg::TrajectoryPoint & setpoint,
+  const TrajectoryLookupTable * lookup_table)
 {
   dynamic_traj_generator::References traj_command;
   double yaw_angle;
-
-  if (eval_time <= trajectory_generator_->getMinTime()) {
-    eval_time = trajectory_generator_->getMinTime();
-  } else if (eval_time >= trajectory_generator_->getMaxTime()) {
-    eval_time = trajectory_generator_->getMaxTime();
+  bool succes_eval = false;
+
+  if (lookup_table) {
+    TrajectorySample sample;
+    succes_eval = lookup_table->evaluate(eval_time, sample);
+    traj_command.position = sample.position;
+    traj_command.velocity = sample.velocity;
+    traj_command.acceleration = sample.acceleration;
+  } else {
+    if (eval_time <= trajectory_generator_->getMinTime()) {
+      eval_time = trajectory_generator_->getMinTime();
+    } else if (eval_time >= trajectory_generator_->getMaxTime()) {
+      eval_time = trajectory_generator_->getMaxTime();
+    }
+    succes_eval = trajectory_generator_->evaluateTrajectory(eval_time, traj_command);
   }
-  bool succes_eval =
-    trajectory_generator_->evaluateTrajectory(eval_time, traj_command);
 
   switch (yaw_mode_.mode) {
     case as2_msgs::msg::YawMode::KEEP_YAW:
@@ -567,8 +923,49 @@ double DynamicPolynomialTrajectoryGenerator::computeYawAnglePathFacing(
   return current_yaw_;
 }
 
+void DynamicPolynomialTrajectoryGenerator::sampleTrajectory(bool keep_table)
+{
+  // The sampler keeps its own reference, the generator may be replaced while sampling
+  auto trajectory_generator = trajectory_generator_;
+  trajectory_sampler_.request(
+    trajectory_generator->getMinTime(), trajectory_generator->getMaxTime(),
+    lookup_table_resolution_,
+    [trajectory_generator](double time, TrajectorySample & sample) {
+      dynamic_traj_generator::References refs;
+      if (!trajectory_generator->evaluateTrajectory(time, refs, false, true)) {
+        return false;
+      }
+      sample.position = refs.position;
+      sample.velocity = refs.velocity;
+      sample.acceleration = refs.acceleration;
+      return true;
+    }, keep_table);
+}
+
 /** Debug functions **/
 
+void DynamicPolynomialTrajectoryGenerator::plotDebug(bool trajectory_regenerated)
+{
+  path_plot_pending_ |= trajectory_regenerated;
+
+  // Rate limited, the last regenerated trajectory is plotted once the period elapses
+  const double now = this->now().seconds();
+  if (debug_max_rate_ > 0.0 && now - last_debug_time_ < 1.0 / debug_max_rate_) {
+    return;
+  }
+  last_debug_time_ = now;
+
+  // Nothing is computed without subscribers, a pending path waits for one
+  if (ref_point_pub->get_subscription_count() > 0) {
+    plotRefTrajPoint();
+  }
+  if (path_plot_pending_ && path_pub_->get_subscription_count() > 0) {
+    RCLCPP_DEBUG(this->get_logger(), "Plot trajectory");
+    plotTrajectory();
+    path_plot_pending_ = false;
+  }
+}
+
 void DynamicPolynomialTrajectoryGenerator::plotTrajectory()
 {
   // launch async plot
@@ -576,33 +973,44 @@ void DynamicPolynomialTrajectoryGenerator::plotTrajectory()
     plot_thread_.join();
   }
   plot_thread_ = std::thread(
-    &DynamicPolynomialTrajectoryGenerator::plotTrajectoryThread, this);
+    &DynamicPolynomialTrajectoryGenerator::plotTrajectoryThread, this, trajectory_generator_);
 }
 
-void DynamicPolynomialTrajectoryGenerator::plotTrajectoryThread()
+void DynamicPolynomialTrajectoryGenerator::plotTrajectoryThread(
+  std::shared_ptr<dynamic_traj_generator::DynamicTrajectory> trajectory_generator)
 {
-  nav_msgs::msg::Path path_msg;
-  const float step = 0.2;
-  const float max_time = trajectory_generator_->getMaxTime();
-  const float min_time = trajectory_generator_->getMinTime();
+  const double max_time = trajectory_generator->getMaxTime();
+  const double min_time = trajectory_generator->getMinTime();
   dynamic_traj_generator::References refs;
-  const int n_measures = (max_time - min_time) / step;
+  std::vector<Eigen::Vector3d> points;
+  points.reserve(static_cast<size_t>(std::max(0.0, (max_time - min_time) / debug_path_step_)) + 2);
+  for (double time = min_time; time < max_time; time += debug_path_step_) {
+    trajectory_generator->evaluateTrajectory(time, refs, true, true);
+    points.emplace_back(refs.position);
+  }
+  trajectory_generator->evaluateTrajectory(max_time, refs, true, true);
+  points.emplace_back(refs.position);
+
+  const std::vector<Eigen::Vector3d> path_points =
+    decimatePath(points, debug_path_max_angle_, debug_path_max_distance_);
+
+  nav_msgs::msg::Path path_msg;
   auto time_stamp = this->now();
-  // path_msg.poses.reserve(n_measures);
-  for (float time = min_time; time <= max_time; time += step) {
+  path_msg.header.frame_id = desired_frame_id_;
+  path_msg.header.stamp = time_stamp;
+  path_msg.poses.reserve(path_points.size());
+  for (const Eigen::Vector3d & point : path_points) {
     geometry_msgs::msg::PoseStamped pose_msg;
-    pose_msg.header.frame_id = desired_frame_id_;
-    pose_msg.header.stamp = time_stamp;
-    trajectory_generator_->evaluateTrajectory(time, refs, true, true);
-    pose_msg.pose.position.x = refs.position.x();
-    pose_msg.pose.position.y = refs.position.y();
-    pose_msg.pose.position.z = refs.position.z();
+    pose_msg.header = path_msg.header;
+    pose_msg.pose.position.x = point.x();
+    pose_msg.pose.position.y = point.y();
+    pose_msg.pose.position.z = point.z();
     path_msg.poses.emplace_back(pose_msg);
   }
-  path_msg.header.frame_id = desired_frame_id_;
-  path_msg.header.stamp = time_stamp;
 
-  RCLCPP_INFO(this->get_logger(), "DEBUG: Plotting trajectory");
+  RCLCPP_DEBUG(
+    this->get_logger(), "DEBUG: Plotting trajectory with %zu of %zu poses",
+    path_points.size(), points.size());
   path_pub_->publish(path_msg);
 }
 
@@ -632,6 +1040,35 @@ void DynamicPolynomialTrajectoryGenerator::plotRefTrajPoint()
 }
 
 /** Auxiliar Functions **/
+std::vector<Eigen::Vector3d> decimatePath(
+  const std::vector<Eigen::Vector3d> & points,
+  double max_angle,
+  double max_distance)
+{
+  if (points.size() <= 2 || max_angle <= 0.0) {
+    return points;
+  }
+
+  std::vector<Eigen::Vector3d> decimated;
+  decimated.emplace_back(points.front());
+  double angle = 0.0;
+  double distance = 0.0;
+  for (size_t i = 1; i + 1 < points.size(); i++) {
+    const Eigen::Vector3d segment_in = points[i] - points[i - 1];
+    const Eigen::Vector3d segment_out = points[i + 1] - points[i];
+    distance += segment_in.norm();
+    // Turning angle at this point, accumulated since the last kept point
+    angle += std::atan2(segment_in.cross(segment_out).norm(), segment_in.dot(segment_out));
+    if (angle >= max_angle || (max_distance > 0.0 && distance >= max_distance)) {
+      decimated.emplace_back(points[i]);
+      angle = 0.0;
+      distance = 0.0;
+    }
+  }
+  decimated.emplace_back(points.back());
+  return decimated;
+}
+
 void generateDynamicPoint(
   const as2_msgs::msg::PoseWithID & msg,
   dynamic_traj_generator::DynamicWaypoint & dynamic_point)
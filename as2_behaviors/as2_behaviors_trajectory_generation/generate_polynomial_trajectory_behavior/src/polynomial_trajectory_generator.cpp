@@ -0,0 +1,159 @@
+// Copyright 2024 Universidad Politécnica de Madrid
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the Universidad Politécnica de Madrid nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+* @file polynomial_trajectory_generator.cpp
+*
+* @brief Source file for the PolynomialTrajectoryGenerator class.
+*
+* @author Miguel Fernández Cortizas
+*         Rafael Pérez Seguí
+*/
+
+#include "polynomial_trajectory_generator.hpp"
+
+#include <algorithm>
+
+#include "dynamic_trajectory_generator/dynamic_trajectory.hpp"
+#include "dynamic_trajectory_generator/dynamic_waypoint.hpp"
+
+PolynomialTrajectoryGenerator::PolynomialTrajectoryGenerator()
+: trajectory_(std::make_unique<dynamic_traj_generator::DynamicTrajectory>()) {}
+
+PolynomialTrajectoryGenerator::~PolynomialTrajectoryGenerator() = default;
+
+bool PolynomialTrajectoryGenerator::setWaypoints(
+  const std::vector<TrajectoryWaypoint> & waypoints,
+  double max_speed,
+  const Eigen::Vector3d & vehicle_position)
+{
+  if (waypoints.empty() || max_speed <= 0.0) {
+    return false;
+  }
+
+  dynamic_traj_generator::DynamicWaypoint::Vector dynamic_waypoints;
+  dynamic_waypoints.reserve(waypoints.size());
+  for (size_t i = 0; i < waypoints.size(); i++) {
+    if (waypoints[i].id.empty()) {
+      return false;
+    }
+    for (size_t j = 0; j < i; j++) {
+      if (waypoints[j].id == waypoints[i].id) {
+        return false;
+      }
+    }
+    dynamic_traj_generator::DynamicWaypoint dynamic_waypoint;
+    dynamic_waypoint.setName(waypoints[i].id);
+    dynamic_waypoint.resetWaypoint(waypoints[i].position);
+    dynamic_waypoints.emplace_back(dynamic_waypoint);
+  }
+
+  reset();
+  trajectory_->updateVehiclePosition(vehicle_position);
+  trajectory_->setSpeed(max_speed);
+  trajectory_->setWaypoints(dynamic_waypoints);
+  has_trajectory_ = true;
+  return true;
+}
+
+bool PolynomialTrajectoryGenerator::modifyWaypoint(
+  const std::string & id, const Eigen::Vector3d & position)
+{
+  if (!has_trajectory_) {
+    return false;
+  }
+  trajectory_->modifyWaypoint(id, position);
+  return true;
+}
+
+void PolynomialTrajectoryGenerator::updateVehiclePosition(const Eigen::Vector3d & position)
+{
+  trajectory_->updateVehiclePosition(position);
+}
+
+bool PolynomialTrajectoryGenerator::evaluate(double time, TrajectorySample & sample)
+{
+  return evaluateTrajectory(time, sample, true);
+}
+
+bool PolynomialTrajectoryGenerator::evaluateNoTracking(double time, TrajectorySample & sample)
+{
+  return evaluateTrajectory(time, sample, false);
+}
+
+bool PolynomialTrajectoryGenerator::evaluateTrajectory(
+  double time, TrajectorySample & sample, bool tracking)
+{
+  if (!has_trajectory_) {
+    return false;
+  }
+  dynamic_traj_generator::References refs;
+  const double eval_time = std::clamp(time, getMinTime(), getMaxTime());
+  if (!trajectory_->evaluateTrajectory(eval_time, refs, false, !tracking)) {
+    return false;
+  }
+  sample.position = refs.position;
+  sample.velocity = refs.velocity;
+  sample.acceleration = refs.acceleration;
+  return true;
+}
+
+double PolynomialTrajectoryGenerator::getMinTime() const
+{
+  return trajectory_->getMinTime();
+}
+
+double PolynomialTrajectoryGenerator::getMaxTime() const
+{
+  return trajectory_->getMaxTime();
+}
+
+bool PolynomialTrajectoryGenerator::wasRegenerated()
+{
+  return has_trajectory_ && trajectory_->getWasTrajectoryRegenerated();
+}
+
+std::vector<std::string> PolynomialTrajectoryGenerator::getRemainingWaypoints() const
+{
+  std::vector<std::string> remaining_waypoints;
+  if (!has_trajectory_) {
+    return remaining_waypoints;
+  }
+  auto next_waypoints = trajectory_->getNextTrajectoryWaypoints();
+  remaining_waypoints.reserve(next_waypoints.size());
+  for (const auto & waypoint : next_waypoints) {
+    remaining_waypoints.emplace_back(waypoint.getName());
+  }
+  return remaining_waypoints;
+}
+
+void PolynomialTrajectoryGenerator::reset()
+{
+  trajectory_ = std::make_unique<dynamic_traj_generator::DynamicTrajectory>();
+  has_trajectory_ = false;
+}
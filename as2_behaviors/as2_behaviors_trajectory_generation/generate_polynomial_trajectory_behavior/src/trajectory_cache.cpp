@@ -0,0 +1,173 @@
+// Copyright 2024 Universidad Politécnica de Madrid
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the Universidad Politécnica de Madrid nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+* @file trajectory_cache.cpp
+*
+* @brief Source file for the TrajectoryCache class.
+*
+* @author Miguel Fernández Cortizas
+*         Rafael Pérez Seguí
+*/
+
+#include "trajectory_cache.hpp"
+
+#include <cmath>
+#include <functional>
+#include <utility>
+
+namespace
+{
+constexpr double kQuantization = 1e-3;
+
+int64_t quantize(double value)
+{
+  return static_cast<int64_t>(std::llround(value / kQuantization));
+}
+
+void hashCombine(std::size_t & seed, int64_t value)
+{
+  seed ^= std::hash<int64_t>{}(value) + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+}
+}  // namespace
+
+TrajectoryCache::TrajectoryCache(std::size_t capacity, double position_tolerance)
+: capacity_(capacity), position_tolerance_(position_tolerance)
+{
+}
+
+void TrajectoryCache::configure(std::size_t capacity, double position_tolerance)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  capacity_ = capacity;
+  position_tolerance_ = position_tolerance;
+  evict();
+}
+
+std::shared_ptr<const TrajectoryLookupTable> TrajectoryCache::find(
+  const TrajectoryCacheQuery & query)
+{
+  const std::size_t key = hash(query);
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = index_.find(key);
+  if (it == index_.end() || !sameTrajectory(it->second->query, query) ||
+    (it->second->query.initial_position - query.initial_position).norm() > position_tolerance_)
+  {
+    misses_++;
+    return nullptr;
+  }
+  hits_++;
+  entries_.splice(entries_.begin(), entries_, it->second);
+  return it->second->table;
+}
+
+void TrajectoryCache::insert(
+  const TrajectoryCacheQuery & query,
+  std::shared_ptr<const TrajectoryLookupTable> table)
+{
+  if (!table || table->empty()) {
+    return;
+  }
+  const std::size_t key = hash(query);
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (capacity_ == 0) {
+    return;
+  }
+  auto it = index_.find(key);
+  if (it != index_.end()) {
+    entries_.erase(it->second);
+  }
+  entries_.push_front(Entry{key, query, std::move(table)});
+  index_[key] = entries_.begin();
+  evict();
+}
+
+void TrajectoryCache::clear()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  entries_.clear();
+  index_.clear();
+}
+
+std::size_t TrajectoryCache::size() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return entries_.size();
+}
+
+uint64_t TrajectoryCache::getHits() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return hits_;
+}
+
+uint64_t TrajectoryCache::getMisses() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return misses_;
+}
+
+std::size_t TrajectoryCache::hash(const TrajectoryCacheQuery & query)
+{
+  std::size_t seed = query.waypoints.size();
+  hashCombine(seed, quantize(query.max_speed));
+  for (const Eigen::Vector3d & waypoint : query.waypoints) {
+    hashCombine(seed, quantize(waypoint.x()));
+    hashCombine(seed, quantize(waypoint.y()));
+    hashCombine(seed, quantize(waypoint.z()));
+  }
+  return seed;
+}
+
+bool TrajectoryCache::sameTrajectory(
+  const TrajectoryCacheQuery & a,
+  const TrajectoryCacheQuery & b)
+{
+  // Guards against hash collisions
+  if (a.waypoints.size() != b.waypoints.size() ||
+    quantize(a.max_speed) != quantize(b.max_speed))
+  {
+    return false;
+  }
+  for (std::size_t i = 0; i < a.waypoints.size(); ++i) {
+    for (int axis = 0; axis < 3; ++axis) {
+      if (quantize(a.waypoints[i][axis]) != quantize(b.waypoints[i][axis])) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+void TrajectoryCache::evict()
+{
+  while (entries_.size() > capacity_) {
+    index_.erase(entries_.back().key);
+    entries_.pop_back();
+  }
+}
@@ -0,0 +1,187 @@
+// Copyright 2024 Universidad Politécnica de Madrid
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the Universidad Politécnica de Madrid nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+* @file trajectory_lookup_table.cpp
+*
+* @brief Source file for the TrajectoryLookupTable and TrajectorySampler classes.
+*
+* @author Miguel Fernández Cortizas
+*         Rafael Pérez Seguí
+*/
+
+#include "trajectory_lookup_table.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+bool TrajectoryLookupTable::build(
+  double min_time, double max_time, double resolution,
+  const SampleFunction & sample_function)
+{
+  samples_.clear();
+  if (!(resolution > 0.0) || !(max_time >= min_time)) {
+    return false;
+  }
+
+  const std::size_t n_intervals = std::max<std::size_t>(
+    1, static_cast<std::size_t>(std::ceil((max_time - min_time) / resolution)));
+  min_time_ = min_time;
+  max_time_ = max_time;
+  resolution_ = (max_time - min_time) / static_cast<double>(n_intervals);
+  inv_resolution_ = resolution_ > 0.0 ? 1.0 / resolution_ : 0.0;
+
+  std::vector<TrajectorySample> samples(n_intervals + 1);
+  for (std::size_t i = 0; i <= n_intervals; i++) {
+    const double time = (i == n_intervals) ? max_time : min_time + i * resolution_;
+    if (!sample_function(time, samples[i])) {
+      return false;
+    }
+  }
+  samples_ = std::move(samples);
+  return true;
+}
+
+bool TrajectoryLookupTable::evaluate(double time, TrajectorySample & sample) const
+{
+  if (samples_.empty()) {
+    return false;
+  }
+
+  const double t = std::clamp(time, min_time_, max_time_);
+  const double index = (t - min_time_) * inv_resolution_;
+  const std::size_t i = std::min(static_cast<std::size_t>(index), samples_.size() - 2);
+  const double s = std::clamp(index - static_cast<double>(i), 0.0, 1.0);
+  const TrajectorySample & p0 = samples_[i];
+  const TrajectorySample & p1 = samples_[i + 1];
+
+  // Cubic Hermite basis
+  const double s2 = s * s;
+  const double s3 = s2 * s;
+  const double h00 = 2.0 * s3 - 3.0 * s2 + 1.0;
+  const double h10 = (s3 - 2.0 * s2 + s) * resolution_;
+  const double h01 = -2.0 * s3 + 3.0 * s2;
+  const double h11 = (s3 - s2) * resolution_;
+
+  sample.position = h00 * p0.position + h10 * p0.velocity + h01 * p1.position +
+    h11 * p1.velocity;
+  sample.velocity = h00 * p0.velocity + h10 * p0.acceleration + h01 * p1.velocity +
+    h11 * p1.acceleration;
+  sample.acceleration = (1.0 - s) * p0.acceleration + s * p1.acceleration;
+  return true;
+}
+
+TrajectorySampler::TrajectorySampler()
+{
+  thread_ = std::thread(&TrajectorySampler::run, this);
+}
+
+TrajectorySampler::~TrajectorySampler()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  cv_.notify_one();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+}
+
+void TrajectorySampler::request(
+  double min_time, double max_time, double resolution,
+  TrajectoryLookupTable::SampleFunction sample_function, bool keep_table)
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending_request_ = std::make_unique<Request>(
+      Request{min_time, max_time, resolution, std::move(sample_function)});
+    request_id_++;
+    if (!keep_table) {
+      std::atomic_store(&table_, std::shared_ptr<const TrajectoryLookupTable>());
+    }
+  }
+  cv_.notify_one();
+}
+
+void TrajectorySampler::reset()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  pending_request_.reset();
+  request_id_++;
+  done_request_id_ = request_id_;
+  std::atomic_store(&table_, std::shared_ptr<const TrajectoryLookupTable>());
+}
+
+void TrajectorySampler::setTable(std::shared_ptr<const TrajectoryLookupTable> table)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  pending_request_.reset();
+  request_id_++;
+  done_request_id_ = request_id_;
+  std::atomic_store(&table_, std::move(table));
+}
+
+bool TrajectorySampler::pending() const
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  return done_request_id_ != request_id_;
+}
+
+std::shared_ptr<const TrajectoryLookupTable> TrajectorySampler::getTable() const
+{
+  return std::atomic_load(&table_);
+}
+
+void TrajectorySampler::run()
+{
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    cv_.wait(lock, [this]() {return stop_ || pending_request_;});
+    if (stop_) {
+      return;
+    }
+    std::unique_ptr<Request> request = std::move(pending_request_);
+    const uint64_t request_id = request_id_;
+
+    lock.unlock();
+    auto table = std::make_shared<TrajectoryLookupTable>();
+    const bool success = table->build(
+      request->min_time, request->max_time, request->resolution, request->sample_function);
+    lock.lock();
+
+    // Discard the table if it was superseded while sampling
+    if (request_id == request_id_) {
+      if (success) {
+        std::atomic_store(&table_, std::shared_ptr<const TrajectoryLookupTable>(std::move(table)));
+      }
+      done_request_id_ = request_id;
+    }
+  }
+}
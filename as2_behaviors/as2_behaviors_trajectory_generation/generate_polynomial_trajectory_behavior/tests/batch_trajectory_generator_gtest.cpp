@@ -0,0 +1,131 @@
+// Copyright 2024 Universidad Politécnica de Madrid
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the Universidad Politécnica de Madrid nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+* @file batch_trajectory_generator_gtest.cpp
+*
+* @brief Tests for the start delays of the BatchTrajectoryGenerator class.
+*
+* @author Miguel Fernández Cortizas
+*         Rafael Pérez Seguí
+*/
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include <generate_polynomial_trajectory_behavior/batch_trajectory_generator.hpp>
+
+// Straight line at constant speed, lasting one second
+std::shared_ptr<const TrajectoryLookupTable> makeLine(
+  const Eigen::Vector3d & start, const Eigen::Vector3d & end)
+{
+  auto table = std::make_shared<TrajectoryLookupTable>();
+  table->build(
+    0.0, 1.0, 0.01, [&start, &end](double t, TrajectorySample & sample) {
+      sample.position = start + t * (end - start);
+      sample.velocity = end - start;
+      sample.acceleration.setZero();
+      return true;
+    });
+  return table;
+}
+
+double minDistance(
+  const TrajectoryLookupTable & a, double delay_a,
+  const TrajectoryLookupTable & b, double delay_b)
+{
+  double min_distance = std::numeric_limits<double>::infinity();
+  for (double time = 0.0; time < 5.0; time += 0.001) {
+    TrajectorySample sample_a;
+    TrajectorySample sample_b;
+    a.evaluate(time - delay_a, sample_a);
+    b.evaluate(time - delay_b, sample_b);
+    min_distance = std::min(min_distance, (sample_a.position - sample_b.position).norm());
+  }
+  return min_distance;
+}
+
+TEST(BatchTrajectoryGenerator, SeparatedTrajectoriesAreNotDelayed)
+{
+  const std::vector<std::shared_ptr<const TrajectoryLookupTable>> tables = {
+    makeLine(Eigen::Vector3d(0.0, 0.0, 1.0), Eigen::Vector3d(5.0, 0.0, 1.0)),
+    makeLine(Eigen::Vector3d(0.0, 3.0, 1.0), Eigen::Vector3d(5.0, 3.0, 1.0))};
+
+  std::vector<double> delays;
+  ASSERT_TRUE(BatchTrajectoryGenerator::computeStartDelays(tables, 1.0, 0.05, 0.05, 2.0, delays));
+  ASSERT_EQ(delays.size(), 2u);
+  EXPECT_DOUBLE_EQ(delays[0], 0.0);
+  EXPECT_DOUBLE_EQ(delays[1], 0.0);
+}
+
+TEST(BatchTrajectoryGenerator, CrossingTrajectoryIsDelayed)
+{
+  const std::vector<std::shared_ptr<const TrajectoryLookupTable>> tables = {
+    makeLine(Eigen::Vector3d(-5.0, 0.0, 1.0), Eigen::Vector3d(5.0, 0.0, 1.0)),
+    makeLine(Eigen::Vector3d(0.0, -5.0, 1.0), Eigen::Vector3d(0.0, 5.0, 1.0))};
+  EXPECT_LT(minDistance(*tables[0], 0.0, *tables[1], 0.0), 1.0);
+
+  std::vector<double> delays;
+  ASSERT_TRUE(BatchTrajectoryGenerator::computeStartDelays(tables, 1.0, 0.01, 0.01, 2.0, delays));
+  EXPECT_DOUBLE_EQ(delays[0], 0.0);
+  EXPECT_GT(delays[1], 0.0);
+  EXPECT_GE(minDistance(*tables[0], delays[0], *tables[1], delays[1]), 0.95);
+}
+
+TEST(BatchTrajectoryGenerator, SameGoalCanNotBeSeparated)
+{
+  const std::vector<std::shared_ptr<const TrajectoryLookupTable>> tables = {
+    makeLine(Eigen::Vector3d(0.0, 0.0, 1.0), Eigen::Vector3d(5.0, 0.0, 1.0)),
+    makeLine(Eigen::Vector3d(0.0, 5.0, 1.0), Eigen::Vector3d(5.0, 0.0, 1.0))};
+
+  std::vector<double> delays;
+  EXPECT_FALSE(BatchTrajectoryGenerator::computeStartDelays(tables, 1.0, 0.05, 0.05, 2.0, delays));
+}
+
+TEST(BatchTrajectoryGenerator, CoarseDelayStep)
+{
+  const std::vector<std::shared_ptr<const TrajectoryLookupTable>> tables = {
+    makeLine(Eigen::Vector3d(-5.0, 0.0, 1.0), Eigen::Vector3d(5.0, 0.0, 1.0)),
+    makeLine(Eigen::Vector3d(0.0, -5.0, 1.0), Eigen::Vector3d(0.0, 5.0, 1.0))};
+
+  // Separation is still checked every 0.01 s, only the tested delays are coarser
+  std::vector<double> delays;
+  ASSERT_TRUE(BatchTrajectoryGenerator::computeStartDelays(tables, 1.0, 0.01, 0.25, 2.0, delays));
+  EXPECT_GT(delays[1], 0.0);
+  EXPECT_NEAR(std::fmod(delays[1], 0.25), 0.0, 1e-9);
+  EXPECT_GE(minDistance(*tables[0], delays[0], *tables[1], delays[1]), 0.95);
+
+  // The search gives up at the maximum delay
+  EXPECT_FALSE(
+    BatchTrajectoryGenerator::computeStartDelays(tables, 1.0, 0.01, 0.25, 0.0, delays));
+}
@@ -72,6 +72,32 @@ TEST(DynamicPolynomialTrajectoryGenerator, test_constructor)
     get_node("test_constructor"));
 }
 
+TEST(DynamicPolynomialTrajectoryGenerator, test_decimate_path)
+{
+  // Straight segment followed by a quarter circle
+  std::vector<Eigen::Vector3d> points;
+  for (int i = 0; i <= 100; i++) {
+    points.emplace_back(0.1 * i, 0.0, 1.0);
+  }
+  for (int i = 1; i <= 90; i++) {
+    const double angle = i * M_PI / 180.0;
+    points.emplace_back(10.0 + std::sin(angle), 1.0 - std::cos(angle), 1.0);
+  }
+
+  auto decimated = decimatePath(points, 0.1, 0.0);
+  EXPECT_EQ(decimated.front(), points.front());
+  EXPECT_EQ(decimated.back(), points.back());
+  // The straight segment collapses, the curve keeps a point every ~0.1 rad
+  EXPECT_GE(decimated.size(), 15u);
+  EXPECT_LE(decimated.size(), 20u);
+
+  // Distance limit keeps points on straight segments
+  decimated = decimatePath(points, 0.1, 2.0);
+  EXPECT_GE(decimated.size(), 19u);
+
+  // Disabled
+  EXPECT_EQ(decimatePath(points, 0.0, 0.0).size(), points.size());
+}
 
 int main(int argc, char ** argv)
 {
@@ -0,0 +1,129 @@
+// Copyright 2024 Universidad Politécnica de Madrid
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the Universidad Politécnica de Madrid nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+* @file trajectory_cache_gtest.cpp
+*
+* @brief Tests for the TrajectoryCache class.
+*
+* @author Miguel Fernández Cortizas
+*         Rafael Pérez Seguí
+*/
+
+#include <gtest/gtest.h>
+
+#include <memory>
+
+#include <generate_polynomial_trajectory_behavior/trajectory_cache.hpp>
+
+TrajectoryCacheQuery makeQuery(double offset)
+{
+  TrajectoryCacheQuery query;
+  query.waypoints = {Eigen::Vector3d(offset, 0.0, 1.0), Eigen::Vector3d(offset, 5.0, 2.0)};
+  query.max_speed = 1.5;
+  query.initial_position = Eigen::Vector3d(0.0, 0.0, 1.0);
+  return query;
+}
+
+std::shared_ptr<const TrajectoryLookupTable> makeTable()
+{
+  auto table = std::make_shared<TrajectoryLookupTable>();
+  table->build(
+    0.0, 1.0, 0.1, [](double t, TrajectorySample & sample) {
+      sample.position = Eigen::Vector3d(t, 0.0, 0.0);
+      return true;
+    });
+  return table;
+}
+
+TEST(TrajectoryCache, HitsWithinInitialPositionTolerance)
+{
+  TrajectoryCache cache(4, 0.1);
+  const auto query = makeQuery(0.0);
+  const auto table = makeTable();
+
+  EXPECT_EQ(cache.find(query), nullptr);
+  cache.insert(query, table);
+  EXPECT_EQ(cache.find(query), table);
+
+  auto moved = query;
+  moved.initial_position.x() += 0.05;
+  EXPECT_EQ(cache.find(moved), table);
+  moved.initial_position.x() += 0.1;
+  EXPECT_EQ(cache.find(moved), nullptr);
+
+  EXPECT_EQ(cache.getHits(), 2u);
+  EXPECT_EQ(cache.getMisses(), 2u);
+}
+
+TEST(TrajectoryCache, MissesOnDifferentConstraints)
+{
+  TrajectoryCache cache(4, 0.1);
+  const auto query = makeQuery(0.0);
+  cache.insert(query, makeTable());
+
+  auto faster = query;
+  faster.max_speed = 2.0;
+  EXPECT_EQ(cache.find(faster), nullptr);
+
+  auto moved_waypoint = query;
+  moved_waypoint.waypoints[1].z() += 0.01;
+  EXPECT_EQ(cache.find(moved_waypoint), nullptr);
+
+  auto fewer_waypoints = query;
+  fewer_waypoints.waypoints.pop_back();
+  EXPECT_EQ(cache.find(fewer_waypoints), nullptr);
+}
+
+TEST(TrajectoryCache, EvictsLeastRecentlyUsed)
+{
+  TrajectoryCache cache(2, 0.1);
+  cache.insert(makeQuery(0.0), makeTable());
+  cache.insert(makeQuery(1.0), makeTable());
+
+  // Using the first one makes the second the least recently used
+  EXPECT_NE(cache.find(makeQuery(0.0)), nullptr);
+  cache.insert(makeQuery(2.0), makeTable());
+
+  EXPECT_EQ(cache.size(), 2u);
+  EXPECT_NE(cache.find(makeQuery(0.0)), nullptr);
+  EXPECT_EQ(cache.find(makeQuery(1.0)), nullptr);
+  EXPECT_NE(cache.find(makeQuery(2.0)), nullptr);
+
+  cache.configure(1, 0.1);
+  EXPECT_EQ(cache.size(), 1u);
+  EXPECT_NE(cache.find(makeQuery(2.0)), nullptr);
+}
+
+TEST(TrajectoryCache, DisabledWithZeroCapacity)
+{
+  TrajectoryCache cache(0, 0.1);
+  cache.insert(makeQuery(0.0), makeTable());
+  EXPECT_EQ(cache.size(), 0u);
+  EXPECT_EQ(cache.find(makeQuery(0.0)), nullptr);
+}
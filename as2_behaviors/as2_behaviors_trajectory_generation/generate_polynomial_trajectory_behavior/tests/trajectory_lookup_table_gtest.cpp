@@ -0,0 +1,147 @@
+// Copyright 2024 Universidad Politécnica de Madrid
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the Universidad Politécnica de Madrid nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+* @file trajectory_lookup_table_gtest.cpp
+*
+* @brief Tests for the TrajectoryLookupTable and TrajectorySampler classes.
+*
+* @author Miguel Fernández Cortizas
+*         Rafael Pérez Seguí
+*/
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <thread>
+
+#include <generate_polynomial_trajectory_behavior/trajectory_lookup_table.hpp>
+
+// Cubic polynomial per axis, which the Hermite interpolation reproduces exactly
+bool cubicTrajectory(double t, TrajectorySample & sample)
+{
+  const Eigen::Vector3d a(1.0, -0.5, 0.2);
+  const Eigen::Vector3d b(-2.0, 1.0, 0.0);
+  const Eigen::Vector3d c(0.5, 0.0, -1.0);
+  const Eigen::Vector3d d(1.0, 2.0, 3.0);
+  sample.position = a * t * t * t + b * t * t + c * t + d;
+  sample.velocity = 3.0 * a * t * t + 2.0 * b * t + c;
+  sample.acceleration = 6.0 * a * t + 2.0 * b;
+  return true;
+}
+
+TEST(TrajectoryLookupTable, InterpolatesCubicExactly)
+{
+  TrajectoryLookupTable table;
+  ASSERT_TRUE(table.build(0.0, 3.0, 0.1, cubicTrajectory));
+  EXPECT_EQ(table.size(), 31u);
+
+  TrajectorySample expected;
+  TrajectorySample sample;
+  for (double t = 0.0; t <= 3.0; t += 0.013) {
+    cubicTrajectory(t, expected);
+    ASSERT_TRUE(table.evaluate(t, sample));
+    EXPECT_NEAR((sample.position - expected.position).norm(), 0.0, 1e-9);
+    EXPECT_NEAR((sample.velocity - expected.velocity).norm(), 0.0, 1e-9);
+    EXPECT_NEAR((sample.acceleration - expected.acceleration).norm(), 0.0, 1e-9);
+  }
+}
+
+TEST(TrajectoryLookupTable, ClampsToTrajectoryTimes)
+{
+  TrajectoryLookupTable table;
+  ASSERT_TRUE(table.build(1.0, 2.05, 0.1, cubicTrajectory));
+  EXPECT_DOUBLE_EQ(table.getMaxTime(), 2.05);
+  EXPECT_LE(table.getResolution(), 0.1);
+
+  TrajectorySample expected;
+  TrajectorySample sample;
+  cubicTrajectory(2.05, expected);
+  ASSERT_TRUE(table.evaluate(10.0, sample));
+  EXPECT_NEAR((sample.position - expected.position).norm(), 0.0, 1e-9);
+  cubicTrajectory(1.0, expected);
+  ASSERT_TRUE(table.evaluate(-10.0, sample));
+  EXPECT_NEAR((sample.position - expected.position).norm(), 0.0, 1e-9);
+}
+
+TEST(TrajectoryLookupTable, FailedSampling)
+{
+  TrajectoryLookupTable table;
+  TrajectorySample sample;
+  EXPECT_FALSE(table.evaluate(0.0, sample));
+  EXPECT_FALSE(table.build(0.0, 1.0, 0.0, cubicTrajectory));
+  EXPECT_FALSE(
+    table.build(
+      0.0, 1.0, 0.1, [](double t, TrajectorySample &) {return t < 0.5;}));
+  EXPECT_TRUE(table.empty());
+}
+
+TEST(TrajectorySampler, SamplesInBackground)
+{
+  TrajectorySampler sampler;
+  EXPECT_EQ(sampler.getTable(), nullptr);
+
+  sampler.request(0.0, 2.0, 0.01, cubicTrajectory);
+  std::shared_ptr<const TrajectoryLookupTable> table;
+  for (int i = 0; i < 1000 && !table; i++) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    table = sampler.getTable();
+  }
+  ASSERT_NE(table, nullptr);
+  EXPECT_DOUBLE_EQ(table->getMaxTime(), 2.0);
+
+  sampler.reset();
+  EXPECT_EQ(sampler.getTable(), nullptr);
+  // Tables handed out stay valid after a reset
+  TrajectorySample sample;
+  EXPECT_TRUE(table->evaluate(1.0, sample));
+}
+
+TEST(TrajectorySampler, KeepsTableUntilReplaced)
+{
+  TrajectorySampler sampler;
+  sampler.request(0.0, 1.0, 0.01, cubicTrajectory);
+  while (sampler.pending()) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  auto old_table = sampler.getTable();
+  ASSERT_NE(old_table, nullptr);
+
+  sampler.request(0.0, 2.0, 0.01, cubicTrajectory, true);
+  std::shared_ptr<const TrajectoryLookupTable> table = sampler.getTable();
+  ASSERT_NE(table, nullptr);
+  while (sampler.pending()) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  table = sampler.getTable();
+  ASSERT_NE(table, nullptr);
+  EXPECT_NE(table, old_table);
+  EXPECT_DOUBLE_EQ(table->getMaxTime(), 2.0);
+}
@@ -58,12 +58,14 @@ namespace controller
 {
 const char set_control_mode[] = "controller/set_control_mode";
 const char list_control_modes[] = "controller/list_control_modes";
+const char set_controller[] = "controller/set_controller";
 }  // namespace controller
 namespace motion_reference
 {
 const char send_traj_wayp[] = "traj_gen/send_traj_wayp";
 const char add_traj_wayp[] = "traj_gen/add_traj_wayp";
 const char set_traj_speed[] = "traj_gen/set_traj_speed";
+const char generate_polynomial_trajectories[] = "traj_gen/generate_polynomial_trajectories";
 }  // namespace motion_reference
 namespace gps
 {
@@ -102,6 +102,7 @@ namespace controller
 {
 const rclcpp::QoS qos_info = rclcpp::QoS(10);
 const char info[] = "controller/info";
+const char mode_switch_latency[] = "controller/mode_switch_latency";
 }  // namespace controller
 namespace follow_target
 {
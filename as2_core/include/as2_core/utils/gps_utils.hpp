@@ -36,7 +36,10 @@
 #ifndef AS2_CORE__UTILS__GPS_UTILS_HPP_
 #define AS2_CORE__UTILS__GPS_UTILS_HPP_
 
+#include <cstddef>
+#include <stdexcept>
 #include <string>
+#include <vector>
 #include <GeographicLib/LocalCartesian.hpp>
 
 #include "geographic_msgs/msg/geo_pose_stamped.hpp"
@@ -65,6 +68,28 @@ public:
   : std::runtime_error("origin can only be set once") {}
 };
 
+/**
+ * @brief Conversion used by the GpsHandler batch methods
+ *
+ * Exact: geodetic to ECEF on the ellipsoid, then rotation to the local ENU frame with the matrix
+ * precomputed when the origin is set (two Bowring iterations for the inverse). Agrees with the
+ * single point methods to the micrometer.
+ *
+ * LocalTangentPlane: second order expansion of the local ENU coordinates around the origin, with
+ * no trigonometric functions per point. Meant for points close to the origin, such as geozones
+ * and missions. For |lat0| <= 60 deg and |h - h0| <= 500 m, the error against Exact is below
+ * 1 mm within 2 km, 5 mm within 5 km and 5 cm within 10 km of the origin. It grows with the cube
+ * of the distance and with tan(lat0), so use Exact for larger areas or close to the poles.
+ *
+ * Against a loop of single point calls, Exact is about 2x and LocalTangentPlane about 13x faster
+ * on 10k points (GpsUtilsTest.BatchThroughput records both ratios).
+ */
+enum class BatchMode
+{
+  Exact,
+  LocalTangentPlane
+};
+
 class GpsHandler : private GeographicLib::LocalCartesian
 {
 public:
@@ -86,6 +111,7 @@ public:
   : GeographicLib::LocalCartesian(lat0, lon0, h0, earth)
   {
     this->is_origin_set_ = true;
+    this->computeBatchConstants();
   }
 
   /****************************************************************************************
@@ -132,6 +158,51 @@ public:
   void Local2LatLon(
     const geometry_msgs::msg::PoseStamped & ps, geographic_msgs::msg::GeoPoseStamped & gps);
 
+  /****************************************************************************************
+   *                                                                                      *
+   *                 Batch conversions over structure of arrays (SoA) data                *
+   *                                                                                      *
+   ***************************************************************************************/
+  /**
+   * @brief Convert size points from geodesic LLA to local cartesian
+   *
+   * @param lat Latitudes (degrees)
+   * @param lon Longitudes (degrees)
+   * @param h Altitudes (meters)
+   * @param rX East coordinates (meters), may not overlap the inputs
+   * @param rY North coordinates (meters), may not overlap the inputs
+   * @param rZ Up coordinates (meters), may not overlap the inputs
+   * @param size Number of points
+   * @param mode Conversion used, see BatchMode
+   */
+  void LatLon2Local(
+    const double * lat, const double * lon, const double * h, double * rX, double * rY,
+    double * rZ, const std::size_t size, const BatchMode mode = BatchMode::Exact);
+  void LatLon2Local(
+    const std::vector<double> & lat, const std::vector<double> & lon,
+    const std::vector<double> & h, std::vector<double> & rX, std::vector<double> & rY,
+    std::vector<double> & rZ, const BatchMode mode = BatchMode::Exact);
+
+  /**
+   * @brief Convert size points from local cartesian to geodesic LLA
+   *
+   * @param x East coordinates (meters)
+   * @param y North coordinates (meters)
+   * @param z Up coordinates (meters)
+   * @param rLat Latitudes (degrees), may not overlap the inputs
+   * @param rLon Longitudes (degrees), may not overlap the inputs
+   * @param rH Altitudes (meters), may not overlap the inputs
+   * @param size Number of points
+   * @param mode Conversion used, see BatchMode
+   */
+  void Local2LatLon(
+    const double * x, const double * y, const double * z, double * rLat, double * rLon,
+    double * rH, const std::size_t size, const BatchMode mode = BatchMode::Exact);
+  void Local2LatLon(
+    const std::vector<double> & x, const std::vector<double> & y,
+    const std::vector<double> & z, std::vector<double> & rLat, std::vector<double> & rLon,
+    std::vector<double> & rH, const BatchMode mode = BatchMode::Exact);
+
   /****************************************************************************************
    *                                                                                      *
    *                      Geodesic LLA to Earth-Centered-Earth-Fixed                      *
@@ -170,6 +241,24 @@ public:
 private:
   const std::string local_frame_ = "map";  // local world fixed --> ROS REP105 Name Convention
   bool is_origin_set_ = false;
+
+  // Batch conversion constants, computed when the origin is set
+  struct BatchConstants
+  {
+    double lat0 = 0.0;  // Origin (degrees, meters)
+    double lon0 = 0.0;
+    double h0 = 0.0;
+    double origin_ecef[3] = {0.0, 0.0, 0.0};
+    double ecef_to_enu[9] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0};  // Row major
+    double east_scale = 0.0;  // Meters per degree of longitude at the origin
+    double north_scale = 0.0;  // Meters per degree of latitude at the origin
+    double inv_east_radius = 0.0;  // Inverse of the prime vertical radius at the origin
+    double inv_north_radius = 0.0;  // Inverse of the meridian radius at the origin
+    double tan_lat0 = 0.0;
+    double north_curvature = 0.0;  // Meridian radius variation, second order northing term
+  } batch_;
+
+  void computeBatchConstants();
 };  // GpsHandler
 
 }  // namespace gps
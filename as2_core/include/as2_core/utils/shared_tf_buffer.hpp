@@ -0,0 +1,124 @@
+// Copyright 2024 Universidad Politécnica de Madrid
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the Universidad Politécnica de Madrid nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/*!*******************************************************************************************
+ *  \file       shared_tf_buffer.hpp
+ *  \brief      Process-wide TF buffer shared by the nodes composed in the same process.
+ *  \authors    Rafael Perez Segui
+ *              Miguel Fernandez Cortizas
+ ********************************************************************************/
+
+#ifndef AS2_CORE__UTILS__SHARED_TF_BUFFER_HPP_
+#define AS2_CORE__UTILS__SHARED_TF_BUFFER_HPP_
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <geometry_msgs/msg/transform_stamped.hpp>
+#include <rclcpp/rclcpp.hpp>
+#include <tf2_msgs/msg/tf_message.hpp>
+
+#include "tf2_ros/buffer.h"
+
+namespace as2
+{
+namespace tf
+{
+
+/**
+ * @brief TF buffers shared by all the nodes of a process. A single node subscribes to /tf and
+ * /tf_static, on its own thread, and feeds every buffer handed out, so each TF message is
+ * deserialized once per process instead of once per node.
+ *
+ * Buffers are grouped by namespace filter: nodes asking for the same filter get the same buffer.
+ * A filtered buffer only stores the transforms whose child frame is inside the namespace, or is
+ * outside any namespace (e.g. earth), so memory scales with the drones of the process.
+ *
+ * The registry lives in the rclcpp context, so it is shared even across libraries that link
+ * as2_core statically. It only holds the context weakly and stops its listener node when the
+ * context shuts down, so the context and the registry are released together.
+ */
+class SharedTfBuffer
+{
+public:
+  /**
+   * @brief Get the buffer shared by the nodes of the process with this namespace filter
+   * @param node node asking for the buffer, its clock is used if the buffer is created
+   * @param namespace_filter only store frames of this namespace, empty stores all frames
+   * @return std::shared_ptr<tf2_ros::Buffer> buffer, released when no node uses it
+   */
+  static std::shared_ptr<tf2_ros::Buffer> getBuffer(
+    rclcpp::Node * node, const std::string & namespace_filter = "");
+
+  /**
+   * @brief Whether a child frame is stored in a buffer filtered by this namespace
+   * @param namespace_filter normalized filter, without leading '/' and ending with '/'
+   * @param child_frame_id child frame of the transform
+   */
+  static bool passesFilter(
+    const std::string & namespace_filter, const std::string & child_frame_id);
+
+  // Created through rclcpp::Context::get_sub_context, one per context
+  explicit SharedTfBuffer(rclcpp::Context::SharedPtr context);
+  ~SharedTfBuffer();
+
+  SharedTfBuffer(const SharedTfBuffer &) = delete;
+  SharedTfBuffer & operator=(const SharedTfBuffer &) = delete;
+
+private:
+  std::mutex mutex_;
+  // The context owns this registry, an owning reference back would keep both alive
+  std::weak_ptr<rclcpp::Context> context_;
+  bool shutdown_ = false;
+  rclcpp::OnShutdownCallbackHandle on_shutdown_handle_;
+  rclcpp::Node::SharedPtr listener_node_;
+  rclcpp::executors::SingleThreadedExecutor::SharedPtr executor_;
+  std::thread listener_thread_;
+  rclcpp::Subscription<tf2_msgs::msg::TFMessage>::SharedPtr tf_sub_;
+  rclcpp::Subscription<tf2_msgs::msg::TFMessage>::SharedPtr tf_static_sub_;
+
+  // Filter to buffer, released buffers are removed on the next message
+  std::unordered_map<std::string, std::weak_ptr<tf2_ros::Buffer>> buffers_;
+  // Last static transform by child frame, given to buffers created after it was received
+  std::unordered_map<std::string, geometry_msgs::msg::TransformStamped> static_transforms_;
+
+  std::shared_ptr<tf2_ros::Buffer> getBufferImpl(
+    rclcpp::Node * node, const std::string & namespace_filter);
+  void startListener(rclcpp::Node * node, rclcpp::Context::SharedPtr context);
+  void stopListener();
+  void tfCallback(const tf2_msgs::msg::TFMessage::SharedPtr msg, const bool is_static);
+};
+
+}  // namespace tf
+}  // namespace as2
+
+#endif  // AS2_CORE__UTILS__SHARED_TF_BUFFER_HPP_
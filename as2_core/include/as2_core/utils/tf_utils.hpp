@@ -51,10 +51,12 @@
 #include <geometry_msgs/msg/transform_stamped.hpp>
 #include <geometry_msgs/msg/twist_stamped.hpp>
 #include <geometry_msgs/msg/vector3_stamped.hpp>
+#include <nav_msgs/msg/odometry.hpp>
 #include <nav_msgs/msg/path.hpp>
 
 #include "as2_core/custom/tf2_geometry_msgs.hpp"
 #include "as2_core/node.hpp"
+#include "as2_core/utils/shared_tf_buffer.hpp"
 #include "tf2_ros/buffer.h"
 #include "tf2_ros/transform_listener.h"
 
@@ -104,13 +106,25 @@ private:
   as2::Node * node_;
   std::chrono::nanoseconds tf_timeout_threshold_ = std::chrono::nanoseconds::zero();
 
+  void readTfTimeoutThreshold();
+
 public:
   /**
-   * @brief Construct a new Tf Handler object
+   * @brief Construct a new Tf Handler object. If the tf_shared_buffer parameter is true, the
+   * buffer is shared with the other nodes of the process (see SharedTfBuffer), and filtered by
+   * the node namespace if tf_namespace_filter is true
    * @param _node an as2::Node object
    */
   explicit TfHandler(as2::Node * _node);
 
+  /**
+   * @brief Construct a new Tf Handler object reusing an existing tf2_ros::Buffer, so several
+   * handlers living in the same process share one TransformListener
+   * @param _node an as2::Node object
+   * @param _tf_buffer tf2_ros::Buffer already fed by a TransformListener
+   */
+  TfHandler(as2::Node * _node, std::shared_ptr<tf2_ros::Buffer> _tf_buffer);
+
   /**
    * @brief Set the tf timeout threshold
    * @param tf_timeout_threshold double in seconds
@@ -415,6 +429,33 @@ public:
   std::pair<geometry_msgs::msg::PoseStamped, geometry_msgs::msg::TwistStamped> getState(
     const geometry_msgs::msg::TwistStamped & _twist, const std::string & _twist_target_frame,
     const std::string & _pose_target_frame, const std::string & _pose_source_frame);
+
+  /**
+   * @brief get pose and twist from an odometry message in the desired frames. No transform is
+   * looked up when the pose target is the odometry frame and the twist target is the odometry
+   * frame or its child frame
+   * @param _odom odometry with the pose in header.frame_id and the twist in child_frame_id
+   * @param _twist_target_frame the target frame of the twist
+   * @param _pose_target_frame the target frame of the pose
+   * @param _timeout the timeout for the transform
+   * @return std::pair<geometry_msgs::msg::PoseStamped, geometry_msgs::msg::TwistStamped>
+   * @throw tf2::TransformException if a needed transform is not available
+   */
+  std::pair<geometry_msgs::msg::PoseStamped, geometry_msgs::msg::TwistStamped> getState(
+    const nav_msgs::msg::Odometry & _odom, const std::string & _twist_target_frame,
+    const std::string & _pose_target_frame, const std::chrono::nanoseconds _timeout);
+
+  /**
+   * @brief get pose and twist from an odometry message in the desired frames
+   * @param _odom odometry with the pose in header.frame_id and the twist in child_frame_id
+   * @param _twist_target_frame the target frame of the twist
+   * @param _pose_target_frame the target frame of the pose
+   * @return std::pair<geometry_msgs::msg::PoseStamped, geometry_msgs::msg::TwistStamped>
+   * @throw tf2::TransformException if a needed transform is not available
+   */
+  std::pair<geometry_msgs::msg::PoseStamped, geometry_msgs::msg::TwistStamped> getState(
+    const nav_msgs::msg::Odometry & _odom, const std::string & _twist_target_frame,
+    const std::string & _pose_target_frame);
 };  // namespace tf
 
 }  // namespace tf
@@ -73,6 +73,7 @@ PYBIND11_MODULE(as2_names, m) {
 
   auto m_controller = m_topics.def_submodule("controller");
   m_controller.attr("info") = as2_names::topics::controller::info;
+  m_controller.attr("mode_switch_latency") = as2_names::topics::controller::mode_switch_latency;
 
   auto m_follow_target = m_topics.def_submodule("follow_target");
   m_follow_target.attr("info") = as2_names::topics::follow_target::info;
@@ -95,6 +96,7 @@ PYBIND11_MODULE(as2_names, m) {
   m_controller_serv.attr("set_control_mode") = as2_names::services::controller::set_control_mode;
   m_controller_serv.attr("list_control_modes") =
     as2_names::services::controller::list_control_modes;
+  m_controller_serv.attr("set_controller") = as2_names::services::controller::set_controller;
 
   auto m_motion_reference_serv = m_services.def_submodule("motion_reference");
   m_motion_reference_serv.attr("send_traj_wayp") =
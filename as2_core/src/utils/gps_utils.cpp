@@ -34,11 +34,36 @@
 
 #include "as2_core/utils/gps_utils.hpp"
 
+#include <algorithm>
+#include <cmath>
+
 namespace as2
 {
 namespace gps
 {
 
+namespace
+{
+constexpr double kDegToRad = M_PI / 180.0;
+constexpr double kRadToDeg = 180.0 / M_PI;
+
+// Longitude in [-180, 180), for sums and differences of valid longitudes (|lon| < 540). Two
+// selects instead of floor, which costs more than the rest of the tangent plane loop
+inline double wrapLongitude(const double lon)
+{
+  const double wrapped = lon >= 180.0 ? lon - 360.0 : lon;
+  return wrapped < -180.0 ? wrapped + 360.0 : wrapped;
+}
+
+template<typename T>
+void checkBatchSizes(const std::vector<T> & a, const std::vector<T> & b, const std::vector<T> & c)
+{
+  if (a.size() != b.size() || a.size() != c.size()) {
+    throw std::invalid_argument("batch conversion inputs must have the same size");
+  }
+}
+}  // namespace
+
 // SET ORIGIN
 void GpsHandler::setOrigin(const double & lat0, const double & lon0, const double & h0)
 {
@@ -47,6 +72,7 @@ void GpsHandler::setOrigin(const double & lat0, const double & lon0, const doubl
   }
   this->Reset(lat0, lon0, h0);
   this->is_origin_set_ = true;
+  this->computeBatchConstants();
 }
 
 void GpsHandler::setOrigin(const sensor_msgs::msg::NavSatFix & fix)
@@ -165,6 +191,170 @@ void GpsHandler::Local2LatLon(
   this->Local2LatLon(ps.pose.position.x, ps.pose.position.y, ps.pose.position.z, gps);
 }
 
+// BATCH
+void GpsHandler::computeBatchConstants()
+{
+  const double a = earth.EquatorialRadius();
+  const double e2 = earth.Flattening() * (2.0 - earth.Flattening());
+  const double lat0 = this->LatitudeOrigin();
+  const double lon0 = this->LongitudeOrigin();
+  const double h0 = this->HeightOrigin();
+  const double sin_lat = std::sin(lat0 * kDegToRad);
+  const double cos_lat = std::cos(lat0 * kDegToRad);
+  const double sin_lon = std::sin(lon0 * kDegToRad);
+  const double cos_lon = std::cos(lon0 * kDegToRad);
+  const double w2 = 1.0 - e2 * sin_lat * sin_lat;
+  const double prime_vertical_radius = a / std::sqrt(w2);
+  const double meridian_radius = prime_vertical_radius * (1.0 - e2) / w2;
+
+  batch_.lat0 = lat0;
+  batch_.lon0 = lon0;
+  batch_.h0 = h0;
+  batch_.origin_ecef[0] = (prime_vertical_radius + h0) * cos_lat * cos_lon;
+  batch_.origin_ecef[1] = (prime_vertical_radius + h0) * cos_lat * sin_lon;
+  batch_.origin_ecef[2] = (prime_vertical_radius * (1.0 - e2) + h0) * sin_lat;
+  const double ecef_to_enu[9] = {
+    -sin_lon, cos_lon, 0.0,
+    -sin_lat * cos_lon, -sin_lat * sin_lon, cos_lat,
+    cos_lat * cos_lon, cos_lat * sin_lon, sin_lat};
+  std::copy(ecef_to_enu, ecef_to_enu + 9, batch_.ecef_to_enu);
+  batch_.east_scale = (prime_vertical_radius + h0) * cos_lat * kDegToRad;
+  batch_.north_scale = (meridian_radius + h0) * kDegToRad;
+  batch_.inv_east_radius = 1.0 / (prime_vertical_radius + h0);
+  batch_.inv_north_radius = 1.0 / (meridian_radius + h0);
+  batch_.tan_lat0 = sin_lat / cos_lat;
+  batch_.north_curvature = 1.5 * e2 * sin_lat * cos_lat / w2;
+}
+
+void GpsHandler::LatLon2Local(
+  const double * lat, const double * lon, const double * h, double * rX, double * rY,
+  double * rZ, const std::size_t size, const BatchMode mode)
+{
+  if (!this->is_origin_set_) {
+    throw OriginNonSet();
+  }
+  // Constants are copied to locals, so the loops do not reload them after each store and can be
+  // vectorized by the compiler
+  const BatchConstants c = batch_;
+
+  if (mode == BatchMode::LocalTangentPlane) {
+    for (std::size_t i = 0; i < size; ++i) {
+      const double dh = h[i] - c.h0;
+      const double east =
+        c.east_scale * wrapLongitude(lon[i] - c.lon0) * (1.0 + dh * c.inv_east_radius);
+      const double north = c.north_scale * (lat[i] - c.lat0) * (1.0 + dh * c.inv_north_radius);
+      rX[i] = east - c.tan_lat0 * east * north * c.inv_east_radius;
+      rY[i] = north + 0.5 * c.tan_lat0 * east * east * c.inv_east_radius +
+        c.north_curvature * north * north * c.inv_north_radius;
+      rZ[i] = dh - 0.5 * (east * east * c.inv_east_radius + north * north * c.inv_north_radius);
+    }
+    return;
+  }
+
+  const double a = earth.EquatorialRadius();
+  const double e2 = earth.Flattening() * (2.0 - earth.Flattening());
+  for (std::size_t i = 0; i < size; ++i) {
+    const double sin_lat = std::sin(lat[i] * kDegToRad);
+    const double cos_lat = std::cos(lat[i] * kDegToRad);
+    const double sin_lon = std::sin(lon[i] * kDegToRad);
+    const double cos_lon = std::cos(lon[i] * kDegToRad);
+    const double n = a / std::sqrt(1.0 - e2 * sin_lat * sin_lat);
+    const double dx = (n + h[i]) * cos_lat * cos_lon - c.origin_ecef[0];
+    const double dy = (n + h[i]) * cos_lat * sin_lon - c.origin_ecef[1];
+    const double dz = (n * (1.0 - e2) + h[i]) * sin_lat - c.origin_ecef[2];
+    rX[i] = c.ecef_to_enu[0] * dx + c.ecef_to_enu[1] * dy;
+    rY[i] = c.ecef_to_enu[3] * dx + c.ecef_to_enu[4] * dy + c.ecef_to_enu[5] * dz;
+    rZ[i] = c.ecef_to_enu[6] * dx + c.ecef_to_enu[7] * dy + c.ecef_to_enu[8] * dz;
+  }
+}
+
+void GpsHandler::LatLon2Local(
+  const std::vector<double> & lat, const std::vector<double> & lon,
+  const std::vector<double> & h, std::vector<double> & rX, std::vector<double> & rY,
+  std::vector<double> & rZ, const BatchMode mode)
+{
+  checkBatchSizes(lat, lon, h);
+  rX.resize(lat.size());
+  rY.resize(lat.size());
+  rZ.resize(lat.size());
+  this->LatLon2Local(
+    lat.data(), lon.data(), h.data(), rX.data(), rY.data(), rZ.data(), lat.size(), mode);
+}
+
+void GpsHandler::Local2LatLon(
+  const double * x, const double * y, const double * z, double * rLat, double * rLon,
+  double * rH, const std::size_t size, const BatchMode mode)
+{
+  if (!this->is_origin_set_) {
+    throw OriginNonSet();
+  }
+  const BatchConstants c = batch_;
+
+  if (mode == BatchMode::LocalTangentPlane) {
+    // Inverse of the second order expansion
+    for (std::size_t i = 0; i < size; ++i) {
+      const double dh =
+        z[i] + 0.5 * (x[i] * x[i] * c.inv_east_radius + y[i] * y[i] * c.inv_north_radius);
+      const double north = y[i] - 0.5 * c.tan_lat0 * x[i] * x[i] * c.inv_east_radius -
+        c.north_curvature * y[i] * y[i] * c.inv_north_radius;
+      const double east = x[i] + c.tan_lat0 * x[i] * north * c.inv_east_radius;
+      rLat[i] = c.lat0 + north / (c.north_scale * (1.0 + dh * c.inv_north_radius));
+      rLon[i] = wrapLongitude(c.lon0 + east / (c.east_scale * (1.0 + dh * c.inv_east_radius)));
+      rH[i] = c.h0 + dh;
+    }
+    return;
+  }
+
+  const double a = earth.EquatorialRadius();
+  const double f = earth.Flattening();
+  const double e2 = f * (2.0 - f);
+  const double b = a * (1.0 - f);
+  const double ep2 = e2 / (1.0 - e2);
+  for (std::size_t i = 0; i < size; ++i) {
+    // Local to ECEF with the transposed rotation
+    const double ex =
+      c.ecef_to_enu[0] * x[i] + c.ecef_to_enu[3] * y[i] + c.ecef_to_enu[6] * z[i] +
+      c.origin_ecef[0];
+    const double ey =
+      c.ecef_to_enu[1] * x[i] + c.ecef_to_enu[4] * y[i] + c.ecef_to_enu[7] * z[i] +
+      c.origin_ecef[1];
+    const double ez = c.ecef_to_enu[5] * y[i] + c.ecef_to_enu[8] * z[i] + c.origin_ecef[2];
+    const double p = std::sqrt(ex * ex + ey * ey);
+
+    // Two Bowring iterations on the reduced latitude
+    double tan_beta = ez * a / (p * b);
+    double cos_beta = 1.0 / std::sqrt(1.0 + tan_beta * tan_beta);
+    double sin_beta = tan_beta * cos_beta;
+    double num = ez + ep2 * b * sin_beta * sin_beta * sin_beta;
+    double den = p - e2 * a * cos_beta * cos_beta * cos_beta;
+    tan_beta = (1.0 - f) * num / den;
+    cos_beta = 1.0 / std::sqrt(1.0 + tan_beta * tan_beta);
+    sin_beta = tan_beta * cos_beta;
+    num = ez + ep2 * b * sin_beta * sin_beta * sin_beta;
+    den = p - e2 * a * cos_beta * cos_beta * cos_beta;
+
+    const double inv_norm = 1.0 / std::sqrt(num * num + den * den);
+    const double sin_lat = num * inv_norm;
+    const double cos_lat = den * inv_norm;
+    rLat[i] = std::atan2(num, den) * kRadToDeg;
+    rLon[i] = std::atan2(ey, ex) * kRadToDeg;
+    rH[i] = p * cos_lat + ez * sin_lat - a * std::sqrt(1.0 - e2 * sin_lat * sin_lat);
+  }
+}
+
+void GpsHandler::Local2LatLon(
+  const std::vector<double> & x, const std::vector<double> & y,
+  const std::vector<double> & z, std::vector<double> & rLat, std::vector<double> & rLon,
+  std::vector<double> & rH, const BatchMode mode)
+{
+  checkBatchSizes(x, y, z);
+  rLat.resize(x.size());
+  rLon.resize(x.size());
+  rH.resize(x.size());
+  this->Local2LatLon(
+    x.data(), y.data(), z.data(), rLat.data(), rLon.data(), rH.data(), x.size(), mode);
+}
+
 // LAT LON ----> ECEF
 void GpsHandler::LatLon2Ecef(
   const double & lat, const double & lon, const double & h, double & rX, double & rY, double & rZ)
@@ -0,0 +1,208 @@
+// Copyright 2024 Universidad Politécnica de Madrid
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the Universidad Politécnica de Madrid nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/*!*******************************************************************************************
+ *  \file       shared_tf_buffer.cpp
+ *  \brief      Process-wide TF buffer implementation file.
+ *  \authors    Rafael Perez Segui
+ *              Miguel Fernandez Cortizas
+ ********************************************************************************/
+
+#include "as2_core/utils/shared_tf_buffer.hpp"
+
+#include <tf2_ros/create_timer_ros.h>
+#include <tf2_ros/qos.hpp>
+#include <unistd.h>
+
+namespace as2
+{
+namespace tf
+{
+
+namespace
+{
+constexpr char kAuthority[] = "as2_shared_tf_buffer";
+
+// Without leading '/' and with trailing '/', empty for no filter
+std::string normalizeFilter(const std::string & namespace_filter)
+{
+  std::string filter = namespace_filter;
+  while (!filter.empty() && filter.front() == '/') {
+    filter.erase(0, 1);
+  }
+  if (!filter.empty() && filter.back() != '/') {
+    filter.push_back('/');
+  }
+  return filter;
+}
+}  // namespace
+
+std::shared_ptr<tf2_ros::Buffer> SharedTfBuffer::getBuffer(
+  rclcpp::Node * node, const std::string & namespace_filter)
+{
+  auto context = node->get_node_base_interface()->get_context();
+  auto shared_tf_buffer = context->get_sub_context<SharedTfBuffer>(context);
+  return shared_tf_buffer->getBufferImpl(node, normalizeFilter(namespace_filter));
+}
+
+bool SharedTfBuffer::passesFilter(
+  const std::string & namespace_filter, const std::string & child_frame_id)
+{
+  if (namespace_filter.empty()) {
+    return true;
+  }
+  const size_t start = (!child_frame_id.empty() && child_frame_id.front() == '/') ? 1 : 0;
+  // Frames outside any namespace, such as earth, are kept
+  if (child_frame_id.find('/', start) == std::string::npos) {
+    return true;
+  }
+  return child_frame_id.compare(start, namespace_filter.size(), namespace_filter) == 0;
+}
+
+SharedTfBuffer::SharedTfBuffer(rclcpp::Context::SharedPtr context)
+: context_(context) {}
+
+SharedTfBuffer::~SharedTfBuffer()
+{
+  if (auto context = context_.lock()) {
+    context->remove_on_shutdown_callback(on_shutdown_handle_);
+  }
+  stopListener();
+}
+
+void SharedTfBuffer::stopListener()
+{
+  // Joined without the mutex, the listener thread takes it in tfCallback
+  if (executor_) {
+    executor_->cancel();
+  }
+  if (listener_thread_.joinable()) {
+    listener_thread_.join();
+  }
+
+  // The listener node holds the context, release it so the context can be destroyed
+  std::lock_guard<std::mutex> lock(mutex_);
+  shutdown_ = true;
+  tf_sub_.reset();
+  tf_static_sub_.reset();
+  executor_.reset();
+  listener_node_.reset();
+}
+
+std::shared_ptr<tf2_ros::Buffer> SharedTfBuffer::getBufferImpl(
+  rclcpp::Node * node, const std::string & namespace_filter)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!listener_node_ && !shutdown_) {
+    if (auto context = context_.lock()) {
+      startListener(node, context);
+    }
+  }
+
+  auto it = buffers_.find(namespace_filter);
+  if (it != buffers_.end()) {
+    if (auto buffer = it->second.lock()) {
+      return buffer;
+    }
+  }
+
+  auto buffer = std::make_shared<tf2_ros::Buffer>(node->get_clock());
+  if (listener_node_) {
+    buffer->setCreateTimerInterface(
+      std::make_shared<tf2_ros::CreateTimerROS>(
+        listener_node_->get_node_base_interface(), listener_node_->get_node_timers_interface()));
+  }
+  for (const auto & [child_frame_id, transform] : static_transforms_) {
+    if (passesFilter(namespace_filter, child_frame_id)) {
+      buffer->setTransform(transform, kAuthority, true);
+    }
+  }
+  buffers_[namespace_filter] = buffer;
+  return buffer;
+}
+
+void SharedTfBuffer::startListener(rclcpp::Node * node, rclcpp::Context::SharedPtr context)
+{
+  // Same clock source as the first node, and no parameter services, as tf2_ros listeners do
+  bool use_sim_time = false;
+  if (node->has_parameter("use_sim_time")) {
+    node->get_parameter("use_sim_time", use_sim_time);
+  }
+  listener_node_ = std::make_shared<rclcpp::Node>(
+    "as2_shared_tf_buffer_" + std::to_string(getpid()),
+    rclcpp::NodeOptions()
+    .context(context)
+    .start_parameter_services(false)
+    .start_parameter_event_publisher(false)
+    .parameter_overrides({{"use_sim_time", use_sim_time}}));
+
+  tf_sub_ = listener_node_->create_subscription<tf2_msgs::msg::TFMessage>(
+    "/tf", tf2_ros::DynamicListenerQoS(),
+    [this](const tf2_msgs::msg::TFMessage::SharedPtr msg) {tfCallback(msg, false);});
+  tf_static_sub_ = listener_node_->create_subscription<tf2_msgs::msg::TFMessage>(
+    "/tf_static", tf2_ros::StaticListenerQoS(),
+    [this](const tf2_msgs::msg::TFMessage::SharedPtr msg) {tfCallback(msg, true);});
+
+  rclcpp::ExecutorOptions executor_options;
+  executor_options.context = context;
+  executor_ = std::make_shared<rclcpp::executors::SingleThreadedExecutor>(executor_options);
+  executor_->add_node(listener_node_);
+  listener_thread_ = std::thread([this]() {executor_->spin();});
+
+  on_shutdown_handle_ = context->add_on_shutdown_callback([this]() {stopListener();});
+}
+
+void SharedTfBuffer::tfCallback(
+  const tf2_msgs::msg::TFMessage::SharedPtr msg, const bool is_static)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::vector<std::pair<const std::string *, std::shared_ptr<tf2_ros::Buffer>>> buffers;
+  buffers.reserve(buffers_.size());
+  for (auto it = buffers_.begin(); it != buffers_.end(); ) {
+    if (auto buffer = it->second.lock()) {
+      buffers.emplace_back(&it->first, buffer);
+      ++it;
+    } else {
+      it = buffers_.erase(it);
+    }
+  }
+
+  for (const auto & transform : msg->transforms) {
+    if (is_static) {
+      static_transforms_[transform.child_frame_id] = transform;
+    }
+    for (const auto & [namespace_filter, buffer] : buffers) {
+      if (passesFilter(*namespace_filter, transform.child_frame_id)) {
+        buffer->setTransform(transform, kAuthority, is_static);
+      }
+    }
+  }
+}
+
+}  // namespace tf
+}  // namespace as2
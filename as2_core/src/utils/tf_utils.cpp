@@ -34,6 +34,13 @@
 
 #include "as2_core/utils/tf_utils.hpp"
 
+#include <tf2/LinearMath/Quaternion.h>
+#include <tf2/LinearMath/Vector3.h>
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+
 namespace as2
 {
 namespace tf
@@ -101,19 +108,50 @@ geometry_msgs::msg::TransformStamped getTransformation(
 TfHandler::TfHandler(as2::Node * _node)
 : node_(_node)
 {
-  tf_buffer_ = std::make_shared<tf2_ros::Buffer>(_node->get_clock());
-  auto timer_interface = std::make_shared<tf2_ros::CreateTimerROS>(
-    _node->get_node_base_interface(), _node->get_node_timers_interface());
-  tf_buffer_->setCreateTimerInterface(timer_interface);
-  tf_listener_ = std::make_shared<tf2_ros::TransformListener>(*tf_buffer_);
+  // Read tf_shared_buffer and tf_namespace_filter from the parameter server
+  bool tf_shared_buffer = false;
+  bool tf_namespace_filter = false;
+  if (!node_->has_parameter("tf_shared_buffer")) {
+    node_->declare_parameter("tf_shared_buffer", tf_shared_buffer);
+  }
+  if (!node_->has_parameter("tf_namespace_filter")) {
+    node_->declare_parameter("tf_namespace_filter", tf_namespace_filter);
+  }
+  node_->get_parameter("tf_shared_buffer", tf_shared_buffer);
+  node_->get_parameter("tf_namespace_filter", tf_namespace_filter);
 
+  if (tf_shared_buffer) {
+    // Fed by the process-wide listener, no TransformListener per node
+    tf_buffer_ = SharedTfBuffer::getBuffer(
+      _node, tf_namespace_filter ? std::string(_node->get_namespace()) : std::string());
+  } else {
+    tf_buffer_ = std::make_shared<tf2_ros::Buffer>(_node->get_clock());
+    auto timer_interface = std::make_shared<tf2_ros::CreateTimerROS>(
+      _node->get_node_base_interface(), _node->get_node_timers_interface());
+    tf_buffer_->setCreateTimerInterface(timer_interface);
+    tf_listener_ = std::make_shared<tf2_ros::TransformListener>(*tf_buffer_);
+  }
+  readTfTimeoutThreshold();
+}
+
+TfHandler::TfHandler(as2::Node * _node, std::shared_ptr<tf2_ros::Buffer> _tf_buffer)
+: tf_buffer_(_tf_buffer), node_(_node)
+{
+  if (!tf_buffer_) {
+    throw std::invalid_argument("TfHandler: shared tf buffer is null");
+  }
+  readTfTimeoutThreshold();
+}
+
+void TfHandler::readTfTimeoutThreshold()
+{
   // Read tf_timeout_threshold from the parameter server
   double tf_timeout_threshold = 0.05;
-  if (!_node->has_parameter("tf_timeout_threshold")) {
+  if (!node_->has_parameter("tf_timeout_threshold")) {
     // Declare the parameter
-    _node->declare_parameter("tf_timeout_threshold", tf_timeout_threshold);
+    node_->declare_parameter("tf_timeout_threshold", tf_timeout_threshold);
   }
-  _node->get_parameter("tf_timeout_threshold", tf_timeout_threshold);
+  node_->get_parameter("tf_timeout_threshold", tf_timeout_threshold);
   setTfTimeoutThreshold(tf_timeout_threshold);
 }
 
@@ -259,5 +297,45 @@ std::pair<geometry_msgs::msg::PoseStamped, geometry_msgs::msg::TwistStamped> TfH
     _twist, _twist_target_frame, _pose_target_frame, _pose_source_frame, tf_timeout_threshold_);
 }
 
+std::pair<geometry_msgs::msg::PoseStamped, geometry_msgs::msg::TwistStamped> TfHandler::getState(
+  const nav_msgs::msg::Odometry & _odom, const std::string & _twist_target_frame,
+  const std::string & _pose_target_frame, const std::chrono::nanoseconds _timeout)
+{
+  geometry_msgs::msg::PoseStamped pose;
+  pose.header = _odom.header;
+  pose.pose = _odom.pose.pose;
+
+  geometry_msgs::msg::TwistStamped twist;
+  twist.header.stamp = _odom.header.stamp;
+  twist.header.frame_id = _odom.child_frame_id;
+  twist.twist = _odom.twist.twist;
+
+  if (_twist_target_frame == _odom.header.frame_id) {
+    // The odometry orientation is the rotation from the child frame, no lookup needed
+    const auto & q = pose.pose.orientation;
+    const auto & v = twist.twist.linear;
+    const tf2::Vector3 linear =
+      tf2::quatRotate(tf2::Quaternion(q.x, q.y, q.z, q.w), tf2::Vector3(v.x, v.y, v.z));
+    twist.header.frame_id = _twist_target_frame;
+    twist.twist.linear.x = linear.x();
+    twist.twist.linear.y = linear.y();
+    twist.twist.linear.z = linear.z();
+  } else if (_twist_target_frame != _odom.child_frame_id) {
+    twist = convert(twist, _twist_target_frame, _timeout);
+  }
+
+  if (_pose_target_frame != pose.header.frame_id) {
+    pose = convert(pose, _pose_target_frame, _timeout);
+  }
+  return std::make_pair(pose, twist);
+}
+
+std::pair<geometry_msgs::msg::PoseStamped, geometry_msgs::msg::TwistStamped> TfHandler::getState(
+  const nav_msgs::msg::Odometry & _odom, const std::string & _twist_target_frame,
+  const std::string & _pose_target_frame)
+{
+  return getState(_odom, _twist_target_frame, _pose_target_frame, tf_timeout_threshold_);
+}
+
 }  // namespace tf
 }  // namespace as2
@@ -0,0 +1,218 @@
+// Copyright 2023 Universidad Politécnica de Madrid
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the Universidad Politécnica de Madrid nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/*!*******************************************************************************************
+ *  \file       gps_utils_gtest.cpp
+ *  \brief      Test file for the gps_utils batch conversions
+ *  \authors    Rafael Pérez Seguí
+ *              Pedro Arias Pérez
+ ********************************************************************************/
+
+#include "as2_core/utils/gps_utils.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace as2
+{
+namespace gps
+{
+
+// Local points within radius (m) of the origin
+void randomLocalPoints(
+  const double radius, const std::size_t size, std::vector<double> & x,
+  std::vector<double> & y, std::vector<double> & z)
+{
+  std::mt19937 generator(42);
+  std::uniform_real_distribution<double> distribution(-1.0, 1.0);
+  x.resize(size);
+  y.resize(size);
+  z.resize(size);
+  for (std::size_t i = 0; i < size; ++i) {
+    const double r = radius * std::sqrt(std::abs(distribution(generator)));
+    const double angle = M_PI * distribution(generator);
+    x[i] = r * std::cos(angle);
+    y[i] = r * std::sin(angle);
+    z[i] = 300.0 * distribution(generator);
+  }
+}
+
+TEST(GpsUtilsTest, BatchExactMatchesSinglePoint) {
+  GpsHandler gps_handler(40.4405287, -3.6883193, 650.0);
+  std::vector<double> x, y, z;
+  randomLocalPoints(20000.0, 1000, x, y, z);
+
+  std::vector<double> lat, lon, h;
+  gps_handler.Local2LatLon(x, y, z, lat, lon, h);
+  std::vector<double> rx, ry, rz;
+  gps_handler.LatLon2Local(lat, lon, h, rx, ry, rz);
+
+  for (std::size_t i = 0; i < x.size(); ++i) {
+    double single_lat, single_lon, single_h;
+    gps_handler.Local2LatLon(x[i], y[i], z[i], single_lat, single_lon, single_h);
+    EXPECT_NEAR(lat[i], single_lat, 1e-10);
+    EXPECT_NEAR(lon[i], single_lon, 1e-10);
+    EXPECT_NEAR(h[i], single_h, 1e-6);
+
+    double single_x, single_y, single_z;
+    gps_handler.LatLon2Local(lat[i], lon[i], h[i], single_x, single_y, single_z);
+    EXPECT_NEAR(rx[i], single_x, 1e-6);
+    EXPECT_NEAR(ry[i], single_y, 1e-6);
+    EXPECT_NEAR(rz[i], single_z, 1e-6);
+    EXPECT_NEAR(rx[i], x[i], 1e-6);
+    EXPECT_NEAR(ry[i], y[i], 1e-6);
+    EXPECT_NEAR(rz[i], z[i], 1e-6);
+  }
+}
+
+TEST(GpsUtilsTest, BatchLocalTangentPlaneErrorBound) {
+  GpsHandler gps_handler(40.4405287, -3.6883193, 650.0);
+  // Documented bounds against the exact conversion
+  const std::vector<std::pair<double, double>> bounds = {{2000.0, 1e-3}, {10000.0, 5e-2}};
+  for (const auto & [radius, bound] : bounds) {
+    std::vector<double> x, y, z;
+    randomLocalPoints(radius, 1000, x, y, z);
+
+    std::vector<double> lat, lon, h;
+    gps_handler.Local2LatLon(x, y, z, lat, lon, h);
+    std::vector<double> rx, ry, rz;
+    gps_handler.LatLon2Local(lat, lon, h, rx, ry, rz, BatchMode::LocalTangentPlane);
+
+    std::vector<double> approx_lat, approx_lon, approx_h;
+    gps_handler.Local2LatLon(
+      x, y, z, approx_lat, approx_lon, approx_h, BatchMode::LocalTangentPlane);
+    std::vector<double> ex, ey, ez;
+    gps_handler.LatLon2Local(approx_lat, approx_lon, approx_h, ex, ey, ez);
+
+    for (std::size_t i = 0; i < x.size(); ++i) {
+      EXPECT_LT(std::hypot(rx[i] - x[i], ry[i] - y[i], rz[i] - z[i]), bound);
+      EXPECT_LT(std::hypot(ex[i] - x[i], ey[i] - y[i], ez[i] - z[i]), bound);
+    }
+  }
+}
+
+TEST(GpsUtilsTest, BatchLocalTangentPlaneAntimeridian) {
+  // Origin a few hundred meters west of the antimeridian, points on both sides of it
+  GpsHandler gps_handler(-16.5, 179.995, 10.0);
+  std::vector<double> x, y, z;
+  randomLocalPoints(2000.0, 1000, x, y, z);
+
+  std::vector<double> lat, lon, h;
+  gps_handler.Local2LatLon(x, y, z, lat, lon, h);
+  std::vector<double> rx, ry, rz;
+  gps_handler.LatLon2Local(lat, lon, h, rx, ry, rz, BatchMode::LocalTangentPlane);
+
+  std::vector<double> approx_lat, approx_lon, approx_h;
+  gps_handler.Local2LatLon(
+    x, y, z, approx_lat, approx_lon, approx_h, BatchMode::LocalTangentPlane);
+
+  bool crosses = false;
+  for (std::size_t i = 0; i < x.size(); ++i) {
+    crosses |= lon[i] < 0.0;
+    EXPECT_GE(approx_lon[i], -180.0);
+    EXPECT_LT(approx_lon[i], 180.0);
+    EXPECT_NEAR(approx_lon[i], lon[i], 1e-7);
+    EXPECT_LT(std::hypot(rx[i] - x[i], ry[i] - y[i], rz[i] - z[i]), 1e-3);
+  }
+  EXPECT_TRUE(crosses);
+}
+
+// Best of several runs of f, in seconds
+template<typename F>
+double bestTime(F && f)
+{
+  double best = std::numeric_limits<double>::max();
+  for (int run = 0; run < 25; ++run) {
+    const auto start = std::chrono::steady_clock::now();
+    f();
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    best = std::min(best, elapsed.count());
+  }
+  return best;
+}
+
+TEST(GpsUtilsTest, BatchThroughput) {
+#ifndef NDEBUG
+  GTEST_SKIP() << "Throughput is only meaningful in optimized builds";
+#endif
+  GpsHandler gps_handler(40.4405287, -3.6883193, 650.0);
+  std::vector<double> x, y, z;
+  randomLocalPoints(2000.0, 10000, x, y, z);
+  std::vector<double> lat, lon, h;
+  gps_handler.Local2LatLon(x, y, z, lat, lon, h);
+
+  std::vector<double> rx(x.size()), ry(x.size()), rz(x.size());
+  const double single_time = bestTime(
+    [&]() {
+      for (std::size_t i = 0; i < lat.size(); ++i) {
+        gps_handler.LatLon2Local(lat[i], lon[i], h[i], rx[i], ry[i], rz[i]);
+      }
+    });
+  const double exact_time = bestTime(
+    [&]() {gps_handler.LatLon2Local(lat, lon, h, rx, ry, rz, BatchMode::Exact);});
+  const double ltp_time = bestTime(
+    [&]() {gps_handler.LatLon2Local(lat, lon, h, rx, ry, rz, BatchMode::LocalTangentPlane);});
+
+  const double exact_ratio = single_time / exact_time;
+  const double ltp_ratio = single_time / ltp_time;
+  RecordProperty("exact_speedup", std::to_string(exact_ratio));
+  RecordProperty("local_tangent_plane_speedup", std::to_string(ltp_ratio));
+  EXPECT_GE(exact_ratio, 1.0);
+  EXPECT_GE(ltp_ratio, 10.0);
+}
+
+TEST(GpsUtilsTest, BatchErrors) {
+  GpsHandler gps_handler;
+  std::vector<double> x = {0.0, 1.0};
+  std::vector<double> y = {0.0, 1.0};
+  std::vector<double> z = {0.0, 1.0};
+  std::vector<double> lat, lon, h;
+  EXPECT_THROW(gps_handler.Local2LatLon(x, y, z, lat, lon, h), OriginNonSet);
+
+  gps_handler.setOrigin(40.4405287, -3.6883193, 650.0);
+  z.pop_back();
+  EXPECT_THROW(gps_handler.Local2LatLon(x, y, z, lat, lon, h), std::invalid_argument);
+  EXPECT_THROW(gps_handler.LatLon2Local(x, y, z, lat, lon, h), std::invalid_argument);
+
+  // Empty batches are valid
+  x.clear();
+  y.clear();
+  z.clear();
+  EXPECT_NO_THROW(gps_handler.LatLon2Local(x, y, z, lat, lon, h));
+  EXPECT_TRUE(lat.empty());
+}
+
+}  // namespace gps
+}  // namespace as2
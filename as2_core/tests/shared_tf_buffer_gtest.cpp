@@ -0,0 +1,110 @@
+// Copyright 2024 Universidad Politécnica de Madrid
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the Universidad Politécnica de Madrid nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/*!*******************************************************************************************
+ *  \file       shared_tf_buffer_gtest.cpp
+ *  \brief      Test file for the process-wide shared TF buffer
+ *  \authors    Rafael Pérez Seguí
+ *              Miguel Fernández Cortizas
+ ********************************************************************************/
+
+#include "as2_core/utils/shared_tf_buffer.hpp"
+
+#include <memory>
+#include <string>
+
+#include "as2_core/node.hpp"
+#include "as2_core/utils/tf_utils.hpp"
+#include "gtest/gtest.h"
+
+namespace as2
+{
+namespace tf
+{
+
+TEST(SharedTfBufferTest, NamespaceFilter) {
+  EXPECT_TRUE(SharedTfBuffer::passesFilter("", "drone0/base_link"));
+  EXPECT_TRUE(SharedTfBuffer::passesFilter("drone0/", "drone0/base_link"));
+  EXPECT_TRUE(SharedTfBuffer::passesFilter("drone0/", "/drone0/odom"));
+  EXPECT_TRUE(SharedTfBuffer::passesFilter("drone0/", "earth"));
+  EXPECT_FALSE(SharedTfBuffer::passesFilter("drone0/", "drone1/base_link"));
+  EXPECT_FALSE(SharedTfBuffer::passesFilter("drone0/", "drone01/base_link"));
+}
+
+TEST(SharedTfBufferTest, SameBufferPerFilter) {
+  auto node_a = std::make_shared<as2::Node>("shared_tf_a", "drone0");
+  auto node_b = std::make_shared<as2::Node>("shared_tf_b", "drone0");
+  auto node_c = std::make_shared<as2::Node>("shared_tf_c", "drone1");
+
+  auto buffer_a = SharedTfBuffer::getBuffer(node_a.get(), node_a->get_namespace());
+  auto buffer_b = SharedTfBuffer::getBuffer(node_b.get(), node_b->get_namespace());
+  auto buffer_c = SharedTfBuffer::getBuffer(node_c.get(), node_c->get_namespace());
+  auto buffer_all = SharedTfBuffer::getBuffer(node_a.get());
+
+  EXPECT_EQ(buffer_a, buffer_b);
+  EXPECT_NE(buffer_a, buffer_c);
+  EXPECT_NE(buffer_a, buffer_all);
+}
+
+TEST(SharedTfBufferTest, TfHandlerParameters) {
+  rclcpp::NodeOptions options;
+  options.parameter_overrides({{"tf_shared_buffer", true}, {"tf_namespace_filter", true}});
+  auto node_a = std::make_shared<as2::Node>("shared_tf_handler_a", "drone0", options);
+  auto node_b = std::make_shared<as2::Node>("shared_tf_handler_b", "drone0", options);
+
+  TfHandler tf_handler_a(node_a.get());
+  TfHandler tf_handler_b(node_b.get());
+  EXPECT_EQ(tf_handler_a.getTfBuffer(), tf_handler_b.getTfBuffer());
+}
+
+TEST(SharedTfBufferTest, ReleasedWithContext) {
+  auto context = std::make_shared<rclcpp::Context>();
+  context->init(0, nullptr);
+  std::weak_ptr<rclcpp::Context> weak_context = context;
+  {
+    auto node = std::make_shared<as2::Node>(
+      "shared_tf_context", "drone0", rclcpp::NodeOptions().context(context));
+    auto buffer = SharedTfBuffer::getBuffer(node.get(), node->get_namespace());
+    EXPECT_TRUE(buffer);
+  }
+  context->shutdown("test finished");
+  context.reset();
+  EXPECT_TRUE(weak_context.expired());
+}
+
+}  // namespace tf
+}  // namespace as2
+
+int main(int argc, char * argv[])
+{
+  ::testing::InitGoogleTest(&argc, argv);
+  rclcpp::init(argc, argv);
+  auto result = RUN_ALL_TESTS();
+  rclcpp::shutdown();
+  return result;
+}
@@ -36,6 +36,8 @@
 
 #include "as2_core/utils/tf_utils.hpp"
 
+#include <cmath>
+
 #include <tf2_ros/static_transform_broadcaster.h>
 
 #include <std_msgs/msg/bool.hpp>
@@ -165,6 +167,23 @@ TEST(TFHandlerTest, TfHandler) {
     tf_handler->getState(twist, parent_frame_id, parent_frame_id, frame_id, timeout));
   EXPECT_NO_THROW(
     tf_handler->getState(twist, parent_frame_id, parent_frame_id, frame_id));
+
+  // Odometry in its own frames is rotated without lookups
+  nav_msgs::msg::Odometry odom;
+  odom.header.frame_id = parent_frame_id;
+  odom.child_frame_id = frame_id;
+  odom.pose.pose.orientation.z = std::sqrt(0.5);
+  odom.pose.pose.orientation.w = std::sqrt(0.5);
+  odom.twist.twist.linear.x = 1.0;
+  auto [odom_pose, odom_twist] = tf_handler->getState(odom, parent_frame_id, parent_frame_id);
+  EXPECT_EQ(odom_pose.header.frame_id, parent_frame_id);
+  EXPECT_EQ(odom_twist.header.frame_id, parent_frame_id);
+  EXPECT_NEAR(odom_twist.twist.linear.x, 0.0, 1e-9);
+  EXPECT_NEAR(odom_twist.twist.linear.y, 1.0, 1e-9);
+  auto [base_pose, base_twist] = tf_handler->getState(odom, frame_id, parent_frame_id);
+  EXPECT_EQ(base_twist.header.frame_id, frame_id);
+  EXPECT_NEAR(base_twist.twist.linear.x, 1.0, 1e-9);
+  EXPECT_NO_THROW(tf_handler->getState(odom, parent_frame_id, frame_id, timeout));
 }
 
 }  // namespace tf
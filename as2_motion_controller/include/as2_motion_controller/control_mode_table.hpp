@@ -0,0 +1,116 @@
+// Copyright 2024 Universidad Politécnica de Madrid
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the Universidad Politécnica de Madrid nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/*!*******************************************************************************************
+ *  \file       control_mode_table.hpp
+ *  \brief      Precomputed control mode compatibility table definition
+ *  \authors    Miguel Fernández Cortizas
+ *              Rafael Pérez Seguí
+ ********************************************************************************************/
+
+#ifndef AS2_MOTION_CONTROLLER__CONTROL_MODE_TABLE_HPP_
+#define AS2_MOTION_CONTROLLER__CONTROL_MODE_TABLE_HPP_
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace controller_handler
+{
+
+#define MATCH_ALL 0b11111111
+#define MATCH_MODE_AND_FRAME 0b11110011
+#define MATCH_MODE 0b11110000
+#define MATCH_MODE_AND_YAW 0b11111100
+
+#define UNSET_MODE_MASK 0b00000000
+#define HOVER_MODE_MASK 0b00010000
+
+/**
+ * @brief Resolution of a requested control mode against the controller and platform modes
+ */
+struct ControlModeResolution
+{
+  enum class Status : uint8_t
+  {
+    OK = 0,
+    NO_OUTPUT_MODE,      // No common output mode between controller and platform
+    INPUT_NOT_AVAILABLE,  // Requested mode is not an input mode of the controller
+    INPUT_LOWER_LEVEL,   // Input mode has lower level than the output mode
+  };
+
+  // Resolution using the controller plugin
+  Status status = Status::NO_OUTPUT_MODE;
+  uint8_t input_mode = 0;
+  uint8_t output_mode = 0;
+
+  // Resolution sending the reference directly to the platform
+  bool bypass_available = false;
+  uint8_t bypass_output_mode = 0;
+};
+
+/**
+ * @brief Table with the resolution of every uint8_t control mode, built once for a given set of
+ * controller and platform modes so that a mode switch is a single lookup
+ */
+class ControlModeTable
+{
+public:
+  /**
+   * @brief Compute the resolution for the 256 possible requested modes
+   * @param controller_modes_in controller input modes, sorted in ascending order
+   * @param controller_modes_out controller output modes, sorted in ascending order
+   * @param platform_modes_in platform input modes
+   * @param prefered_output_mode output mode to use if the platform supports it, 0 for none
+   */
+  void build(
+    const std::vector<uint8_t> & controller_modes_in,
+    const std::vector<uint8_t> & controller_modes_out,
+    const std::vector<uint8_t> & platform_modes_in,
+    const uint8_t prefered_output_mode = 0);
+
+  /**
+   * @brief Invalidate the table, e.g. when the platform modes are no longer valid
+   */
+  void clear() {built_ = false;}
+
+  bool isBuilt() const {return built_;}
+
+  const ControlModeResolution & lookup(const uint8_t requested_mode) const
+  {
+    return table_[requested_mode];
+  }
+
+private:
+  std::array<ControlModeResolution, 256> table_;
+  bool built_ = false;
+};
+
+}  // namespace controller_handler
+
+#endif  // AS2_MOTION_CONTROLLER__CONTROL_MODE_TABLE_HPP_
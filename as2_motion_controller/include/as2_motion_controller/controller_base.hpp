@@ -42,6 +42,7 @@
 #include <rclcpp/rclcpp.hpp>
 #include <geometry_msgs/msg/pose_stamped.hpp>
 #include <geometry_msgs/msg/twist_stamped.hpp>
+#include <geometry_msgs/msg/vector3.hpp>
 
 #include "as2_core/node.hpp"
 #include "as2_msgs/msg/control_mode.hpp"
@@ -148,6 +149,24 @@ public:
    */
   virtual void reset() = 0;
 
+  /*
+   * @brief Export the integral state of the controller for a bumpless transfer to another
+   * controller plugin
+   * @param integral geometry_msgs::msg::Vector3 with the acceleration (m/s^2) that the integral
+   * terms are currently adding, in the "odom" frame
+   * @return bool true if the controller has integral state to export, false otherwise
+   */
+  virtual bool getIntegralState(geometry_msgs::msg::Vector3 & integral) {return false;}
+
+  /*
+   * @brief Initialize the integral state of the controller when it takes over from another
+   * controller plugin, so its first output continues the previous one
+   * @param integral geometry_msgs::msg::Vector3 with the acceleration (m/s^2) that the integral
+   * terms must add, in the "odom" frame
+   * @return bool true if the integral state was set, false if it is not supported
+   */
+  virtual bool setIntegralState(const geometry_msgs::msg::Vector3 & integral) {return false;}
+
   /*
    * @brief Get the desired frame_id of the state and reference pose msgs
    * By default it is "odom"
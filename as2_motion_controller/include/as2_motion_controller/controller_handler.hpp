@@ -46,8 +46,10 @@
 #include <chrono>
 #include <cstdint>
 #include <fstream>
+#include <mutex>
 #include <vector>
 #include <string>
+#include <utility>
 #include <rclcpp/clock.hpp>
 #include <rclcpp/logging.hpp>
 #include <rclcpp/rate.hpp>
@@ -55,6 +57,8 @@
 #include <rclcpp/timer.hpp>
 #include <geometry_msgs/msg/pose_stamped.hpp>
 #include <geometry_msgs/msg/twist_stamped.hpp>
+#include <nav_msgs/msg/odometry.hpp>
+#include <std_msgs/msg/float64.hpp>
 
 #include "as2_core/names/services.hpp"
 #include "as2_core/names/topics.hpp"
@@ -68,37 +72,73 @@
 #include "as2_msgs/msg/trajectory_setpoints.hpp"
 #include "as2_msgs/srv/list_control_modes.hpp"
 #include "as2_msgs/srv/set_control_mode.hpp"
+#include "as2_msgs/srv/set_controller.hpp"
 
 #include "controller_base.hpp"
+#include "control_mode_table.hpp"
 
 namespace controller_handler
 {
 
-#define MATCH_ALL 0b11111111
-#define MATCH_MODE_AND_FRAME 0b11110011
-#define MATCH_MODE 0b11110000
-#define MATCH_MODE_AND_YAW 0b11111100
-
-#define UNSET_MODE_MASK 0b00000000
-#define HOVER_MODE_MASK 0b00010000
-
 using namespace std::chrono_literals; // NOLINT
 
 class ControllerHandler
 {
 public:
+  /**
+   * @brief Construct a new Controller Handler
+   * @param controller controller plugin instance
+   * @param node node where the handler creates its interfaces
+   * @param tf_buffer optional tf2_ros::Buffer shared with other handlers in the same process. If
+   * null, the handler creates its own buffer and listener
+   * @param external_control_step if true, no control timer is created and the owner must call
+   * controlStep() at the command frequency
+   */
   ControllerHandler(
     std::shared_ptr<as2_motion_controller_plugin_base::ControllerBase> controller,
-    as2::Node * node);
+    as2::Node * node,
+    std::shared_ptr<tf2_ros::Buffer> tf_buffer = nullptr,
+    bool external_control_step = false);
 
   virtual ~ControllerHandler() {}
 
+  /**
+   * @brief Run one control iteration. Called from the control timer, or by the owner when the
+   * handler was built with external_control_step. No command is sent while the platform control
+   * mode is being changed, those steps are counted and reported when the switch ends
+   */
+  void controlStep();
+
   rcl_interfaces::msg::SetParametersResult parametersCallback(
     const std::vector<rclcpp::Parameter> & parameters);
 
   void getMode(as2_msgs::msg::ControlMode & mode_in, as2_msgs::msg::ControlMode & mode_out);
   void setInputControlModesAvailables(const std::vector<uint8_t> & available_modes);
   void setOutputControlModesAvailables(const std::vector<uint8_t> & available_modes);
+  void setPlatformControlModesAvailables(const std::vector<uint8_t> & available_modes);
+
+  /**
+   * @brief Set the name of the controller plugin given in the constructor
+   * @param name plugin name
+   */
+  void setActiveControllerName(const std::string & name);
+
+  /**
+   * @brief Add a preloaded controller plugin that is kept warm, receiving state updates, so the
+   * handler can switch to it through the set_controller service
+   * @param name plugin name
+   * @param controller initialized controller plugin instance
+   * @param available_modes_in controller input modes
+   * @param available_modes_out controller output modes
+   * @param parameters_prefix prefix of the node parameters for this plugin. The prefix is
+   * removed before passing the parameters to the plugin
+   */
+  void addStandbyController(
+    const std::string & name,
+    std::shared_ptr<as2_motion_controller_plugin_base::ControllerBase> controller,
+    const std::vector<uint8_t> & available_modes_in,
+    const std::vector<uint8_t> & available_modes_out,
+    const std::string & parameters_prefix);
 
   void reset();
 
@@ -106,11 +146,28 @@ protected:
   as2::Node * node_ptr_;
 
 private:
+  struct StandbyController
+  {
+    std::string name;
+    std::string parameters_prefix;
+    std::shared_ptr<as2_motion_controller_plugin_base::ControllerBase> controller;
+    std::vector<uint8_t> available_modes_in;
+    std::vector<uint8_t> available_modes_out;
+    std::string pose_frame_id;
+    std::string twist_frame_id;
+    bool state_adquired = false;
+    geometry_msgs::msg::PoseStamped state_pose;
+    geometry_msgs::msg::TwistStamped state_twist;
+  };
+
   // Control modes availables
   std::vector<uint8_t> controller_available_modes_in_;
   std::vector<uint8_t> controller_available_modes_out_;
   std::vector<uint8_t> platform_available_modes_in_;
 
+  // Resolution of every requested mode, rebuilt when any of the mode lists changes
+  ControlModeTable control_mode_table_;
+
   // Frame ids
   std::string enu_frame_id_ = "odom";
   std::string flu_frame_id_ = "base_link";
@@ -124,6 +181,7 @@ private:
 
   // Subscribers
   rclcpp::Subscription<geometry_msgs::msg::TwistStamped>::SharedPtr twist_sub_;
+  rclcpp::Subscription<nav_msgs::msg::Odometry>::SharedPtr odometry_sub_;
   rclcpp::Subscription<geometry_msgs::msg::PoseStamped>::SharedPtr ref_pose_sub_;
   rclcpp::Subscription<geometry_msgs::msg::TwistStamped>::SharedPtr ref_twist_sub_;
   rclcpp::Subscription<as2_msgs::msg::TrajectorySetpoints>::SharedPtr ref_traj_sub_;
@@ -135,9 +193,11 @@ private:
   rclcpp::Publisher<as2_msgs::msg::Thrust>::SharedPtr thrust_pub_;
   rclcpp::Publisher<geometry_msgs::msg::PoseStamped>::SharedPtr pose_pub_;
   rclcpp::Publisher<geometry_msgs::msg::TwistStamped>::SharedPtr twist_pub_;
+  rclcpp::Publisher<std_msgs::msg::Float64>::SharedPtr mode_switch_latency_pub_;
 
   // Services servers
   rclcpp::Service<as2_msgs::srv::SetControlMode>::SharedPtr set_control_mode_srv_;
+  rclcpp::Service<as2_msgs::srv::SetController>::SharedPtr set_controller_srv_;
 
   // Services clients
   as2::SynchronousServiceClient<as2_msgs::srv::SetControlMode>::SharedPtr set_control_mode_client_;
@@ -147,14 +207,29 @@ private:
   // Timers
   rclcpp::TimerBase::SharedPtr control_timer_;
 
+  // Parameters callback
+  rclcpp::node_interfaces::OnSetParametersCallbackHandle::SharedPtr parameters_callback_handle_;
+
+  // Serializes callbacks with controlStep() when it is called from a thread outside the node
+  // executor. Released during the platform service calls of a mode switch
+  std::mutex mutex_;
+  // Serializes the control mode and controller switches
+  std::mutex mode_switch_mutex_;
+
   // Internal variables
   bool control_mode_established_ = false;
   bool motion_reference_adquired_ = false;
   bool state_adquired_ = false;
   bool use_bypass_ = false;
+  bool bypass_pass_through_ = true;
+  bool use_odometry_ = false;
+  bool reference_passed_through_ = false;
   bool bypass_controller_ = false;
+  bool mode_switch_in_progress_ = false;
+  size_t skipped_control_steps_ = 0;
 
   uint8_t prefered_output_mode_ = 0b00000000;  // by default, no output mode is prefered
+  uint8_t requested_control_mode_ = UNSET_MODE_MASK;
 
   rclcpp::Time last_time_;
 
@@ -174,13 +249,19 @@ private:
 
   // Controller plugin
   std::shared_ptr<as2_motion_controller_plugin_base::ControllerBase> controller_ptr_;
+  std::string controller_name_;
+  std::string controller_parameters_prefix_;
+
+  // Preloaded controller plugins ready to take over
+  std::vector<StandbyController> standby_controllers_;
 
 private:
   // Subscribers callbacks
   void stateCallback(const geometry_msgs::msg::TwistStamped::SharedPtr msg);
-  void refPoseCallback(const geometry_msgs::msg::PoseStamped::SharedPtr msg);
-  void refTwistCallback(const geometry_msgs::msg::TwistStamped::SharedPtr msg);
-  void refTrajCallback(const as2_msgs::msg::TrajectorySetpoints::SharedPtr msg);
+  void odometryCallback(const nav_msgs::msg::Odometry::SharedPtr msg);
+  void refPoseCallback(geometry_msgs::msg::PoseStamped::UniquePtr msg);
+  void refTwistCallback(geometry_msgs::msg::TwistStamped::UniquePtr msg);
+  void refTrajCallback(as2_msgs::msg::TrajectorySetpoints::UniquePtr msg);
   void refThrustCallback(const as2_msgs::msg::Thrust::SharedPtr msg);
   void platformInfoCallback(const as2_msgs::msg::PlatformInfo::SharedPtr msg);
 
@@ -189,6 +270,9 @@ private:
     const as2_msgs::srv::SetControlMode::Request::SharedPtr request,
     as2_msgs::srv::SetControlMode::Response::SharedPtr response);
   bool listPlatformAvailableControlModes();
+  void setControllerSrvCall(
+    const as2_msgs::srv::SetController::Request::SharedPtr request,
+    as2_msgs::srv::SetController::Response::SharedPtr response);
 
   // Timer callbacks
   void controlTimerCallback();
@@ -196,16 +280,27 @@ private:
   // Internal methods
   std::string getFrameIdByReferenceFrame(uint8_t reference_frame);
 
-  bool findSuitableOutputControlModeForPlatformInputMode(
-    uint8_t & output_mode,
-    const uint8_t input_mode);
-  bool checkSuitabilityInputMode(uint8_t & input_mode, const uint8_t output_mode);
   bool setPlatformControlMode(const as2_msgs::msg::ControlMode & mode);
 
-  bool findSuitableControlModes(uint8_t & input_mode, uint8_t & output_mode);
-  bool trySetPlatformHover();
-  bool tryToBypassController(const uint8_t input_mode, uint8_t & output_mode);
-
+  void buildControlModeTable();
+  bool checkControlModeResolution(const ControlModeResolution & resolution);
+  void beginModeSwitch();
+  void endModeSwitch(const std::chrono::nanoseconds & latency);
+
+  // StateMsgT is the twist or the odometry state message, see as2::tf::TfHandler::getState
+  template<typename StateMsgT>
+  void updateStandbyControllersState(const StateMsgT & state_msg);
+  std::pair<geometry_msgs::msg::PoseStamped, geometry_msgs::msg::TwistStamped> getState(
+    const geometry_msgs::msg::TwistStamped & twist_msg, const std::string & twist_frame_id,
+    const std::string & pose_frame_id);
+  std::pair<geometry_msgs::msg::PoseStamped, geometry_msgs::msg::TwistStamped> getState(
+    const nav_msgs::msg::Odometry & odometry_msg, const std::string & twist_frame_id,
+    const std::string & pose_frame_id);
+  bool switchController(StandbyController & next, std::string & message);
+  void updateControllerReferences(
+    as2_motion_controller_plugin_base::ControllerBase & controller);
+
+  bool canPassThrough(const uint8_t output_control_mode) const;
   void sendCommand();
   void publishCommand();
 };  //  class ControllerBase
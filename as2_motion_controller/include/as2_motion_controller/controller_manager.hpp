@@ -39,6 +39,7 @@
 #include <memory>
 #include <chrono>
 #include <filesystem>
+#include <string>
 #include <pluginlib/class_loader.hpp>
 #include <rclcpp/logging.hpp>
 
@@ -56,8 +57,26 @@ class ControllerManager : public as2::Node
 {
 public:
   explicit ControllerManager(const rclcpp::NodeOptions & options = rclcpp::NodeOptions());
+
+  /**
+   * @brief Construct a controller manager hosted inside a multi-vehicle process
+   * @param name_space vehicle namespace
+   * @param tf_buffer tf2_ros::Buffer shared by all the vehicles of the process
+   * @param options node options
+   * The control loop is not driven by an own timer, the owner must call controlStep()
+   */
+  ControllerManager(
+    const std::string & name_space,
+    std::shared_ptr<tf2_ros::Buffer> tf_buffer,
+    const rclcpp::NodeOptions & options = rclcpp::NodeOptions());
+
   ~ControllerManager();
 
+  /**
+   * @brief Run one control iteration of the controller handler
+   */
+  void controlStep();
+
 public:
   double cmd_freq_;
 
@@ -74,7 +93,10 @@ private:
   rclcpp::TimerBase::SharedPtr mode_timer_;
 
 private:
+  void setup(std::shared_ptr<tf2_ros::Buffer> tf_buffer, bool external_control_step);
   void configAvailableControlModes(const std::filesystem::path project_path);
+  std::filesystem::path findAvailableModesConfigFile(const std::string & plugin_name);
+  void loadStandbyControllers();
   void modeTimerCallback();
 
   /**
@@ -0,0 +1,111 @@
+// Copyright 2024 Universidad Politécnica de Madrid
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the Universidad Politécnica de Madrid nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/*!*******************************************************************************************
+ *  \file       multi_controller_manager.hpp
+ *  \brief      Multi-vehicle controller manager class definition
+ *  \authors    Miguel Fernández Cortizas
+ *              Rafael Pérez Seguí
+ ********************************************************************************************/
+
+#ifndef AS2_MOTION_CONTROLLER__MULTI_CONTROLLER_MANAGER_HPP_
+#define AS2_MOTION_CONTROLLER__MULTI_CONTROLLER_MANAGER_HPP_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <rclcpp/rclcpp.hpp>
+#include <tf2_ros/buffer.h>
+#include <tf2_ros/transform_listener.h>
+
+#include "as2_core/node.hpp"
+#include "controller_manager.hpp"
+
+namespace controller_manager
+{
+
+/**
+ * @brief Hosts one ControllerManager per vehicle namespace inside a single process.
+ *
+ * All the vehicles share one tf2_ros::Buffer (a single TransformListener) and the control loop of
+ * every vehicle is stepped from one timer, distributing the steps over a fixed pool of worker
+ * threads.
+ */
+class MultiControllerManager : public as2::Node
+{
+public:
+  explicit MultiControllerManager(const rclcpp::NodeOptions & options = rclcpp::NodeOptions());
+  ~MultiControllerManager();
+
+  /**
+   * @brief Get the controller managers hosted by this node, one per vehicle namespace. They must
+   * be added to the same executor as this node
+   */
+  const std::vector<std::shared_ptr<ControllerManager>> & getControllerManagers() const;
+
+  /**
+   * @brief Add this node and all the hosted controller managers to an executor
+   * @param executor executor that will spin the nodes
+   */
+  void addToExecutor(rclcpp::Executor & executor);
+
+private:
+  double cmd_freq_ = 100.0;
+  std::vector<std::string> namespaces_;
+
+  std::shared_ptr<tf2_ros::Buffer> tf_buffer_;
+  std::shared_ptr<tf2_ros::TransformListener> tf_listener_;
+  std::vector<std::shared_ptr<ControllerManager>> controller_managers_;
+  rclcpp::TimerBase::SharedPtr control_timer_;
+
+  // Worker pool
+  std::vector<std::thread> workers_;
+  std::mutex pool_mutex_;
+  std::condition_variable pool_start_cv_;
+  std::condition_variable pool_done_cv_;
+  std::atomic<std::size_t> next_vehicle_{0};
+  std::size_t pending_workers_ = 0;
+  std::size_t batch_id_ = 0;
+  bool stop_workers_ = false;
+
+private:
+  void controlTimerCallback();
+  void runBatch();
+  void workerLoop();
+  void stepVehicles();
+};  // class MultiControllerManager
+
+}  // namespace controller_manager
+
+#endif  // AS2_MOTION_CONTROLLER__MULTI_CONTROLLER_MANAGER_HPP_
@@ -0,0 +1,113 @@
+# Copyright 2024 Universidad Politécnica de Madrid
+#
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are met:
+#
+#    * Redistributions of source code must retain the above copyright
+#      notice, this list of conditions and the following disclaimer.
+#
+#    * Redistributions in binary form must reproduce the above copyright
+#      notice, this list of conditions and the following disclaimer in the
+#      documentation and/or other materials provided with the distribution.
+#
+#    * Neither the name of the the copyright holder nor the names of its
+#      contributors may be used to endorse or promote products derived from
+#      this software without specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+# AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+# IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+# ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+# LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+# CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+# SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+# INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+# CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+# ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+# POSSIBILITY OF SUCH DAMAGE.
+
+"""Launch file for the multi-vehicle controller manager node."""
+
+__authors__ = 'Pedro Arias Pérez, Rafael Pérez Seguí'
+__copyright__ = 'Copyright (c) 2024 Universidad Politécnica de Madrid'
+__license__ = 'BSD-3-Clause'
+
+import os
+
+from ament_index_python.packages import get_package_share_directory
+from as2_core.launch_plugin_utils import get_available_plugins
+from launch import LaunchDescription
+from launch.actions import DeclareLaunchArgument, OpaqueFunction
+from launch.substitutions import LaunchConfiguration
+from launch_ros.actions import Node
+
+
+def get_package_config_file():
+    """Return the package config file."""
+    package_folder = get_package_share_directory('as2_motion_controller')
+    return os.path.join(package_folder,
+                        'config/multi_motion_controller_default.yaml')
+
+
+def launch_multi_controller(context):
+    """Create the multi-vehicle controller manager node."""
+    package_folder = get_package_share_directory('as2_motion_controller')
+    plugin_name = LaunchConfiguration('plugin_name').perform(context)
+    namespaces = [
+        ns.strip() for ns in LaunchConfiguration('namespaces').perform(context).split(',')
+        if ns.strip() != ''
+    ]
+    plugin_folder = os.path.join(package_folder, 'plugins', plugin_name, 'config')
+
+    parameters = [
+        LaunchConfiguration('config_file').perform(context),
+        os.path.join(plugin_folder, 'controller_default.yaml'),
+        {
+            'use_sim_time': LaunchConfiguration('use_sim_time'),
+            'plugin_name': plugin_name,
+            'plugin_available_modes_config_file': os.path.join(
+                plugin_folder, 'available_modes.yaml'),
+        },
+    ]
+    if namespaces:
+        parameters.append({'namespaces': namespaces})
+
+    return [
+        Node(
+            package='as2_motion_controller',
+            executable='as2_motion_controller_multi_node',
+            # Node name and namespace are not remapped: remaps are process wide and would also
+            # apply to the controller managers hosted for each vehicle
+            output='screen',
+            arguments=['--ros-args', '--log-level',
+                       LaunchConfiguration('log_level')],
+            emulate_tty=True,
+            parameters=parameters,
+        )
+    ]
+
+
+def generate_launch_description():
+    """Return the launch description."""
+    return LaunchDescription([
+        DeclareLaunchArgument('log_level',
+                              description='Logging level',
+                              default_value='info'),
+        DeclareLaunchArgument('use_sim_time',
+                              description='Use simulation clock if true',
+                              default_value='false'),
+        DeclareLaunchArgument(
+            'namespaces',
+            description='Comma separated list of drone namespaces. '
+                        'If empty, it is taken from config_file',
+            default_value=''),
+        DeclareLaunchArgument(
+            'plugin_name',
+            description='Plugin name',
+            choices=get_available_plugins('as2_motion_controller')),
+        DeclareLaunchArgument(
+            'config_file',
+            description='Configuration file',
+            default_value=get_package_config_file()),
+        OpaqueFunction(function=launch_multi_controller),
+    ])
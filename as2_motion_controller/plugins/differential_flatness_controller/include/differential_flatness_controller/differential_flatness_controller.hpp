@@ -152,6 +152,9 @@ public:
   bool updateParams(const std::vector<rclcpp::Parameter> & _params_list) override;
   void reset() override;
 
+  bool getIntegralState(geometry_msgs::msg::Vector3 & integral) override;
+  bool setIntegralState(const geometry_msgs::msg::Vector3 & integral) override;
+
   // IMPORTANT: this is the frame_id of the desired pose and twist,
   // both reference and state
   std::string getDesiredPoseFrameId() override {return odom_frame_id_;}
@@ -114,6 +114,34 @@ void Plugin::reset()
   resetCommands();
 }
 
+bool Plugin::getIntegralState(geometry_msgs::msg::Vector3 & integral)
+{
+  if (mass_ <= 0.0) {
+    return false;
+  }
+  const Eigen::Vector3d integral_accel = Ki_ * accum_pos_error_ / mass_;
+  integral.x = integral_accel.x();
+  integral.y = integral_accel.y();
+  integral.z = integral_accel.z();
+  return true;
+}
+
+bool Plugin::setIntegralState(const geometry_msgs::msg::Vector3 & integral)
+{
+  const Eigen::Vector3d integral_accel(integral.x, integral.y, integral.z);
+  for (uint8_t j = 0; j < 3; j++) {
+    const double ki = Ki_.diagonal()[j];
+    if (ki == 0.0) {
+      accum_pos_error_[j] = 0.0;
+      continue;
+    }
+    const double antiwindup_value = antiwindup_cte_ / ki;
+    accum_pos_error_[j] =
+      std::clamp(mass_ * integral_accel[j] / ki, -antiwindup_value, antiwindup_value);
+  }
+  return true;
+}
+
 inline void Plugin::resetState() {uav_state_ = UAV_state();}
 
 void Plugin::resetReferences()
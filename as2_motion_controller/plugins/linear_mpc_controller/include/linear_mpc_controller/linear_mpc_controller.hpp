@@ -0,0 +1,200 @@
+// Copyright 2024 Universidad Politécnica de Madrid
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the Universidad Politécnica de Madrid nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/*!*******************************************************************************************
+ *  \file       linear_mpc_controller.hpp
+ *  \brief      Declares the controller plugin linear MPC
+ *  \authors    Miguel Fernández Cortizas
+ *              Rafael Pérez Seguí
+ ********************************************************************************************/
+
+#ifndef LINEAR_MPC_CONTROLLER__LINEAR_MPC_CONTROLLER_HPP_
+#define LINEAR_MPC_CONTROLLER__LINEAR_MPC_CONTROLLER_HPP_
+
+#include <Eigen/Dense>
+#include <Eigen/Geometry>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+#include <string>
+#include <rclcpp/logging.hpp>
+#include <rclcpp/rclcpp.hpp>
+#include <geometry_msgs/msg/pose_stamped.hpp>
+#include <geometry_msgs/msg/twist_stamped.hpp>
+
+#include "as2_core/utils/frame_utils.hpp"
+#include "as2_core/utils/tf_utils.hpp"
+#include "as2_msgs/msg/thrust.hpp"
+#include "as2_msgs/msg/trajectory_point.hpp"
+#include "as2_msgs/msg/trajectory_setpoints.hpp"
+
+#include "as2_motion_controller/controller_base.hpp"
+#include "linear_mpc_controller/linear_mpc_solver.hpp"
+
+namespace linear_mpc_controller
+{
+struct UAV_state
+{
+  Eigen::Vector3d position = Eigen::Vector3d::Zero();
+  Eigen::Vector3d velocity = Eigen::Vector3d::Zero();
+  tf2::Quaternion attitude_state = tf2::Quaternion::getIdentity();
+};
+
+/* Reference sampled at the prediction steps, one vector per axis */
+struct Horizon_reference
+{
+  std::array<HorizonVector, 3> position;
+  std::array<HorizonVector, 3> velocity;
+  std::array<HorizonVector, 3> acceleration;
+  double yaw = 0.0;
+};
+
+struct Control_flags
+{
+  bool parameters_read = false;
+  bool problem_ready = false;
+  bool state_received = false;
+  bool ref_received = false;
+};
+
+class Plugin : public as2_motion_controller_plugin_base::ControllerBase
+{
+  UAV_state uav_state_;
+  Horizon_reference control_ref_;
+  Control_flags flags_;
+  bool hover_flag_ = false;
+
+  as2_msgs::msg::ControlMode control_mode_in_;
+  as2_msgs::msg::ControlMode control_mode_out_;
+
+  // Last reference received, sampled again if the horizon changes
+  std::vector<as2_msgs::msg::TrajectoryPoint> reference_setpoints_;
+
+  std::array<LinearMPCSolver, 3> solvers_;
+  std::array<MPCWeights, 3> weights_;
+  MPCLimits limits_xy_;
+  MPCLimits limits_z_;
+  ADMMSettings solver_settings_;
+  int horizon_ = 20;
+  double prediction_dt_ = 0.1;
+  double reference_dt_ = 0.01;
+  double warm_start_elapsed_ = 0.0;
+
+  Eigen::Matrix3d Kp_ang_mat_{Eigen::Matrix3d::Zero()};
+  double mass_ = 1.0;
+
+  std::string odom_frame_id_ = "odom";
+  std::string base_link_frame_id_ = "base_link";
+
+  const Eigen::Vector3d gravitational_accel_ = Eigen::Vector3d(0, 0, -9.81);
+
+  const std::vector<std::string> parameters_list_ = {
+    "mass",
+    "mpc.horizon",
+    "mpc.prediction_dt",
+    "mpc.reference_dt",
+    "mpc.weights.position.x",
+    "mpc.weights.position.y",
+    "mpc.weights.position.z",
+    "mpc.weights.velocity.x",
+    "mpc.weights.velocity.y",
+    "mpc.weights.velocity.z",
+    "mpc.weights.acceleration.x",
+    "mpc.weights.acceleration.y",
+    "mpc.weights.acceleration.z",
+    "mpc.limits.max_acceleration.xy",
+    "mpc.limits.max_acceleration.z",
+    "mpc.limits.max_velocity.xy",
+    "mpc.limits.max_velocity.z",
+    "mpc.solver.rho",
+    "mpc.solver.alpha",
+    "mpc.solver.tolerance",
+    "mpc.solver.max_iterations",
+    "attitude_control.roll_control.kp",
+    "attitude_control.pitch_control.kp",
+    "attitude_control.yaw_control.kp",
+  };
+  std::vector<std::string> parameters_to_read_{parameters_list_};  // copy mutable
+
+public:
+  Plugin() {}
+  ~Plugin() {}
+
+  /** Virtual functions from ControllerBase */
+  void ownInitialize() override;
+  void updateState(
+    const geometry_msgs::msg::PoseStamped & pose_msg,
+    const geometry_msgs::msg::TwistStamped & twist_msg) override;
+
+  void updateReference(const geometry_msgs::msg::PoseStamped & ref) override;
+  void updateReference(const as2_msgs::msg::TrajectorySetpoints & ref) override;
+
+  bool setMode(
+    const as2_msgs::msg::ControlMode & mode_in,
+    const as2_msgs::msg::ControlMode & mode_out) override;
+
+  bool computeOutput(
+    double dt,
+    geometry_msgs::msg::PoseStamped & pose,
+    geometry_msgs::msg::TwistStamped & twist,
+    as2_msgs::msg::Thrust & thrust) override;
+
+  bool updateParams(const std::vector<rclcpp::Parameter> & _params_list) override;
+  void reset() override;
+
+  // IMPORTANT: this is the frame_id of the desired pose and twist,
+  // both reference and state
+  std::string getDesiredPoseFrameId() override {return odom_frame_id_;}
+  std::string getDesiredTwistFrameId() override {return odom_frame_id_;}
+
+private:
+  /** Controller especific functions */
+  bool checkParamList(const std::string & param, std::vector<std::string> & _params_list);
+
+  /* @brief Update one parameter, return true if the MPC problem has to be built again */
+  bool updateMPCParameter(const std::string & _parameter_name, const rclcpp::Parameter & _param);
+
+  /* @brief Build the condensed problem of each axis, only when the parameters change */
+  bool buildProblem();
+
+  /* @brief Sample the last reference received at the prediction steps */
+  void sampleReference();
+
+  void resetState();
+  void resetReferences();
+
+  bool getOutput(
+    const Eigen::Vector3d & _acceleration,
+    geometry_msgs::msg::PoseStamped & pose_msg,
+    geometry_msgs::msg::TwistStamped & twist_msg,
+    as2_msgs::msg::Thrust & thrust_msg);
+};  // class Plugin
+}   // namespace linear_mpc_controller
+
+#endif  // LINEAR_MPC_CONTROLLER__LINEAR_MPC_CONTROLLER_HPP_
@@ -0,0 +1,167 @@
+// Copyright 2024 Universidad Politécnica de Madrid
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the Universidad Politécnica de Madrid nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/*!*******************************************************************************************
+ *  \file       linear_mpc_solver.hpp
+ *  \brief      Declares a condensed linear MPC solver for one double integrator axis
+ *  \authors    Miguel Fernández Cortizas
+ *              Rafael Pérez Seguí
+ ********************************************************************************************/
+
+#ifndef LINEAR_MPC_CONTROLLER__LINEAR_MPC_SOLVER_HPP_
+#define LINEAR_MPC_CONTROLLER__LINEAR_MPC_SOLVER_HPP_
+
+#include <Eigen/Dense>
+
+namespace linear_mpc_controller
+{
+
+/* Maximum prediction horizon. Matrices are sized for it so solving never allocates */
+constexpr int kMaxHorizon = 50;
+
+using HorizonVector = Eigen::Matrix<double, Eigen::Dynamic, 1, 0, kMaxHorizon, 1>;
+using HorizonMatrix =
+  Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, 0, kMaxHorizon, kMaxHorizon>;
+using ConstraintVector = Eigen::Matrix<double, Eigen::Dynamic, 1, 0, 2 * kMaxHorizon, 1>;
+
+struct MPCWeights
+{
+  double position = 1.0;      // Weight of the position error
+  double velocity = 0.1;      // Weight of the velocity error
+  double acceleration = 0.1;  // Weight of the acceleration error
+};
+
+struct MPCLimits
+{
+  double max_acceleration = 5.0;  // Acceleration bound (m/s^2), symmetric
+  double max_velocity = 5.0;      // Velocity bound (m/s), symmetric
+};
+
+struct ADMMSettings
+{
+  double rho = 1.0;            // Penalty of the constraint residual
+  double sigma = 1e-6;         // Regularization of the primal update
+  double alpha = 1.6;          // Over-relaxation factor
+  double tolerance = 1e-4;     // Absolute tolerance of the primal and dual residuals
+  int max_iterations = 50;     // Iteration cap, the last iterate is used if it is reached
+};
+
+/**
+ * @brief Linear MPC for a double integrator axis (position, velocity) driven by acceleration.
+ *
+ * The problem is condensed to the N accelerations of the horizon:
+ *   min 1/2 U' H U + f' U  s.t.  -a_max <= U <= a_max,  -v_max <= v0 + Sv U <= v_max
+ * H and the factorization of the ADMM linear system only depend on the horizon, the step and
+ * the weights, so they are built in setup(). solve() only computes f and iterates, and is warm
+ * started with the solution of the previous call.
+ */
+class LinearMPCSolver
+{
+public:
+  LinearMPCSolver() = default;
+
+  /**
+   * @brief Build the condensed problem and factorize the ADMM linear system
+   * @param horizon number of prediction steps, in [1, kMaxHorizon]
+   * @param dt prediction step (s)
+   * @return true if the problem was built, false if the arguments are not valid
+   */
+  bool setup(
+    const int horizon, const double dt,
+    const MPCWeights & weights, const MPCLimits & limits,
+    const ADMMSettings & settings);
+
+  /**
+   * @brief Solve the problem for the current state and the reference over the horizon
+   * @param position current position
+   * @param velocity current velocity
+   * @param position_ref position reference at steps 1..N
+   * @param velocity_ref velocity reference at steps 1..N
+   * @param acceleration_ref acceleration reference (feedforward) at steps 0..N-1
+   * @return true if the residuals reached the tolerance
+   */
+  bool solve(
+    const double position, const double velocity,
+    const HorizonVector & position_ref,
+    const HorizonVector & velocity_ref,
+    const HorizonVector & acceleration_ref);
+
+  /**
+   * @brief Shift the previous solution to be used as the initial guess of the next solve
+   * @param steps number of prediction steps elapsed since the previous solve
+   */
+  void shiftWarmStart(const int steps);
+
+  /* @brief Discard the previous solution, next solve starts from zero */
+  void resetWarmStart();
+
+  bool isSetup() const {return horizon_ > 0;}
+  int getHorizon() const {return horizon_;}
+  int getIterations() const {return iterations_;}
+
+  /* @brief First acceleration of the horizon, the one to be applied */
+  double getAcceleration() const {return z_(0);}
+
+  /* @brief Accelerations of the whole horizon */
+  const HorizonVector & getAccelerations() const {return x_;}
+
+private:
+  int horizon_ = 0;
+  double dt_ = 0.0;
+  MPCWeights weights_;
+  MPCLimits limits_;
+  ADMMSettings settings_;
+
+  HorizonMatrix position_gain_;  // Sp, effect of the accelerations on the positions
+  HorizonMatrix hessian_;        // H
+  Eigen::LLT<HorizonMatrix> kkt_llt_;  // H + sigma I + rho A'A
+
+  HorizonVector gradient_;  // f
+  HorizonVector x_;         // Primal solution
+  HorizonVector x_tilde_;
+  HorizonVector rhs_;
+  HorizonVector aux_;
+  ConstraintVector z_;      // Constrained variables A U
+  ConstraintVector z_tilde_;
+  ConstraintVector y_;      // Dual variables
+  ConstraintVector lower_;
+  ConstraintVector upper_;
+  ConstraintVector residual_;
+  int iterations_ = 0;
+
+  /* @brief out = Sv' in, with Sv the lower triangular matrix of dt */
+  void velocityGainTransposed(const HorizonVector & in, HorizonVector & out) const;
+  /* @brief out = A' in, with A = [I; Sv] */
+  void constraintTransposed(const ConstraintVector & in, HorizonVector & out) const;
+  /* @brief out = A in, with A = [I; Sv] */
+  void constraint(const HorizonVector & in, ConstraintVector & out) const;
+};  // class LinearMPCSolver
+
+}  // namespace linear_mpc_controller
+
+#endif  // LINEAR_MPC_CONTROLLER__LINEAR_MPC_SOLVER_HPP_
@@ -0,0 +1,462 @@
+// Copyright 2024 Universidad Politécnica de Madrid
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the Universidad Politécnica de Madrid nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/*!*******************************************************************************************
+ *  \file       linear_mpc_controller.cpp
+ *  \brief      Linear MPC controller plugin for the Aerostack framework.
+ *  \authors    Miguel Fernández Cortizas
+ *              Rafael Pérez Seguí
+ ********************************************************************************************/
+
+#include "linear_mpc_controller.hpp"
+
+namespace linear_mpc_controller
+{
+void Plugin::ownInitialize()
+{
+  odom_frame_id_ = as2::tf::generateTfName(node_ptr_, odom_frame_id_);
+  base_link_frame_id_ = as2::tf::generateTfName(node_ptr_, base_link_frame_id_);
+  reset();
+  return;
+}
+
+bool Plugin::updateParams(const std::vector<rclcpp::Parameter> & _params_list)
+{
+  bool rebuild = false;
+  for (auto & param : _params_list) {
+    rebuild |= updateMPCParameter(param.get_name(), param);
+  }
+  if (flags_.parameters_read && (rebuild || !flags_.problem_ready)) {
+    return buildProblem();
+  }
+  return true;
+}
+
+bool Plugin::checkParamList(const std::string & param, std::vector<std::string> & _params_list)
+{
+  if (find(_params_list.begin(), _params_list.end(), param) != _params_list.end()) {
+    // Remove the parameter from the list of parameters to be read
+    _params_list.erase(
+      std::remove(_params_list.begin(), _params_list.end(), param),
+      _params_list.end());
+  }
+  return !_params_list.size();  // Return true if the list is empty
+}
+
+bool Plugin::updateMPCParameter(
+  const std::string & _parameter_name,
+  const rclcpp::Parameter & _param)
+{
+  if (find(parameters_list_.begin(), parameters_list_.end(), _parameter_name) ==
+    parameters_list_.end())
+  {
+    return false;
+  }
+
+  bool rebuild = true;
+  const std::string axes = "xyz";
+  const size_t axis = axes.find(_parameter_name.back());
+  if (_parameter_name == "mass") {
+    mass_ = _param.get_value<double>();
+    rebuild = false;
+  } else if (_parameter_name == "mpc.horizon") {
+    horizon_ = _param.get_value<int>();
+  } else if (_parameter_name == "mpc.prediction_dt") {
+    prediction_dt_ = _param.get_value<double>();
+  } else if (_parameter_name == "mpc.reference_dt") {
+    reference_dt_ = _param.get_value<double>();
+  } else if (_parameter_name.rfind("mpc.weights.position.", 0) == 0) {
+    weights_[axis].position = _param.get_value<double>();
+  } else if (_parameter_name.rfind("mpc.weights.velocity.", 0) == 0) {
+    weights_[axis].velocity = _param.get_value<double>();
+  } else if (_parameter_name.rfind("mpc.weights.acceleration.", 0) == 0) {
+    weights_[axis].acceleration = _param.get_value<double>();
+  } else if (_parameter_name == "mpc.limits.max_acceleration.xy") {
+    limits_xy_.max_acceleration = _param.get_value<double>();
+  } else if (_parameter_name == "mpc.limits.max_acceleration.z") {
+    limits_z_.max_acceleration = _param.get_value<double>();
+  } else if (_parameter_name == "mpc.limits.max_velocity.xy") {
+    limits_xy_.max_velocity = _param.get_value<double>();
+  } else if (_parameter_name == "mpc.limits.max_velocity.z") {
+    limits_z_.max_velocity = _param.get_value<double>();
+  } else if (_parameter_name == "mpc.solver.rho") {
+    solver_settings_.rho = _param.get_value<double>();
+  } else if (_parameter_name == "mpc.solver.alpha") {
+    solver_settings_.alpha = _param.get_value<double>();
+  } else if (_parameter_name == "mpc.solver.tolerance") {
+    solver_settings_.tolerance = _param.get_value<double>();
+  } else if (_parameter_name == "mpc.solver.max_iterations") {
+    solver_settings_.max_iterations = _param.get_value<int>();
+  } else if (_parameter_name == "attitude_control.roll_control.kp") {
+    Kp_ang_mat_(0, 0) = _param.get_value<double>();
+    rebuild = false;
+  } else if (_parameter_name == "attitude_control.pitch_control.kp") {
+    Kp_ang_mat_(1, 1) = _param.get_value<double>();
+    rebuild = false;
+  } else if (_parameter_name == "attitude_control.yaw_control.kp") {
+    Kp_ang_mat_(2, 2) = _param.get_value<double>();
+    rebuild = false;
+  }
+  flags_.parameters_read = checkParamList(_parameter_name, parameters_to_read_);
+  return rebuild;
+}
+
+bool Plugin::buildProblem()
+{
+  flags_.problem_ready = false;
+  for (int i = 0; i < 3; i++) {
+    const MPCLimits & limits = i < 2 ? limits_xy_ : limits_z_;
+    if (!solvers_[i].setup(horizon_, prediction_dt_, weights_[i], limits, solver_settings_)) {
+      RCLCPP_ERROR(
+        node_ptr_->get_logger(),
+        "Invalid MPC parameters, horizon must be in [1, %d] and weights, limits and solver "
+        "settings positive", kMaxHorizon);
+      return false;
+    }
+  }
+  if (reference_dt_ <= 0.0) {
+    RCLCPP_ERROR(node_ptr_->get_logger(), "Invalid MPC parameters, reference_dt must be positive");
+    return false;
+  }
+  warm_start_elapsed_ = 0.0;
+  flags_.problem_ready = true;
+  sampleReference();
+  return true;
+}
+
+void Plugin::reset()
+{
+  resetReferences();
+  resetState();
+  for (auto & solver : solvers_) {
+    solver.resetWarmStart();
+  }
+  warm_start_elapsed_ = 0.0;
+}
+
+inline void Plugin::resetState() {uav_state_ = UAV_state();}
+
+void Plugin::resetReferences()
+{
+  reference_setpoints_.resize(1);
+  as2_msgs::msg::TrajectoryPoint & setpoint = reference_setpoints_[0];
+  setpoint.position.x = uav_state_.position.x();
+  setpoint.position.y = uav_state_.position.y();
+  setpoint.position.z = uav_state_.position.z();
+  setpoint.twist = geometry_msgs::msg::Vector3();
+  setpoint.acceleration = geometry_msgs::msg::Vector3();
+  setpoint.yaw_angle = as2::frame::getYawFromQuaternion(uav_state_.attitude_state);
+  sampleReference();
+  return;
+}
+
+void Plugin::sampleReference()
+{
+  if (!flags_.problem_ready || reference_setpoints_.empty()) {
+    return;
+  }
+
+  const int last = static_cast<int>(reference_setpoints_.size()) - 1;
+  const double last_time = last * reference_dt_;
+  for (int i = 0; i < 3; i++) {
+    control_ref_.position[i].resize(horizon_);
+    control_ref_.velocity[i].resize(horizon_);
+    control_ref_.acceleration[i].resize(horizon_);
+  }
+
+  for (int k = 0; k < horizon_; k++) {
+    // Position and velocity at the end of step k, acceleration along step k
+    const double time = (k + 1) * prediction_dt_;
+    const int index = std::min(static_cast<int>(std::lround(time / reference_dt_)), last);
+    const int acc_index =
+      std::min(static_cast<int>(std::lround(k * prediction_dt_ / reference_dt_)), last);
+    // Beyond the last setpoint, keep its velocity
+    const double extrapolation = std::max(time - last_time, 0.0);
+
+    const auto & setpoint = reference_setpoints_[index];
+    const auto & acc_setpoint = reference_setpoints_[acc_index];
+    const Eigen::Vector3d position(setpoint.position.x, setpoint.position.y, setpoint.position.z);
+    const Eigen::Vector3d velocity(setpoint.twist.x, setpoint.twist.y, setpoint.twist.z);
+    const Eigen::Vector3d acceleration(
+      acc_setpoint.acceleration.x, acc_setpoint.acceleration.y, acc_setpoint.acceleration.z);
+    for (int i = 0; i < 3; i++) {
+      control_ref_.position[i](k) = position[i] + velocity[i] * extrapolation;
+      control_ref_.velocity[i](k) = velocity[i];
+      control_ref_.acceleration[i](k) = time - prediction_dt_ <= last_time ? acceleration[i] : 0.0;
+    }
+  }
+  control_ref_.yaw = reference_setpoints_[0].yaw_angle;
+}
+
+void Plugin::updateState(
+  const geometry_msgs::msg::PoseStamped & pose_msg,
+  const geometry_msgs::msg::TwistStamped & twist_msg)
+{
+  if (pose_msg.header.frame_id != odom_frame_id_ && twist_msg.header.frame_id != odom_frame_id_) {
+    RCLCPP_ERROR(node_ptr_->get_logger(), "Pose and Twist frame_id are not desired ones");
+    RCLCPP_ERROR(
+      node_ptr_->get_logger(), "Recived: %s, %s", pose_msg.header.frame_id.c_str(),
+      twist_msg.header.frame_id.c_str());
+    RCLCPP_ERROR(
+      node_ptr_->get_logger(), "Desired: %s, %s", odom_frame_id_.c_str(),
+      odom_frame_id_.c_str());
+    return;
+  }
+
+  uav_state_.position =
+    Eigen::Vector3d(pose_msg.pose.position.x, pose_msg.pose.position.y, pose_msg.pose.position.z);
+  uav_state_.velocity =
+    Eigen::Vector3d(twist_msg.twist.linear.x, twist_msg.twist.linear.y, twist_msg.twist.linear.z);
+
+  uav_state_.attitude_state =
+    tf2::Quaternion(
+    pose_msg.pose.orientation.x, pose_msg.pose.orientation.y,
+    pose_msg.pose.orientation.z, pose_msg.pose.orientation.w);
+
+  if (hover_flag_) {
+    resetReferences();
+    flags_.ref_received = true;
+    hover_flag_ = false;
+  }
+
+  flags_.state_received = true;
+  return;
+}
+
+void Plugin::updateReference(const geometry_msgs::msg::PoseStamped & pose_msg)
+{
+  if (control_mode_in_.control_mode != as2_msgs::msg::ControlMode::POSITION) {
+    return;
+  }
+
+  reference_setpoints_.resize(1);
+  as2_msgs::msg::TrajectoryPoint & setpoint = reference_setpoints_[0];
+  setpoint.position.x = pose_msg.pose.position.x;
+  setpoint.position.y = pose_msg.pose.position.y;
+  setpoint.position.z = pose_msg.pose.position.z;
+  setpoint.twist = geometry_msgs::msg::Vector3();
+  setpoint.acceleration = geometry_msgs::msg::Vector3();
+  setpoint.yaw_angle = as2::frame::getYawFromQuaternion(pose_msg.pose.orientation);
+  sampleReference();
+
+  flags_.ref_received = true;
+  return;
+}
+
+void Plugin::updateReference(const as2_msgs::msg::TrajectorySetpoints & trajectory_setpoints_msg)
+{
+  if (control_mode_in_.control_mode != as2_msgs::msg::ControlMode::TRAJECTORY ||
+    trajectory_setpoints_msg.setpoints.empty())
+  {
+    return;
+  }
+
+  reference_setpoints_.assign(
+    trajectory_setpoints_msg.setpoints.begin(),
+    trajectory_setpoints_msg.setpoints.end());
+  sampleReference();
+
+  flags_.ref_received = true;
+  return;
+}
+
+bool Plugin::setMode(
+  const as2_msgs::msg::ControlMode & in_mode,
+  const as2_msgs::msg::ControlMode & out_mode)
+{
+  if (!flags_.parameters_read) {
+    RCLCPP_WARN(node_ptr_->get_logger(), "Plugin parameters not read yet, can not set mode");
+    return false;
+  }
+
+  if (in_mode.control_mode == as2_msgs::msg::ControlMode::HOVER) {
+    control_mode_in_.control_mode = in_mode.control_mode;
+    control_mode_in_.yaw_mode = as2_msgs::msg::ControlMode::YAW_ANGLE;
+    control_mode_in_.reference_frame = as2_msgs::msg::ControlMode::LOCAL_ENU_FRAME;
+    hover_flag_ = true;
+  } else {
+    control_mode_in_ = in_mode;
+  }
+
+  flags_.ref_received = false;
+  flags_.state_received = false;
+  for (auto & solver : solvers_) {
+    solver.resetWarmStart();
+  }
+  warm_start_elapsed_ = 0.0;
+
+  control_mode_out_ = out_mode;
+  return true;
+}
+
+bool Plugin::computeOutput(
+  double dt,
+  geometry_msgs::msg::PoseStamped & pose,
+  geometry_msgs::msg::TwistStamped & twist,
+  as2_msgs::msg::Thrust & thrust)
+{
+  auto & clk = *node_ptr_->get_clock();
+  if (!flags_.state_received) {
+    RCLCPP_WARN_THROTTLE(node_ptr_->get_logger(), clk, 5000, "State not received yet");
+    return false;
+  }
+
+  if (!flags_.ref_received) {
+    RCLCPP_WARN_THROTTLE(
+      node_ptr_->get_logger(), clk, 5000,
+      "State changed, but ref not recived yet");
+    return false;
+  }
+
+  if (!flags_.parameters_read) {
+    RCLCPP_WARN_THROTTLE(node_ptr_->get_logger(), clk, 5000, "Parameters not read yet");
+    for (auto & param : parameters_to_read_) {
+      RCLCPP_WARN(node_ptr_->get_logger(), "Parameter %s not read yet", param.c_str());
+    }
+    return false;
+  }
+
+  if (!flags_.problem_ready) {
+    RCLCPP_WARN_THROTTLE(node_ptr_->get_logger(), clk, 5000, "MPC problem not built");
+    return false;
+  }
+
+  switch (control_mode_in_.yaw_mode) {
+    case as2_msgs::msg::ControlMode::YAW_ANGLE: {
+        break;
+      }
+    default:
+      RCLCPP_ERROR_THROTTLE(node_ptr_->get_logger(), clk, 5000, "Unknown yaw mode");
+      return false;
+      break;
+  }
+
+  switch (control_mode_in_.control_mode) {
+    case as2_msgs::msg::ControlMode::HOVER:
+    case as2_msgs::msg::ControlMode::POSITION:
+    case as2_msgs::msg::ControlMode::TRAJECTORY:
+      break;
+    default:
+      RCLCPP_ERROR_THROTTLE(node_ptr_->get_logger(), clk, 5000, "Unknown control mode");
+      return false;
+      break;
+  }
+
+  // Move the previous solution forward by the prediction steps elapsed since the last call
+  warm_start_elapsed_ += dt;
+  const int elapsed_steps = static_cast<int>(warm_start_elapsed_ / prediction_dt_);
+  warm_start_elapsed_ -= elapsed_steps * prediction_dt_;
+
+  Eigen::Vector3d acceleration;
+  for (int i = 0; i < 3; i++) {
+    solvers_[i].shiftWarmStart(elapsed_steps);
+    if (!solvers_[i].solve(
+        uav_state_.position[i], uav_state_.velocity[i],
+        control_ref_.position[i], control_ref_.velocity[i], control_ref_.acceleration[i]))
+    {
+      RCLCPP_DEBUG_THROTTLE(
+        node_ptr_->get_logger(), clk, 1000,
+        "MPC axis %d reached the iteration limit", i);
+    }
+    acceleration[i] = solvers_[i].getAcceleration();
+  }
+
+  return getOutput(acceleration, pose, twist, thrust);
+}
+
+bool Plugin::getOutput(
+  const Eigen::Vector3d & _acceleration,
+  geometry_msgs::msg::PoseStamped & pose_msg,
+  geometry_msgs::msg::TwistStamped & twist_msg,
+  as2_msgs::msg::Thrust & thrust_msg)
+{
+  const Eigen::Vector3d desired_force = mass_ * (_acceleration - gravitational_accel_);
+
+  // Compute the desired attitude
+  const tf2::Matrix3x3 rot_matrix_tf2(uav_state_.attitude_state);
+
+  Eigen::Matrix3d rot_matrix;
+  rot_matrix << rot_matrix_tf2[0][0], rot_matrix_tf2[0][1], rot_matrix_tf2[0][2],
+    rot_matrix_tf2[1][0], rot_matrix_tf2[1][1], rot_matrix_tf2[1][2], rot_matrix_tf2[2][0],
+    rot_matrix_tf2[2][1], rot_matrix_tf2[2][2];
+
+  const Eigen::Vector3d xc_des(cos(control_ref_.yaw), sin(control_ref_.yaw), 0);
+  const Eigen::Vector3d zb_des = desired_force.normalized();
+  const Eigen::Vector3d yb_des = zb_des.cross(xc_des).normalized();
+  const Eigen::Vector3d xb_des = yb_des.cross(zb_des).normalized();
+
+  Eigen::Matrix3d R_des;
+  R_des.col(0) = xb_des;
+  R_des.col(1) = yb_des;
+  R_des.col(2) = zb_des;
+
+  thrust_msg.header.stamp = node_ptr_->now();
+  thrust_msg.header.frame_id = base_link_frame_id_;
+
+  switch (control_mode_out_.control_mode) {
+    case as2_msgs::msg::ControlMode::ACRO: {
+        // Compute the rotation matrix error
+        const Eigen::Matrix3d Mat_e_rot =
+          (R_des.transpose() * rot_matrix - rot_matrix.transpose() * R_des);
+        const Eigen::Vector3d V_e_rot(Mat_e_rot(2, 1), Mat_e_rot(0, 2), Mat_e_rot(1, 0));
+        const Eigen::Vector3d E_rot = 0.5 * V_e_rot;
+        const Eigen::Vector3d PQR = -Kp_ang_mat_ * E_rot;
+
+        twist_msg.header.stamp = thrust_msg.header.stamp;
+        twist_msg.header.frame_id = base_link_frame_id_;
+        twist_msg.twist.angular.x = PQR.x();
+        twist_msg.twist.angular.y = PQR.y();
+        twist_msg.twist.angular.z = PQR.z();
+        thrust_msg.thrust = desired_force.dot(rot_matrix.col(2).normalized());
+        break;
+      }
+    case as2_msgs::msg::ControlMode::ATTITUDE: {
+        const Eigen::Quaterniond q_des(R_des);
+        pose_msg.header.stamp = thrust_msg.header.stamp;
+        pose_msg.header.frame_id = odom_frame_id_;
+        pose_msg.pose.orientation.x = q_des.x();
+        pose_msg.pose.orientation.y = q_des.y();
+        pose_msg.pose.orientation.z = q_des.z();
+        pose_msg.pose.orientation.w = q_des.w();
+        thrust_msg.thrust = desired_force.norm();
+        break;
+      }
+    default:
+      auto & clk = *node_ptr_->get_clock();
+      RCLCPP_ERROR_THROTTLE(node_ptr_->get_logger(), clk, 5000, "Unknown output control mode");
+      return false;
+  }
+  return true;
+}
+
+}  // namespace linear_mpc_controller
+
+#include <pluginlib/class_list_macros.hpp>
+PLUGINLIB_EXPORT_CLASS(
+  linear_mpc_controller::Plugin,
+  as2_motion_controller_plugin_base::ControllerBase)
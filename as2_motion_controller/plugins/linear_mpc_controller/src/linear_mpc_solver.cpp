@@ -0,0 +1,236 @@
+// Copyright 2024 Universidad Politécnica de Madrid
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the Universidad Politécnica de Madrid nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/*!*******************************************************************************************
+ *  \file       linear_mpc_solver.cpp
+ *  \brief      Condensed linear MPC solver for one double integrator axis, solved with ADMM
+ *  \authors    Miguel Fernández Cortizas
+ *              Rafael Pérez Seguí
+ ********************************************************************************************/
+
+#include "linear_mpc_solver.hpp"
+
+#include <algorithm>
+
+namespace linear_mpc_controller
+{
+
+bool LinearMPCSolver::setup(
+  const int horizon, const double dt,
+  const MPCWeights & weights, const MPCLimits & limits,
+  const ADMMSettings & settings)
+{
+  if (horizon < 1 || horizon > kMaxHorizon || dt <= 0.0 ||
+    weights.position < 0.0 || weights.velocity < 0.0 || weights.acceleration < 0.0 ||
+    limits.max_acceleration <= 0.0 || limits.max_velocity <= 0.0 ||
+    settings.rho <= 0.0 || settings.sigma < 0.0 || settings.alpha <= 0.0 ||
+    settings.alpha >= 2.0 || settings.max_iterations < 1)
+  {
+    horizon_ = 0;
+    return false;
+  }
+
+  const int n = horizon;
+  dt_ = dt;
+  weights_ = weights;
+  limits_ = limits;
+  settings_ = settings;
+
+  // Position at step k + 1 due to the acceleration applied at step j <= k
+  position_gain_.setZero(n, n);
+  for (int k = 0; k < n; k++) {
+    for (int j = 0; j <= k; j++) {
+      position_gain_(k, j) = dt * dt * (k - j + 0.5);
+    }
+  }
+
+  // Sv' Sv, with Sv the lower triangular matrix of dt
+  HorizonMatrix velocity_hessian(n, n);
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < n; j++) {
+      velocity_hessian(i, j) = dt * dt * (n - std::max(i, j));
+    }
+  }
+
+  hessian_.noalias() = weights.position * position_gain_.transpose() * position_gain_;
+  hessian_ += weights.velocity * velocity_hessian;
+  hessian_.diagonal().array() += weights.acceleration;
+
+  // A'A = I + Sv' Sv
+  HorizonMatrix kkt = hessian_ + settings.rho * velocity_hessian;
+  kkt.diagonal().array() += settings.sigma + settings.rho;
+  kkt_llt_.compute(kkt);
+  if (kkt_llt_.info() != Eigen::Success) {
+    horizon_ = 0;
+    return false;
+  }
+
+  lower_.resize(2 * n);
+  upper_.resize(2 * n);
+  lower_.head(n).setConstant(-limits.max_acceleration);
+  upper_.head(n).setConstant(limits.max_acceleration);
+
+  gradient_.setZero(n);
+  x_tilde_.setZero(n);
+  rhs_.setZero(n);
+  aux_.setZero(n);
+  z_tilde_.setZero(2 * n);
+  residual_.setZero(2 * n);
+
+  horizon_ = n;
+  resetWarmStart();
+  return true;
+}
+
+void LinearMPCSolver::resetWarmStart()
+{
+  x_.setZero(horizon_);
+  z_.setZero(2 * horizon_);
+  y_.setZero(2 * horizon_);
+  iterations_ = 0;
+}
+
+void LinearMPCSolver::shiftWarmStart(const int steps)
+{
+  const int n = horizon_;
+  if (steps <= 0 || n == 0) {
+    return;
+  }
+  if (steps >= n) {
+    resetWarmStart();
+    return;
+  }
+  // Move the tail of the horizon forward and hold its last value
+  for (int k = 0; k < n; k++) {
+    const int from = std::min(k + steps, n - 1);
+    x_(k) = x_(from);
+    z_(k) = z_(from);
+    z_(n + k) = z_(n + from);
+    y_(k) = y_(from);
+    y_(n + k) = y_(n + from);
+  }
+}
+
+bool LinearMPCSolver::solve(
+  const double position, const double velocity,
+  const HorizonVector & position_ref,
+  const HorizonVector & velocity_ref,
+  const HorizonVector & acceleration_ref)
+{
+  const int n = horizon_;
+  if (n == 0 || position_ref.size() < n || velocity_ref.size() < n ||
+    acceleration_ref.size() < n)
+  {
+    return false;
+  }
+
+  // f = wp Sp' (p_free - p_ref) + wv Sv' (v_free - v_ref) - wa a_ref
+  for (int k = 0; k < n; k++) {
+    aux_(k) = weights_.position * (position + (k + 1) * dt_ * velocity - position_ref(k));
+  }
+  gradient_.noalias() = position_gain_.transpose() * aux_;
+  for (int k = 0; k < n; k++) {
+    aux_(k) = weights_.velocity * (velocity - velocity_ref(k));
+  }
+  velocityGainTransposed(aux_, rhs_);
+  gradient_ += rhs_;
+  gradient_ -= weights_.acceleration * acceleration_ref.head(n);
+
+  // Velocity bounds are relative to the current velocity
+  lower_.tail(n).setConstant(-limits_.max_velocity - velocity);
+  upper_.tail(n).setConstant(limits_.max_velocity - velocity);
+
+  const double rho = settings_.rho;
+  const double sigma = settings_.sigma;
+  const double alpha = settings_.alpha;
+  for (iterations_ = 1; iterations_ <= settings_.max_iterations; iterations_++) {
+    // x_tilde = (H + sigma I + rho A'A)^-1 (sigma x - f + A' (rho z - y))
+    z_tilde_ = rho * z_ - y_;
+    constraintTransposed(z_tilde_, rhs_);
+    rhs_ += sigma * x_ - gradient_;
+    kkt_llt_.solveInPlace(rhs_);
+    x_tilde_ = rhs_;
+
+    // Relaxed update of the primal, constrained and dual variables
+    constraint(x_tilde_, z_tilde_);
+    x_ = alpha * x_tilde_ + (1.0 - alpha) * x_;
+    z_tilde_ = alpha * z_tilde_ + (1.0 - alpha) * z_;
+    residual_ = z_tilde_ + y_ / rho;
+    z_ = residual_.cwiseMax(lower_).cwiseMin(upper_);
+    y_ = rho * (residual_ - z_);
+
+    // Primal residual |A x - z| and dual residual |H x + f + A' y|
+    constraint(x_, residual_);
+    const double primal_residual = (residual_ - z_).lpNorm<Eigen::Infinity>();
+    constraintTransposed(y_, aux_);
+    aux_.noalias() += hessian_ * x_;
+    aux_ += gradient_;
+    const double dual_residual = aux_.lpNorm<Eigen::Infinity>();
+    if (primal_residual <= settings_.tolerance && dual_residual <= settings_.tolerance) {
+      return true;
+    }
+  }
+  iterations_ = settings_.max_iterations;
+  return false;
+}
+
+void LinearMPCSolver::velocityGainTransposed(
+  const HorizonVector & in,
+  HorizonVector & out) const
+{
+  double sum = 0.0;
+  for (int k = horizon_ - 1; k >= 0; k--) {
+    sum += in(k);
+    out(k) = dt_ * sum;
+  }
+}
+
+void LinearMPCSolver::constraint(const HorizonVector & in, ConstraintVector & out) const
+{
+  const int n = horizon_;
+  double sum = 0.0;
+  for (int k = 0; k < n; k++) {
+    sum += in(k);
+    out(k) = in(k);
+    out(n + k) = dt_ * sum;
+  }
+}
+
+void LinearMPCSolver::constraintTransposed(
+  const ConstraintVector & in,
+  HorizonVector & out) const
+{
+  const int n = horizon_;
+  double sum = 0.0;
+  for (int k = n - 1; k >= 0; k--) {
+    sum += in(n + k);
+    out(k) = in(k) + dt_ * sum;
+  }
+}
+
+}  // namespace linear_mpc_controller
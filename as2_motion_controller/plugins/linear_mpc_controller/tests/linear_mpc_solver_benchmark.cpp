@@ -0,0 +1,96 @@
+// Copyright 2024 Universidad Politécnica de Madrid
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the Universidad Politécnica de Madrid nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+ * @file linear_mpc_solver_benchmark.cpp
+ *
+ * LinearMPCSolver solve time against the prediction horizon
+ *
+ * @authors Rafael Pérez Seguí
+ */
+
+#include <benchmark/benchmark.h>
+
+#include "linear_mpc_solver.hpp"
+
+using linear_mpc_controller::ADMMSettings;
+using linear_mpc_controller::HorizonVector;
+using linear_mpc_controller::LinearMPCSolver;
+using linear_mpc_controller::MPCLimits;
+using linear_mpc_controller::MPCWeights;
+
+static void BM_SetupHorizon(benchmark::State & state)
+{
+  const int horizon = state.range(0);
+  LinearMPCSolver solver;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+      solver.setup(horizon, 0.1, MPCWeights(), MPCLimits(), ADMMSettings()));
+  }
+}
+BENCHMARK(BM_SetupHorizon)->Arg(10)->Arg(20)->Arg(30)->Arg(40)->Arg(50);
+
+// Tracking a moving reference, with the solution shifted between calls as in the controller
+static void BM_SolveHorizon(benchmark::State & state)
+{
+  const int horizon = state.range(0);
+  const bool warm_start = state.range(1);
+  const double dt = 0.1;
+  LinearMPCSolver solver;
+  solver.setup(horizon, dt, MPCWeights(), MPCLimits(), ADMMSettings());
+
+  HorizonVector position_ref(horizon);
+  HorizonVector velocity_ref = HorizonVector::Constant(horizon, 1.0);
+  HorizonVector acceleration_ref = HorizonVector::Zero(horizon);
+  double position = 0.0;
+  double velocity = 0.0;
+  int64_t iterations = 0;
+  for (auto _ : state) {
+    for (int k = 0; k < horizon; k++) {
+      position_ref(k) = position + 0.5 + (k + 1) * dt;
+    }
+    if (!warm_start) {
+      solver.resetWarmStart();
+    }
+    solver.solve(position, velocity, position_ref, velocity_ref, acceleration_ref);
+    benchmark::DoNotOptimize(solver.getAcceleration());
+    iterations += solver.getIterations();
+
+    const double acceleration = solver.getAcceleration();
+    position += velocity * dt + 0.5 * acceleration * dt * dt;
+    velocity += acceleration * dt;
+    solver.shiftWarmStart(1);
+  }
+  state.counters["admm_iterations"] =
+    benchmark::Counter(static_cast<double>(iterations), benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_SolveHorizon)
+->ArgNames({"horizon", "warm_start"})
+->ArgsProduct({{5, 10, 20, 30, 40, 50}, {0, 1}});
+
+BENCHMARK_MAIN();
@@ -0,0 +1,184 @@
+// Copyright 2024 Universidad Politécnica de Madrid
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the Universidad Politécnica de Madrid nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+ * @file linear_mpc_solver_gtest.cpp
+ *
+ * LinearMPCSolver gtest
+ *
+ * @authors Rafael Pérez Seguí
+ */
+
+#include <gtest/gtest.h>
+
+#include "linear_mpc_solver.hpp"
+
+using linear_mpc_controller::ADMMSettings;
+using linear_mpc_controller::HorizonVector;
+using linear_mpc_controller::LinearMPCSolver;
+using linear_mpc_controller::MPCLimits;
+using linear_mpc_controller::MPCWeights;
+
+namespace
+{
+constexpr int kHorizon = 20;
+constexpr double kDt = 0.1;
+
+// Predicted positions and velocities obtained by simulating the double integrator
+void simulate(
+  const double p0, const double v0, const HorizonVector & accelerations,
+  HorizonVector & positions, HorizonVector & velocities)
+{
+  const int n = accelerations.size();
+  positions.resize(n);
+  velocities.resize(n);
+  double p = p0;
+  double v = v0;
+  for (int k = 0; k < n; k++) {
+    p += v * kDt + 0.5 * accelerations(k) * kDt * kDt;
+    v += accelerations(k) * kDt;
+    positions(k) = p;
+    velocities(k) = v;
+  }
+}
+
+HorizonVector constant(const double value)
+{
+  return HorizonVector::Constant(kHorizon, value);
+}
+}  // namespace
+
+TEST(LinearMPCSolverGTest, SetupRejectsInvalidArguments) {
+  LinearMPCSolver solver;
+  EXPECT_FALSE(solver.setup(0, kDt, MPCWeights(), MPCLimits(), ADMMSettings()));
+  EXPECT_FALSE(
+    solver.setup(
+      linear_mpc_controller::kMaxHorizon + 1, kDt, MPCWeights(), MPCLimits(),
+      ADMMSettings()));
+  EXPECT_FALSE(solver.setup(kHorizon, 0.0, MPCWeights(), MPCLimits(), ADMMSettings()));
+  EXPECT_FALSE(solver.isSetup());
+  EXPECT_FALSE(solver.solve(0.0, 0.0, constant(0.0), constant(0.0), constant(0.0)));
+  EXPECT_TRUE(solver.setup(kHorizon, kDt, MPCWeights(), MPCLimits(), ADMMSettings()));
+  EXPECT_TRUE(solver.isSetup());
+}
+
+TEST(LinearMPCSolverGTest, UnconstrainedMatchesLeastSquares) {
+  MPCWeights weights;
+  MPCLimits limits;
+  limits.max_acceleration = 1e3;
+  limits.max_velocity = 1e3;
+  ADMMSettings settings;
+  settings.tolerance = 1e-9;
+  settings.max_iterations = 500;
+
+  LinearMPCSolver solver;
+  ASSERT_TRUE(solver.setup(kHorizon, kDt, weights, limits, settings));
+  const double p0 = -1.0;
+  const double v0 = 0.5;
+  ASSERT_TRUE(solver.solve(p0, v0, constant(2.0), constant(0.0), constant(0.0)));
+
+  // Build the same cost by simulating the response to each acceleration
+  Eigen::MatrixXd sp(kHorizon, kHorizon);
+  Eigen::MatrixXd sv(kHorizon, kHorizon);
+  HorizonVector p_free, v_free, p_unit, v_unit;
+  simulate(p0, v0, constant(0.0), p_free, v_free);
+  for (int j = 0; j < kHorizon; j++) {
+    HorizonVector unit = constant(0.0);
+    unit(j) = 1.0;
+    simulate(0.0, 0.0, unit, p_unit, v_unit);
+    sp.col(j) = p_unit;
+    sv.col(j) = v_unit;
+  }
+  const Eigen::MatrixXd h = weights.position * sp.transpose() * sp +
+    weights.velocity * sv.transpose() * sv +
+    weights.acceleration * Eigen::MatrixXd::Identity(kHorizon, kHorizon);
+  const Eigen::VectorXd f = weights.position * sp.transpose() * (p_free - constant(2.0)) +
+    weights.velocity * sv.transpose() * v_free;
+  const Eigen::VectorXd expected = h.ldlt().solve(-f);
+
+  for (int k = 0; k < kHorizon; k++) {
+    EXPECT_NEAR(solver.getAccelerations()(k), expected(k), 1e-5);
+  }
+}
+
+TEST(LinearMPCSolverGTest, RespectsAccelerationAndVelocityLimits) {
+  MPCLimits limits;
+  limits.max_acceleration = 2.0;
+  limits.max_velocity = 1.0;
+  ADMMSettings settings;
+  settings.max_iterations = 500;
+
+  LinearMPCSolver solver;
+  ASSERT_TRUE(solver.setup(kHorizon, kDt, MPCWeights(), limits, settings));
+  solver.solve(0.0, 0.0, constant(10.0), constant(0.0), constant(0.0));
+
+  // Far from the reference: accelerate at the limit
+  EXPECT_NEAR(solver.getAcceleration(), limits.max_acceleration, 1e-3);
+
+  HorizonVector positions, velocities;
+  simulate(0.0, 0.0, solver.getAccelerations(), positions, velocities);
+  const double tolerance = 1e-2;
+  for (int k = 0; k < kHorizon; k++) {
+    EXPECT_LE(std::abs(solver.getAccelerations()(k)), limits.max_acceleration + tolerance);
+    EXPECT_LE(std::abs(velocities(k)), limits.max_velocity + tolerance);
+  }
+}
+
+TEST(LinearMPCSolverGTest, WarmStartReducesIterations) {
+  ADMMSettings settings;
+  settings.max_iterations = 500;
+
+  LinearMPCSolver solver;
+  ASSERT_TRUE(solver.setup(kHorizon, kDt, MPCWeights(), MPCLimits(), settings));
+  ASSERT_TRUE(solver.solve(0.0, 0.0, constant(3.0), constant(0.0), constant(0.0)));
+  const int cold_iterations = solver.getIterations();
+
+  ASSERT_TRUE(solver.solve(0.0, 0.0, constant(3.0), constant(0.0), constant(0.0)));
+  EXPECT_LT(solver.getIterations(), cold_iterations);
+
+  solver.resetWarmStart();
+  ASSERT_TRUE(solver.solve(0.0, 0.0, constant(3.0), constant(0.0), constant(0.0)));
+  EXPECT_EQ(solver.getIterations(), cold_iterations);
+}
+
+TEST(LinearMPCSolverGTest, ClosedLoopReachesReference) {
+  LinearMPCSolver solver;
+  ASSERT_TRUE(solver.setup(kHorizon, kDt, MPCWeights(), MPCLimits(), ADMMSettings()));
+
+  double p = 0.0;
+  double v = 0.0;
+  for (int step = 0; step < 100; step++) {
+    solver.solve(p, v, constant(1.5), constant(0.0), constant(0.0));
+    const double a = solver.getAcceleration();
+    p += v * kDt + 0.5 * a * kDt * kDt;
+    v += a * kDt;
+    solver.shiftWarmStart(1);
+  }
+  EXPECT_NEAR(p, 1.5, 1e-2);
+  EXPECT_NEAR(v, 0.0, 1e-2);
+}
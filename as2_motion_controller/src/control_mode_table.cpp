@@ -0,0 +1,189 @@
+// Copyright 2024 Universidad Politécnica de Madrid
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the Universidad Politécnica de Madrid nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/*!*******************************************************************************************
+ *  \file       control_mode_table.cpp
+ *  \brief      Precomputed control mode compatibility table implementation
+ *  \authors    Miguel Fernández Cortizas
+ *              Rafael Pérez Seguí
+ ********************************************************************************************/
+
+#include "as2_motion_controller/control_mode_table.hpp"
+
+namespace controller_handler
+{
+
+static inline bool checkMatchWithMask(
+  const uint8_t mode1,
+  const uint8_t mode2,
+  const uint8_t mask)
+{
+  return (mode1 & mask) == (mode2 & mask);
+}
+
+static uint8_t findBestMatchWithMask(
+  const uint8_t mode,
+  const std::vector<uint8_t> & mode_list,
+  const uint8_t mask)
+{
+  uint8_t best_match = 0;
+  for (const auto & candidate : mode_list) {
+    if (checkMatchWithMask(mode, candidate, mask)) {
+      best_match = candidate;
+      if (candidate == mode) {
+        return candidate;
+      }
+    }
+  }
+  return best_match;
+}
+
+static bool findSuitableOutputControlModeForPlatformInputMode(
+  uint8_t & output_mode,
+  const std::vector<uint8_t> & controller_modes_out,
+  const std::vector<uint8_t> & platform_modes_in,
+  const uint8_t prefered_output_mode)
+{
+  //  check if the prefered mode is available
+  if (prefered_output_mode) {
+    auto match = findBestMatchWithMask(
+      prefered_output_mode, platform_modes_in,
+      MATCH_MODE_AND_YAW);
+    if (match) {
+      output_mode = match;
+      return true;
+    }
+  }
+
+  // if the prefered mode is not available, search for the first common mode
+  uint8_t common_mode = 0;
+  for (auto & mode_out : controller_modes_out) {
+    // skip unset modes and hover
+    if ((mode_out & MATCH_MODE) == UNSET_MODE_MASK || (mode_out & MATCH_MODE) == HOVER_MODE_MASK) {
+      continue;
+    }
+    common_mode = findBestMatchWithMask(mode_out, platform_modes_in, MATCH_MODE_AND_YAW);
+    if (common_mode) {
+      break;
+    }
+  }
+
+  // check if the common mode exist
+  if (common_mode == 0) {
+    return false;
+  }
+  output_mode = common_mode;
+  return true;
+}
+
+static ControlModeResolution::Status checkSuitabilityInputMode(
+  uint8_t & input_mode,
+  const uint8_t output_mode,
+  const std::vector<uint8_t> & controller_modes_in)
+{
+  // check if input_conversion is in the list of available modes
+  bool mode_found = false;
+  for (auto & mode : controller_modes_in) {
+    if ((input_mode & MATCH_MODE) == HOVER_MODE_MASK && (input_mode & MATCH_MODE) == mode) {
+      return ControlModeResolution::Status::OK;
+    } else if (mode == input_mode) {
+      input_mode = mode;
+      mode_found = true;
+      break;
+    }
+  }
+
+  // if not match, try to match only control mode and yaw mode
+  if (!mode_found) {
+    for (auto & mode : controller_modes_in) {
+      if (checkMatchWithMask(mode, input_mode, MATCH_MODE_AND_YAW)) {
+        input_mode = mode;
+        mode_found = true;
+        break;
+      }
+    }
+  }
+
+  // check if the input mode is compatible with the output mode
+  if ((input_mode & MATCH_MODE) < (output_mode & 0b1111000)) {
+    return ControlModeResolution::Status::INPUT_LOWER_LEVEL;
+  }
+
+  return mode_found ?
+         ControlModeResolution::Status::OK :
+         ControlModeResolution::Status::INPUT_NOT_AVAILABLE;
+}
+
+void ControlModeTable::build(
+  const std::vector<uint8_t> & controller_modes_in,
+  const std::vector<uint8_t> & controller_modes_out,
+  const std::vector<uint8_t> & platform_modes_in,
+  const uint8_t prefered_output_mode)
+{
+  bool platform_hover_available = false;
+  for (auto & mode : platform_modes_in) {
+    if ((mode & MATCH_MODE) == HOVER_MODE_MASK) {
+      platform_hover_available = true;
+      break;
+    }
+  }
+
+  // The output mode does not depend on the requested mode
+  uint8_t output_mode = 0;
+  const bool output_mode_found = findSuitableOutputControlModeForPlatformInputMode(
+    output_mode, controller_modes_out, platform_modes_in, prefered_output_mode);
+
+  for (int mode = 0; mode < static_cast<int>(table_.size()); ++mode) {
+    const uint8_t requested_mode = static_cast<uint8_t>(mode);
+    ControlModeResolution & resolution = table_[requested_mode];
+    resolution = ControlModeResolution();
+
+    // Bypass: the platform accepts the requested mode (discarding the reference frame)
+    if ((requested_mode & MATCH_MODE) == HOVER_MODE_MASK) {
+      resolution.bypass_available = platform_hover_available;
+      resolution.bypass_output_mode = HOVER_MODE_MASK;
+    } else if ((requested_mode & MATCH_MODE) != UNSET_MODE_MASK) {
+      resolution.bypass_output_mode =
+        findBestMatchWithMask(requested_mode, platform_modes_in, MATCH_MODE_AND_YAW);
+      resolution.bypass_available = resolution.bypass_output_mode != 0;
+    }
+
+    // Controller: best output mode for the platform and best input mode for that output
+    if (!output_mode_found) {
+      resolution.status = ControlModeResolution::Status::NO_OUTPUT_MODE;
+      continue;
+    }
+    uint8_t input_mode = requested_mode;
+    resolution.status = checkSuitabilityInputMode(input_mode, output_mode, controller_modes_in);
+    resolution.input_mode = input_mode;
+    resolution.output_mode = output_mode;
+  }
+  built_ = true;
+}
+
+}  // namespace controller_handler
@@ -36,40 +36,55 @@
 #include "as2_motion_controller/controller_handler.hpp"
 #include <as2_core/utils/tf_utils.hpp>
 
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
 namespace controller_handler
 {
 
-static inline bool checkMatchWithMask(
-  const uint8_t mode1,
-  const uint8_t mode2,
-  const uint8_t mask)
+// Releases a locked mutex for the lifetime of the object, to make a blocking call without it
+class ScopedUnlock
 {
-  return (mode1 & mask) == (mode2 & mask);
-}
-
-static uint8_t findBestMatchWithMask(
-  const uint8_t mode,
-  const std::vector<uint8_t> & mode_list,
-  const uint8_t mask)
+public:
+  explicit ScopedUnlock(std::mutex & mutex)
+  : mutex_(mutex) {mutex_.unlock();}
+  ~ScopedUnlock() {mutex_.lock();}
+
+private:
+  std::mutex & mutex_;
+};
+
+static std::vector<rclcpp::Parameter> filterParameters(
+  const std::vector<rclcpp::Parameter> & parameters,
+  const std::string & prefix)
 {
-  uint8_t best_match = 0;
-  for (const auto & candidate : mode_list) {
-    if (checkMatchWithMask(mode, candidate, mask)) {
-      best_match = candidate;
-      if (candidate == mode) {
-        return candidate;
-      }
+  if (prefix.empty()) {
+    return parameters;
+  }
+  std::vector<rclcpp::Parameter> filtered_parameters;
+  for (const auto & parameter : parameters) {
+    if (parameter.get_name().rfind(prefix, 0) == 0) {
+      filtered_parameters.emplace_back(
+        parameter.get_name().substr(prefix.size()), parameter.get_parameter_value());
     }
   }
-  return best_match;
+  return filtered_parameters;
 }
 
 ControllerHandler::ControllerHandler(
   std::shared_ptr<as2_motion_controller_plugin_base::ControllerBase> controller,
-  as2::Node * node)
-: controller_ptr_(controller), node_ptr_(node), tf_handler_(node)
+  as2::Node * node,
+  std::shared_ptr<tf2_ros::Buffer> tf_buffer,
+  bool external_control_step)
+: node_ptr_(node),
+  tf_handler_(tf_buffer ? as2::tf::TfHandler(node, tf_buffer) : as2::tf::TfHandler(node)),
+  controller_ptr_(controller)
 {
   node_ptr_->get_parameter("use_bypass", use_bypass_);
+  node_ptr_->get_parameter("bypass_pass_through", bypass_pass_through_);
+  node_ptr_->get_parameter("use_odometry", use_odometry_);
   node_ptr_->get_parameter("odom_frame_id", enu_frame_id_);
   node_ptr_->get_parameter("base_frame_id", flu_frame_id_);
 
@@ -84,22 +99,29 @@ ControllerHandler::ControllerHandler(
   // Subscribers
   ref_pose_sub_ = node_ptr_->create_subscription<geometry_msgs::msg::PoseStamped>(
     as2_names::topics::motion_reference::pose, as2_names::topics::motion_reference::qos,
-    std::bind(&ControllerHandler::refPoseCallback, this, std::placeholders::_1));
+    [this](geometry_msgs::msg::PoseStamped::UniquePtr msg) {refPoseCallback(std::move(msg));});
   ref_twist_sub_ = node_ptr_->create_subscription<geometry_msgs::msg::TwistStamped>(
     as2_names::topics::motion_reference::twist, as2_names::topics::motion_reference::qos,
-    std::bind(&ControllerHandler::refTwistCallback, this, std::placeholders::_1));
+    [this](geometry_msgs::msg::TwistStamped::UniquePtr msg) {refTwistCallback(std::move(msg));});
   ref_traj_sub_ = node_ptr_->create_subscription<as2_msgs::msg::TrajectorySetpoints>(
     as2_names::topics::motion_reference::trajectory, as2_names::topics::motion_reference::qos,
-    std::bind(&ControllerHandler::refTrajCallback, this, std::placeholders::_1));
+    [this](as2_msgs::msg::TrajectorySetpoints::UniquePtr msg) {refTrajCallback(std::move(msg));});
   ref_thrust_sub_ = node_ptr_->create_subscription<as2_msgs::msg::Thrust>(
     as2_names::topics::motion_reference::thrust, as2_names::topics::motion_reference::qos,
     std::bind(&ControllerHandler::refThrustCallback, this, std::placeholders::_1));
   platform_info_sub_ = node_ptr_->create_subscription<as2_msgs::msg::PlatformInfo>(
     as2_names::topics::platform::info, as2_names::topics::platform::qos,
     std::bind(&ControllerHandler::platformInfoCallback, this, std::placeholders::_1));
-  twist_sub_ = node_ptr_->create_subscription<geometry_msgs::msg::TwistStamped>(
-    as2_names::topics::self_localization::twist, as2_names::topics::self_localization::qos,
-    std::bind(&ControllerHandler::stateCallback, this, std::placeholders::_1));
+  if (use_odometry_) {
+    // Pose and twist in one message, no TF lookup when the frames match the controller ones
+    odometry_sub_ = node_ptr_->create_subscription<nav_msgs::msg::Odometry>(
+      as2_names::topics::self_localization::odom, as2_names::topics::self_localization::qos,
+      std::bind(&ControllerHandler::odometryCallback, this, std::placeholders::_1));
+  } else {
+    twist_sub_ = node_ptr_->create_subscription<geometry_msgs::msg::TwistStamped>(
+      as2_names::topics::self_localization::twist, as2_names::topics::self_localization::qos,
+      std::bind(&ControllerHandler::stateCallback, this, std::placeholders::_1));
+  }
 
   // Publishers
   trajectory_pub_ = node_ptr_->create_publisher<as2_msgs::msg::TrajectorySetpoints>(
@@ -110,15 +132,34 @@ ControllerHandler::ControllerHandler(
     as2_names::topics::actuator_command::twist, as2_names::topics::actuator_command::qos);
   thrust_pub_ = node_ptr_->create_publisher<as2_msgs::msg::Thrust>(
     as2_names::topics::actuator_command::thrust, as2_names::topics::actuator_command::qos);
+  mode_switch_latency_pub_ = node_ptr_->create_publisher<std_msgs::msg::Float64>(
+    as2_names::topics::controller::mode_switch_latency, as2_names::topics::controller::qos_info);
 
   // Services servers
   set_control_mode_srv_ = node_ptr_->create_service<as2_msgs::srv::SetControlMode>(
     as2_names::services::controller::set_control_mode,
-    std::bind(
-      &ControllerHandler::setControlModeSrvCall, this,
-      std::placeholders::_1,            // Corresponds to the 'request'  input
-      std::placeholders::_2             // Corresponds to the 'response' input
-  ));
+    [this](
+      const as2_msgs::srv::SetControlMode::Request::SharedPtr request,
+      as2_msgs::srv::SetControlMode::Response::SharedPtr response) {
+      std::lock_guard<std::mutex> switch_lock(mode_switch_mutex_);
+      std::lock_guard<std::mutex> lock(mutex_);
+      const auto start = std::chrono::steady_clock::now();
+      beginModeSwitch();
+      setControlModeSrvCall(request, response);
+      endModeSwitch(std::chrono::steady_clock::now() - start);
+    });
+  set_controller_srv_ = node_ptr_->create_service<as2_msgs::srv::SetController>(
+    as2_names::services::controller::set_controller,
+    [this](
+      const as2_msgs::srv::SetController::Request::SharedPtr request,
+      as2_msgs::srv::SetController::Response::SharedPtr response) {
+      std::lock_guard<std::mutex> switch_lock(mode_switch_mutex_);
+      std::lock_guard<std::mutex> lock(mutex_);
+      const auto start = std::chrono::steady_clock::now();
+      beginModeSwitch();
+      setControllerSrvCall(request, response);
+      endModeSwitch(std::chrono::steady_clock::now() - start);
+    });
 
   // Services clients
   set_control_mode_client_ =
@@ -129,15 +170,17 @@ ControllerHandler::ControllerHandler(
     as2_names::services::platform::list_control_modes, node_ptr_);
 
   // Timers
-  double cmd_freq = 0.0;
-  node_ptr_->get_parameter("cmd_freq", cmd_freq);
-  control_timer_ =
-    node_ptr_->create_timer(
-    std::chrono::duration<double>(1.0 / cmd_freq),
-    std::bind(&ControllerHandler::controlTimerCallback, this));
+  if (!external_control_step) {
+    double cmd_freq = 0.0;
+    node_ptr_->get_parameter("cmd_freq", cmd_freq);
+    control_timer_ =
+      node_ptr_->create_timer(
+      std::chrono::duration<double>(1.0 / cmd_freq),
+      std::bind(&ControllerHandler::controlStep, this));
+  }
 
   // Initialize internal variables
-  static auto parameters_callback_handle_ = node_ptr_->add_on_set_parameters_callback(
+  parameters_callback_handle_ = node_ptr_->add_on_set_parameters_callback(
     std::bind(&ControllerHandler::parametersCallback, this, std::placeholders::_1));
 
   control_mode_in_.control_mode = as2_msgs::msg::ControlMode::UNSET;
@@ -147,13 +190,21 @@ ControllerHandler::ControllerHandler(
 rcl_interfaces::msg::SetParametersResult ControllerHandler::parametersCallback(
   const std::vector<rclcpp::Parameter> & parameters)
 {
+  std::lock_guard<std::mutex> lock(mutex_);
   rcl_interfaces::msg::SetParametersResult result;
   result.successful = true;
   result.reason = "success";
-  if (!controller_ptr_->updateParams(parameters)) {
+  if (!controller_ptr_->updateParams(filterParameters(parameters, controller_parameters_prefix_))) {
     result.successful = false;
     result.reason = "Failed to update controller parameters";
   }
+  for (auto & standby : standby_controllers_) {
+    if (!standby.controller->updateParams(filterParameters(parameters, standby.parameters_prefix)))
+    {
+      result.successful = false;
+      result.reason = "Failed to update " + standby.name + " parameters";
+    }
+  }
   return result;
 }
 
@@ -171,6 +222,7 @@ void ControllerHandler::setInputControlModesAvailables(const std::vector<uint8_t
   controller_available_modes_in_ = available_modes;
   // sort modes in ascending order
   std::sort(controller_available_modes_in_.begin(), controller_available_modes_in_.end());
+  buildControlModeTable();
 }
 
 void ControllerHandler::setOutputControlModesAvailables(
@@ -179,6 +231,54 @@ void ControllerHandler::setOutputControlModesAvailables(
   controller_available_modes_out_ = available_modes;
   // sort modes in ascending order
   std::sort(controller_available_modes_out_.begin(), controller_available_modes_out_.end());
+  buildControlModeTable();
+}
+
+void ControllerHandler::setPlatformControlModesAvailables(
+  const std::vector<uint8_t> & available_modes)
+{
+  platform_available_modes_in_ = available_modes;
+  buildControlModeTable();
+}
+
+void ControllerHandler::setActiveControllerName(const std::string & name)
+{
+  controller_name_ = name;
+}
+
+void ControllerHandler::addStandbyController(
+  const std::string & name,
+  std::shared_ptr<as2_motion_controller_plugin_base::ControllerBase> controller,
+  const std::vector<uint8_t> & available_modes_in,
+  const std::vector<uint8_t> & available_modes_out,
+  const std::string & parameters_prefix)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  StandbyController standby;
+  standby.name = name;
+  standby.parameters_prefix = parameters_prefix;
+  standby.controller = controller;
+  standby.available_modes_in = available_modes_in;
+  standby.available_modes_out = available_modes_out;
+  // sort modes in ascending order
+  std::sort(standby.available_modes_in.begin(), standby.available_modes_in.end());
+  std::sort(standby.available_modes_out.begin(), standby.available_modes_out.end());
+  standby.pose_frame_id =
+    as2::tf::generateTfName(node_ptr_, controller->getDesiredPoseFrameId());
+  standby.twist_frame_id =
+    as2::tf::generateTfName(node_ptr_, controller->getDesiredTwistFrameId());
+  standby_controllers_.emplace_back(std::move(standby));
+}
+
+void ControllerHandler::buildControlModeTable()
+{
+  if (platform_available_modes_in_.empty()) {
+    control_mode_table_.clear();
+    return;
+  }
+  control_mode_table_.build(
+    controller_available_modes_in_, controller_available_modes_out_,
+    platform_available_modes_in_, prefered_output_mode_);
 }
 
 void ControllerHandler::reset()
@@ -192,13 +292,14 @@ void ControllerHandler::reset()
 void ControllerHandler::stateCallback(
   const geometry_msgs::msg::TwistStamped::SharedPtr _twist_msg)
 {
+  std::lock_guard<std::mutex> lock(mutex_);
   if (!control_mode_established_ || bypass_controller_) {
     return;
   }
 
   try {
-    auto [pose_msg, twist_msg] = tf_handler_.getState(
-      *_twist_msg, input_twist_frame_id_, input_pose_frame_id_, flu_frame_id_);
+    auto [pose_msg, twist_msg] =
+      getState(*_twist_msg, input_twist_frame_id_, input_pose_frame_id_);
 
     state_adquired_ = true;
     state_pose_ = pose_msg;
@@ -206,12 +307,79 @@ void ControllerHandler::stateCallback(
     if (!bypass_controller_) {controller_ptr_->updateState(state_pose_, state_twist_);}
   } catch (tf2::TransformException & ex) {
     RCLCPP_WARN(node_ptr_->get_logger(), "Could not get transform: %s", ex.what());
+    return;
   }
+  updateStandbyControllersState(*_twist_msg);
   return;
 }
 
-void ControllerHandler::refPoseCallback(const geometry_msgs::msg::PoseStamped::SharedPtr msg)
+void ControllerHandler::odometryCallback(const nav_msgs::msg::Odometry::SharedPtr _odom_msg)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!control_mode_established_ || bypass_controller_) {
+    return;
+  }
+
+  try {
+    auto [pose_msg, twist_msg] =
+      getState(*_odom_msg, input_twist_frame_id_, input_pose_frame_id_);
+
+    state_adquired_ = true;
+    state_pose_ = pose_msg;
+    state_twist_ = twist_msg;
+    controller_ptr_->updateState(state_pose_, state_twist_);
+  } catch (tf2::TransformException & ex) {
+    RCLCPP_WARN(node_ptr_->get_logger(), "Could not get transform: %s", ex.what());
+    return;
+  }
+  updateStandbyControllersState(*_odom_msg);
+}
+
+std::pair<geometry_msgs::msg::PoseStamped, geometry_msgs::msg::TwistStamped>
+ControllerHandler::getState(
+  const geometry_msgs::msg::TwistStamped & twist_msg, const std::string & twist_frame_id,
+  const std::string & pose_frame_id)
+{
+  return tf_handler_.getState(twist_msg, twist_frame_id, pose_frame_id, flu_frame_id_);
+}
+
+std::pair<geometry_msgs::msg::PoseStamped, geometry_msgs::msg::TwistStamped>
+ControllerHandler::getState(
+  const nav_msgs::msg::Odometry & odometry_msg, const std::string & twist_frame_id,
+  const std::string & pose_frame_id)
 {
+  return tf_handler_.getState(odometry_msg, twist_frame_id, pose_frame_id);
+}
+
+template<typename StateMsgT>
+void ControllerHandler::updateStandbyControllersState(const StateMsgT & state_msg)
+{
+  for (auto & standby : standby_controllers_) {
+    if (standby.pose_frame_id == input_pose_frame_id_ &&
+      standby.twist_frame_id == input_twist_frame_id_)
+    {
+      standby.state_pose = state_pose_;
+      standby.state_twist = state_twist_;
+    } else {
+      try {
+        std::tie(standby.state_pose, standby.state_twist) =
+          getState(state_msg, standby.twist_frame_id, standby.pose_frame_id);
+      } catch (tf2::TransformException & ex) {
+        auto & clk = *node_ptr_->get_clock();
+        RCLCPP_WARN_THROTTLE(
+          node_ptr_->get_logger(), clk, 1000, "Could not get state for [%s]: %s",
+          standby.name.c_str(), ex.what());
+        continue;
+      }
+    }
+    standby.state_adquired = true;
+    standby.controller->updateState(standby.state_pose, standby.state_twist);
+  }
+}
+
+void ControllerHandler::refPoseCallback(geometry_msgs::msg::PoseStamped::UniquePtr msg)
+{
+  std::lock_guard<std::mutex> lock(mutex_);
   if ((!control_mode_established_ && !bypass_controller_) ||
     control_mode_in_.control_mode == as2_msgs::msg::ControlMode::HOVER ||
     control_mode_in_.control_mode == as2_msgs::msg::ControlMode::UNSET)
@@ -219,23 +387,37 @@ void ControllerHandler::refPoseCallback(const geometry_msgs::msg::PoseStamped::S
     return;
   }
 
-  geometry_msgs::msg::PoseStamped pose_msg = *msg;
-  if (!tf_handler_.tryConvert(pose_msg, input_pose_frame_id_)) {
+  // Forward the reference to the platform as soon as it arrives
+  if (bypass_controller_ && msg->header.frame_id == output_pose_frame_id_ &&
+    (control_mode_out_.control_mode == as2_msgs::msg::ControlMode::POSITION ||
+    control_mode_out_.control_mode == as2_msgs::msg::ControlMode::SPEED_IN_A_PLANE) &&
+    canPassThrough(control_mode_out_.control_mode))
+  {
+    msg->header.stamp = node_ptr_->now();
+    ref_pose_ = *msg;
+    motion_reference_adquired_ = true;
+    reference_passed_through_ = true;
+    pose_pub_->publish(std::move(msg));
+    return;
+  }
+
+  if (!tf_handler_.tryConvert(*msg, input_pose_frame_id_)) {
     auto & clk = *node_ptr_->get_clock();
     RCLCPP_ERROR_THROTTLE(
       node_ptr_->get_logger(), clk, 1000,
       "Failed to convert reference pose to input frame, from %s to %s",
-      pose_msg.header.frame_id.c_str(), input_pose_frame_id_.c_str());
+      msg->header.frame_id.c_str(), input_pose_frame_id_.c_str());
     return;
   }
-  ref_pose_ = pose_msg;
+  ref_pose_ = *msg;
   motion_reference_adquired_ = true;
 
   if (!bypass_controller_) {controller_ptr_->updateReference(ref_pose_);}
 }
 
-void ControllerHandler::refTwistCallback(const geometry_msgs::msg::TwistStamped::SharedPtr msg)
+void ControllerHandler::refTwistCallback(geometry_msgs::msg::TwistStamped::UniquePtr msg)
 {
+  std::lock_guard<std::mutex> lock(mutex_);
   if ((!control_mode_established_ && !bypass_controller_) ||
     control_mode_in_.control_mode == as2_msgs::msg::ControlMode::HOVER ||
     control_mode_in_.control_mode == as2_msgs::msg::ControlMode::UNSET)
@@ -243,23 +425,38 @@ void ControllerHandler::refTwistCallback(const geometry_msgs::msg::TwistStamped:
     return;
   }
 
-  geometry_msgs::msg::TwistStamped twist_msg = *msg;
-  if (!tf_handler_.tryConvert(twist_msg, input_twist_frame_id_)) {
+  // Forward the reference to the platform as soon as it arrives
+  if (bypass_controller_ && msg->header.frame_id == output_twist_frame_id_ &&
+    (control_mode_out_.control_mode == as2_msgs::msg::ControlMode::SPEED ||
+    control_mode_out_.control_mode == as2_msgs::msg::ControlMode::POSITION ||
+    control_mode_out_.control_mode == as2_msgs::msg::ControlMode::SPEED_IN_A_PLANE) &&
+    canPassThrough(control_mode_out_.control_mode))
+  {
+    msg->header.stamp = node_ptr_->now();
+    ref_twist_ = *msg;
+    motion_reference_adquired_ = true;
+    reference_passed_through_ = true;
+    twist_pub_->publish(std::move(msg));
+    return;
+  }
+
+  if (!tf_handler_.tryConvert(*msg, input_twist_frame_id_)) {
     auto & clk = *node_ptr_->get_clock();
     RCLCPP_ERROR_THROTTLE(
       node_ptr_->get_logger(), clk, 1000,
       "Failed to convert reference twist to input frame, from %s to %s",
-      twist_msg.header.frame_id.c_str(), input_twist_frame_id_.c_str());
+      msg->header.frame_id.c_str(), input_twist_frame_id_.c_str());
     return;
   }
-  ref_twist_ = twist_msg;
+  ref_twist_ = *msg;
   motion_reference_adquired_ = true;
 
   if (!bypass_controller_) {controller_ptr_->updateReference(ref_twist_);}
 }
 
-void ControllerHandler::refTrajCallback(const as2_msgs::msg::TrajectorySetpoints::SharedPtr msg)
+void ControllerHandler::refTrajCallback(as2_msgs::msg::TrajectorySetpoints::UniquePtr msg)
 {
+  std::lock_guard<std::mutex> lock(mutex_);
   if ((!control_mode_established_ && !bypass_controller_) ||
     control_mode_in_.control_mode == as2_msgs::msg::ControlMode::HOVER ||
     control_mode_in_.control_mode == as2_msgs::msg::ControlMode::UNSET)
@@ -282,11 +479,20 @@ void ControllerHandler::refTrajCallback(const as2_msgs::msg::TrajectorySetpoints
 
   motion_reference_adquired_ = true;
   ref_traj_ = *msg;
-  if (!bypass_controller_) {controller_ptr_->updateReference(ref_traj_);}
+  if (!bypass_controller_) {
+    controller_ptr_->updateReference(ref_traj_);
+  } else if (control_mode_out_.control_mode == as2_msgs::msg::ControlMode::TRAJECTORY &&
+    canPassThrough(control_mode_out_.control_mode))
+  {
+    // Forward the reference to the platform as soon as it arrives
+    reference_passed_through_ = true;
+    trajectory_pub_->publish(std::move(msg));
+  }
 }
 
 void ControllerHandler::refThrustCallback(const as2_msgs::msg::Thrust::SharedPtr msg)
 {
+  std::lock_guard<std::mutex> lock(mutex_);
   if ((!control_mode_established_ && !bypass_controller_) ||
     control_mode_in_.control_mode == as2_msgs::msg::ControlMode::HOVER ||
     control_mode_in_.control_mode == as2_msgs::msg::ControlMode::UNSET)
@@ -300,6 +506,7 @@ void ControllerHandler::refThrustCallback(const as2_msgs::msg::Thrust::SharedPtr
 
 void ControllerHandler::platformInfoCallback(const as2_msgs::msg::PlatformInfo::SharedPtr msg)
 {
+  std::lock_guard<std::mutex> lock(mutex_);
   platform_info_ = *msg;
 }
 
@@ -313,7 +520,9 @@ void ControllerHandler::setControlModeSrvCall(
   as2_msgs::msg::ControlMode _control_mode_msg_plugin_in;
   as2_msgs::msg::ControlMode _control_mode_msg_plugin_out;
 
+  // References are not forwarded until the platform accepts the new mode
   control_mode_established_ = false;
+  bypass_controller_ = false;
 
   // check if platform_available_modes is set
   if (!listPlatformAvailableControlModes()) {
@@ -330,41 +539,54 @@ void ControllerHandler::setControlModeSrvCall(
       as2::control_mode::convertAS2ControlModeToUint8t(request->control_mode);
   }
 
+  // Resolve the request with the precomputed table
+  requested_control_mode_ = _control_mode_plugin_in;
+  const ControlModeResolution & resolution = control_mode_table_.lookup(_control_mode_plugin_in);
+
   // Check if a bypass is possible for the input_control_mode_desired ( DISCARDING REFERENCE
   // COMPONENT)
-  bypass_controller_ = false;
-  if (use_bypass_) {
-    if (_control_mode_plugin_in == HOVER_MODE_MASK) {
-      if (trySetPlatformHover()) {
-        bypass_controller_ = true;
-        _control_mode_plugin_out = HOVER_MODE_MASK;
-      }
-    } else {
-      bypass_controller_ = tryToBypassController(_control_mode_plugin_in, _control_mode_plugin_out);
-    }
-  }
-
-  if (bypass_controller_) {
+  bool bypass_controller = use_bypass_ && resolution.bypass_available;
+  if (bypass_controller) {
     RCLCPP_INFO(node_ptr_->get_logger(), "Bypassing controller");
     _control_mode_plugin_in = UNSET_MODE_MASK;
+    _control_mode_plugin_out = resolution.bypass_output_mode;
+  } else if (!checkControlModeResolution(resolution)) {
+    RCLCPP_ERROR(node_ptr_->get_logger(), "No suitable control mode found");
+    response->success = false;
+    return;
   } else {
-    bool success = findSuitableControlModes(_control_mode_plugin_in, _control_mode_plugin_out);
-
-    if (!success) {
-      RCLCPP_ERROR(node_ptr_->get_logger(), "No suitable control mode found");
-      response->success = false;
-      return;
-    }
+    _control_mode_plugin_in = resolution.input_mode;
+    _control_mode_plugin_out = resolution.output_mode;
   }
 
   // request the out mode to the platform
   _control_mode_msg_plugin_out =
     as2::control_mode::convertUint8tToAS2ControlMode(_control_mode_plugin_out);
-  if (!setPlatformControlMode(_control_mode_msg_plugin_out)) {
+  bool platform_mode_set = setPlatformControlMode(_control_mode_msg_plugin_out);
+
+  // if the platform rejects hover, fall back to hover through the controller
+  if (!platform_mode_set && bypass_controller &&
+    _control_mode_plugin_out == HOVER_MODE_MASK &&
+    resolution.status == ControlModeResolution::Status::OK)
+  {
+    RCLCPP_ERROR(node_ptr_->get_logger(), "Failed to set platform control mode to HOVER");
+    bypass_controller = false;
+    _control_mode_plugin_in = resolution.input_mode;
+    _control_mode_plugin_out = resolution.output_mode;
+    _control_mode_msg_plugin_out =
+      as2::control_mode::convertUint8tToAS2ControlMode(_control_mode_plugin_out);
+    platform_mode_set = setPlatformControlMode(_control_mode_msg_plugin_out);
+  }
+
+  if (!platform_mode_set) {
     RCLCPP_ERROR(node_ptr_->get_logger(), "Failed to set platform control mode");
+    // The platform modes may have changed, list them again on the next request
+    platform_available_modes_in_.clear();
+    control_mode_table_.clear();
     response->success = false;
     return;
   }
+  bypass_controller_ = bypass_controller;
 
   // request the input and output modes to the platform
   _control_mode_msg_plugin_in =
@@ -434,17 +656,148 @@ void ControllerHandler::setControlModeSrvCall(
 }
 
 
+void ControllerHandler::setControllerSrvCall(
+  const as2_msgs::srv::SetController::Request::SharedPtr request,
+  as2_msgs::srv::SetController::Response::SharedPtr response)
+{
+  if (request->plugin_name == controller_name_) {
+    response->success = true;
+    return;
+  }
+
+  auto standby = std::find_if(
+    standby_controllers_.begin(), standby_controllers_.end(),
+    [&request](const StandbyController & candidate) {
+      return candidate.name == request->plugin_name;
+    });
+  if (standby == standby_controllers_.end()) {
+    response->success = false;
+    response->message = "Controller plugin [" + request->plugin_name + "] is not loaded";
+    RCLCPP_ERROR(node_ptr_->get_logger(), "%s", response->message.c_str());
+    return;
+  }
+
+  response->success = switchController(*standby, response->message);
+  if (!response->success) {
+    RCLCPP_ERROR(node_ptr_->get_logger(), "%s", response->message.c_str());
+    return;
+  }
+  RCLCPP_INFO(
+    node_ptr_->get_logger(), "Controller switched to [%s]", controller_name_.c_str());
+}
+
+bool ControllerHandler::switchController(StandbyController & next, std::string & message)
+{
+  // With the controller in the loop, the next one takes over the current control mode
+  if (control_mode_established_ && !bypass_controller_) {
+    ControlModeTable next_table;
+    next_table.build(
+      next.available_modes_in, next.available_modes_out,
+      platform_available_modes_in_, prefered_output_mode_);
+    const ControlModeResolution & resolution = next_table.lookup(requested_control_mode_);
+    if (resolution.status != ControlModeResolution::Status::OK) {
+      message = "Control mode [" + as2::control_mode::controlModeToString(requested_control_mode_) +
+        "] is not supported by [" + next.name + "]";
+      return false;
+    }
+
+    const as2_msgs::msg::ControlMode mode_in =
+      as2::control_mode::convertUint8tToAS2ControlMode(resolution.input_mode);
+    const as2_msgs::msg::ControlMode mode_out =
+      as2::control_mode::convertUint8tToAS2ControlMode(resolution.output_mode);
+    const bool change_platform_mode = resolution.output_mode !=
+      as2::control_mode::convertAS2ControlModeToUint8t(control_mode_out_);
+    if (change_platform_mode && !setPlatformControlMode(mode_out)) {
+      message = "Failed to set platform control mode";
+      return false;
+    }
+    if (!next.controller->setMode(mode_in, mode_out)) {
+      message = "Failed to set [" + next.name + "] control mode";
+      if (change_platform_mode) {
+        setPlatformControlMode(control_mode_out_);
+      }
+      return false;
+    }
+
+    // Bumpless transfer of the integral terms
+    geometry_msgs::msg::Vector3 integral;
+    if (controller_ptr_->getIntegralState(integral) && next.controller->setIntegralState(integral)) {
+      RCLCPP_INFO(node_ptr_->get_logger(), "Integral state transferred to [%s]", next.name.c_str());
+    }
+
+    control_mode_in_ = mode_in;
+    control_mode_out_ = mode_out;
+    output_pose_frame_id_ = getFrameIdByReferenceFrame(control_mode_out_.reference_frame);
+    output_twist_frame_id_ = getFrameIdByReferenceFrame(control_mode_out_.reference_frame);
+    input_pose_frame_id_ = next.pose_frame_id;
+    input_twist_frame_id_ = next.twist_frame_id;
+
+    if (next.state_adquired) {
+      next.controller->updateState(next.state_pose, next.state_twist);
+    }
+    updateControllerReferences(*next.controller);
+  }
+
+  // Swap the active controller with the standby one. The previous controller keeps receiving
+  // state updates
+  std::swap(controller_ptr_, next.controller);
+  std::swap(controller_name_, next.name);
+  std::swap(controller_parameters_prefix_, next.parameters_prefix);
+  std::swap(controller_available_modes_in_, next.available_modes_in);
+  std::swap(controller_available_modes_out_, next.available_modes_out);
+  std::swap(state_adquired_, next.state_adquired);
+  std::swap(state_pose_, next.state_pose);
+  std::swap(state_twist_, next.state_twist);
+  next.pose_frame_id = as2::tf::generateTfName(node_ptr_, next.controller->getDesiredPoseFrameId());
+  next.twist_frame_id =
+    as2::tf::generateTfName(node_ptr_, next.controller->getDesiredTwistFrameId());
+  buildControlModeTable();
+  return true;
+}
+
+void ControllerHandler::updateControllerReferences(
+  as2_motion_controller_plugin_base::ControllerBase & controller)
+{
+  if (!motion_reference_adquired_) {
+    return;
+  }
+
+  // Stored references are in the frames of the previous controller
+  if (!ref_pose_.header.frame_id.empty() &&
+    tf_handler_.tryConvert(ref_pose_, input_pose_frame_id_))
+  {
+    controller.updateReference(ref_pose_);
+  }
+  if (!ref_twist_.header.frame_id.empty() &&
+    tf_handler_.tryConvert(ref_twist_, input_twist_frame_id_))
+  {
+    controller.updateReference(ref_twist_);
+  }
+  if (ref_traj_.header.frame_id == input_pose_frame_id_) {
+    controller.updateReference(ref_traj_);
+  }
+  if (control_mode_in_.control_mode == as2_msgs::msg::ControlMode::ATTITUDE ||
+    control_mode_in_.control_mode == as2_msgs::msg::ControlMode::ACRO)
+  {
+    controller.updateReference(ref_thrust_);
+  }
+}
+
 bool ControllerHandler::listPlatformAvailableControlModes()
 {
-  if (platform_available_modes_in_.empty()) {
+  if (platform_available_modes_in_.empty() || !control_mode_table_.isBuilt()) {
     RCLCPP_DEBUG(node_ptr_->get_logger(), "LISTING AVAILABLE MODES");
     // if the list is empty, send a request to the platform to get the list of
     // available modes
     as2_msgs::srv::ListControlModes::Request list_control_modes_req;
     as2_msgs::srv::ListControlModes::Response list_control_modes_resp;
 
-    bool out =
-      list_control_modes_client_->sendRequest(list_control_modes_req, list_control_modes_resp);
+    bool out = false;
+    {
+      ScopedUnlock unlock(mutex_);
+      out =
+        list_control_modes_client_->sendRequest(list_control_modes_req, list_control_modes_resp);
+    }
     if (!out) {
       RCLCPP_ERROR(node_ptr_->get_logger(), "Error listing control_modes");
       return false;
@@ -461,11 +814,43 @@ bool ControllerHandler::listPlatformAvailableControlModes()
         as2::control_mode::controlModeToString(mode).c_str());
     }
 
-    platform_available_modes_in_ = list_control_modes_resp.control_modes;
+    setPlatformControlModesAvailables(list_control_modes_resp.control_modes);
   }
   return true;
 }
 
+void ControllerHandler::beginModeSwitch()
+{
+  mode_switch_in_progress_ = true;
+  skipped_control_steps_ = 0;
+}
+
+void ControllerHandler::endModeSwitch(const std::chrono::nanoseconds & latency)
+{
+  mode_switch_in_progress_ = false;
+  if (skipped_control_steps_ > 0) {
+    RCLCPP_WARN(
+      node_ptr_->get_logger(), "%zu control steps skipped while switching the control mode",
+      skipped_control_steps_);
+  }
+
+  std_msgs::msg::Float64 msg;
+  msg.data = std::chrono::duration<double>(latency).count();
+  mode_switch_latency_pub_->publish(msg);
+  RCLCPP_DEBUG(node_ptr_->get_logger(), "Control mode switch took %.3f ms", msg.data * 1e3);
+}
+
+void ControllerHandler::controlStep()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (mode_switch_in_progress_) {
+    // The platform may be in the previous or the next mode, no command is valid until it ends
+    ++skipped_control_steps_;
+    return;
+  }
+  controlTimerCallback();
+}
+
 void ControllerHandler::controlTimerCallback()
 {
   if (!platform_info_.offboard || !platform_info_.armed ||
@@ -509,142 +894,44 @@ bool ControllerHandler::setPlatformControlMode(const as2_msgs::msg::ControlMode
   as2_msgs::srv::SetControlMode::Request set_control_mode_req;
   as2_msgs::srv::SetControlMode::Response set_control_mode_resp;
   set_control_mode_req.control_mode = mode;
-  auto out = set_control_mode_client_->sendRequest(set_control_mode_req, set_control_mode_resp);
+  bool out = false;
+  {
+    // Callbacks and control steps keep running during the round trip
+    ScopedUnlock unlock(mutex_);
+    out = set_control_mode_client_->sendRequest(set_control_mode_req, set_control_mode_resp);
+  }
   if (out && set_control_mode_resp.success) {return true;}
   return false;
 }
 
-bool ControllerHandler::findSuitableOutputControlModeForPlatformInputMode(
-  uint8_t & output_mode,
-  const uint8_t input_mode)
+bool ControllerHandler::checkControlModeResolution(const ControlModeResolution & resolution)
 {
-  //  check if the prefered mode is available
-  if (prefered_output_mode_) {
-    auto match = findBestMatchWithMask(
-      prefered_output_mode_, platform_available_modes_in_,
-      MATCH_MODE_AND_YAW);
-    if (match) {
-      output_mode = match;
+  switch (resolution.status) {
+    case ControlModeResolution::Status::OK:
       return true;
-    }
-  }
-
-  // if the prefered mode is not available, search for the first common mode
-
-  uint8_t common_mode = 0;
-  bool same_yaw = false;
-
-  for (auto & mode_out : controller_available_modes_out_) {
-    // skip unset modes and hover
-    if ((mode_out & MATCH_MODE) == UNSET_MODE_MASK || (mode_out & MATCH_MODE) == HOVER_MODE_MASK) {
-      continue;
-    }
-    common_mode = findBestMatchWithMask(mode_out, platform_available_modes_in_, MATCH_MODE_AND_YAW);
-    if (common_mode) {
+    case ControlModeResolution::Status::NO_OUTPUT_MODE:
+      RCLCPP_WARN(node_ptr_->get_logger(), "No suitable output control mode found");
       break;
-    }
-  }
-
-  // check if the common mode exist
-  if (common_mode == 0) {
-    return false;
-  }
-  output_mode = common_mode;
-  return true;
-}
-
-bool ControllerHandler::checkSuitabilityInputMode(uint8_t & input_mode, const uint8_t output_mode)
-{
-  // check if input_conversion is in the list of available modes
-  bool mode_found = false;
-  for (auto & mode : controller_available_modes_in_) {
-    if ((input_mode & MATCH_MODE) == HOVER_MODE_MASK && (input_mode & MATCH_MODE) == mode) {
-      mode_found = true;
-      return true;
-    } else if (mode == input_mode) {
-      input_mode = mode;
-      mode_found = true;
+    case ControlModeResolution::Status::INPUT_LOWER_LEVEL:
+      RCLCPP_ERROR(
+        node_ptr_->get_logger(),
+        "Input control mode has lower level than output control mode");
+      RCLCPP_ERROR(
+        node_ptr_->get_logger(), "Input control mode is not suitable for this controller");
+      break;
+    case ControlModeResolution::Status::INPUT_NOT_AVAILABLE:
+      RCLCPP_ERROR(
+        node_ptr_->get_logger(), "Input control mode is not suitable for this controller");
       break;
-    }
-  }
-
-  // if not match, try to match only control mode and yaw mode
-  if (!mode_found) {
-    for (auto & mode : controller_available_modes_in_) {
-      if (checkMatchWithMask(mode, input_mode, MATCH_MODE_AND_YAW)) {
-        input_mode = mode;
-        mode_found = true;
-        break;
-      }
-    }
-  }
-
-  // check if the input mode is compatible with the output mode
-  if ((input_mode & MATCH_MODE) < (output_mode & 0b1111000)) {
-    RCLCPP_ERROR(
-      node_ptr_->get_logger(),
-      "Input control mode has lower level than output control mode");
-    return false;
-  }
-
-  return mode_found;
-}
-
-bool ControllerHandler::findSuitableControlModes(uint8_t & input_mode, uint8_t & output_mode)
-{
-  // check if the input mode is available. Get the best output mode
-  bool success = findSuitableOutputControlModeForPlatformInputMode(output_mode, input_mode);
-  if (!success) {
-    RCLCPP_WARN(node_ptr_->get_logger(), "No suitable output control mode found");
-    return false;
-  }
-
-  // Get the best input mode for the output mode
-  success = checkSuitabilityInputMode(input_mode, output_mode);
-  if (!success) {
-    RCLCPP_ERROR(node_ptr_->get_logger(), "Input control mode is not suitable for this controller");
-    return false;
-  }
-  return success;
-}
-
-bool ControllerHandler::trySetPlatformHover()
-{
-  // Check if HOVER_MODE_MASK is available in platform_available_modes_in_
-  for (auto & mode : platform_available_modes_in_) {
-    if ((mode & MATCH_MODE) == HOVER_MODE_MASK) {
-      as2_msgs::msg::ControlMode _control_mode_msg_plugin_out =
-        as2::control_mode::convertUint8tToAS2ControlMode(HOVER_MODE_MASK);
-
-      // set the platform in hover mode
-      if (setPlatformControlMode(_control_mode_msg_plugin_out)) {
-        RCLCPP_INFO(node_ptr_->get_logger(), "Platform set in HOVER mode");
-        return true;
-      } else {
-        RCLCPP_ERROR(node_ptr_->get_logger(), "Failed to set platform control mode to HOVER");
-        return false;
-      }
-    }
   }
   return false;
 }
 
-bool ControllerHandler::tryToBypassController(const uint8_t input_mode, uint8_t & output_mode)
+bool ControllerHandler::canPassThrough(const uint8_t output_control_mode) const
 {
-  // check if platform available modes are set
-  if ((input_mode & MATCH_MODE) == UNSET_MODE_MASK ||
-    (input_mode & MATCH_MODE) == HOVER_MODE_MASK)
-  {
-    return false;
-  }
-
-  uint8_t candidate_mode =
-    findBestMatchWithMask(input_mode, platform_available_modes_in_, MATCH_MODE_AND_YAW);
-  if (candidate_mode) {
-    output_mode = candidate_mode;
-    return true;
-  }
-  return false;
+  // Same conditions as the control timer
+  return bypass_pass_through_ && platform_info_.offboard && platform_info_.armed &&
+         output_control_mode != as2_msgs::msg::ControlMode::HOVER;
 }
 
 void ControllerHandler::sendCommand()
@@ -655,6 +942,12 @@ void ControllerHandler::sendCommand()
       RCLCPP_INFO_THROTTLE(node_ptr_->get_logger(), clock, 2000, "Waiting for motion reference");
       return;
     }
+    // References forwarded on arrival during the last period are not sent again; the last one
+    // is only held if the reference stream stops
+    if (reference_passed_through_) {
+      reference_passed_through_ = false;
+      return;
+    }
     command_pose_ = ref_pose_;
     command_twist_ = ref_twist_;
   } else {
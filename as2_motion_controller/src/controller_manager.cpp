@@ -40,6 +40,22 @@ namespace controller_manager
 
 ControllerManager::ControllerManager(const rclcpp::NodeOptions & options)
 : as2::Node("controller_manager", get_modified_options(options))
+{
+  setup(nullptr, false);
+}
+
+ControllerManager::ControllerManager(
+  const std::string & name_space,
+  std::shared_ptr<tf2_ros::Buffer> tf_buffer,
+  const rclcpp::NodeOptions & options)
+: as2::Node("controller_manager", name_space, get_modified_options(options))
+{
+  setup(tf_buffer, true);
+}
+
+void ControllerManager::setup(
+  std::shared_ptr<tf2_ros::Buffer> tf_buffer,
+  bool external_control_step)
 {
   try {
     this->get_parameter("plugin_name", plugin_name_);
@@ -83,7 +99,8 @@ ControllerManager::ControllerManager(const rclcpp::NodeOptions & options)
     }
     controller_->updateParams(params);
     controller_handler_ =
-      std::make_shared<controller_handler::ControllerHandler>(controller_, this);
+      std::make_shared<controller_handler::ControllerHandler>(
+      controller_, this, tf_buffer, external_control_step);
     RCLCPP_INFO(this->get_logger(), "PLUGIN LOADED [%s]", plugin_name_.c_str());
   } catch (pluginlib::PluginlibException & ex) {
     RCLCPP_ERROR(
@@ -94,29 +111,11 @@ ControllerManager::ControllerManager(const rclcpp::NodeOptions & options)
 
   // controller_handler_->initialize(this);
   if (available_modes_config_file_.empty()) {
-    // Get the path of the package
-    available_modes_config_file_ = loader_->getPluginManifestPath(plugin_name_);
-
-    // Try search if file available_modes.yaml exists in package_folder/config/
-    available_modes_config_file_ =
-      available_modes_config_file_.parent_path() / "config" / "available_modes.yaml";
-
-    if (!std::filesystem::exists(available_modes_config_file_)) {
-      // Try search if file available_modes.yaml exists in
-      // package_folder/plugins/plugin_name/config/
-      std::string plugin_name;
-      this->get_parameter("plugin_name", plugin_name);
-      available_modes_config_file_ = loader_->getPluginManifestPath(plugin_name_);
-      available_modes_config_file_ = available_modes_config_file_.parent_path() / "plugins" /
-        plugin_name / "config" / "available_modes.yaml";
-
-      if (!std::filesystem::exists(available_modes_config_file_)) {
-        RCLCPP_ERROR(
-          this->get_logger(),
-          "Default modes file available_modes.yaml not found in plugin config folder: %s",
-          available_modes_config_file_.c_str());
-        return;
-      }
+    std::string plugin_name;
+    this->get_parameter("plugin_name", plugin_name);
+    available_modes_config_file_ = findAvailableModesConfigFile(plugin_name);
+    if (available_modes_config_file_.empty()) {
+      return;
     }
   }
 
@@ -126,6 +125,11 @@ ControllerManager::ControllerManager(const rclcpp::NodeOptions & options)
 
   configAvailableControlModes(available_modes_config_file_.parent_path());
 
+  std::string plugin_name;
+  this->get_parameter("plugin_name", plugin_name);
+  controller_handler_->setActiveControllerName(plugin_name);
+  loadStandbyControllers();
+
   mode_pub_ = this->create_publisher<as2_msgs::msg::ControllerInfo>(
     as2_names::topics::controller::info, as2_names::topics::controller::qos_info);
 
@@ -136,6 +140,89 @@ ControllerManager::ControllerManager(const rclcpp::NodeOptions & options)
 
 ControllerManager::~ControllerManager() {}
 
+std::filesystem::path ControllerManager::findAvailableModesConfigFile(
+  const std::string & plugin_name)
+{
+  // Get the path of the package
+  std::filesystem::path manifest_path = loader_->getPluginManifestPath(plugin_name + "::Plugin");
+
+  // Try search if file available_modes.yaml exists in package_folder/config/
+  std::filesystem::path available_modes_config_file =
+    manifest_path.parent_path() / "config" / "available_modes.yaml";
+
+  if (!std::filesystem::exists(available_modes_config_file)) {
+    // Try search if file available_modes.yaml exists in
+    // package_folder/plugins/plugin_name/config/
+    available_modes_config_file = manifest_path.parent_path() / "plugins" /
+      plugin_name / "config" / "available_modes.yaml";
+
+    if (!std::filesystem::exists(available_modes_config_file)) {
+      RCLCPP_ERROR(
+        this->get_logger(),
+        "Default modes file available_modes.yaml not found in plugin config folder: %s",
+        available_modes_config_file.c_str());
+      return std::filesystem::path();
+    }
+  }
+  return available_modes_config_file;
+}
+
+void ControllerManager::loadStandbyControllers()
+{
+  std::vector<std::string> standby_plugin_names;
+  this->get_parameter("standby_plugin_names", standby_plugin_names);
+
+  for (const auto & standby_plugin_name : standby_plugin_names) {
+    // Standby plugin parameters are declared under the plugin name, to avoid clashes with the
+    // parameters of the active plugin
+    const std::string parameters_prefix = standby_plugin_name + ".";
+    std::shared_ptr<as2_motion_controller_plugin_base::ControllerBase> controller;
+    try {
+      controller = loader_->createSharedInstance(standby_plugin_name + "::Plugin");
+    } catch (pluginlib::PluginlibException & ex) {
+      RCLCPP_ERROR(
+        this->get_logger(), "The standby plugin [%s] failed to load. Error: %s\n",
+        standby_plugin_name.c_str(), ex.what());
+      continue;
+    }
+    controller->initialize(this);
+    controller->reset();
+
+    auto parameters = this->list_parameters({standby_plugin_name}, 0);
+    std::vector<rclcpp::Parameter> params;
+    params.reserve(parameters.names.size());
+    for (const auto & param : parameters.names) {
+      params.emplace_back(
+        param.substr(parameters_prefix.size()), this->get_parameter(param).get_parameter_value());
+    }
+    controller->updateParams(params);
+
+    const std::filesystem::path modes_file = findAvailableModesConfigFile(standby_plugin_name);
+    if (modes_file.empty()) {
+      continue;
+    }
+    auto available_input_modes = as2::yaml::parse_uint_from_string(
+      as2::yaml::find_tag_from_project_exports_path<std::string>(
+        modes_file.parent_path(), "input_control_modes"));
+    auto available_output_modes = as2::yaml::parse_uint_from_string(
+      as2::yaml::find_tag_from_project_exports_path<std::string>(
+        modes_file.parent_path(), "output_control_modes"));
+
+    controller_handler_->addStandbyController(
+      standby_plugin_name, controller, available_input_modes, available_output_modes,
+      parameters_prefix);
+    RCLCPP_INFO(
+      this->get_logger(), "STANDBY PLUGIN LOADED [%s]", standby_plugin_name.c_str());
+  }
+}
+
+void ControllerManager::controlStep()
+{
+  if (controller_handler_) {
+    controller_handler_->controlStep();
+  }
+}
+
 void ControllerManager::configAvailableControlModes(const std::filesystem::path project_path)
 {
   auto available_input_modes =
@@ -0,0 +1,190 @@
+// Copyright 2024 Universidad Politécnica de Madrid
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the Universidad Politécnica de Madrid nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/*!*******************************************************************************************
+ *  \file       multi_controller_manager.cpp
+ *  \brief      Multi-vehicle controller manager class implementation
+ *  \authors    Miguel Fernández Cortizas
+ *              Rafael Pérez Seguí
+ ********************************************************************************************/
+
+#include "as2_motion_controller/multi_controller_manager.hpp"
+
+#include <algorithm>
+#include <tf2_ros/create_timer_ros.h>
+
+namespace controller_manager
+{
+
+MultiControllerManager::MultiControllerManager(const rclcpp::NodeOptions & options)
+: as2::Node("multi_controller_manager", options)
+{
+  namespaces_ = this->declare_parameter<std::vector<std::string>>(
+    "namespaces", std::vector<std::string>());
+  if (!this->has_parameter("cmd_freq")) {
+    this->declare_parameter<double>("cmd_freq", cmd_freq_);
+  }
+  this->get_parameter("cmd_freq", cmd_freq_);
+  int num_threads = this->declare_parameter<int>("num_threads", 0);
+
+  if (namespaces_.empty()) {
+    RCLCPP_ERROR(this->get_logger(), "Param namespaces must contain at least one namespace");
+    return;
+  }
+  if (cmd_freq_ <= 0.0) {
+    RCLCPP_ERROR(this->get_logger(), "Param cmd_freq must be greater than 0.0");
+    return;
+  }
+
+  // Single TF buffer and listener for every vehicle of the process
+  tf_buffer_ = std::make_shared<tf2_ros::Buffer>(this->get_clock());
+  auto timer_interface = std::make_shared<tf2_ros::CreateTimerROS>(
+    this->get_node_base_interface(), this->get_node_timers_interface());
+  tf_buffer_->setCreateTimerInterface(timer_interface);
+  tf_listener_ = std::make_shared<tf2_ros::TransformListener>(*tf_buffer_);
+
+  // Vehicle nodes receive the same options, so local parameter overrides reach them too
+  controller_managers_.reserve(namespaces_.size());
+  for (const auto & name_space : namespaces_) {
+    controller_managers_.emplace_back(
+      std::make_shared<ControllerManager>(name_space, tf_buffer_, options));
+    RCLCPP_INFO(this->get_logger(), "Controller manager created for [%s]", name_space.c_str());
+  }
+
+  // The timer thread also steps vehicles, so the pool holds one thread less
+  if (num_threads <= 0) {
+    num_threads = static_cast<int>(std::thread::hardware_concurrency());
+  }
+  std::size_t pool_size = std::min<std::size_t>(
+    std::max(num_threads, 1), controller_managers_.size()) - 1;
+  workers_.reserve(pool_size);
+  for (std::size_t i = 0; i < pool_size; ++i) {
+    workers_.emplace_back(&MultiControllerManager::workerLoop, this);
+  }
+  RCLCPP_INFO(
+    this->get_logger(), "Stepping %zu vehicles at %.1f Hz with %zu threads",
+    controller_managers_.size(), cmd_freq_, pool_size + 1);
+
+  control_timer_ = this->create_timer(
+    std::chrono::duration<double>(1.0 / cmd_freq_),
+    std::bind(&MultiControllerManager::controlTimerCallback, this));
+}
+
+MultiControllerManager::~MultiControllerManager()
+{
+  if (control_timer_) {
+    control_timer_->cancel();
+  }
+  {
+    std::lock_guard<std::mutex> lock(pool_mutex_);
+    stop_workers_ = true;
+  }
+  pool_start_cv_.notify_all();
+  for (auto & worker : workers_) {
+    if (worker.joinable()) {
+      worker.join();
+    }
+  }
+}
+
+const std::vector<std::shared_ptr<ControllerManager>> &
+MultiControllerManager::getControllerManagers() const
+{
+  return controller_managers_;
+}
+
+void MultiControllerManager::addToExecutor(rclcpp::Executor & executor)
+{
+  executor.add_node(this->get_node_base_interface());
+  for (auto & controller_manager : controller_managers_) {
+    executor.add_node(controller_manager->get_node_base_interface());
+  }
+}
+
+void MultiControllerManager::controlTimerCallback()
+{
+  if (workers_.empty()) {
+    for (auto & controller_manager : controller_managers_) {
+      controller_manager->controlStep();
+    }
+    return;
+  }
+  runBatch();
+}
+
+void MultiControllerManager::runBatch()
+{
+  {
+    std::lock_guard<std::mutex> lock(pool_mutex_);
+    next_vehicle_.store(0);
+    pending_workers_ = workers_.size();
+    ++batch_id_;
+  }
+  pool_start_cv_.notify_all();
+
+  stepVehicles();
+
+  std::unique_lock<std::mutex> lock(pool_mutex_);
+  pool_done_cv_.wait(lock, [this] {return pending_workers_ == 0;});
+}
+
+void MultiControllerManager::workerLoop()
+{
+  std::size_t last_batch_id = 0;
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(pool_mutex_);
+      pool_start_cv_.wait(
+        lock, [this, last_batch_id] {return stop_workers_ || batch_id_ != last_batch_id;});
+      if (stop_workers_) {
+        return;
+      }
+      last_batch_id = batch_id_;
+    }
+
+    stepVehicles();
+
+    {
+      std::lock_guard<std::mutex> lock(pool_mutex_);
+      --pending_workers_;
+    }
+    pool_done_cv_.notify_one();
+  }
+}
+
+void MultiControllerManager::stepVehicles()
+{
+  const std::size_t n_vehicles = controller_managers_.size();
+  for (std::size_t i = next_vehicle_.fetch_add(1); i < n_vehicles;
+    i = next_vehicle_.fetch_add(1))
+  {
+    controller_managers_[i]->controlStep();
+  }
+}
+
+}  // namespace controller_manager
@@ -38,6 +38,7 @@
 #include <ament_index_cpp/get_package_share_directory.hpp>
 
 #include "controller_manager.hpp"
+#include "multi_controller_manager.hpp"
 
 std::shared_ptr<controller_manager::ControllerManager> getControllerManagerNode(
   const std::string plugin_name)
@@ -94,6 +95,86 @@ TEST(As2MotionControllerGTest, PluginLoadPidSpeedController) {
   executor.spin_some();
 }
 
+TEST(As2MotionControllerGTest, StandbyDifferentialFlatnessController) {
+  const std::string & name_space = "test_as2_motion_controller_standby";
+  const std::string plugin_name = "pid_speed_controller";
+  const std::string package_path =
+    ament_index_cpp::get_package_share_directory("as2_motion_controller");
+  const std::string config_file = package_path + "/config/motion_controller_default.yaml";
+  const std::string plugin_config_file = package_path + "/plugins/" + plugin_name +
+    "/config/controller_default.yaml";
+
+  std::vector<std::string> node_args = {
+    "--ros-args",
+    "-r",
+    "__ns:=/" + name_space,
+    "-p",
+    "plugin_name:=" + plugin_name,
+    "-p",
+    "standby_plugin_names:=[differential_flatness_controller]",
+    "-p",
+    "differential_flatness_controller.mass:=1.0",
+    "--params-file",
+    config_file,
+    "--params-file",
+    plugin_config_file,
+  };
+
+  auto node_options = rclcpp::NodeOptions();
+  node_options.arguments(node_args);
+
+  std::shared_ptr<controller_manager::ControllerManager> node;
+  EXPECT_NO_THROW(node = std::make_shared<controller_manager::ControllerManager>(node_options));
+  EXPECT_TRUE(node->has_parameter("differential_flatness_controller.mass"));
+
+  // Spin the node
+  rclcpp::executors::MultiThreadedExecutor executor;
+  executor.add_node(node);
+  executor.spin_some();
+}
+
+TEST(As2MotionControllerGTest, MultiVehiclePidSpeedController) {
+  const std::string plugin_name = "pid_speed_controller";
+  const std::string package_path =
+    ament_index_cpp::get_package_share_directory("as2_motion_controller");
+  const std::string config_file = package_path +
+    "/config/multi_motion_controller_default.yaml";
+  const std::string plugin_config_file = package_path + "/plugins/" + plugin_name +
+    "/config/controller_default.yaml";
+  const std::string available_modes = package_path + "/plugins/" + plugin_name +
+    "/config/available_modes.yaml";
+
+  std::vector<std::string> node_args = {
+    "--ros-args",
+    "-p",
+    "namespaces:=[test_drone0, test_drone1, test_drone2]",
+    "-p",
+    "num_threads:=2",
+    "-p",
+    "plugin_name:=" + plugin_name,
+    "-p",
+    "plugin_available_modes_config_file:=" + available_modes,
+    "--params-file",
+    config_file,
+    "--params-file",
+    plugin_config_file,
+  };
+
+  auto node_options = rclcpp::NodeOptions();
+  node_options.arguments(node_args);
+
+  std::shared_ptr<controller_manager::MultiControllerManager> node;
+  EXPECT_NO_THROW(
+    node = std::make_shared<controller_manager::MultiControllerManager>(node_options));
+  ASSERT_EQ(node->getControllerManagers().size(), 3u);
+  EXPECT_STREQ(node->getControllerManagers()[1]->get_namespace(), "/test_drone1");
+
+  // Spin the nodes
+  rclcpp::executors::MultiThreadedExecutor executor;
+  node->addToExecutor(executor);
+  executor.spin_some();
+}
+
 int main(int argc, char ** argv)
 {
   ::testing::InitGoogleTest(&argc, argv);
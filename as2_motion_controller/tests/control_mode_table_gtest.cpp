@@ -0,0 +1,133 @@
+// Copyright 2024 Universidad Politécnica de Madrid
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the Universidad Politécnica de Madrid nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+* @file control_mode_table_gtest.cpp
+*
+* Control mode compatibility table gtest
+*
+* @authors Rafael Pérez Seguí
+*/
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "control_mode_table.hpp"
+
+using controller_handler::ControlModeResolution;
+using controller_handler::ControlModeTable;
+
+// Modes sorted in ascending order, as the controller handler stores them
+const std::vector<uint8_t> controller_modes_in = {
+  0b00000000, 0b00010000, 0b01000000, 0b01000001, 0b01000100,
+  0b01000101, 0b01100001, 0b01100101, 0b01110001, 0b01110101};
+const std::vector<uint8_t> controller_modes_out = {0b00000000, 0b01000100, 0b01000101};
+
+TEST(ControlModeTableGTest, ExactInputMode) {
+  ControlModeTable table;
+  EXPECT_FALSE(table.isBuilt());
+  table.build(controller_modes_in, controller_modes_out, {0b01000100});
+  EXPECT_TRUE(table.isBuilt());
+
+  // POSITION with yaw SPEED in the GLOBAL_ENU_FRAME
+  const auto & resolution = table.lookup(0b01100101);
+  EXPECT_EQ(resolution.status, ControlModeResolution::Status::OK);
+  EXPECT_EQ(resolution.input_mode, 0b01100101);
+  EXPECT_EQ(resolution.output_mode, 0b01000100);
+  EXPECT_FALSE(resolution.bypass_available);
+}
+
+TEST(ControlModeTableGTest, InputModeMatchedWithoutFrame) {
+  ControlModeTable table;
+  table.build(controller_modes_in, controller_modes_out, {0b01000100});
+
+  // POSITION with yaw SPEED in the UNDEFINED_FRAME
+  const auto & resolution = table.lookup(0b01100111);
+  EXPECT_EQ(resolution.status, ControlModeResolution::Status::OK);
+  EXPECT_EQ(resolution.input_mode, 0b01100101);
+}
+
+TEST(ControlModeTableGTest, InputModeLowerLevelThanOutput) {
+  ControlModeTable table;
+  table.build(controller_modes_in, controller_modes_out, {0b01000100});
+
+  // ACRO is below the SPEED output of the controller
+  EXPECT_EQ(
+    table.lookup(0b00100001).status, ControlModeResolution::Status::INPUT_LOWER_LEVEL);
+}
+
+TEST(ControlModeTableGTest, NoCommonOutputMode) {
+  ControlModeTable table;
+  table.build(controller_modes_in, controller_modes_out, {0b01100001});
+
+  EXPECT_EQ(table.lookup(0b01100101).status, ControlModeResolution::Status::NO_OUTPUT_MODE);
+  // The platform still accepts position references directly
+  EXPECT_TRUE(table.lookup(0b01100001).bypass_available);
+  EXPECT_EQ(table.lookup(0b01100001).bypass_output_mode, 0b01100001);
+}
+
+TEST(ControlModeTableGTest, Bypass) {
+  ControlModeTable table;
+  table.build(controller_modes_in, controller_modes_out, {0b01000100});
+
+  EXPECT_TRUE(table.lookup(0b01000101).bypass_available);
+  EXPECT_EQ(table.lookup(0b01000101).bypass_output_mode, 0b01000100);
+  EXPECT_FALSE(table.lookup(0b00000000).bypass_available);
+  EXPECT_FALSE(table.lookup(0b00010000).bypass_available);
+}
+
+TEST(ControlModeTableGTest, Hover) {
+  ControlModeTable table;
+  table.build(controller_modes_in, controller_modes_out, {0b00010000, 0b01000100});
+
+  const auto & resolution = table.lookup(0b00010000);
+  EXPECT_TRUE(resolution.bypass_available);
+  EXPECT_EQ(resolution.bypass_output_mode, 0b00010000);
+  EXPECT_EQ(resolution.status, ControlModeResolution::Status::OK);
+  EXPECT_EQ(resolution.input_mode, 0b00010000);
+}
+
+TEST(ControlModeTableGTest, PreferedOutputMode) {
+  ControlModeTable table;
+  table.build(
+    controller_modes_in, controller_modes_out, {0b01000100, 0b01100001}, 0b01100001);
+
+  EXPECT_EQ(table.lookup(0b01110001).output_mode, 0b01100001);
+}
+
+TEST(ControlModeTableGTest, Rebuild) {
+  ControlModeTable table;
+  table.build(controller_modes_in, controller_modes_out, {0b01000100});
+  EXPECT_FALSE(table.lookup(0b01100001).bypass_available);
+
+  table.clear();
+  EXPECT_FALSE(table.isBuilt());
+  table.build(controller_modes_in, controller_modes_out, {0b01000100, 0b01100001});
+  EXPECT_TRUE(table.lookup(0b01100001).bypass_available);
+}
@@ -40,7 +40,7 @@ from action_msgs.msg import GoalStatus
 from as2_msgs.msg import BehaviorStatus
 from rclpy.action import ActionClient
 from rclpy.node import Node
-from rclpy.qos import QoSProfile
+from rclpy.qos import DurabilityPolicy, QoSProfile
 from std_srvs.srv import Trigger
 
 
@@ -75,7 +75,8 @@ class BehaviorHandler(abc.ABC):
 
         self.__status_sub = self._node.create_subscription(
             BehaviorStatus, behavior_name + '/_behavior/behavior_status',
-            self.__status_callback, QoSProfile(depth=1))
+            self.__status_callback,
+            QoSProfile(depth=1, durability=DurabilityPolicy.TRANSIENT_LOCAL))
 
         # Wait for Action and Servers availability
         if not self.__action_client.wait_for_server(timeout_sec=self.TIMEOUT) or \
@@ -0,0 +1,120 @@
+// Copyright 2024 Universidad Politécnica de Madrid
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the Universidad Politécnica de Madrid nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+* @file gps_origin_handler.hpp
+*
+* GPS origin and map fix handling on its own callback group and worker thread
+*
+* @authors Rafael Pérez Seguí
+*          Javier Melero Deza
+*/
+
+#ifndef AS2_STATE_ESTIMATOR__GPS_ORIGIN_HANDLER_HPP_
+#define AS2_STATE_ESTIMATOR__GPS_ORIGIN_HANDLER_HPP_
+
+#include <functional>
+#include <memory>
+#include <thread>
+
+#include <rclcpp/rclcpp.hpp>
+#include <geographic_msgs/msg/geo_point.hpp>
+#include <sensor_msgs/msg/nav_sat_fix.hpp>
+#include <tf2/LinearMath/Vector3.h>
+
+#include <as2_core/node.hpp>
+#include <as2_msgs/srv/get_origin.hpp>
+#include <as2_msgs/srv/set_origin.hpp>
+
+namespace as2_state_estimator
+{
+
+/**
+ * @brief Owns the set_origin and get_origin services and the GPS subscription of a plugin.
+ * They run on a dedicated callback group spun by a worker thread, so origin requests and GPS
+ * fixes never wait for, nor delay, the callbacks of the plugin. Once both the origin and the
+ * first GPS fix (the map fix) are known, the map position in the earth frame is given to the
+ * plugin from the worker thread.
+ *
+ * Origin parameters, read on construction: set_origin_on_start and set_origin.{lat, lon, alt}.
+ */
+class GpsOriginHandler
+{
+public:
+  /**
+   * @brief Called from the worker thread once, when the map fix is known
+   * @param origin earth frame origin
+   * @param map_fix first GPS fix, where the map frame is placed
+   * @param map_position map fix in the earth frame (ENU)
+   */
+  using MapFixCallback = std::function<void (
+        const geographic_msgs::msg::GeoPoint & origin,
+        const sensor_msgs::msg::NavSatFix & map_fix,
+        const tf2::Vector3 & map_position)>;
+
+  GpsOriginHandler(as2::Node * node, MapFixCallback map_fix_callback);
+
+  /* @brief Stops the worker thread */
+  ~GpsOriginHandler();
+
+  GpsOriginHandler(const GpsOriginHandler &) = delete;
+  GpsOriginHandler & operator=(const GpsOriginHandler &) = delete;
+
+private:
+  as2::Node * node_;
+  MapFixCallback map_fix_callback_;
+  bool set_origin_on_start_ = false;
+
+  // Only accessed from the worker thread after construction
+  std::unique_ptr<geographic_msgs::msg::GeoPoint> origin_;
+  std::unique_ptr<sensor_msgs::msg::NavSatFix> map_fix_;
+
+  rclcpp::CallbackGroup::SharedPtr callback_group_;
+  rclcpp::Subscription<sensor_msgs::msg::NavSatFix>::SharedPtr gps_sub_;
+  rclcpp::Service<as2_msgs::srv::SetOrigin>::SharedPtr set_origin_srv_;
+  rclcpp::Service<as2_msgs::srv::GetOrigin>::SharedPtr get_origin_srv_;
+
+  rclcpp::executors::SingleThreadedExecutor executor_;
+  std::thread worker_;
+
+  void gpsCallback(const sensor_msgs::msg::NavSatFix::SharedPtr msg);
+
+  void setOriginCallback(
+    const as2_msgs::srv::SetOrigin::Request::SharedPtr request,
+    as2_msgs::srv::SetOrigin::Response::SharedPtr response);
+
+  void getOriginCallback(
+    const as2_msgs::srv::GetOrigin::Request::SharedPtr request,
+    as2_msgs::srv::GetOrigin::Response::SharedPtr response);
+
+  void generateMapFix();
+};  // class GpsOriginHandler
+
+}  // namespace as2_state_estimator
+
+#endif  // AS2_STATE_ESTIMATOR__GPS_ORIGIN_HANDLER_HPP_
@@ -0,0 +1,130 @@
+// Copyright 2024 Universidad Politécnica de Madrid
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the Universidad Politécnica de Madrid nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+* @file imu_propagator.hpp
+*
+* Propagation of the estimated state with IMU samples between absolute updates
+*
+* @authors Rafael Pérez Seguí
+*          Miguel Fernández Cortizas
+*/
+
+#ifndef AS2_STATE_ESTIMATOR__IMU_PROPAGATOR_HPP_
+#define AS2_STATE_ESTIMATOR__IMU_PROPAGATOR_HPP_
+
+#include <Eigen/Dense>
+#include <Eigen/Geometry>
+
+namespace as2_state_estimator
+{
+
+struct PropagatedState
+{
+  double stamp = 0.0;  // Time of the state (s)
+  Eigen::Vector3d position = Eigen::Vector3d::Zero();          // Earth frame
+  Eigen::Quaterniond orientation = Eigen::Quaterniond::Identity();  // Base to earth frame
+  Eigen::Vector3d velocity = Eigen::Vector3d::Zero();          // Earth frame
+  Eigen::Vector3d angular_velocity = Eigen::Vector3d::Zero();  // Base frame
+};
+
+/**
+ * @brief Integrates IMU samples (base frame, specific force) on top of the last absolute pose
+ * and twist given by the state estimator plugin. Each absolute update resets the state, so the
+ * integration drift is bounded by the time between updates.
+ */
+class ImuPropagator
+{
+public:
+  ImuPropagator() = default;
+
+  /**
+   * @brief Set the maximum time to propagate without absolute updates
+   * @param max_propagation_time time (s), propagation stops after it
+   */
+  void setMaxPropagationTime(const double max_propagation_time);
+
+  /**
+   * @brief Absolute pose update
+   * @param stamp time of the measurement (s)
+   * @param position position in the earth frame
+   * @param orientation orientation of the base frame in the earth frame
+   */
+  void updatePose(
+    const double stamp, const Eigen::Vector3d & position,
+    const Eigen::Quaterniond & orientation);
+
+  /**
+   * @brief Absolute twist update
+   * @param stamp time of the measurement (s)
+   * @param linear_velocity linear velocity in the base frame
+   * @param angular_velocity angular velocity in the base frame
+   */
+  void updateTwist(
+    const double stamp, const Eigen::Vector3d & linear_velocity,
+    const Eigen::Vector3d & angular_velocity);
+
+  /**
+   * @brief Integrate one IMU sample up to its stamp
+   * @param stamp time of the sample (s)
+   * @param angular_velocity gyroscope measurement in the base frame (rad/s)
+   * @param linear_acceleration accelerometer measurement (specific force) in the base frame
+   * @return true if the state was propagated, false if it is not initialized, the sample is
+   * older than the state or the last absolute update is too old
+   */
+  bool propagate(
+    const double stamp, const Eigen::Vector3d & angular_velocity,
+    const Eigen::Vector3d & linear_acceleration);
+
+  /* @brief Whether both a pose and a twist have been received */
+  bool isInitialized() const {return has_pose_ && has_twist_;}
+
+  /* @brief Discard the state, waiting for new absolute updates */
+  void reset();
+
+  const PropagatedState & getState() const {return state_;}
+
+  /* @brief Linear velocity of the state in the base frame */
+  Eigen::Vector3d getBodyVelocity() const
+  {
+    return state_.orientation.conjugate() * state_.velocity;
+  }
+
+private:
+  PropagatedState state_;
+  double last_update_stamp_ = 0.0;
+  double max_propagation_time_ = 0.5;
+  bool has_pose_ = false;
+  bool has_twist_ = false;
+
+  const Eigen::Vector3d gravity_ = Eigen::Vector3d(0.0, 0.0, -9.81);
+};  // class ImuPropagator
+
+}  // namespace as2_state_estimator
+
+#endif  // AS2_STATE_ESTIMATOR__IMU_PROPAGATOR_HPP_
@@ -0,0 +1,413 @@
+// Copyright 2024 Universidad Politécnica de Madrid
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the Universidad Politécnica de Madrid nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+* @file measurement_buffer.hpp
+*
+* Timestamp-ordered measurement buffer with delayed-measurement replay
+*
+* @authors Rafael Pérez Seguí
+*          Miguel Fernández Cortizas
+*/
+
+#ifndef AS2_STATE_ESTIMATOR__MEASUREMENT_BUFFER_HPP_
+#define AS2_STATE_ESTIMATOR__MEASUREMENT_BUFFER_HPP_
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace as2_state_estimator
+{
+
+struct SourceLatencyStats
+{
+  uint64_t count = 0;         // Measurements received
+  uint64_t late = 0;          // Measurements older than the last applied one
+  uint64_t dropped = 0;       // Late measurements older than the replay window
+  uint64_t ahead = 0;         // Measurements stamped after their arrival, source clock ahead
+  double last_latency = 0.0;  // Arrival time minus header stamp (s)
+  double mean_latency = 0.0;
+  double max_latency = 0.0;
+};
+
+/**
+ * @brief Measurement queue that applies measurements to an estimator state in header stamp
+ * order, regardless of the order they arrive in.
+ *
+ * Producers push from any thread without locking into a preallocated ring. The consumer,
+ * process(), sorts them by stamp and applies the ones older than the reorder delay. Applied
+ * measurements are kept with the state after them for the last replay_size steps: a late
+ * measurement inside that window rolls the state back and the newer measurements are replayed on
+ * top of it. Older ones are dropped.
+ *
+ * @tparam MeasurementT measurement data
+ * @tparam StateT estimator state, copied once per applied measurement
+ */
+template<typename MeasurementT, typename StateT>
+class MeasurementBuffer
+{
+public:
+  static constexpr size_t kMaxSources = 8;
+
+  struct Measurement
+  {
+    double stamp = 0.0;    // Header stamp (s)
+    double arrival = 0.0;  // Reception time (s)
+    uint8_t source = 0;
+    MeasurementT data;
+  };
+
+  /**
+   * @brief Constructor
+   * @param capacity maximum measurements waiting to be applied, rounded up to a power of two
+   * @param replay_size number of applied measurements kept to replay late ones
+   * @param reorder_delay time (s) measurements wait before being applied, counted from their
+   * stamp or, if the source clock is ahead, from their arrival. 0 applies them on the next
+   * process() call and relies only on replay
+   * @param initial_state state before the first measurement
+   */
+  MeasurementBuffer(
+    const size_t capacity, const size_t replay_size, const double reorder_delay = 0.0,
+    const StateT & initial_state = StateT())
+  : replay_size_(replay_size), reorder_delay_(reorder_delay), state_(initial_state),
+    base_state_(initial_state)
+  {
+    if (capacity == 0) {
+      throw std::invalid_argument("MeasurementBuffer capacity must be positive");
+    }
+    size_t ring_size = 1;
+    while (ring_size < capacity) {
+      ring_size <<= 1;
+    }
+    mask_ = ring_size - 1;
+    slots_ = std::unique_ptr<Slot[]>(new Slot[ring_size]);
+    for (size_t i = 0; i < ring_size; i++) {
+      slots_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    pending_.reserve(ring_size);
+    history_.reserve(replay_size_ + 1);
+    source_names_.reserve(kMaxSources);
+  }
+
+  /**
+   * @brief Register a measurement source. Not thread safe, call it before pushing.
+   * @param name source name, used for logging
+   * @return source id to use in push()
+   */
+  uint8_t addSource(const std::string & name)
+  {
+    if (source_names_.size() >= kMaxSources) {
+      throw std::length_error("MeasurementBuffer supports up to 8 sources");
+    }
+    source_names_.push_back(name);
+    return static_cast<uint8_t>(source_names_.size() - 1);
+  }
+
+  /**
+   * @brief Enqueue a measurement. Lock free, can be called from several threads.
+   * @param source source id from addSource()
+   * @param stamp header stamp (s)
+   * @param arrival reception time (s), used for the latency statistics
+   * @param data measurement
+   * @return false if the buffer is full and the measurement was discarded
+   */
+  bool push(
+    const uint8_t source, const double stamp, const double arrival, const MeasurementT & data)
+  {
+    Slot * slot = nullptr;
+    size_t position = enqueue_position_.load(std::memory_order_relaxed);
+    while (true) {
+      slot = &slots_[position & mask_];
+      const size_t sequence = slot->sequence.load(std::memory_order_acquire);
+      const intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+      if (diff == 0) {
+        if (enqueue_position_.compare_exchange_weak(
+            position, position + 1, std::memory_order_relaxed))
+        {
+          break;
+        }
+      } else if (diff < 0) {
+        overflow_count_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+      } else {
+        position = enqueue_position_.load(std::memory_order_relaxed);
+      }
+    }
+    slot->measurement.stamp = stamp;
+    slot->measurement.arrival = arrival;
+    slot->measurement.source = source;
+    slot->measurement.data = data;
+    slot->sequence.store(position + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief Apply the queued measurements in stamp order. Only one thread processes at a time,
+   * a concurrent call returns 0 and its measurements are applied by the running one.
+   * @param now current time (s), measurements that arrived and are stamped after
+   * now - reorder_delay keep waiting
+   * @param apply callable (const Measurement &, StateT &) updating the state
+   * @return number of measurements applied, including replayed ones
+   */
+  template<typename ApplyFn>
+  size_t process(const double now, ApplyFn && apply)
+  {
+    size_t applied = 0;
+    while (!processing_.test_and_set(std::memory_order_acquire)) {
+      applied += drain(now, apply);
+      processing_.clear(std::memory_order_release);
+      // A producer may have pushed after the drain, pick it up unless another thread does
+      if (ingressEmpty()) {
+        break;
+      }
+    }
+    return applied;
+  }
+
+  /**
+   * @brief Get the state after the last applied measurement
+   */
+  const StateT & getState() const {return state_;}
+
+  /**
+   * @brief Get the stamp of the newest applied measurement
+   */
+  double getLastAppliedStamp() const {return last_applied_stamp_;}
+
+  /**
+   * @brief Get the latency statistics of a source. Updated by process().
+   */
+  const SourceLatencyStats & getLatencyStats(const uint8_t source) const
+  {
+    return stats_.at(source);
+  }
+
+  const std::string & getSourceName(const uint8_t source) const
+  {
+    return source_names_.at(source);
+  }
+
+  size_t getNumSources() const {return source_names_.size();}
+
+  /**
+   * @brief Get the number of measurements discarded because the buffer was full
+   */
+  uint64_t getOverflowCount() const {return overflow_count_.load(std::memory_order_relaxed);}
+
+  /**
+   * @brief Discard queued and applied measurements and restart from a state. Not thread safe.
+   */
+  void reset(const StateT & state = StateT())
+  {
+    Measurement measurement;
+    while (pop(measurement)) {
+    }
+    pending_.clear();
+    history_.clear();
+    state_ = state;
+    base_state_ = state;
+    has_applied_ = false;
+    last_applied_stamp_ = 0.0;
+  }
+
+private:
+  struct Slot
+  {
+    std::atomic<size_t> sequence{0};
+    Measurement measurement;
+  };
+
+  struct HistoryEntry
+  {
+    Measurement measurement;
+    StateT state;  // State after applying the measurement
+  };
+
+  static bool olderThan(const Measurement & lhs, const Measurement & rhs)
+  {
+    return lhs.stamp < rhs.stamp;
+  }
+
+  bool ingressEmpty() const
+  {
+    const size_t position = dequeue_position_.load(std::memory_order_relaxed);
+    const size_t sequence = slots_[position & mask_].sequence.load(std::memory_order_acquire);
+    return sequence != position + 1;
+  }
+
+  bool pop(Measurement & measurement)
+  {
+    const size_t position = dequeue_position_.load(std::memory_order_relaxed);
+    Slot & slot = slots_[position & mask_];
+    if (slot.sequence.load(std::memory_order_acquire) != position + 1) {
+      return false;
+    }
+    measurement = std::move(slot.measurement);
+    slot.sequence.store(position + mask_ + 1, std::memory_order_release);
+    dequeue_position_.store(position + 1, std::memory_order_relaxed);
+    return true;
+  }
+
+  void updateStats(const Measurement & measurement)
+  {
+    if (measurement.source >= kMaxSources) {
+      return;
+    }
+    SourceLatencyStats & stats = stats_[measurement.source];
+    const double latency = measurement.arrival - measurement.stamp;
+    stats.count++;
+    if (latency < 0.0) {
+      stats.ahead++;
+    }
+    stats.last_latency = latency;
+    stats.mean_latency += (latency - stats.mean_latency) / static_cast<double>(stats.count);
+    stats.max_latency = std::max(stats.max_latency, latency);
+  }
+
+  template<typename ApplyFn>
+  size_t drain(const double now, ApplyFn & apply)
+  {
+    size_t applied = 0;
+    Measurement measurement;
+    while (pop(measurement)) {
+      updateStats(measurement);
+      if (has_applied_ && measurement.stamp < last_applied_stamp_) {
+        applied += replay(std::move(measurement), apply);
+        continue;
+      }
+      if (pending_.size() == pending_.capacity()) {
+        // Full, release the oldest measurement to keep the reserved storage
+        applyAndStore(pending_.front(), apply);
+        pending_.erase(pending_.begin());
+        applied++;
+      }
+      pending_.insert(
+        std::upper_bound(pending_.begin(), pending_.end(), measurement, olderThan),
+        std::move(measurement));
+    }
+
+    size_t ready = 0;
+    while (ready < pending_.size() && isReady(pending_[ready], now)) {
+      applyAndStore(pending_[ready], apply);
+      ready++;
+    }
+    pending_.erase(pending_.begin(), pending_.begin() + ready);
+    return applied + ready;
+  }
+
+  // A stamp ahead of the local clock must not hold the measurement longer than the reorder delay
+  bool isReady(const Measurement & measurement, const double now) const
+  {
+    return reorder_delay_ <= 0.0 ||
+           std::min(measurement.stamp, measurement.arrival) <= now - reorder_delay_;
+  }
+
+  template<typename ApplyFn>
+  void applyAndStore(const Measurement & measurement, ApplyFn & apply)
+  {
+    apply(measurement, state_);
+    has_applied_ = true;
+    last_applied_stamp_ = measurement.stamp;
+    if (replay_size_ == 0) {
+      return;
+    }
+    if (history_.size() == replay_size_) {
+      base_state_ = std::move(history_.front().state);
+      history_.erase(history_.begin());
+    }
+    history_.push_back(HistoryEntry{measurement, state_});
+  }
+
+  template<typename ApplyFn>
+  size_t replay(Measurement && measurement, ApplyFn & apply)
+  {
+    SourceLatencyStats * stats =
+      measurement.source < kMaxSources ? &stats_[measurement.source] : nullptr;
+    if (stats != nullptr) {
+      stats->late++;
+    }
+    if (history_.empty() || measurement.stamp < history_.front().measurement.stamp) {
+      if (stats != nullptr) {
+        stats->dropped++;
+      }
+      return 0;
+    }
+
+    auto it = std::upper_bound(
+      history_.begin(), history_.end(), measurement,
+      [](const Measurement & lhs, const HistoryEntry & rhs) {
+        return lhs.stamp < rhs.measurement.stamp;
+      });
+    size_t index = static_cast<size_t>(it - history_.begin());
+    history_.insert(it, HistoryEntry{std::move(measurement), StateT()});
+    if (history_.size() > replay_size_) {
+      // The late measurement is newer than the front one, so index stays valid after this
+      base_state_ = std::move(history_.front().state);
+      history_.erase(history_.begin());
+      index--;
+    }
+
+    state_ = index == 0 ? base_state_ : history_[index - 1].state;
+    for (size_t i = index; i < history_.size(); i++) {
+      apply(history_[i].measurement, state_);
+      history_[i].state = state_;
+    }
+    return history_.size() - index;
+  }
+
+  size_t mask_ = 0;
+  std::unique_ptr<Slot[]> slots_;
+  std::atomic<size_t> enqueue_position_{0};
+  std::atomic<size_t> dequeue_position_{0};
+  std::atomic<uint64_t> overflow_count_{0};
+  std::atomic_flag processing_ = ATOMIC_FLAG_INIT;
+
+  const size_t replay_size_;
+  const double reorder_delay_;
+  std::vector<Measurement> pending_;
+  std::vector<HistoryEntry> history_;
+  StateT state_;
+  StateT base_state_;
+  bool has_applied_ = false;
+  double last_applied_stamp_ = 0.0;
+
+  std::vector<std::string> source_names_;
+  std::array<SourceLatencyStats, kMaxSources> stats_;
+};
+
+}  // namespace as2_state_estimator
+
+#endif  // AS2_STATE_ESTIMATOR__MEASUREMENT_BUFFER_HPP_
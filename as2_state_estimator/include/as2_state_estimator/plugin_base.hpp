@@ -45,18 +45,24 @@
 #include <tf2_ros/buffer_interface.h>
 #include <tf2_ros/static_transform_broadcaster.h>
 #include <tf2_ros/transform_broadcaster.h>
+#include <array>
+#include <chrono>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <rclcpp/rclcpp.hpp>
 #include <rclcpp/subscription_base.hpp>
 #include <geometry_msgs/msg/pose_stamped.hpp>
 #include <geometry_msgs/msg/twist_stamped.hpp>
 #include <nav_msgs/msg/odometry.hpp>
+#include <sensor_msgs/msg/imu.hpp>
 
 #include <as2_core/node.hpp>
 #include <as2_core/utils/tf_utils.hpp>
 #include <as2_core/names/topics.hpp>
 
+#include "as2_state_estimator/imu_propagator.hpp"
+
 namespace as2_state_estimator_plugin_base
 {
 class StateEstimatorBase
@@ -72,6 +78,25 @@ private:
   tf2::Transform earth_to_map_ = tf2::Transform::getIdentity();
   tf2::Transform map_to_odom_ = tf2::Transform::getIdentity();
   tf2::Transform odom_to_base_ = tf2::Transform::getIdentity();
+  std::mutex static_tf_mutex_;
+
+  // IMU propagation between the absolute updates of the plugin
+  bool imu_propagation_enabled_ = false;
+  double imu_propagation_rate_ = 200.0;
+  double last_published_stamp_ = 0.0;
+  std::mutex imu_propagation_mutex_;  // Also guards odometry_msg_
+  as2_state_estimator::ImuPropagator imu_propagator_;
+  rclcpp::Subscription<sensor_msgs::msg::Imu>::SharedPtr imu_sub_;
+  rclcpp::TimerBase::SharedPtr imu_propagation_timer_;
+  geometry_msgs::msg::PoseStamped propagated_pose_msg_;
+  geometry_msgs::msg::TwistStamped propagated_twist_msg_;
+  builtin_interfaces::msg::Time propagated_stamp_;  // Stamp of the message that set the state
+
+  // Pose and twist joined in a single message
+  bool odometry_enabled_ = false;
+  bool odometry_has_pose_ = false;
+  rclcpp::Publisher<nav_msgs::msg::Odometry>::SharedPtr odometry_pub_;
+  nav_msgs::msg::Odometry odometry_msg_;
 
 public:
   StateEstimatorBase() {}
@@ -106,6 +131,13 @@ public:
     map_frame_id_ = as2::tf::generateTfName(node_ptr_, map_frame_id_);
     // !! WATCHOUT : earth_frame_id_ is not generated because it is a global frame
 
+    node_ptr_->get_parameter("publish_odometry", odometry_enabled_);
+    if (odometry_enabled_) {
+      odometry_pub_ = node_ptr_->create_publisher<nav_msgs::msg::Odometry>(
+        as2_names::topics::self_localization::odom, as2_names::topics::self_localization::qos);
+    }
+
+    setup_imu_propagation();
     on_setup();
   }
   virtual void on_setup() = 0;
@@ -146,16 +178,45 @@ protected:
   }
   inline void publish_static_transform(const geometry_msgs::msg::TransformStamped & transform)
   {
+    // Static transforms may also be sent from a plugin worker thread, such as the GPS origin one
+    std::lock_guard<std::mutex> lock(static_tf_mutex_);
     static_tf_broadcaster_->sendTransform(transform);
   }
 
   inline void publish_twist(const geometry_msgs::msg::TwistStamped & twist)
   {
     twist_pub_->publish(twist);
+    if (imu_propagation_enabled_) {
+      update_propagation(twist);
+    }
+    if (odometry_enabled_) {
+      std::lock_guard<std::mutex> lock(imu_propagation_mutex_);
+      update_odometry(twist);
+    }
   }
   inline void publish_pose(const geometry_msgs::msg::PoseStamped & pose)
   {
     pose_pub_->publish(pose);
+    if (imu_propagation_enabled_) {
+      update_propagation(pose);
+    }
+    if (odometry_enabled_) {
+      std::lock_guard<std::mutex> lock(imu_propagation_mutex_);
+      update_odometry(pose);
+    }
+  }
+
+  /**
+   * @brief Covariances sent in the odometry message, row-major as in nav_msgs/Odometry.
+   * Pose covariance in the pose frame, twist covariance in the twist frame.
+   */
+  inline void set_odometry_covariance(
+    const std::array<double, 36> & pose_covariance,
+    const std::array<double, 36> & twist_covariance)
+  {
+    std::lock_guard<std::mutex> lock(imu_propagation_mutex_);
+    odometry_msg_.pose.covariance = pose_covariance;
+    odometry_msg_.twist.covariance = twist_covariance;
   }
 
   inline const std::string & get_earth_frame() const {return earth_frame_id_;}
@@ -199,6 +260,152 @@ protected:
     earth_to_baselink = earth_to_map * map_to_odom * odom_to_baselink;
     return true;
   }
+
+private:
+  // The odometry is sent on each twist, with the last pose published before it.
+  // The IMU propagation also writes odometry_msg_, so callers must hold imu_propagation_mutex_
+  void update_odometry(const geometry_msgs::msg::PoseStamped & pose)
+  {
+    odometry_msg_.header = pose.header;
+    odometry_msg_.pose.pose = pose.pose;
+    odometry_has_pose_ = true;
+  }
+
+  void update_odometry(const geometry_msgs::msg::TwistStamped & twist)
+  {
+    if (!odometry_has_pose_) {
+      return;
+    }
+    odometry_msg_.child_frame_id = twist.header.frame_id;
+    odometry_msg_.twist.twist = twist.twist;
+    odometry_pub_->publish(odometry_msg_);
+  }
+
+  void setup_imu_propagation()
+  {
+    node_ptr_->get_parameter("imu_propagation.enabled", imu_propagation_enabled_);
+    if (!imu_propagation_enabled_) {
+      return;
+    }
+
+    std::string imu_topic = as2_names::topics::sensor_measurements::imu;
+    double max_propagation_time = 0.5;
+    node_ptr_->get_parameter("imu_propagation.imu_topic", imu_topic);
+    node_ptr_->get_parameter("imu_propagation.publish_rate", imu_propagation_rate_);
+    node_ptr_->get_parameter("imu_propagation.max_propagation_time", max_propagation_time);
+    imu_propagator_.setMaxPropagationTime(max_propagation_time);
+
+    propagated_pose_msg_.header.frame_id = get_earth_frame();
+    propagated_twist_msg_.header.frame_id = get_base_frame();
+
+    imu_sub_ = node_ptr_->create_subscription<sensor_msgs::msg::Imu>(
+      imu_topic, as2_names::topics::sensor_measurements::qos,
+      std::bind(&StateEstimatorBase::imu_callback, this, std::placeholders::_1));
+
+    // A non positive rate publishes on every IMU sample
+    if (imu_propagation_rate_ > 0.0) {
+      imu_propagation_timer_ = node_ptr_->create_timer(
+        std::chrono::duration<double>(1.0 / imu_propagation_rate_),
+        std::bind(&StateEstimatorBase::publish_propagated_state, this));
+    }
+    RCLCPP_INFO(
+      node_ptr_->get_logger(), "IMU propagation enabled from %s at %f Hz", imu_topic.c_str(),
+      imu_propagation_rate_);
+  }
+
+  void update_propagation(const geometry_msgs::msg::PoseStamped & pose)
+  {
+    if (pose.header.frame_id != get_earth_frame()) {
+      RCLCPP_WARN_ONCE(
+        node_ptr_->get_logger(), "IMU propagation expects pose in %s, received %s",
+        get_earth_frame().c_str(), pose.header.frame_id.c_str());
+      return;
+    }
+    const double stamp = rclcpp::Time(pose.header.stamp).seconds();
+    std::lock_guard<std::mutex> lock(imu_propagation_mutex_);
+    imu_propagator_.updatePose(
+      stamp,
+      Eigen::Vector3d(pose.pose.position.x, pose.pose.position.y, pose.pose.position.z),
+      Eigen::Quaterniond(
+        pose.pose.orientation.w, pose.pose.orientation.x,
+        pose.pose.orientation.y, pose.pose.orientation.z));
+    propagated_stamp_ = pose.header.stamp;
+    last_published_stamp_ = stamp;
+  }
+
+  void update_propagation(const geometry_msgs::msg::TwistStamped & twist)
+  {
+    if (twist.header.frame_id != get_base_frame()) {
+      RCLCPP_WARN_ONCE(
+        node_ptr_->get_logger(), "IMU propagation expects twist in %s, received %s",
+        get_base_frame().c_str(), twist.header.frame_id.c_str());
+      return;
+    }
+    std::lock_guard<std::mutex> lock(imu_propagation_mutex_);
+    imu_propagator_.updateTwist(
+      rclcpp::Time(twist.header.stamp).seconds(),
+      Eigen::Vector3d(twist.twist.linear.x, twist.twist.linear.y, twist.twist.linear.z),
+      Eigen::Vector3d(twist.twist.angular.x, twist.twist.angular.y, twist.twist.angular.z));
+  }
+
+  void imu_callback(const sensor_msgs::msg::Imu::SharedPtr msg)
+  {
+    {
+      std::lock_guard<std::mutex> lock(imu_propagation_mutex_);
+      if (!imu_propagator_.propagate(
+          rclcpp::Time(msg->header.stamp).seconds(),
+          Eigen::Vector3d(
+            msg->angular_velocity.x, msg->angular_velocity.y,
+            msg->angular_velocity.z),
+          Eigen::Vector3d(
+            msg->linear_acceleration.x, msg->linear_acceleration.y,
+            msg->linear_acceleration.z)))
+      {
+        return;
+      }
+      propagated_stamp_ = msg->header.stamp;
+    }
+    if (imu_propagation_rate_ <= 0.0) {
+      publish_propagated_state();
+    }
+  }
+
+  void publish_propagated_state()
+  {
+    std::lock_guard<std::mutex> lock(imu_propagation_mutex_);
+    const as2_state_estimator::PropagatedState & state = imu_propagator_.getState();
+    // Only publish states newer than the last one published
+    if (!imu_propagator_.isInitialized() || state.stamp <= last_published_stamp_) {
+      return;
+    }
+    last_published_stamp_ = state.stamp;
+
+    const builtin_interfaces::msg::Time & stamp = propagated_stamp_;
+    propagated_pose_msg_.header.stamp = stamp;
+    propagated_pose_msg_.pose.position.x = state.position.x();
+    propagated_pose_msg_.pose.position.y = state.position.y();
+    propagated_pose_msg_.pose.position.z = state.position.z();
+    propagated_pose_msg_.pose.orientation.w = state.orientation.w();
+    propagated_pose_msg_.pose.orientation.x = state.orientation.x();
+    propagated_pose_msg_.pose.orientation.y = state.orientation.y();
+    propagated_pose_msg_.pose.orientation.z = state.orientation.z();
+
+    const Eigen::Vector3d body_velocity = imu_propagator_.getBodyVelocity();
+    propagated_twist_msg_.header.stamp = stamp;
+    propagated_twist_msg_.twist.linear.x = body_velocity.x();
+    propagated_twist_msg_.twist.linear.y = body_velocity.y();
+    propagated_twist_msg_.twist.linear.z = body_velocity.z();
+    propagated_twist_msg_.twist.angular.x = state.angular_velocity.x();
+    propagated_twist_msg_.twist.angular.y = state.angular_velocity.y();
+    propagated_twist_msg_.twist.angular.z = state.angular_velocity.z();
+
+    pose_pub_->publish(propagated_pose_msg_);
+    twist_pub_->publish(propagated_twist_msg_);
+    if (odometry_enabled_) {
+      update_odometry(propagated_pose_msg_);
+      update_odometry(propagated_twist_msg_);
+    }
+  }
 };
 }  // namespace as2_state_estimator_plugin_base
 
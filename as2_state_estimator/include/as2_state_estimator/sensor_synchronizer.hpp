@@ -0,0 +1,455 @@
+// Copyright 2024 Universidad Politécnica de Madrid
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the Universidad Politécnica de Madrid nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+* @file sensor_synchronizer.hpp
+*
+* Time alignment of sensor streams with different rates and delays
+*
+* @authors Rafael Pérez Seguí
+*          Miguel Fernández Cortizas
+*/
+
+#ifndef AS2_STATE_ESTIMATOR__SENSOR_SYNCHRONIZER_HPP_
+#define AS2_STATE_ESTIMATOR__SENSOR_SYNCHRONIZER_HPP_
+
+#include <Eigen/Dense>
+#include <Eigen/Geometry>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace as2_state_estimator
+{
+
+struct ImuSample
+{
+  Eigen::Vector3d angular_velocity = Eigen::Vector3d::Zero();     // Base frame (rad/s)
+  Eigen::Vector3d linear_acceleration = Eigen::Vector3d::Zero();  // Base frame, specific force
+};
+
+struct PoseSample
+{
+  Eigen::Vector3d position = Eigen::Vector3d::Zero();
+  Eigen::Quaterniond orientation = Eigen::Quaterniond::Identity();
+};
+
+struct OdometrySample
+{
+  Eigen::Vector3d position = Eigen::Vector3d::Zero();
+  Eigen::Quaterniond orientation = Eigen::Quaterniond::Identity();
+  Eigen::Vector3d linear_velocity = Eigen::Vector3d::Zero();   // Base frame
+  Eigen::Vector3d angular_velocity = Eigen::Vector3d::Zero();  // Base frame
+};
+
+struct GpsSample
+{
+  double latitude = 0.0;   // Degrees
+  double longitude = 0.0;  // Degrees
+  double altitude = 0.0;   // Meters
+};
+
+/**
+ * @brief Interpolation of a sample type between two stamps, ratio in [0, 1]. Types without a
+ * specialization take the nearest sample. Specialize it for custom sample types.
+ */
+template<typename SampleT>
+struct SampleInterpolation
+{
+  static SampleT interpolate(const SampleT & a, const SampleT & b, const double ratio)
+  {
+    return ratio < 0.5 ? a : b;
+  }
+};
+
+template<>
+struct SampleInterpolation<double>
+{
+  static double interpolate(const double a, const double b, const double ratio)
+  {
+    return a + (b - a) * ratio;
+  }
+};
+
+template<>
+struct SampleInterpolation<Eigen::Vector3d>
+{
+  static Eigen::Vector3d interpolate(
+    const Eigen::Vector3d & a, const Eigen::Vector3d & b, const double ratio)
+  {
+    return a + (b - a) * ratio;
+  }
+};
+
+template<>
+struct SampleInterpolation<Eigen::Quaterniond>
+{
+  static Eigen::Quaterniond interpolate(
+    const Eigen::Quaterniond & a, const Eigen::Quaterniond & b, const double ratio)
+  {
+    return a.slerp(ratio, b);
+  }
+};
+
+template<>
+struct SampleInterpolation<ImuSample>
+{
+  static ImuSample interpolate(const ImuSample & a, const ImuSample & b, const double ratio)
+  {
+    ImuSample sample;
+    sample.angular_velocity = SampleInterpolation<Eigen::Vector3d>::interpolate(
+      a.angular_velocity, b.angular_velocity, ratio);
+    sample.linear_acceleration = SampleInterpolation<Eigen::Vector3d>::interpolate(
+      a.linear_acceleration, b.linear_acceleration, ratio);
+    return sample;
+  }
+};
+
+template<>
+struct SampleInterpolation<PoseSample>
+{
+  static PoseSample interpolate(const PoseSample & a, const PoseSample & b, const double ratio)
+  {
+    PoseSample sample;
+    sample.position =
+      SampleInterpolation<Eigen::Vector3d>::interpolate(a.position, b.position, ratio);
+    sample.orientation =
+      SampleInterpolation<Eigen::Quaterniond>::interpolate(a.orientation, b.orientation, ratio);
+    return sample;
+  }
+};
+
+template<>
+struct SampleInterpolation<OdometrySample>
+{
+  static OdometrySample interpolate(
+    const OdometrySample & a, const OdometrySample & b, const double ratio)
+  {
+    OdometrySample sample;
+    sample.position =
+      SampleInterpolation<Eigen::Vector3d>::interpolate(a.position, b.position, ratio);
+    sample.orientation =
+      SampleInterpolation<Eigen::Quaterniond>::interpolate(a.orientation, b.orientation, ratio);
+    sample.linear_velocity = SampleInterpolation<Eigen::Vector3d>::interpolate(
+      a.linear_velocity, b.linear_velocity, ratio);
+    sample.angular_velocity = SampleInterpolation<Eigen::Vector3d>::interpolate(
+      a.angular_velocity, b.angular_velocity, ratio);
+    return sample;
+  }
+};
+
+template<>
+struct SampleInterpolation<GpsSample>
+{
+  // Linear in degrees, fine for the distances between two fixes
+  static GpsSample interpolate(const GpsSample & a, const GpsSample & b, const double ratio)
+  {
+    GpsSample sample;
+    sample.latitude = a.latitude + (b.latitude - a.latitude) * ratio;
+    sample.longitude = a.longitude + (b.longitude - a.longitude) * ratio;
+    sample.altitude = a.altitude + (b.altitude - a.altitude) * ratio;
+    return sample;
+  }
+};
+
+/**
+ * @brief Stamp ordered ring of samples, preallocated on construction. When full, a new sample
+ * overwrites the oldest one. Not thread safe.
+ */
+template<typename SampleT>
+class SampleRing
+{
+public:
+  explicit SampleRing(const size_t capacity)
+  : entries_(capacity)
+  {
+    if (capacity == 0) {
+      throw std::invalid_argument("SampleRing capacity must be positive");
+    }
+  }
+
+  /**
+   * @brief Insert a sample in stamp order. Out of order samples are inserted in place, a sample
+   * with the stamp of a stored one replaces it.
+   * @return false if the ring is full and the sample is older than all the stored ones
+   */
+  bool push(const double stamp, const SampleT & sample)
+  {
+    const size_t position = upperBound(stamp);
+    if (position > 0 && at(position - 1).stamp == stamp) {
+      at(position - 1).sample = sample;
+      return true;
+    }
+    if (size_ == entries_.size()) {
+      if (position == 0) {
+        return false;
+      }
+      // Drop the oldest one
+      head_ = (head_ + 1) % entries_.size();
+      size_--;
+      insert(position - 1, stamp, sample);
+      return true;
+    }
+    insert(position, stamp, sample);
+    return true;
+  }
+
+  /**
+   * @brief Sample at a stamp, interpolated between the stored samples around it
+   * @param stamp query stamp (s)
+   * @param max_lag time (s) the newest sample is held for stamps after it
+   * @param sample interpolated sample
+   * @return false if the stamp is older than the oldest sample or newer than the newest one
+   * plus max_lag
+   */
+  bool sample(const double stamp, const double max_lag, SampleT & sample) const
+  {
+    if (size_ == 0 || stamp < at(0).stamp) {
+      return false;
+    }
+    const size_t position = upperBound(stamp);
+    if (position == size_) {
+      const Entry & newest = at(size_ - 1);
+      if (stamp - newest.stamp > max_lag) {
+        return false;
+      }
+      sample = newest.sample;
+      return true;
+    }
+    const Entry & before = at(position - 1);
+    const Entry & after = at(position);
+    const double ratio = (stamp - before.stamp) / (after.stamp - before.stamp);
+    sample = SampleInterpolation<SampleT>::interpolate(before.sample, after.sample, ratio);
+    return true;
+  }
+
+  size_t size() const {return size_;}
+  size_t capacity() const {return entries_.size();}
+  bool empty() const {return size_ == 0;}
+
+  double oldestStamp() const
+  {
+    return size_ ? at(0).stamp : std::numeric_limits<double>::quiet_NaN();
+  }
+
+  double newestStamp() const
+  {
+    return size_ ? at(size_ - 1).stamp : std::numeric_limits<double>::quiet_NaN();
+  }
+
+  void clear()
+  {
+    head_ = 0;
+    size_ = 0;
+  }
+
+private:
+  struct Entry
+  {
+    double stamp = 0.0;
+    SampleT sample;
+  };
+
+  std::vector<Entry> entries_;
+  size_t head_ = 0;  // Oldest sample
+  size_t size_ = 0;
+
+  const Entry & at(const size_t index) const {return entries_[(head_ + index) % entries_.size()];}
+  Entry & at(const size_t index) {return entries_[(head_ + index) % entries_.size()];}
+
+  // First sample newer than the stamp, by binary search
+  size_t upperBound(const double stamp) const
+  {
+    size_t first = 0;
+    size_t count = size_;
+    while (count > 0) {
+      const size_t step = count / 2;
+      if (at(first + step).stamp <= stamp) {
+        first += step + 1;
+        count -= step + 1;
+      } else {
+        count = step;
+      }
+    }
+    return first;
+  }
+
+  // Shift the newer samples one position, not full
+  void insert(const size_t position, const double stamp, const SampleT & sample)
+  {
+    for (size_t i = size_; i > position; i--) {
+      at(i) = std::move(at(i - 1));
+    }
+    at(position).stamp = stamp;
+    at(position).sample = sample;
+    size_++;
+  }
+};
+
+/**
+ * @brief Aligns sensor streams that arrive at different rates and with different delays. Each
+ * stream has its own preallocated ring of stamped samples; a snapshot interpolates all of them
+ * at the requested stamp, in O(log n) per stream.
+ *
+ * A stream whose newest sample is older than the requested stamp is held at that sample for up
+ * to max_lag seconds, longer gaps make the snapshot unavailable. Pushing and querying are
+ * guarded by a mutex, so streams may be fed from different callback groups.
+ *
+ * @tparam SampleTs sample type of each stream, e.g. ImuSample, OdometrySample, GpsSample
+ */
+template<typename ... SampleTs>
+class SensorSynchronizer
+{
+public:
+  static constexpr size_t kStreams = sizeof...(SampleTs);
+  using Snapshot = std::tuple<SampleTs...>;
+  template<size_t I>
+  using SampleType = std::tuple_element_t<I, Snapshot>;
+
+  /**
+   * @brief Constructor
+   * @param capacities number of samples kept per stream, size it for rate times the time window
+   * the fusion may look back
+   * @param max_lag time (s) the newest sample of a stream is held for newer snapshots
+   */
+  SensorSynchronizer(const std::array<size_t, kStreams> & capacities, const double max_lag)
+  : rings_(makeRings(capacities, std::index_sequence_for<SampleTs...>{})), max_lag_(max_lag)
+  {
+    if (max_lag_ < 0.0) {
+      throw std::invalid_argument("SensorSynchronizer max_lag must not be negative");
+    }
+  }
+
+  /**
+   * @brief Add a sample to stream I
+   * @return false if the stream is full and the sample is older than all the stored ones
+   */
+  template<size_t I>
+  bool push(const double stamp, const SampleType<I> & sample)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return std::get<I>(rings_).push(stamp, sample);
+  }
+
+  /**
+   * @brief All the streams interpolated at a stamp
+   * @return false if any stream has no sample old enough or its newest one is older than the
+   * stamp minus max_lag
+   */
+  bool getSnapshot(const double stamp, Snapshot & snapshot) const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return sampleAll(stamp, snapshot, std::index_sequence_for<SampleTs...>{});
+  }
+
+  /**
+   * @brief Snapshot at the latest stamp all the streams can give, see getLatestStamp()
+   * @return false if any stream is empty or no stamp satisfies every stream
+   */
+  bool getLatestSnapshot(double & stamp, Snapshot & snapshot) const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stamp = latestStamp();
+    if (std::isnan(stamp)) {
+      return false;
+    }
+    return sampleAll(stamp, snapshot, std::index_sequence_for<SampleTs...>{});
+  }
+
+  /**
+   * @brief Latest stamp with a snapshot available: the newest sample of all streams, limited to
+   * max_lag after the newest sample of the slowest stream. NaN if any stream is empty.
+   */
+  double getLatestStamp() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return latestStamp();
+  }
+
+  template<size_t I>
+  size_t size() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return std::get<I>(rings_).size();
+  }
+
+  double getMaxLag() const {return max_lag_;}
+
+  void clear()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::apply([](auto & ... rings) {(rings.clear(), ...);}, rings_);
+  }
+
+private:
+  mutable std::mutex mutex_;
+  std::tuple<SampleRing<SampleTs>...> rings_;
+  double max_lag_;
+
+  template<size_t ... Is>
+  static std::tuple<SampleRing<SampleTs>...> makeRings(
+    const std::array<size_t, kStreams> & capacities, std::index_sequence<Is...>)
+  {
+    return std::tuple<SampleRing<SampleTs>...>(SampleRing<SampleTs>(capacities[Is])...);
+  }
+
+  template<size_t ... Is>
+  bool sampleAll(const double stamp, Snapshot & snapshot, std::index_sequence<Is...>) const
+  {
+    return (std::get<Is>(rings_).sample(stamp, max_lag_, std::get<Is>(snapshot)) && ...);
+  }
+
+  double latestStamp() const
+  {
+    double oldest_newest = std::numeric_limits<double>::infinity();
+    double newest = -std::numeric_limits<double>::infinity();
+    bool empty = false;
+    std::apply(
+      [&](const auto & ... rings) {
+        ((empty = empty || rings.empty(),
+        oldest_newest = std::min(oldest_newest, rings.newestStamp()),
+        newest = std::max(newest, rings.newestStamp())), ...);
+      }, rings_);
+    if (empty) {
+      return std::numeric_limits<double>::quiet_NaN();
+    }
+    return std::min(newest, oldest_newest + max_lag_);
+  }
+};
+
+}  // namespace as2_state_estimator
+
+#endif  // AS2_STATE_ESTIMATOR__SENSOR_SYNCHRONIZER_HPP_
@@ -0,0 +1,239 @@
+// Copyright 2024 Universidad Politécnica de Madrid
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the Universidad Politécnica de Madrid nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+* @file error_state_ekf.hpp
+*
+* Error-state extended Kalman filter with IMU prediction and delayed measurement handling
+*
+* @authors Rafael Pérez Seguí
+*          Miguel Fernández Cortizas
+*/
+
+#ifndef ERROR_STATE_EKF_HPP_
+#define ERROR_STATE_EKF_HPP_
+
+#include <Eigen/Dense>
+#include <Eigen/Geometry>
+#include <cstddef>
+#include <vector>
+
+namespace es_ekf
+{
+
+/* Error state: position, velocity, attitude, accelerometer bias, gyroscope bias */
+constexpr int kErrorStateSize = 15;
+constexpr int kPosition = 0;
+constexpr int kVelocity = 3;
+constexpr int kAttitude = 6;
+constexpr int kAccBias = 9;
+constexpr int kGyroBias = 12;
+
+using ErrorStateVector = Eigen::Matrix<double, kErrorStateSize, 1>;
+using ErrorStateMatrix = Eigen::Matrix<double, kErrorStateSize, kErrorStateSize>;
+
+struct NominalState
+{
+  Eigen::Vector3d position = Eigen::Vector3d::Zero();              // Earth frame
+  Eigen::Vector3d velocity = Eigen::Vector3d::Zero();              // Earth frame
+  Eigen::Quaterniond orientation = Eigen::Quaterniond::Identity();  // Base to earth frame
+  Eigen::Vector3d acc_bias = Eigen::Vector3d::Zero();              // Base frame
+  Eigen::Vector3d gyro_bias = Eigen::Vector3d::Zero();             // Base frame
+};
+
+struct ImuSample
+{
+  Eigen::Vector3d linear_acceleration = Eigen::Vector3d::Zero();  // Specific force, base frame
+  Eigen::Vector3d angular_velocity = Eigen::Vector3d::Zero();     // Base frame
+};
+
+struct ImuNoise
+{
+  double acc_noise = 0.1;          // Accelerometer noise density (m/s^2)
+  double gyro_noise = 0.01;        // Gyroscope noise density (rad/s)
+  double acc_bias_walk = 0.001;    // Accelerometer bias random walk (m/s^2 sqrt(s))
+  double gyro_bias_walk = 0.0001;  // Gyroscope bias random walk (rad/s sqrt(s))
+};
+
+/**
+ * @brief Error-state EKF driven by IMU samples.
+ *
+ * Every predicted state is stored with its covariance in a ring buffer preallocated at
+ * construction. A measurement older than the latest IMU sample is applied on the last stored
+ * state not newer than it, and the following IMU samples are replayed on top of the corrected
+ * state. Measurements older than the buffer are rejected.
+ */
+class ErrorStateEKF
+{
+public:
+  /**
+   * @brief Constructor
+   * @param history_size number of states kept for delayed measurements, at least 2
+   */
+  explicit ErrorStateEKF(const size_t history_size = 500);
+
+  void setImuNoise(const ImuNoise & noise) {imu_noise_ = noise;}
+
+  /**
+   * @brief Set the initial state, discarding the history
+   * @param stamp time of the state (s)
+   * @param state nominal state
+   * @param covariance error state covariance
+   */
+  void initialize(
+    const double stamp, const NominalState & state,
+    const ErrorStateMatrix & covariance);
+
+  bool isInitialized() const {return size_ > 0;}
+
+  /**
+   * @brief Propagate the state up to the stamp of the IMU sample
+   * @return false if the filter is not initialized or the sample is not newer than the state
+   */
+  bool predict(const double stamp, const ImuSample & imu);
+
+  /**
+   * @brief Position measurement in the earth frame
+   * @return false if the measurement is older than the history
+   */
+  bool updatePosition(
+    const double stamp, const Eigen::Vector3d & position,
+    const Eigen::Matrix3d & covariance);
+
+  /**
+   * @brief Pose measurement in the earth frame, covariance ordered as position and attitude
+   * error (rad) in the base frame
+   * @return false if the measurement is older than the history
+   */
+  bool updatePose(
+    const double stamp, const Eigen::Vector3d & position,
+    const Eigen::Quaterniond & orientation,
+    const Eigen::Matrix<double, 6, 6> & covariance);
+
+  /**
+   * @brief Linear velocity measurement in the base frame
+   * @return false if the measurement is older than the history
+   */
+  bool updateBodyVelocity(
+    const double stamp, const Eigen::Vector3d & velocity,
+    const Eigen::Matrix3d & covariance);
+
+  /* @brief Latest state */
+  const NominalState & getState() const {return entry(0).state;}
+  const ErrorStateMatrix & getCovariance() const {return entry(0).covariance;}
+  double getStamp() const {return entry(0).stamp;}
+
+  /* @brief Angular velocity of the latest IMU sample, bias corrected */
+  Eigen::Vector3d getAngularVelocity() const
+  {
+    return entry(0).imu.angular_velocity - entry(0).state.gyro_bias;
+  }
+
+  /* @brief Number of measurements rejected for being older than the history */
+  size_t getRejectedMeasurements() const {return rejected_measurements_;}
+
+private:
+  struct HistoryEntry
+  {
+    double stamp = 0.0;
+    NominalState state;
+    ErrorStateMatrix covariance = ErrorStateMatrix::Identity();
+    ImuSample imu;  // Sample that propagated the previous entry up to this one
+  };
+
+  std::vector<HistoryEntry> history_;
+  size_t head_ = 0;
+  size_t size_ = 0;
+  size_t rejected_measurements_ = 0;
+  ImuNoise imu_noise_;
+
+  const Eigen::Vector3d gravity_ = Eigen::Vector3d(0.0, 0.0, -9.81);
+
+  /* @brief Entry offset positions before the latest one */
+  HistoryEntry & entry(const size_t offset)
+  {
+    return history_[(head_ + history_.size() - offset) % history_.size()];
+  }
+  const HistoryEntry & entry(const size_t offset) const
+  {
+    return history_[(head_ + history_.size() - offset) % history_.size()];
+  }
+
+  void propagate(
+    const HistoryEntry & from, const ImuSample & imu, const double stamp,
+    HistoryEntry & to) const;
+
+  void inject(const ErrorStateVector & error, NominalState & state) const;
+
+  /* @brief Apply a measurement on the state at its stamp and replay the newer IMU samples */
+  template<int M, typename MeasurementModel>
+  bool correct(
+    const double stamp, const Eigen::Matrix<double, M, M> & covariance,
+    MeasurementModel model)
+  {
+    if (!isInitialized()) {
+      return false;
+    }
+    size_t offset = 0;
+    while (offset < size_ && entry(offset).stamp > stamp) {
+      offset++;
+    }
+    if (offset == size_) {
+      rejected_measurements_++;
+      return false;
+    }
+
+    HistoryEntry & corrected = entry(offset);
+    Eigen::Matrix<double, M, 1> residual;
+    Eigen::Matrix<double, M, kErrorStateSize> jacobian;
+    jacobian.setZero();
+    model(corrected.state, residual, jacobian);
+
+    const Eigen::Matrix<double, kErrorStateSize, M> ph =
+      corrected.covariance * jacobian.transpose();
+    const Eigen::Matrix<double, M, M> innovation_cov = jacobian * ph + covariance;
+    const Eigen::Matrix<double, kErrorStateSize, M> gain =
+      innovation_cov.llt().solve(ph.transpose()).transpose();
+    inject(gain * residual, corrected.state);
+
+    // Joseph form keeps the covariance symmetric and positive definite
+    const ErrorStateMatrix ikh = ErrorStateMatrix::Identity() - gain * jacobian;
+    corrected.covariance = ikh * corrected.covariance * ikh.transpose() +
+      gain * covariance * gain.transpose();
+
+    for (size_t i = offset; i > 0; i--) {
+      HistoryEntry & next = entry(i - 1);
+      propagate(entry(i), next.imu, next.stamp, next);
+    }
+    return true;
+  }
+};  // class ErrorStateEKF
+
+}  // namespace es_ekf
+
+#endif  // ERROR_STATE_EKF_HPP_
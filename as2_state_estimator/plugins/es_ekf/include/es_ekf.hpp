@@ -0,0 +1,363 @@
+// Copyright 2024 Universidad Politécnica de Madrid
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the Universidad Politécnica de Madrid nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+* @file es_ekf.hpp
+*
+* An state estimation plugin es_ekf for AeroStack2, fusing IMU with odometry, mocap and GPS
+*
+* @authors Rafael Pérez Seguí
+*          Miguel Fernández Cortizas
+*/
+
+#ifndef ES_EKF_HPP_
+#define ES_EKF_HPP_
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <mocap4r2_msgs/msg/rigid_bodies.hpp>
+#include <sensor_msgs/msg/imu.hpp>
+#include <sensor_msgs/msg/nav_sat_fix.hpp>
+
+#include <as2_core/utils/gps_utils.hpp>
+
+#include "as2_state_estimator/plugin_base.hpp"
+#include "error_state_ekf.hpp"
+
+namespace es_ekf
+{
+
+class Plugin : public as2_state_estimator_plugin_base::StateEstimatorBase
+{
+  rclcpp::Subscription<sensor_msgs::msg::Imu>::SharedPtr imu_sub_;
+  rclcpp::Subscription<nav_msgs::msg::Odometry>::SharedPtr odom_sub_;
+  rclcpp::Subscription<mocap4r2_msgs::msg::RigidBodies>::SharedPtr rigid_bodies_sub_;
+  rclcpp::Subscription<sensor_msgs::msg::NavSatFix>::SharedPtr gps_sub_;
+  rclcpp::TimerBase::SharedPtr publish_timer_;
+
+  std::unique_ptr<ErrorStateEKF> filter_;
+  std::mutex filter_mutex_;
+  as2::gps::GpsHandler gps_handler_;
+  bool gps_origin_set_ = false;
+
+  std::string rigid_body_name_;
+  double mocap_position_std_ = 0.005;
+  double mocap_orientation_std_ = 0.01;
+  double odom_position_std_ = 0.05;
+  double odom_orientation_std_ = 0.05;
+  double odom_velocity_std_ = 0.1;
+  double gps_position_std_ = 2.0;
+  double last_published_stamp_ = 0.0;
+
+  geometry_msgs::msg::PoseStamped pose_msg_;
+  geometry_msgs::msg::TwistStamped twist_msg_;
+  geometry_msgs::msg::TransformStamped odom_to_base_msg_;
+
+public:
+  Plugin()
+  : as2_state_estimator_plugin_base::StateEstimatorBase() {}
+
+  void on_setup() override
+  {
+    int history_size = 500;
+    node_ptr_->get_parameter("history_size", history_size);
+    filter_ = std::make_unique<ErrorStateEKF>(static_cast<size_t>(std::max(history_size, 2)));
+
+    ImuNoise imu_noise;
+    node_ptr_->get_parameter("imu_noise.acc", imu_noise.acc_noise);
+    node_ptr_->get_parameter("imu_noise.gyro", imu_noise.gyro_noise);
+    node_ptr_->get_parameter("imu_noise.acc_bias_walk", imu_noise.acc_bias_walk);
+    node_ptr_->get_parameter("imu_noise.gyro_bias_walk", imu_noise.gyro_bias_walk);
+    filter_->setImuNoise(imu_noise);
+
+    std::string imu_topic = as2_names::topics::sensor_measurements::imu;
+    node_ptr_->get_parameter("imu_topic", imu_topic);
+    imu_sub_ = node_ptr_->create_subscription<sensor_msgs::msg::Imu>(
+      imu_topic, as2_names::topics::sensor_measurements::qos,
+      std::bind(&Plugin::imu_callback, this, std::placeholders::_1));
+
+    bool use_odom = true;
+    node_ptr_->get_parameter("use_odom", use_odom);
+    if (use_odom) {
+      std::string odom_topic = as2_names::topics::sensor_measurements::odom;
+      node_ptr_->get_parameter("odom_topic", odom_topic);
+      node_ptr_->get_parameter("odom.position_std", odom_position_std_);
+      node_ptr_->get_parameter("odom.orientation_std", odom_orientation_std_);
+      node_ptr_->get_parameter("odom.velocity_std", odom_velocity_std_);
+      odom_sub_ = node_ptr_->create_subscription<nav_msgs::msg::Odometry>(
+        odom_topic, as2_names::topics::sensor_measurements::qos,
+        std::bind(&Plugin::odom_callback, this, std::placeholders::_1));
+    }
+
+    bool use_mocap = false;
+    node_ptr_->get_parameter("use_mocap", use_mocap);
+    if (use_mocap) {
+      std::string mocap_topic;
+      node_ptr_->get_parameter("mocap_topic", mocap_topic);
+      node_ptr_->get_parameter("rigid_body_name", rigid_body_name_);
+      if (mocap_topic.empty() || rigid_body_name_.empty()) {
+        RCLCPP_ERROR(
+          node_ptr_->get_logger(), "Parameters 'mocap_topic' and 'rigid_body_name' must be set");
+        throw std::runtime_error("Parameters 'mocap_topic' and 'rigid_body_name' not set");
+      }
+      node_ptr_->get_parameter("mocap.position_std", mocap_position_std_);
+      node_ptr_->get_parameter("mocap.orientation_std", mocap_orientation_std_);
+      rigid_bodies_sub_ = node_ptr_->create_subscription<mocap4r2_msgs::msg::RigidBodies>(
+        mocap_topic, rclcpp::QoS(10),
+        std::bind(&Plugin::rigid_bodies_callback, this, std::placeholders::_1));
+    }
+
+    bool use_gps = false;
+    node_ptr_->get_parameter("use_gps", use_gps);
+    if (use_gps) {
+      node_ptr_->get_parameter("gps.position_std", gps_position_std_);
+      gps_sub_ = node_ptr_->create_subscription<sensor_msgs::msg::NavSatFix>(
+        as2_names::topics::sensor_measurements::gps, as2_names::topics::sensor_measurements::qos,
+        std::bind(&Plugin::gps_callback, this, std::placeholders::_1));
+    }
+
+    // The filter estimates the pose in the earth frame, map and odom are kept on it
+    publish_static_transform(
+      as2::tf::getTransformation(get_earth_frame(), get_map_frame(), 0, 0, 0, 0, 0, 0));
+    publish_static_transform(
+      as2::tf::getTransformation(get_map_frame(), get_odom_frame(), 0, 0, 0, 0, 0, 0));
+
+    pose_msg_.header.frame_id = get_earth_frame();
+    twist_msg_.header.frame_id = get_base_frame();
+    odom_to_base_msg_.header.frame_id = get_odom_frame();
+    odom_to_base_msg_.child_frame_id = get_base_frame();
+
+    double publish_rate = 100.0;
+    node_ptr_->get_parameter("publish_rate", publish_rate);
+    if (publish_rate <= 0.0) {
+      RCLCPP_ERROR(node_ptr_->get_logger(), "Parameter 'publish_rate' must be positive");
+      throw std::runtime_error("Parameter 'publish_rate' must be positive");
+    }
+    publish_timer_ = node_ptr_->create_timer(
+      std::chrono::duration<double>(1.0 / publish_rate),
+      std::bind(&Plugin::publish_state, this));
+  }
+
+private:
+  static double to_seconds(const builtin_interfaces::msg::Time & stamp)
+  {
+    return rclcpp::Time(stamp).seconds();
+  }
+
+  /* Measurement std used when the message does not carry a covariance */
+  static double variance(const double msg_variance, const double default_std)
+  {
+    return msg_variance > 0.0 ? msg_variance : default_std * default_std;
+  }
+
+  void initialize_filter(
+    const double stamp, const Eigen::Vector3d & position,
+    const Eigen::Quaterniond & orientation, const Eigen::Vector3d & velocity)
+  {
+    NominalState state;
+    state.position = position;
+    state.orientation = orientation;
+    state.velocity = velocity;
+    ErrorStateMatrix covariance = ErrorStateMatrix::Zero();
+    covariance.diagonal() << Eigen::Vector3d::Constant(0.01), Eigen::Vector3d::Constant(0.01),
+      Eigen::Vector3d::Constant(0.01), Eigen::Vector3d::Constant(0.01),
+      Eigen::Vector3d::Constant(1e-4);
+    filter_->initialize(stamp, state, covariance);
+    RCLCPP_INFO(node_ptr_->get_logger(), "Filter initialized");
+  }
+
+  void imu_callback(const sensor_msgs::msg::Imu::SharedPtr msg)
+  {
+    ImuSample imu;
+    imu.linear_acceleration = Eigen::Vector3d(
+      msg->linear_acceleration.x, msg->linear_acceleration.y, msg->linear_acceleration.z);
+    imu.angular_velocity = Eigen::Vector3d(
+      msg->angular_velocity.x, msg->angular_velocity.y, msg->angular_velocity.z);
+    std::lock_guard<std::mutex> lock(filter_mutex_);
+    filter_->predict(to_seconds(msg->header.stamp), imu);
+  }
+
+  void odom_callback(const nav_msgs::msg::Odometry::SharedPtr msg)
+  {
+    // Odometry frame is assumed to be the odom frame, which matches the earth frame
+    const double stamp = to_seconds(msg->header.stamp);
+    const auto & p = msg->pose.pose.position;
+    const auto & q = msg->pose.pose.orientation;
+    const auto & v = msg->twist.twist.linear;
+    const Eigen::Vector3d position(p.x, p.y, p.z);
+    const Eigen::Quaterniond orientation(q.w, q.x, q.y, q.z);
+    const Eigen::Vector3d velocity(v.x, v.y, v.z);
+
+    std::lock_guard<std::mutex> lock(filter_mutex_);
+    if (!filter_->isInitialized()) {
+      initialize_filter(stamp, position, orientation, orientation * velocity);
+      return;
+    }
+
+    Eigen::Matrix<double, 6, 6> pose_covariance = Eigen::Matrix<double, 6, 6>::Zero();
+    Eigen::Matrix3d velocity_covariance = Eigen::Matrix3d::Zero();
+    for (int i = 0; i < 3; i++) {
+      pose_covariance(i, i) = variance(msg->pose.covariance[i * 7], odom_position_std_);
+      pose_covariance(i + 3, i + 3) =
+        variance(msg->pose.covariance[(i + 3) * 7], odom_orientation_std_);
+      velocity_covariance(i, i) = variance(msg->twist.covariance[i * 7], odom_velocity_std_);
+    }
+    filter_->updatePose(stamp, position, orientation, pose_covariance);
+    filter_->updateBodyVelocity(stamp, velocity, velocity_covariance);
+  }
+
+  void rigid_bodies_callback(const mocap4r2_msgs::msg::RigidBodies::SharedPtr msg)
+  {
+    for (const auto & rigid_body : msg->rigidbodies) {
+      if (rigid_body.rigid_body_name != rigid_body_name_) {
+        continue;
+      }
+      const double stamp = to_seconds(msg->header.stamp);
+      const auto & p = rigid_body.pose.position;
+      const auto & q = rigid_body.pose.orientation;
+      const Eigen::Vector3d position(p.x, p.y, p.z);
+      const Eigen::Quaterniond orientation(q.w, q.x, q.y, q.z);
+
+      std::lock_guard<std::mutex> lock(filter_mutex_);
+      if (!filter_->isInitialized()) {
+        initialize_filter(stamp, position, orientation, Eigen::Vector3d::Zero());
+        return;
+      }
+      Eigen::Matrix<double, 6, 6> covariance = Eigen::Matrix<double, 6, 6>::Zero();
+      covariance.diagonal() <<
+        Eigen::Vector3d::Constant(mocap_position_std_ * mocap_position_std_),
+        Eigen::Vector3d::Constant(mocap_orientation_std_ * mocap_orientation_std_);
+      filter_->updatePose(stamp, position, orientation, covariance);
+      return;
+    }
+  }
+
+  void gps_callback(const sensor_msgs::msg::NavSatFix::SharedPtr msg)
+  {
+    if (msg->status.status < sensor_msgs::msg::NavSatStatus::STATUS_FIX) {
+      return;
+    }
+    if (!gps_origin_set_) {
+      // First fix is the origin of the earth frame
+      gps_handler_.setOrigin(msg->latitude, msg->longitude, msg->altitude);
+      gps_origin_set_ = true;
+      RCLCPP_INFO(
+        node_ptr_->get_logger(), "GPS origin set to %f, %f, %f", msg->latitude,
+        msg->longitude, msg->altitude);
+    }
+    Eigen::Vector3d position;
+    gps_handler_.LatLon2Local(
+      msg->latitude, msg->longitude, msg->altitude, position.x(), position.y(), position.z());
+
+    Eigen::Matrix3d covariance = Eigen::Matrix3d::Zero();
+    const bool known_covariance =
+      msg->position_covariance_type != sensor_msgs::msg::NavSatFix::COVARIANCE_TYPE_UNKNOWN;
+    for (int i = 0; i < 3; i++) {
+      covariance(i, i) = variance(
+        known_covariance ? msg->position_covariance[i * 4] : 0.0, gps_position_std_);
+    }
+
+    const double stamp = to_seconds(msg->header.stamp);
+    std::lock_guard<std::mutex> lock(filter_mutex_);
+    if (!filter_->isInitialized()) {
+      // No attitude source: start level, heading is only observable with other sources
+      initialize_filter(
+        stamp, position, Eigen::Quaterniond::Identity(), Eigen::Vector3d::Zero());
+      return;
+    }
+    filter_->updatePosition(stamp, position, covariance);
+  }
+
+  void publish_state()
+  {
+    std::lock_guard<std::mutex> lock(filter_mutex_);
+    if (!filter_->isInitialized() || filter_->getStamp() <= last_published_stamp_) {
+      return;
+    }
+    last_published_stamp_ = filter_->getStamp();
+    const NominalState & state = filter_->getState();
+    const rclcpp::Time stamp(
+      static_cast<int64_t>(filter_->getStamp() * 1e9), node_ptr_->get_clock()->get_clock_type());
+
+    pose_msg_.header.stamp = stamp;
+    pose_msg_.pose.position.x = state.position.x();
+    pose_msg_.pose.position.y = state.position.y();
+    pose_msg_.pose.position.z = state.position.z();
+    pose_msg_.pose.orientation.w = state.orientation.w();
+    pose_msg_.pose.orientation.x = state.orientation.x();
+    pose_msg_.pose.orientation.y = state.orientation.y();
+    pose_msg_.pose.orientation.z = state.orientation.z();
+
+    odom_to_base_msg_.header.stamp = stamp;
+    odom_to_base_msg_.transform.translation.x = state.position.x();
+    odom_to_base_msg_.transform.translation.y = state.position.y();
+    odom_to_base_msg_.transform.translation.z = state.position.z();
+    odom_to_base_msg_.transform.rotation = pose_msg_.pose.orientation;
+
+    const Eigen::Vector3d body_velocity = state.orientation.conjugate() * state.velocity;
+    const Eigen::Vector3d angular_velocity = filter_->getAngularVelocity();
+    twist_msg_.header.stamp = stamp;
+    twist_msg_.twist.linear.x = body_velocity.x();
+    twist_msg_.twist.linear.y = body_velocity.y();
+    twist_msg_.twist.linear.z = body_velocity.z();
+    twist_msg_.twist.angular.x = angular_velocity.x();
+    twist_msg_.twist.angular.y = angular_velocity.y();
+    twist_msg_.twist.angular.z = angular_velocity.z();
+
+    // Covariances for the odometry output: pose in earth frame, twist in base frame
+    const ErrorStateMatrix & covariance = filter_->getCovariance();
+    const Eigen::Matrix3d rotation = state.orientation.toRotationMatrix();
+    Eigen::Matrix<double, 6, 6> pose_covariance;
+    pose_covariance << covariance.block<3, 3>(kPosition, kPosition),
+      covariance.block<3, 3>(kPosition, kAttitude),
+      covariance.block<3, 3>(kAttitude, kPosition),
+      covariance.block<3, 3>(kAttitude, kAttitude);
+    Eigen::Matrix<double, 6, 6> twist_covariance = Eigen::Matrix<double, 6, 6>::Zero();
+    twist_covariance.block<3, 3>(0, 0) =
+      rotation.transpose() * covariance.block<3, 3>(kVelocity, kVelocity) * rotation;
+    twist_covariance.block<3, 3>(3, 3) = covariance.block<3, 3>(kGyroBias, kGyroBias);
+    std::array<double, 36> pose_covariance_msg;
+    std::array<double, 36> twist_covariance_msg;
+    Eigen::Map<Eigen::Matrix<double, 6, 6, Eigen::RowMajor>>(pose_covariance_msg.data()) =
+      pose_covariance;
+    Eigen::Map<Eigen::Matrix<double, 6, 6, Eigen::RowMajor>>(twist_covariance_msg.data()) =
+      twist_covariance;
+    set_odometry_covariance(pose_covariance_msg, twist_covariance_msg);
+
+    publish_transform(odom_to_base_msg_);
+    publish_pose(pose_msg_);
+    publish_twist(twist_msg_);
+  }
+};
+
+}  // namespace es_ekf
+
+#endif  // ES_EKF_HPP_
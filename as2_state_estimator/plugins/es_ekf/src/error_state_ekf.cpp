@@ -0,0 +1,225 @@
+// Copyright 2024 Universidad Politécnica de Madrid
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the Universidad Politécnica de Madrid nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+* @file error_state_ekf.cpp
+*
+* Error-state extended Kalman filter with IMU prediction and delayed measurement handling
+* implementation
+*
+* @authors Rafael Pérez Seguí
+*          Miguel Fernández Cortizas
+*/
+
+#include "error_state_ekf.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace es_ekf
+{
+
+namespace
+{
+Eigen::Matrix3d skew(const Eigen::Vector3d & v)
+{
+  Eigen::Matrix3d m;
+  m << 0.0, -v.z(), v.y(),
+    v.z(), 0.0, -v.x(),
+    -v.y(), v.x(), 0.0;
+  return m;
+}
+
+Eigen::Quaterniond rotationVectorToQuaternion(const Eigen::Vector3d & rotation)
+{
+  const double angle = rotation.norm();
+  if (angle < 1e-12) {
+    return Eigen::Quaterniond(1.0, 0.5 * rotation.x(), 0.5 * rotation.y(), 0.5 * rotation.z())
+           .normalized();
+  }
+  return Eigen::Quaterniond(Eigen::AngleAxisd(angle, rotation / angle));
+}
+
+Eigen::Vector3d quaternionToRotationVector(const Eigen::Quaterniond & q)
+{
+  // Shortest rotation
+  const Eigen::Quaterniond q_pos = q.w() < 0.0 ? Eigen::Quaterniond(-q.coeffs()) : q;
+  const Eigen::AngleAxisd angle_axis(q_pos);
+  return angle_axis.angle() * angle_axis.axis();
+}
+}  // namespace
+
+ErrorStateEKF::ErrorStateEKF(const size_t history_size)
+{
+  if (history_size < 2) {
+    throw std::invalid_argument("ErrorStateEKF history size must be at least 2");
+  }
+  history_.resize(history_size);
+}
+
+void ErrorStateEKF::initialize(
+  const double stamp, const NominalState & state,
+  const ErrorStateMatrix & covariance)
+{
+  head_ = 0;
+  size_ = 1;
+  rejected_measurements_ = 0;
+  HistoryEntry & first = history_[head_];
+  first.stamp = stamp;
+  first.state = state;
+  first.state.orientation.normalize();
+  first.covariance = covariance;
+  first.imu = ImuSample();
+}
+
+bool ErrorStateEKF::predict(const double stamp, const ImuSample & imu)
+{
+  if (!isInitialized() || stamp <= entry(0).stamp) {
+    return false;
+  }
+  const size_t next = (head_ + 1) % history_.size();
+  propagate(history_[head_], imu, stamp, history_[next]);
+  head_ = next;
+  size_ = std::min(size_ + 1, history_.size());
+  return true;
+}
+
+void ErrorStateEKF::propagate(
+  const HistoryEntry & from, const ImuSample & imu, const double stamp,
+  HistoryEntry & to) const
+{
+  const double dt = stamp - from.stamp;
+  const NominalState & s = from.state;
+  const Eigen::Vector3d acc = imu.linear_acceleration - s.acc_bias;
+  const Eigen::Vector3d gyro = imu.angular_velocity - s.gyro_bias;
+  const Eigen::Matrix3d rot = s.orientation.toRotationMatrix();
+  const Eigen::Vector3d acc_earth = rot * acc + gravity_;
+  const Eigen::Quaterniond delta_q = rotationVectorToQuaternion(gyro * dt);
+
+  // Error state transition F is the identity except for these blocks
+  const Eigen::Matrix3d f_vel_att = -rot * skew(acc) * dt;
+  const Eigen::Matrix3d f_vel_acc_bias = -rot * dt;
+  const Eigen::Matrix3d f_att_att = delta_q.toRotationMatrix().transpose();
+
+  // Left multiplication by F as block row operations, far cheaper than dense 15x15 products
+  auto apply_transition = [&](const ErrorStateMatrix & in, ErrorStateMatrix & out) {
+      out.middleRows<3>(kPosition) =
+        in.middleRows<3>(kPosition) + dt * in.middleRows<3>(kVelocity);
+      out.middleRows<3>(kVelocity) = in.middleRows<3>(kVelocity);
+      out.middleRows<3>(kVelocity).noalias() += f_vel_att * in.middleRows<3>(kAttitude);
+      out.middleRows<3>(kVelocity).noalias() += f_vel_acc_bias * in.middleRows<3>(kAccBias);
+      out.middleRows<3>(kAttitude).noalias() = f_att_att * in.middleRows<3>(kAttitude);
+      out.middleRows<3>(kAttitude) -= dt * in.middleRows<3>(kGyroBias);
+      out.middleRows<6>(kAccBias) = in.middleRows<6>(kAccBias);
+    };
+
+  const double vel_var = imu_noise_.acc_noise * imu_noise_.acc_noise * dt * dt;
+  const double att_var = imu_noise_.gyro_noise * imu_noise_.gyro_noise * dt * dt;
+  const double acc_bias_var = imu_noise_.acc_bias_walk * imu_noise_.acc_bias_walk * dt;
+  const double gyro_bias_var = imu_noise_.gyro_bias_walk * imu_noise_.gyro_bias_walk * dt;
+
+  // F P F' = (F (F P)')'
+  ErrorStateMatrix fp;
+  apply_transition(from.covariance, fp);
+  ErrorStateMatrix fpf_t;
+  apply_transition(fp.transpose(), fpf_t);
+  to.covariance = fpf_t.transpose();
+  to.covariance.diagonal().segment<3>(kVelocity).array() += vel_var;
+  to.covariance.diagonal().segment<3>(kAttitude).array() += att_var;
+  to.covariance.diagonal().segment<3>(kAccBias).array() += acc_bias_var;
+  to.covariance.diagonal().segment<3>(kGyroBias).array() += gyro_bias_var;
+
+  to.state.position = s.position + s.velocity * dt + 0.5 * acc_earth * dt * dt;
+  to.state.velocity = s.velocity + acc_earth * dt;
+  to.state.orientation = (s.orientation * delta_q).normalized();
+  to.state.acc_bias = s.acc_bias;
+  to.state.gyro_bias = s.gyro_bias;
+  to.stamp = stamp;
+  to.imu = imu;
+}
+
+void ErrorStateEKF::inject(const ErrorStateVector & error, NominalState & state) const
+{
+  state.position += error.segment<3>(kPosition);
+  state.velocity += error.segment<3>(kVelocity);
+  state.orientation =
+    (state.orientation * rotationVectorToQuaternion(error.segment<3>(kAttitude))).normalized();
+  state.acc_bias += error.segment<3>(kAccBias);
+  state.gyro_bias += error.segment<3>(kGyroBias);
+}
+
+bool ErrorStateEKF::updatePosition(
+  const double stamp, const Eigen::Vector3d & position,
+  const Eigen::Matrix3d & covariance)
+{
+  return correct<3>(
+    stamp, covariance,
+    [&position](
+      const NominalState & state, Eigen::Matrix<double, 3, 1> & residual,
+      Eigen::Matrix<double, 3, kErrorStateSize> & jacobian) {
+      residual = position - state.position;
+      jacobian.block<3, 3>(0, kPosition).setIdentity();
+    });
+}
+
+bool ErrorStateEKF::updatePose(
+  const double stamp, const Eigen::Vector3d & position,
+  const Eigen::Quaterniond & orientation,
+  const Eigen::Matrix<double, 6, 6> & covariance)
+{
+  return correct<6>(
+    stamp, covariance,
+    [&position, &orientation](
+      const NominalState & state, Eigen::Matrix<double, 6, 1> & residual,
+      Eigen::Matrix<double, 6, kErrorStateSize> & jacobian) {
+      residual.head<3>() = position - state.position;
+      residual.tail<3>() =
+        quaternionToRotationVector(state.orientation.conjugate() * orientation.normalized());
+      jacobian.block<3, 3>(0, kPosition).setIdentity();
+      jacobian.block<3, 3>(3, kAttitude).setIdentity();
+    });
+}
+
+bool ErrorStateEKF::updateBodyVelocity(
+  const double stamp, const Eigen::Vector3d & velocity,
+  const Eigen::Matrix3d & covariance)
+{
+  return correct<3>(
+    stamp, covariance,
+    [&velocity](
+      const NominalState & state, Eigen::Matrix<double, 3, 1> & residual,
+      Eigen::Matrix<double, 3, kErrorStateSize> & jacobian) {
+      const Eigen::Matrix3d rot_t = state.orientation.toRotationMatrix().transpose();
+      const Eigen::Vector3d predicted = rot_t * state.velocity;
+      residual = velocity - predicted;
+      jacobian.block<3, 3>(0, kVelocity) = rot_t;
+      jacobian.block<3, 3>(0, kAttitude) = skew(predicted);
+    });
+}
+
+}  // namespace es_ekf
@@ -0,0 +1,168 @@
+// Copyright 2024 Universidad Politécnica de Madrid
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the Universidad Politécnica de Madrid nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+* @file error_state_ekf_gtest.cpp
+*
+* Error-state EKF gtest
+*
+* @authors Rafael Pérez Seguí
+*/
+
+#include <gtest/gtest.h>
+
+#include "error_state_ekf.hpp"
+
+using es_ekf::ErrorStateEKF;
+using es_ekf::ErrorStateMatrix;
+using es_ekf::ImuSample;
+using es_ekf::NominalState;
+
+namespace
+{
+constexpr double kImuDt = 0.001;
+
+ImuSample hoverSample()
+{
+  ImuSample imu;
+  imu.linear_acceleration = Eigen::Vector3d(0.0, 0.0, 9.81);
+  return imu;
+}
+
+ErrorStateMatrix initialCovariance()
+{
+  ErrorStateMatrix p = ErrorStateMatrix::Identity() * 0.01;
+  return p;
+}
+}  // namespace
+
+TEST(ErrorStateEKFGTest, RequiresInitialization) {
+  ErrorStateEKF filter(10);
+  EXPECT_FALSE(filter.isInitialized());
+  EXPECT_FALSE(filter.predict(0.1, hoverSample()));
+  EXPECT_FALSE(filter.updatePosition(0.1, Eigen::Vector3d::Zero(), Eigen::Matrix3d::Identity()));
+  EXPECT_THROW(ErrorStateEKF(1), std::invalid_argument);
+}
+
+TEST(ErrorStateEKFGTest, HoverKeepsStateAndGrowsCovariance) {
+  ErrorStateEKF filter(100);
+  NominalState initial;
+  initial.position = Eigen::Vector3d(1.0, 2.0, 3.0);
+  filter.initialize(0.0, initial, initialCovariance());
+  for (int i = 1; i <= 50; i++) {
+    ASSERT_TRUE(filter.predict(i * kImuDt, hoverSample()));
+  }
+  EXPECT_TRUE(filter.getState().position.isApprox(initial.position));
+  EXPECT_NEAR(filter.getState().velocity.norm(), 0.0, 1e-12);
+  EXPECT_GT(filter.getCovariance()(3, 3), initialCovariance()(3, 3));
+  EXPECT_FALSE(filter.predict(0.0, hoverSample()));
+}
+
+TEST(ErrorStateEKFGTest, PositionUpdatesConverge) {
+  ErrorStateEKF filter(100);
+  filter.initialize(0.0, NominalState(), initialCovariance());
+  const Eigen::Vector3d measured(0.5, -0.5, 1.0);
+  const Eigen::Matrix3d covariance = Eigen::Matrix3d::Identity() * 1e-4;
+  for (int i = 1; i <= 2000; i++) {
+    filter.predict(i * kImuDt, hoverSample());
+    if (i % 10 == 0) {
+      ASSERT_TRUE(filter.updatePosition(i * kImuDt, measured, covariance));
+    }
+  }
+  EXPECT_NEAR((filter.getState().position - measured).norm(), 0.0, 1e-2);
+  EXPECT_NEAR(filter.getState().velocity.norm(), 0.0, 5e-2);
+}
+
+TEST(ErrorStateEKFGTest, PoseUpdateCorrectsAttitude) {
+  ErrorStateEKF filter(100);
+  filter.initialize(0.0, NominalState(), initialCovariance());
+  const Eigen::Quaterniond yaw(Eigen::AngleAxisd(0.05, Eigen::Vector3d::UnitZ()));
+  Eigen::Matrix<double, 6, 6> covariance = Eigen::Matrix<double, 6, 6>::Identity() * 1e-6;
+  for (int i = 1; i <= 20; i++) {
+    filter.predict(i * kImuDt, hoverSample());
+    filter.updatePose(i * kImuDt, Eigen::Vector3d::Zero(), yaw, covariance);
+  }
+  EXPECT_NEAR(filter.getState().orientation.angularDistance(yaw), 0.0, 1e-3);
+}
+
+TEST(ErrorStateEKFGTest, BodyVelocityUpdate) {
+  ErrorStateEKF filter(100);
+  NominalState initial;
+  initial.orientation = Eigen::Quaterniond(Eigen::AngleAxisd(M_PI_2, Eigen::Vector3d::UnitZ()));
+  filter.initialize(0.0, initial, initialCovariance());
+  const Eigen::Matrix3d covariance = Eigen::Matrix3d::Identity() * 1e-6;
+  for (int i = 1; i <= 20; i++) {
+    filter.predict(i * kImuDt, hoverSample());
+    filter.updateBodyVelocity(i * kImuDt, Eigen::Vector3d(1.0, 0.0, 0.0), covariance);
+  }
+  // Forward in the base frame is +y in the earth frame
+  EXPECT_NEAR((filter.getState().velocity - Eigen::Vector3d(0.0, 1.0, 0.0)).norm(), 0.0, 1e-2);
+}
+
+TEST(ErrorStateEKFGTest, DelayedMeasurementMatchesInOrderProcessing) {
+  const Eigen::Vector3d measured(0.2, 0.1, -0.3);
+  const Eigen::Matrix3d covariance = Eigen::Matrix3d::Identity() * 1e-3;
+  ImuSample imu = hoverSample();
+  imu.linear_acceleration.x() += 0.5;
+  imu.angular_velocity.z() = 0.3;
+
+  // Measurement processed when it is taken
+  ErrorStateEKF in_order(100);
+  in_order.initialize(0.0, NominalState(), initialCovariance());
+  for (int i = 1; i <= 50; i++) {
+    in_order.predict(i * kImuDt, imu);
+    if (i == 20) {
+      in_order.updatePosition(i * kImuDt, measured, covariance);
+    }
+  }
+
+  // Same measurement received 30 IMU samples later
+  ErrorStateEKF delayed(100);
+  delayed.initialize(0.0, NominalState(), initialCovariance());
+  for (int i = 1; i <= 50; i++) {
+    delayed.predict(i * kImuDt, imu);
+  }
+  ASSERT_TRUE(delayed.updatePosition(20 * kImuDt, measured, covariance));
+
+  EXPECT_NEAR((in_order.getState().position - delayed.getState().position).norm(), 0.0, 1e-9);
+  EXPECT_NEAR((in_order.getState().velocity - delayed.getState().velocity).norm(), 0.0, 1e-9);
+  EXPECT_NEAR(
+    in_order.getState().orientation.angularDistance(delayed.getState().orientation), 0.0, 1e-9);
+  EXPECT_TRUE(in_order.getCovariance().isApprox(delayed.getCovariance(), 1e-9));
+}
+
+TEST(ErrorStateEKFGTest, RejectsMeasurementsOlderThanHistory) {
+  ErrorStateEKF filter(10);
+  filter.initialize(0.0, NominalState(), initialCovariance());
+  for (int i = 1; i <= 50; i++) {
+    filter.predict(i * kImuDt, hoverSample());
+  }
+  EXPECT_FALSE(filter.updatePosition(0.01, Eigen::Vector3d::Zero(), Eigen::Matrix3d::Identity()));
+  EXPECT_EQ(filter.getRejectedMeasurements(), 1u);
+  EXPECT_TRUE(filter.updatePosition(0.045, Eigen::Vector3d::Zero(), Eigen::Matrix3d::Identity()));
+}
@@ -41,17 +41,17 @@
 #ifndef GROUND_TRUTH_HPP_
 #define GROUND_TRUTH_HPP_
 
-#include <utility>
+#include <atomic>
+#include <functional>
 #include <regex>
 #include <memory>
+#include <mutex>
 #include <geographic_msgs/msg/geo_point.hpp>
+#include <sensor_msgs/msg/nav_sat_fix.hpp>
 
-#include <as2_core/names/services.hpp>
-#include <as2_core/utils/gps_utils.hpp>
 #include <as2_core/utils/tf_utils.hpp>
-#include <as2_msgs/srv/get_origin.hpp>
-#include <as2_msgs/srv/set_origin.hpp>
 
+#include "as2_state_estimator/gps_origin_handler.hpp"
 #include "as2_state_estimator/plugin_base.hpp"
 
 namespace ground_truth
@@ -61,31 +61,26 @@ class Plugin : public as2_state_estimator_plugin_base::StateEstimatorBase
 {
   rclcpp::Subscription<geometry_msgs::msg::PoseStamped>::SharedPtr pose_sub_;
   rclcpp::Subscription<geometry_msgs::msg::TwistStamped>::SharedPtr twist_sub_;
-  rclcpp::Subscription<sensor_msgs::msg::NavSatFix>::SharedPtr gps_sub_;
-
-  rclcpp::Service<as2_msgs::srv::SetOrigin>::SharedPtr set_origin_srv_;
-  rclcpp::Service<as2_msgs::srv::GetOrigin>::SharedPtr get_origin_srv_;
 
   bool use_gps_ = false;
-  bool set_origin_on_start_ = false;
-  bool earth_to_map_set_ = false;
-  double origin_lat_ = 0.0;
-  double origin_lon_ = 0.0;
-  double origin_alt_ = 0.0;
 
-  geometry_msgs::msg::TransformStamped earth_to_map_;
-  geographic_msgs::msg::GeoPoint::UniquePtr origin_;
-  sensor_msgs::msg::NavSatFix::UniquePtr gps_pose_;
+  // Replaced as a whole by the first pose or the GPS origin worker, read by the pose callback
+  std::shared_ptr<const tf2::Transform> earth_to_map_ =
+    std::make_shared<const tf2::Transform>(tf2::Transform::getIdentity());
+  std::atomic<bool> earth_to_map_set_{false};
+  std::mutex earth_to_map_mutex_;
 
   bool using_gazebo_tf_ = false;
 
+  // Declared last, so its worker thread is stopped before the other members are destroyed
+  std::unique_ptr<as2_state_estimator::GpsOriginHandler> gps_origin_handler_;
+
 public:
   Plugin()
   : as2_state_estimator_plugin_base::StateEstimatorBase() {}
   void on_setup() override
   {
     node_ptr_->get_parameter("use_gps", use_gps_);
-    node_ptr_->get_parameter("set_origin_on_start", set_origin_on_start_);
 
     pose_sub_ = node_ptr_->create_subscription<geometry_msgs::msg::PoseStamped>(
       as2_names::topics::ground_truth::pose, as2_names::topics::ground_truth::qos,
@@ -95,48 +90,6 @@ public:
       std::bind(&Plugin::twist_callback, this, std::placeholders::_1));
 
     // publish static transform from earth to map and map to odom
-    earth_to_map_ =
-      as2::tf::getTransformation(get_earth_frame(), get_map_frame(), 0, 0, 0, 0, 0, 0);
-    if (!use_gps_) {
-      // TODO(javilinos): MODIFY this to a initial earth to map transform (reading initial position
-      // from parameters or msgs )
-      publish_static_transform(earth_to_map_);
-    } else {
-      set_origin_srv_ = node_ptr_->create_service<as2_msgs::srv::SetOrigin>(
-        as2_names::services::gps::set_origin,
-        std::bind(
-          &Plugin::setOriginCallback, this, std::placeholders::_1,
-          std::placeholders::_2));
-      get_origin_srv_ = node_ptr_->create_service<as2_msgs::srv::GetOrigin>(
-        as2_names::services::gps::get_origin,
-        std::bind(
-          &Plugin::getOriginCallback, this, std::placeholders::_1,
-          std::placeholders::_2));
-      gps_sub_ = node_ptr_->create_subscription<sensor_msgs::msg::NavSatFix>(
-        as2_names::topics::sensor_measurements::gps, as2_names::topics::sensor_measurements::qos,
-        std::bind(&Plugin::gps_callback, this, std::placeholders::_1));
-
-      if (set_origin_on_start_ && node_ptr_->has_parameter("set_origin.lat") &&
-        node_ptr_->has_parameter("set_origin.lon") &&
-        node_ptr_->has_parameter("set_origin.alt"))
-      {
-        node_ptr_->get_parameter("set_origin.lat", origin_lat_);
-        node_ptr_->get_parameter("set_origin.lon", origin_lon_);
-        node_ptr_->get_parameter("set_origin.alt", origin_alt_);
-
-        origin_ = std::make_unique<geographic_msgs::msg::GeoPoint>();
-        origin_->latitude = origin_lat_;
-        origin_->longitude = origin_lon_;
-        origin_->altitude = origin_alt_;
-
-        RCLCPP_INFO(
-          node_ptr_->get_logger(), "Origin set to %f, %f, %f", origin_lat_, origin_lon_,
-          origin_alt_);
-      } else {
-        RCLCPP_INFO(node_ptr_->get_logger(), "Waiting for origin to be set");
-      }
-    }
-
     geometry_msgs::msg::TransformStamped map_to_odom =
       as2::tf::getTransformation(get_map_frame(), get_odom_frame(), 0, 0, 0, 0, 0, 0);
 
@@ -145,34 +98,57 @@ public:
       node_ptr_->get_parameter("use_gazebo_tf", using_gazebo_tf_);
       if (using_gazebo_tf_) {RCLCPP_INFO(node_ptr_->get_logger(), "Using gazebo tfs");}
     }
-    publish_static_transform(earth_to_map_);
+    publish_static_transform(
+      as2::tf::getTransformation(get_earth_frame(), get_map_frame(), 0, 0, 0, 0, 0, 0));
     publish_static_transform(map_to_odom);
+
+    if (use_gps_) {
+      // GPS fixes and origin requests are handled on their own thread
+      gps_origin_handler_ = std::make_unique<as2_state_estimator::GpsOriginHandler>(
+        node_ptr_,
+        std::bind(
+          &Plugin::generate_map_frame_from_gps, this, std::placeholders::_1,
+          std::placeholders::_2, std::placeholders::_3));
+    }
   }
 
 private:
+  // Called from the GPS origin worker thread, the GPS map fix overrides the first pose one
   void generate_map_frame_from_gps(
-    const geographic_msgs::msg::GeoPoint & origin,
-    const sensor_msgs::msg::NavSatFix & gps_pose)
+    const geographic_msgs::msg::GeoPoint &,
+    const sensor_msgs::msg::NavSatFix &,
+    const tf2::Vector3 & map_position)
   {
-    as2::gps::GpsHandler gps_handler;
-    gps_handler.setOrigin(origin.latitude, origin.longitude, origin.altitude);
-    double x, y, z;
-    gps_handler.LatLon2Local(gps_pose.latitude, gps_pose.longitude, gps_pose.altitude, x, y, z);
-    earth_to_map_ =
-      as2::tf::getTransformation(get_earth_frame(), get_map_frame(), x, y, z, 0, 0, 0);
-    publish_static_transform(earth_to_map_);
+    std::lock_guard<std::mutex> lock(earth_to_map_mutex_);
+    set_earth_to_map(
+      as2::tf::getTransformation(
+        get_earth_frame(), get_map_frame(),
+        map_position.x(), map_position.y(), map_position.z(), 0, 0, 0));
   }
 
   void generate_map_frame_from_ground_truth_pose(const geometry_msgs::msg::PoseStamped & pose)
   {
-    earth_to_map_.transform.translation.x = pose.pose.position.x;
-    earth_to_map_.transform.translation.y = pose.pose.position.y;
-    earth_to_map_.transform.translation.z = pose.pose.position.z;
-    earth_to_map_.transform.rotation.x = pose.pose.orientation.x;
-    earth_to_map_.transform.rotation.y = pose.pose.orientation.y;
-    earth_to_map_.transform.rotation.z = pose.pose.orientation.z;
-    earth_to_map_.transform.rotation.w = pose.pose.orientation.w;
-    publish_static_transform(earth_to_map_);
+    std::lock_guard<std::mutex> lock(earth_to_map_mutex_);
+    if (earth_to_map_set_) {
+      return;
+    }
+    geometry_msgs::msg::TransformStamped earth_to_map =
+      as2::tf::getTransformation(get_earth_frame(), get_map_frame(), 0, 0, 0, 0, 0, 0);
+    earth_to_map.transform.translation.x = pose.pose.position.x;
+    earth_to_map.transform.translation.y = pose.pose.position.y;
+    earth_to_map.transform.translation.z = pose.pose.position.z;
+    earth_to_map.transform.rotation = pose.pose.orientation;
+    set_earth_to_map(earth_to_map);
+  }
+
+  // Must be called with earth_to_map_mutex_ locked
+  void set_earth_to_map(const geometry_msgs::msg::TransformStamped & earth_to_map_msg)
+  {
+    auto earth_to_map = std::make_shared<tf2::Transform>();
+    tf2::fromMsg(earth_to_map_msg.transform, *earth_to_map);
+    std::atomic_store(&earth_to_map_, std::shared_ptr<const tf2::Transform>(earth_to_map));
+    earth_to_map_set_ = true;
+    publish_static_transform(earth_to_map_msg);
   }
 
   void pose_callback(const geometry_msgs::msg::PoseStamped::SharedPtr msg)
@@ -191,7 +167,6 @@ private:
 
     if (!earth_to_map_set_) {
       generate_map_frame_from_ground_truth_pose(*msg);
-      earth_to_map_set_ = true;
     }
 
     earth_to_baselink.setOrigin(
@@ -202,11 +177,9 @@ private:
         msg->pose.orientation.z,
         msg->pose.orientation.w));
 
-    tf2::fromMsg(earth_to_map_.transform, earth_to_map);
-
     convert_earth_to_baselink_2_odom_to_baselink_transform(
       earth_to_baselink, odom_to_baselink,
-      earth_to_map);
+      *std::atomic_load(&earth_to_map_));
 
     auto odom_to_baselink_msg = geometry_msgs::msg::TransformStamped();
     odom_to_baselink_msg.header.stamp = msg->header.stamp;
@@ -236,66 +209,6 @@ private:
     }
     publish_twist(*msg);
   }
-
-  void getOriginCallback(
-    const as2_msgs::srv::GetOrigin::Request::SharedPtr request,
-    as2_msgs::srv::GetOrigin::Response::SharedPtr response)
-  {
-    if (origin_) {
-      response->origin = *origin_;
-      response->success = true;
-    } else {
-      RCLCPP_WARN(node_ptr_->get_logger(), "Origin not set");
-      response->success = false;
-    }
-  }
-
-  void setOriginCallback(
-    const as2_msgs::srv::SetOrigin::Request::SharedPtr request,
-    as2_msgs::srv::SetOrigin::Response::SharedPtr response)
-  {
-    if (origin_) {
-      RCLCPP_WARN(node_ptr_->get_logger(), "Origin already set");
-      response->success = false;
-    } else {
-      origin_ = std::make_unique<geographic_msgs::msg::GeoPoint>(request->origin);
-      RCLCPP_INFO(
-        node_ptr_->get_logger(), "Origin set to %f, %f, %f", origin_->latitude,
-        origin_->longitude, origin_->altitude);
-      response->success = true;
-      generate_map_frame_from_gps(request->origin, *gps_pose_);
-    }
-  }
-
-  void gps_callback(sensor_msgs::msg::NavSatFix::UniquePtr msg)
-  {
-    // This sould only be called when the use_gps_origin is true
-    if (gps_pose_) {
-      gps_sub_.reset();
-      return;
-    }
-    gps_pose_ = std::move(msg);
-
-    if (set_origin_on_start_) {
-      if (!origin_) {
-        origin_ = std::make_unique<geographic_msgs::msg::GeoPoint>();
-        origin_->latitude = gps_pose_->latitude;
-        origin_->longitude = gps_pose_->longitude;
-        origin_->altitude = gps_pose_->altitude;
-        RCLCPP_WARN(node_ptr_->get_logger(), "Careful, using GPS pose as origin");
-        RCLCPP_INFO(
-          node_ptr_->get_logger(), "Origin set to %f, %f, %f", origin_lat_, origin_lon_,
-          origin_alt_);
-      }
-
-      RCLCPP_INFO(
-        node_ptr_->get_logger(), "GPS Callback: Map GPS pose set to %f, %f, %f",
-        gps_pose_->latitude, gps_pose_->longitude, gps_pose_->altitude);
-
-      generate_map_frame_from_gps(*origin_, *gps_pose_);
-      earth_to_map_set_ = true;
-    }
-  }
 };      // class GroundTruth
 }       // namespace ground_truth
 #endif  // GROUND_TRUTH_HPP_
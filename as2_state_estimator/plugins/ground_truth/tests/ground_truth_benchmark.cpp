@@ -0,0 +1,76 @@
+// Copyright 2024 Universidad Politécnica de Madrid
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the Universidad Politécnica de Madrid nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+* @file ground_truth_benchmark.cpp
+*
+* Ground truth plugin benchmark: ground truth pose input to estimator pose output, in process
+*
+* @authors Rafael Pérez Seguí
+*/
+
+#include <geometry_msgs/msg/pose_stamped.hpp>
+#include <as2_core/names/topics.hpp>
+
+#include "ground_truth.hpp"
+#include "plugin_pipeline_benchmark.hpp"
+
+namespace
+{
+
+using GroundTruthPipeline = as2_state_estimator::PluginPipeline<
+  ground_truth::Plugin, geometry_msgs::msg::PoseStamped, geometry_msgs::msg::PoseStamped>;
+
+as2_state_estimator::PluginPipelineConfig<geometry_msgs::msg::PoseStamped> makeConfig()
+{
+  as2_state_estimator::PluginPipelineConfig<geometry_msgs::msg::PoseStamped> config;
+  config.source_name = "ground_truth_source";
+  config.input_topic = as2_names::topics::ground_truth::pose;
+  config.input_qos = as2_names::topics::ground_truth::qos;
+  config.output_topic = as2_names::topics::self_localization::pose;
+  config.output_qos = as2_names::topics::self_localization::qos;
+  config.init_input = [](as2::Node &, geometry_msgs::msg::PoseStamped & msg) {
+      msg.header.frame_id = "earth";
+      msg.pose.orientation.w = 1.0;
+    };
+  config.next_input = [](as2::Node & node, geometry_msgs::msg::PoseStamped & msg) {
+      msg.header.stamp = node.now();
+      msg.pose.position.x += 0.01;
+    };
+  return config;
+}
+
+}  // namespace
+
+static void BM_GroundTruthCallbackToPublish(benchmark::State & state)
+{
+  as2_state_estimator::runCallbackToPublish<GroundTruthPipeline>(state, makeConfig());
+}
+PLUGIN_PIPELINE_BENCHMARK(BM_GroundTruthCallbackToPublish);
+
+PLUGIN_PIPELINE_BENCHMARK_MAIN()
@@ -43,12 +43,17 @@
 
 #include <tf2/LinearMath/Quaternion.h>
 #include <tf2/LinearMath/Vector3.h>
+#include <algorithm>
+#include <chrono>
+#include <memory>
 #include <string>
-#include <vector>
+#include <diagnostic_msgs/msg/diagnostic_status.hpp>
 #include <mocap4r2_msgs/msg/rigid_bodies.hpp>
 #include <rclcpp/duration.hpp>
 
+#include "as2_state_estimator/measurement_buffer.hpp"
 #include "as2_state_estimator/plugin_base.hpp"
+#include "savitzky_golay_differentiator.hpp"
 
 namespace mocap_pose
 {
@@ -64,9 +69,34 @@ class Plugin : public as2_state_estimator_plugin_base::StateEstimatorBase
   bool has_earth_to_map_ = false;
   std::string mocap_topic_;
   std::string rigid_body_name_;
-  double twist_alpha_ = 1.0;
   double orientation_alpha_ = 1.0;
-  geometry_msgs::msg::PoseStamped last_pose_msg_;
+
+  // Position (earth frame) and accumulated body rotation, differentiated together
+  using Differentiator = SavitzkyGolayDifferentiator<6>;
+
+  struct MocapState
+  {
+    bool initialized = false;
+    double stamp = 0.0;
+    builtin_interfaces::msg::Time stamp_msg;  // Original stamp, published without conversion
+    tf2::Vector3 position = tf2::Vector3(0, 0, 0);
+    tf2::Quaternion orientation = tf2::Quaternion::getIdentity();
+    tf2::Quaternion smoothed_orientation = tf2::Quaternion::getIdentity();
+    tf2::Vector3 attitude = tf2::Vector3(0, 0, 0);  // Sum of body frame rotation increments
+    tf2::Vector3 velocity = tf2::Vector3(0, 0, 0);  // Earth frame
+    tf2::Vector3 angular_velocity = tf2::Vector3(0, 0, 0);  // Base frame
+    Differentiator differentiator;
+  };
+  using MocapBuffer =
+    as2_state_estimator::MeasurementBuffer<geometry_msgs::msg::PoseStamped, MocapState>;
+  std::unique_ptr<MocapBuffer> measurement_buffer_;
+  uint8_t mocap_source_ = 0;
+
+  // Latency statistics of the measurement buffer, published once a second
+  rclcpp::Publisher<diagnostic_msgs::msg::DiagnosticStatus>::SharedPtr diagnostics_pub_;
+  rclcpp::TimerBase::SharedPtr diagnostics_timer_;
+  uint64_t published_dropped_ = 0;
+  uint64_t published_overflows_ = 0;
 
 public:
   Plugin()
@@ -85,13 +115,18 @@ public:
       throw std::runtime_error("Parameter 'rigid_body_name' not set");
     }
 
+    int twist_window_size = 9;
+    int twist_polynomial_order = 2;
+    node_ptr_->get_parameter("twist_window_size", twist_window_size);
+    node_ptr_->get_parameter("twist_polynomial_order", twist_polynomial_order);
+    MocapState initial_state;
     try {
-      twist_alpha_ = node_ptr_->get_parameter("twist_smooth_filter_cte").as_double();
-    } catch (const rclcpp::ParameterTypeException & e) {
-      RCLCPP_INFO(
-        node_ptr_->get_logger(),
-        "Parameter 'twist_smooth_filter_cte' not set. Filter disabled. Using default value: %f",
-        twist_alpha_);
+      initial_state.differentiator = Differentiator(
+        static_cast<size_t>(std::max(twist_window_size, 0)), twist_polynomial_order);
+    } catch (const std::invalid_argument & e) {
+      RCLCPP_ERROR(
+        node_ptr_->get_logger(), "Invalid twist differentiator configuration: %s", e.what());
+      throw;
     }
 
     try {
@@ -104,6 +139,22 @@ public:
         orientation_alpha_);
     }
 
+    // Mocap stamps are kept, measurements are applied in stamp order and late ones replayed
+    int buffer_size = 64;
+    int replay_size = 20;
+    double reorder_delay = 0.0;
+    node_ptr_->get_parameter("measurement_buffer.size", buffer_size);
+    node_ptr_->get_parameter("measurement_buffer.replay_size", replay_size);
+    node_ptr_->get_parameter("measurement_buffer.reorder_delay", reorder_delay);
+    measurement_buffer_ = std::make_unique<MocapBuffer>(
+      static_cast<size_t>(std::max(buffer_size, 1)), static_cast<size_t>(std::max(replay_size, 0)),
+      reorder_delay, initial_state);
+    mocap_source_ = measurement_buffer_->addSource("mocap");
+    diagnostics_pub_ = node_ptr_->create_publisher<diagnostic_msgs::msg::DiagnosticStatus>(
+      "mocap_pose/measurement_diagnostics", 10);
+    diagnostics_timer_ = node_ptr_->create_timer(
+      std::chrono::seconds(1), std::bind(&Plugin::publish_diagnostics, this));
+
     rigid_bodies_sub_ = node_ptr_->create_subscription<mocap4r2_msgs::msg::RigidBodies>(
       mocap_topic_, rclcpp::QoS(10),
       std::bind(&Plugin::rigid_bodies_callback, this, std::placeholders::_1));
@@ -119,136 +170,178 @@ public:
     has_earth_to_map_ = false;
   }
 
-  const geometry_msgs::msg::TwistStamped & twist_from_pose(
-    const geometry_msgs::msg::PoseStamped & pose,
-    std::vector<tf2::Transform> * data = nullptr)
-  {
-    const auto last_time = twist_msg_.header.stamp;
-    auto dt = (rclcpp::Time(pose.header.stamp) - last_time).seconds();
-    // RCLCPP_INFO(node_ptr_->get_logger(), "dt: %f", dt);
-    if (dt <= 0) {
-      RCLCPP_WARN(node_ptr_->get_logger(), "dt <= 0");
-      return twist_msg_;
-    }
-
-    static tf2::Vector3 last_pose =
-      tf2::Vector3(pose.pose.position.x, pose.pose.position.y, pose.pose.position.z);
-
-    tf2::Vector3 current_pose =
-      tf2::Vector3(pose.pose.position.x, pose.pose.position.y, pose.pose.position.z);
-
-    tf2::Vector3 vel = (current_pose - last_pose) / dt;
-
-    last_pose = current_pose;
-
-    vel = twist_alpha_ * vel + (1 - twist_alpha_) * tf2::Vector3(
-      twist_msg_.twist.linear.x,
-      twist_msg_.twist.linear.y,
-      twist_msg_.twist.linear.z);
-
-    twist_msg_.header.stamp = pose.header.stamp;
-    twist_msg_.twist.linear.x = vel.x();
-    twist_msg_.twist.linear.y = vel.y();
-    twist_msg_.twist.linear.z = vel.z();
-    // TODO(javilinos): add angular velocity -> this_could_be_obtained_from_imu
-    twist_msg_.twist.angular.x = 0;
-    twist_msg_.twist.angular.y = 0;
-    twist_msg_.twist.angular.z = 0;
-    if (data != nullptr) {
-      std::vector<tf2::Transform> * transforms = (std::vector<tf2::Transform> *)data;
-      tf2::Transform earth_to_map = transforms->at(0);
-      tf2::Transform map_to_odom = transforms->at(1);
-      tf2::Transform odom_to_base = transforms->at(2);
-
-      vel = tf2::quatRotate(
-        (odom_to_base.inverse() * map_to_odom.inverse() * earth_to_map.inverse()).getRotation(),
-        vel);
-
-      // FIXME: CLEAN STATIC
-      static geometry_msgs::msg::TwistStamped twist_msg;
-      twist_msg.header.stamp = pose.header.stamp;
-      twist_msg.header.frame_id = get_base_frame();
-      twist_msg.twist.linear.x = vel.x();
-      twist_msg.twist.linear.y = vel.y();
-      twist_msg.twist.linear.z = vel.z();
-      return twist_msg;
-    } else {
-      return twist_msg_;
-    }
-  }
-
-  geometry_msgs::msg::TwistStamped twist_msg_;
-
 private:
   void rigid_bodies_callback(const mocap4r2_msgs::msg::RigidBodies::SharedPtr msg)
   {
-    auto pose_msg = geometry_msgs::msg::PoseStamped();
-    pose_msg.header = msg->header;
     for (const auto & rigid_body : msg->rigidbodies) {
       if (rigid_body.rigid_body_name == rigid_body_name_) {
-        pose_msg.pose = rigid_body.pose;
-        break;
+        if (!has_earth_to_map_) {
+          publish_earth_to_map(rigid_body.pose, msg->header.stamp);
+        }
+        geometry_msgs::msg::PoseStamped pose;
+        pose.header = msg->header;
+        pose.pose = rigid_body.pose;
+        const double now = node_ptr_->now().seconds();
+        if (!measurement_buffer_->push(
+            mocap_source_, rclcpp::Time(msg->header.stamp).seconds(), now, pose))
+        {
+          RCLCPP_WARN_THROTTLE(
+            node_ptr_->get_logger(), *node_ptr_->get_clock(), 1000,
+            "Mocap measurement buffer full, dropping measurement");
+        }
+        process_measurements(now);
+        return;
       }
     }
-    process_mocap_pose(pose_msg);
   }
 
-  void process_mocap_pose(const geometry_msgs::msg::PoseStamped & msg)
+  void publish_earth_to_map(
+    const geometry_msgs::msg::Pose & pose,
+    const builtin_interfaces::msg::Time & stamp)
   {
     // mocap_pose could have a different frame_id, we will publish the transform from earth to
     // base_link without checking origin frame_id
+    earth_to_map_ = tf2::Transform(
+      tf2::Quaternion(
+        pose.orientation.x, pose.orientation.y, pose.orientation.z, pose.orientation.w),
+      tf2::Vector3(pose.position.x, pose.position.y, pose.position.z));
+
+    geometry_msgs::msg::TransformStamped earth_to_map;
+    earth_to_map.transform = tf2::toMsg(earth_to_map_);
+    earth_to_map.header.stamp = stamp;
+    earth_to_map.header.frame_id = get_earth_frame();
+    earth_to_map.child_frame_id = get_map_frame();
+    publish_static_transform(earth_to_map);
+    has_earth_to_map_ = true;
+  }
 
-    if (!has_earth_to_map_) {
-      earth_to_map_ = tf2::Transform(
-        tf2::Quaternion(
-          msg.pose.orientation.x, msg.pose.orientation.y, msg.pose.orientation.z,
-          msg.pose.orientation.w),
-        tf2::Vector3(msg.pose.position.x, msg.pose.position.y, msg.pose.position.z));
-
-      geometry_msgs::msg::TransformStamped earth_to_map;
-      earth_to_map.transform = tf2::toMsg(earth_to_map_);
-      earth_to_map.header.stamp = msg.header.stamp;
-      earth_to_map.header.frame_id = get_earth_frame();
-      earth_to_map.child_frame_id = get_map_frame();
-      publish_static_transform(earth_to_map);
-      has_earth_to_map_ = true;
+  void apply_mocap_pose(const MocapBuffer::Measurement & measurement, MocapState & state) const
+  {
+    const geometry_msgs::msg::Pose & pose = measurement.data.pose;
+    const tf2::Vector3 position(pose.position.x, pose.position.y, pose.position.z);
+    const tf2::Quaternion orientation(
+      pose.orientation.x, pose.orientation.y, pose.orientation.z, pose.orientation.w);
+
+    if (!state.initialized) {
+      state.initialized = true;
+      state.smoothed_orientation = orientation;
+      state.attitude = tf2::Vector3(0, 0, 0);
+    } else if (measurement.stamp > state.stamp) {
+      // Body frame rotation since the previous sample, as a rotation vector
+      tf2::Quaternion increment = state.orientation.inverse() * orientation;
+      if (increment.w() < 0) {
+        increment = -increment;
+      }
+      const double angle = increment.getAngle();
+      if (angle > 1e-9) {
+        state.attitude += increment.getAxis() * angle;
+      }
+      state.smoothed_orientation =
+        state.smoothed_orientation.slerp(orientation, orientation_alpha_).normalized();
+    } else {
+      return;
     }
+    state.stamp = measurement.stamp;
+    state.stamp_msg = measurement.data.header.stamp;
+    state.position = position;
+    state.orientation = orientation;
+
+    state.differentiator.add(
+      measurement.stamp,
+      {position.x(), position.y(), position.z(),
+        state.attitude.x(), state.attitude.y(), state.attitude.z()});
+    Differentiator::Values derivative;
+    if (state.differentiator.derivative(derivative)) {
+      state.velocity = tf2::Vector3(derivative[0], derivative[1], derivative[2]);
+      state.angular_velocity = tf2::Vector3(derivative[3], derivative[4], derivative[5]);
+    }
+  }
+
+  void process_measurements(const double now)
+  {
+    const size_t applied = measurement_buffer_->process(
+      now, [this](const MocapBuffer::Measurement & measurement, MocapState & state) {
+        apply_mocap_pose(measurement, state);
+      });
+    if (applied == 0) {
+      return;
+    }
+
+    const MocapState & state = measurement_buffer_->getState();
+    const builtin_interfaces::msg::Time & stamp = state.stamp_msg;
+
     odom_to_base_ =
       map_to_odom_.inverse() * earth_to_map_.inverse() *
-      tf2::Transform(
-      tf2::Quaternion(
-        msg.pose.orientation.x, msg.pose.orientation.y,
-        msg.pose.orientation.z, msg.pose.orientation.w),
-      tf2::Vector3(msg.pose.position.x, msg.pose.position.y, msg.pose.position.z));
+      tf2::Transform(state.orientation, state.position);
 
     geometry_msgs::msg::TransformStamped odom_to_base_msg;
     odom_to_base_msg.transform = tf2::toMsg(odom_to_base_);
-    odom_to_base_msg.header.stamp = msg.header.stamp;
+    odom_to_base_msg.header.stamp = stamp;
     odom_to_base_msg.header.frame_id = get_odom_frame();
     odom_to_base_msg.child_frame_id = get_base_frame();
     publish_transform(odom_to_base_msg);
 
     // Publish pose
     geometry_msgs::msg::PoseStamped pose_msg;
-    // To avoid time divergence between mocap node and state estimator node
-    // pose_msg.header.stamp = msg.header.stamp;
-    pose_msg.header.stamp = node_ptr_->now();
+    pose_msg.header.stamp = stamp;
     pose_msg.header.frame_id = get_earth_frame();
-    pose_msg.pose = msg.pose;
-    pose_msg.pose.orientation.x = orientation_alpha_ * msg.pose.orientation.x +
-      (1 - orientation_alpha_) * last_pose_msg_.pose.orientation.x;
-    pose_msg.pose.orientation.y = orientation_alpha_ * msg.pose.orientation.y +
-      (1 - orientation_alpha_) * last_pose_msg_.pose.orientation.y;
-    pose_msg.pose.orientation.z = orientation_alpha_ * msg.pose.orientation.z +
-      (1 - orientation_alpha_) * last_pose_msg_.pose.orientation.z;
-    pose_msg.pose.orientation.w = orientation_alpha_ * msg.pose.orientation.w +
-      (1 - orientation_alpha_) * last_pose_msg_.pose.orientation.w;
+    pose_msg.pose.position.x = state.position.x();
+    pose_msg.pose.position.y = state.position.y();
+    pose_msg.pose.position.z = state.position.z();
+    pose_msg.pose.orientation = tf2::toMsg(state.smoothed_orientation);
     publish_pose(pose_msg);
-    last_pose_msg_ = pose_msg;
 
-    // Compute twist from mocap_pose
-    auto data = std::vector<tf2::Transform>{earth_to_map_, map_to_odom_, odom_to_base_};
-    publish_twist(twist_from_pose(pose_msg, &data));
+    // Twist from mocap_pose, in base frame
+    const tf2::Vector3 velocity = tf2::quatRotate(state.orientation.inverse(), state.velocity);
+    geometry_msgs::msg::TwistStamped twist_msg;
+    twist_msg.header.stamp = stamp;
+    twist_msg.header.frame_id = get_base_frame();
+    twist_msg.twist.linear.x = velocity.x();
+    twist_msg.twist.linear.y = velocity.y();
+    twist_msg.twist.linear.z = velocity.z();
+    twist_msg.twist.angular.x = state.angular_velocity.x();
+    twist_msg.twist.angular.y = state.angular_velocity.y();
+    twist_msg.twist.angular.z = state.angular_velocity.z();
+    publish_twist(twist_msg);
+  }
+
+  void publish_diagnostics()
+  {
+    const as2_state_estimator::SourceLatencyStats & stats =
+      measurement_buffer_->getLatencyStats(mocap_source_);
+    const uint64_t overflows = measurement_buffer_->getOverflowCount();
+    const uint64_t new_dropped = stats.dropped - published_dropped_;
+    const uint64_t new_overflows = overflows - published_overflows_;
+    published_dropped_ = stats.dropped;
+    published_overflows_ = overflows;
+
+    diagnostic_msgs::msg::DiagnosticStatus msg;
+    msg.name = std::string(node_ptr_->get_name()) + " mocap measurements";
+    msg.hardware_id = rigid_body_name_;
+    if (new_dropped > 0 || new_overflows > 0) {
+      msg.level = diagnostic_msgs::msg::DiagnosticStatus::WARN;
+      msg.message = std::to_string(new_dropped) + " late and " + std::to_string(new_overflows) +
+        " overflowed measurements dropped in the last second";
+    } else {
+      msg.level = diagnostic_msgs::msg::DiagnosticStatus::OK;
+      msg.message = "OK";
+    }
+
+    auto add_value = [&msg](const std::string & key, const std::string & value) {
+        diagnostic_msgs::msg::KeyValue key_value;
+        key_value.key = key;
+        key_value.value = value;
+        msg.values.push_back(key_value);
+      };
+    add_value("count", std::to_string(stats.count));
+    add_value("late", std::to_string(stats.late));
+    add_value("dropped", std::to_string(stats.dropped));
+    add_value("ahead", std::to_string(stats.ahead));
+    add_value("overflows", std::to_string(overflows));
+    add_value("last_latency", std::to_string(stats.last_latency));
+    add_value("mean_latency", std::to_string(stats.mean_latency));
+    add_value("max_latency", std::to_string(stats.max_latency));
+    diagnostics_pub_->publish(msg);
   }
 };
 
@@ -0,0 +1,171 @@
+// Copyright 2024 Universidad Politécnica de Madrid
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the Universidad Politécnica de Madrid nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+* @file savitzky_golay_differentiator.hpp
+*
+* Savitzky-Golay differentiator over a fixed-size window of stamped samples
+*
+* @authors Rafael Pérez Seguí
+*          Miguel Fernández Cortizas
+*/
+
+#ifndef SAVITZKY_GOLAY_DIFFERENTIATOR_HPP_
+#define SAVITZKY_GOLAY_DIFFERENTIATOR_HPP_
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+
+namespace mocap_pose
+{
+
+/**
+ * @brief Estimates the derivative of several channels at the newest sample by fitting a
+ * polynomial to the last samples in the least squares sense. Samples are not assumed to be
+ * uniformly spaced, the fit uses their stamps. Storage is fixed, nothing is allocated.
+ *
+ * @tparam Channels number of signals differentiated together
+ * @tparam MaxWindow maximum number of samples in the fit
+ */
+template<std::size_t Channels, std::size_t MaxWindow = 32>
+class SavitzkyGolayDifferentiator
+{
+public:
+  using Values = std::array<double, Channels>;
+
+  /**
+   * @brief Constructor
+   * @param window number of samples in the fit, in [order + 2, MaxWindow]
+   * @param order polynomial order, 1 or 2
+   */
+  explicit SavitzkyGolayDifferentiator(const std::size_t window = 9, const int order = 2)
+  : window_(window), order_(order)
+  {
+    if (order_ != 1 && order_ != 2) {
+      throw std::invalid_argument("Savitzky-Golay polynomial order must be 1 or 2");
+    }
+    if (window_ < static_cast<std::size_t>(order_) + 2 || window_ > MaxWindow) {
+      throw std::invalid_argument("Savitzky-Golay window out of range");
+    }
+  }
+
+  void reset()
+  {
+    head_ = 0;
+    size_ = 0;
+  }
+
+  /**
+   * @brief Add a sample
+   * @param stamp time of the sample (s)
+   * @param values sample of each channel
+   * @return false if the stamp is not newer than the last sample, which is ignored
+   */
+  bool add(const double stamp, const Values & values)
+  {
+    if (size_ > 0 && stamp <= stamps_[head_]) {
+      return false;
+    }
+    head_ = (head_ + 1) % window_;
+    stamps_[head_] = stamp;
+    values_[head_] = values;
+    size_ = std::min(size_ + 1, window_);
+    return true;
+  }
+
+  /**
+   * @brief Derivative of each channel at the newest sample
+   * @param derivative output
+   * @return false if there are not enough samples for the fit
+   */
+  bool derivative(Values & derivative) const
+  {
+    if (size_ < static_cast<std::size_t>(order_) + 1) {
+      return false;
+    }
+
+    // Time relative to the newest sample, scaled to [-1, 0] for conditioning
+    const double newest = stamps_[head_];
+    const double scale = newest - stamps_[index(size_ - 1)];
+    std::array<double, 5> s{};   // sum u^k
+    std::array<Values, 3> t{};   // sum u^k y
+    for (std::size_t i = 0; i < size_; i++) {
+      const std::size_t idx = index(i);
+      const double u = (stamps_[idx] - newest) / scale;
+      double power = 1.0;
+      for (int k = 0; k <= 2 * order_; k++) {
+        if (k <= order_) {
+          for (std::size_t c = 0; c < Channels; c++) {
+            t[k][c] += power * values_[idx][c];
+          }
+        }
+        s[k] += power;
+        power *= u;
+      }
+    }
+
+    // Row of the inverse normal matrix giving the first order coefficient
+    std::array<double, 3> row{};
+    if (order_ == 1) {
+      const double det = s[0] * s[2] - s[1] * s[1];
+      row = {-s[1] / det, s[0] / det, 0.0};
+    } else {
+      const double a = s[0], b = s[1], c = s[2], d = s[2], e = s[3], f = s[4];
+      const double det = a * (d * f - e * e) - b * (b * f - c * e) + c * (b * e - c * d);
+      row = {-(b * f - c * e) / det, (a * f - c * c) / det, -(a * e - b * c) / det};
+    }
+    if (!std::isfinite(row[0]) || !std::isfinite(row[1]) || !std::isfinite(row[2])) {
+      return false;
+    }
+
+    for (std::size_t c = 0; c < Channels; c++) {
+      derivative[c] = (row[0] * t[0][c] + row[1] * t[1][c] + row[2] * t[2][c]) / scale;
+    }
+    return true;
+  }
+
+  std::size_t size() const {return size_;}
+
+private:
+  // Index of the i-th newest sample
+  std::size_t index(const std::size_t i) const {return (head_ + window_ - i) % window_;}
+
+  std::size_t window_;
+  int order_;
+  std::size_t head_ = 0;
+  std::size_t size_ = 0;
+  std::array<double, MaxWindow> stamps_{};
+  std::array<Values, MaxWindow> values_{};
+};
+
+}  // namespace mocap_pose
+
+#endif  // SAVITZKY_GOLAY_DIFFERENTIATOR_HPP_
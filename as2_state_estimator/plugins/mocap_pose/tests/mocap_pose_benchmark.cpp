@@ -0,0 +1,112 @@
+// Copyright 2024 Universidad Politécnica de Madrid
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the Universidad Politécnica de Madrid nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+* @file mocap_pose_benchmark.cpp
+*
+* Mocap pose plugin benchmarks: twist differentiation and rigid body input to estimator twist
+* output, in process
+*
+* @authors Rafael Pérez Seguí
+*/
+
+#include <cmath>
+
+#include <geometry_msgs/msg/twist_stamped.hpp>
+#include <mocap4r2_msgs/msg/rigid_bodies.hpp>
+#include <as2_core/names/topics.hpp>
+
+#include "mocap_pose.hpp"
+#include "plugin_pipeline_benchmark.hpp"
+#include "savitzky_golay_differentiator.hpp"
+
+namespace
+{
+
+constexpr char kMocapTopic[] = "/benchmark_mocap/rigid_bodies";
+constexpr char kRigidBodyName[] = "1";
+
+using MocapPosePipeline = as2_state_estimator::PluginPipeline<
+  mocap_pose::Plugin, mocap4r2_msgs::msg::RigidBodies, geometry_msgs::msg::TwistStamped>;
+
+as2_state_estimator::PluginPipelineConfig<mocap4r2_msgs::msg::RigidBodies> makeConfig()
+{
+  as2_state_estimator::PluginPipelineConfig<mocap4r2_msgs::msg::RigidBodies> config;
+  config.parameters = {
+    {"mocap_topic", kMocapTopic}, {"rigid_body_name", kRigidBodyName},
+    {"twist_window_size", 9}, {"twist_polynomial_order", 2},
+    {"orientation_smooth_filter_cte", 1.0}};
+  config.source_name = "mocap_source";
+  config.input_topic = kMocapTopic;
+  config.output_topic = as2_names::topics::self_localization::twist;
+  config.output_qos = as2_names::topics::self_localization::qos;
+  config.init_input = [](as2::Node &, mocap4r2_msgs::msg::RigidBodies & msg) {
+      msg.header.frame_id = "earth";
+      msg.rigidbodies.resize(1);
+      msg.rigidbodies[0].rigid_body_name = kRigidBodyName;
+      msg.rigidbodies[0].pose.orientation.w = 1.0;
+    };
+  config.next_input = [](as2::Node & node, mocap4r2_msgs::msg::RigidBodies & msg) {
+      msg.header.stamp = node.now();
+      msg.rigidbodies[0].pose.position.x += 0.01;
+    };
+  return config;
+}
+
+}  // namespace
+
+static void BM_SavitzkyGolayDerivative(benchmark::State & state)
+{
+  mocap_pose::SavitzkyGolayDifferentiator<6> differentiator(
+    static_cast<std::size_t>(state.range(0)), static_cast<int>(state.range(1)));
+  mocap_pose::SavitzkyGolayDifferentiator<6>::Values values;
+  mocap_pose::SavitzkyGolayDifferentiator<6>::Values derivative;
+  double stamp = 0.0;
+  for (auto _ : state) {
+    // Mocap rate with jitter, so the fit runs with non-uniform stamps
+    stamp += 0.01 + 0.001 * std::sin(stamp * 100.0);
+    for (std::size_t i = 0; i < values.size(); ++i) {
+      values[i] = std::sin(stamp + static_cast<double>(i));
+    }
+    differentiator.add(stamp, values);
+    benchmark::DoNotOptimize(differentiator.derivative(derivative));
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_SavitzkyGolayDerivative)
+->ArgNames({"window", "order"})
+->Args({5, 1})->Args({9, 2})->Args({15, 2})->Args({31, 2});
+
+static void BM_MocapPoseCallbackToPublish(benchmark::State & state)
+{
+  as2_state_estimator::runCallbackToPublish<MocapPosePipeline>(state, makeConfig());
+}
+PLUGIN_PIPELINE_BENCHMARK(BM_MocapPoseCallbackToPublish);
+
+PLUGIN_PIPELINE_BENCHMARK_MAIN()
@@ -0,0 +1,106 @@
+// Copyright 2024 Universidad Politécnica de Madrid
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the Universidad Politécnica de Madrid nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+* @file savitzky_golay_differentiator_gtest.cpp
+*
+* Savitzky-Golay differentiator gtest
+*
+* @authors Rafael Pérez Seguí
+*/
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+
+#include "savitzky_golay_differentiator.hpp"
+
+using Differentiator = mocap_pose::SavitzkyGolayDifferentiator<2>;
+
+TEST(SavitzkyGolayDifferentiator, InvalidConfiguration) {
+  EXPECT_THROW(Differentiator(9, 3), std::invalid_argument);
+  EXPECT_THROW(Differentiator(3, 2), std::invalid_argument);
+  EXPECT_THROW(Differentiator(33, 2), std::invalid_argument);
+}
+
+TEST(SavitzkyGolayDifferentiator, NotEnoughSamples) {
+  Differentiator differentiator(9, 2);
+  Differentiator::Values derivative;
+  EXPECT_FALSE(differentiator.derivative(derivative));
+  differentiator.add(0.0, {0.0, 0.0});
+  differentiator.add(0.1, {1.0, 1.0});
+  EXPECT_FALSE(differentiator.derivative(derivative));
+  differentiator.add(0.2, {2.0, 2.0});
+  EXPECT_TRUE(differentiator.derivative(derivative));
+}
+
+TEST(SavitzkyGolayDifferentiator, RejectsOldStamps) {
+  Differentiator differentiator(5, 1);
+  EXPECT_TRUE(differentiator.add(1.0, {0.0, 0.0}));
+  EXPECT_FALSE(differentiator.add(1.0, {1.0, 1.0}));
+  EXPECT_FALSE(differentiator.add(0.5, {1.0, 1.0}));
+  EXPECT_EQ(differentiator.size(), 1u);
+}
+
+TEST(SavitzkyGolayDifferentiator, ExactForQuadraticWithJitteredStamps) {
+  // Quadratic signals are fitted exactly by the second order fit, also with uneven spacing
+  Differentiator differentiator(9, 2);
+  std::mt19937 generator(42);
+  std::uniform_real_distribution<double> jitter(-0.001, 0.001);
+  double stamp = 0.0;
+  for (int i = 0; i < 30; i++) {
+    stamp += 1.0 / 240.0 + jitter(generator);
+    differentiator.add(stamp, {3.0 * stamp + 1.0, stamp * stamp});
+  }
+  Differentiator::Values derivative;
+  ASSERT_TRUE(differentiator.derivative(derivative));
+  EXPECT_NEAR(derivative[0], 3.0, 1e-9);
+  EXPECT_NEAR(derivative[1], 2.0 * stamp, 1e-9);
+}
+
+TEST(SavitzkyGolayDifferentiator, ReducesNoiseAgainstFiniteDifference) {
+  Differentiator differentiator(15, 1);
+  std::mt19937 generator(7);
+  std::normal_distribution<double> noise(0.0, 0.001);
+  const double dt = 1.0 / 240.0;
+  double last_value = 0.0;
+  double error = 0.0;
+  double finite_difference_error = 0.0;
+  for (int i = 0; i < 500; i++) {
+    const double value = 0.5 * i * dt + noise(generator);
+    differentiator.add(i * dt, {value, 0.0});
+    Differentiator::Values derivative;
+    if (i >= 15 && differentiator.derivative(derivative)) {
+      error += std::pow(derivative[0] - 0.5, 2);
+      finite_difference_error += std::pow((value - last_value) / dt - 0.5, 2);
+    }
+    last_value = value;
+  }
+  EXPECT_LT(error, 0.05 * finite_difference_error);
+}
@@ -41,18 +41,16 @@
 #ifndef RAW_ODOMETRY_HPP_
 #define RAW_ODOMETRY_HPP_
 
+#include <atomic>
+#include <functional>
 #include <string>
-#include <utility>
 #include <memory>
 #include <rclcpp/rclcpp.hpp>
 #include <geographic_msgs/msg/geo_point.hpp>
 #include <geometry_msgs/msg/transform_stamped.hpp>
+#include <sensor_msgs/msg/nav_sat_fix.hpp>
 
-#include <as2_core/names/services.hpp>
-#include <as2_core/utils/gps_utils.hpp>
-#include <as2_msgs/srv/get_origin.hpp>
-#include <as2_msgs/srv/set_origin.hpp>
-
+#include "as2_state_estimator/gps_origin_handler.hpp"
 #include "as2_state_estimator/plugin_base.hpp"
 
 namespace raw_odometry
@@ -61,21 +59,16 @@ namespace raw_odometry
 class Plugin : public as2_state_estimator_plugin_base::StateEstimatorBase
 {
   rclcpp::Subscription<nav_msgs::msg::Odometry>::SharedPtr odom_sub_;
-  rclcpp::Subscription<sensor_msgs::msg::NavSatFix>::SharedPtr gps_sub_;
-
-  rclcpp::Service<as2_msgs::srv::SetOrigin>::SharedPtr set_origin_srv_;
-  rclcpp::Service<as2_msgs::srv::GetOrigin>::SharedPtr get_origin_srv_;
 
   bool use_gps_ = false;
-  bool set_origin_on_start_ = false;
   double earth_to_map_height_ = 0.0;
-  double origin_lat_ = 0.0;
-  double origin_lon_ = 0.0;
-  double origin_alt_ = 0.0;
 
-  geometry_msgs::msg::TransformStamped earth_to_map_;
-  geographic_msgs::msg::GeoPoint::UniquePtr origin_;
-  sensor_msgs::msg::NavSatFix::UniquePtr gps_pose_;
+  // Replaced as a whole by the GPS origin worker, read by the odometry callback
+  std::shared_ptr<const tf2::Transform> earth_to_map_ =
+    std::make_shared<const tf2::Transform>(tf2::Transform::getIdentity());
+
+  // Declared last, so its worker thread is stopped before the other members are destroyed
+  std::unique_ptr<as2_state_estimator::GpsOriginHandler> gps_origin_handler_;
 
 public:
   Plugin()
@@ -91,13 +84,9 @@ public:
 
     node_ptr_->get_parameter("use_gps", use_gps_);
 
-    node_ptr_->get_parameter("set_origin_on_start", set_origin_on_start_);
-
     // publish static transform from earth to map and map to odom
     geometry_msgs::msg::TransformStamped map_to_odom =
       as2::tf::getTransformation(get_map_frame(), get_odom_frame(), 0, 0, 0, 0, 0, 0);
-    earth_to_map_ =
-      as2::tf::getTransformation(get_earth_frame(), get_map_frame(), 0, 0, 0, 0, 0, 0);
     publish_static_transform(map_to_odom);
 
     // If not use gps, read earth_to_map from parameters
@@ -121,70 +110,42 @@ public:
         node_ptr_->get_logger(), "Earth to map set to %f, %f, %f", earth_to_map_x, earth_to_map_y,
         earth_to_map_z);
 
-      earth_to_map_ =
-        as2::tf::getTransformation(
-        get_earth_frame(), get_map_frame(),
-        earth_to_map_x, earth_to_map_y, earth_to_map_z, 0, 0, 0);
-      publish_static_transform(earth_to_map_);
+      set_earth_to_map(earth_to_map_x, earth_to_map_y, earth_to_map_z);
     } else {
-      set_origin_srv_ = node_ptr_->create_service<as2_msgs::srv::SetOrigin>(
-        as2_names::services::gps::set_origin,
-        std::bind(
-          &Plugin::setOriginCallback, this, std::placeholders::_1,
-          std::placeholders::_2));
-      get_origin_srv_ = node_ptr_->create_service<as2_msgs::srv::GetOrigin>(
-        as2_names::services::gps::get_origin,
-        std::bind(
-          &Plugin::getOriginCallback, this, std::placeholders::_1,
-          std::placeholders::_2));
-      gps_sub_ = node_ptr_->create_subscription<sensor_msgs::msg::NavSatFix>(
-        as2_names::topics::sensor_measurements::gps, as2_names::topics::sensor_measurements::qos,
-        std::bind(&Plugin::gps_callback, this, std::placeholders::_1));
-
       if (node_ptr_->has_parameter("earth_to_map_height")) {
         node_ptr_->get_parameter("earth_to_map_height", earth_to_map_height_);
         RCLCPP_INFO(node_ptr_->get_logger(), "Earth to map height set to %f", earth_to_map_height_);
       }
-
-      if (set_origin_on_start_ && node_ptr_->has_parameter("set_origin.lat") &&
-        node_ptr_->has_parameter("set_origin.lon") &&
-        node_ptr_->has_parameter("set_origin.alt"))
-      {
-        node_ptr_->get_parameter("set_origin.lat", origin_lat_);
-        node_ptr_->get_parameter("set_origin.lon", origin_lon_);
-        node_ptr_->get_parameter("set_origin.alt", origin_alt_);
-
-        origin_ = std::make_unique<geographic_msgs::msg::GeoPoint>();
-        origin_->latitude = origin_lat_;
-        origin_->longitude = origin_lon_;
-        origin_->altitude = origin_alt_;
-
-        RCLCPP_INFO(
-          node_ptr_->get_logger(), "Origin set to %f, %f, %f", origin_lat_, origin_lon_,
-          origin_alt_);
-      } else {
-        RCLCPP_INFO(node_ptr_->get_logger(), "Waiting for origin to be set");
-      }
+      // GPS fixes and origin requests are handled on their own thread
+      gps_origin_handler_ = std::make_unique<as2_state_estimator::GpsOriginHandler>(
+        node_ptr_,
+        std::bind(
+          &Plugin::generate_map_frame_from_gps, this, std::placeholders::_1,
+          std::placeholders::_2, std::placeholders::_3));
     }
   }
 
 private:
+  // Called from the GPS origin worker thread
   void generate_map_frame_from_gps(
     const geographic_msgs::msg::GeoPoint & origin,
-    const sensor_msgs::msg::NavSatFix & gps_pose)
+    const sensor_msgs::msg::NavSatFix & gps_pose,
+    const tf2::Vector3 & map_position)
   {
-    as2::gps::GpsHandler gps_handler;
-    gps_handler.setOrigin(origin.latitude, origin.longitude, origin.altitude);
-    double x, y, z;
-    gps_handler.LatLon2Local(gps_pose.latitude, gps_pose.longitude, gps_pose.altitude, x, y, z);
     if (!node_ptr_->has_parameter("earth_to_map_height")) {
       earth_to_map_height_ = gps_pose.altitude - origin.altitude;
     }
-    earth_to_map_ = as2::tf::getTransformation(
-      get_earth_frame(), get_map_frame(), x, y,
-      earth_to_map_height_, 0, 0, 0);
+    set_earth_to_map(map_position.x(), map_position.y(), earth_to_map_height_);
+  }
 
-    publish_static_transform(earth_to_map_);
+  void set_earth_to_map(const double x, const double y, const double z)
+  {
+    const geometry_msgs::msg::TransformStamped earth_to_map_msg =
+      as2::tf::getTransformation(get_earth_frame(), get_map_frame(), x, y, z, 0, 0, 0);
+    auto earth_to_map = std::make_shared<tf2::Transform>();
+    tf2::fromMsg(earth_to_map_msg.transform, *earth_to_map);
+    std::atomic_store(&earth_to_map_, std::shared_ptr<const tf2::Transform>(earth_to_map));
+    publish_static_transform(earth_to_map_msg);
   }
 
   void odom_callback(const nav_msgs::msg::Odometry::UniquePtr msg)
@@ -221,11 +182,10 @@ private:
     publish_transform(transform);  // publish transform from odom to base_link
 
     tf2::fromMsg(transform.transform, odom_to_baselink);
-    tf2::fromMsg(earth_to_map_.transform, earth_to_map);
 
     convert_odom_to_baselink_2_earth_to_baselink_transform(
       odom_to_baselink, earth_to_baselink,
-      earth_to_map);
+      *std::atomic_load(&earth_to_map_));
 
     auto pose = geometry_msgs::msg::PoseStamped();
     pose.header.frame_id = get_earth_frame();
@@ -234,6 +194,7 @@ private:
     pose.pose.position.y = earth_to_baselink.getOrigin().y();
     pose.pose.position.z = earth_to_baselink.getOrigin().z();
     pose.pose.orientation = tf2::toMsg(earth_to_baselink.getRotation());
+    set_odometry_covariance(msg->pose.covariance, msg->twist.covariance);
     publish_pose(pose);
     // publish twist in "base_link" frame
     auto twist = geometry_msgs::msg::TwistStamped();
@@ -242,67 +203,6 @@ private:
     twist.twist = msg->twist.twist;
     publish_twist(twist);
   }
-
-  void getOriginCallback(
-    const as2_msgs::srv::GetOrigin::Request::SharedPtr request,
-    as2_msgs::srv::GetOrigin::Response::SharedPtr response)
-  {
-    if (origin_) {
-      response->origin = *origin_;
-      response->success = true;
-    } else {
-      RCLCPP_WARN(node_ptr_->get_logger(), "Origin not set");
-      response->success = false;
-    }
-  }
-
-  void setOriginCallback(
-    const as2_msgs::srv::SetOrigin::Request::SharedPtr request,
-    as2_msgs::srv::SetOrigin::Response::SharedPtr response)
-  {
-    if (origin_) {
-      RCLCPP_WARN(node_ptr_->get_logger(), "Origin already set");
-      response->success = false;
-    } else {
-      origin_ = std::make_unique<geographic_msgs::msg::GeoPoint>(request->origin);
-      RCLCPP_INFO(
-        node_ptr_->get_logger(), "Origin set to %f, %f, %f", origin_->latitude,
-        origin_->longitude, origin_->altitude);
-      response->success = true;
-      generate_map_frame_from_gps(request->origin, *gps_pose_);
-    }
-  }
-
-  void gps_callback(sensor_msgs::msg::NavSatFix::UniquePtr msg)
-  {
-    // This sould only be called when the use_gps_origin is true
-
-    if (gps_pose_) {
-      gps_sub_.reset();
-      return;
-    }
-
-    gps_pose_ = std::move(msg);
-
-    if (set_origin_on_start_) {
-      if (!origin_) {
-        origin_ = std::make_unique<geographic_msgs::msg::GeoPoint>();
-        origin_->latitude = gps_pose_->latitude;
-        origin_->longitude = gps_pose_->longitude;
-        origin_->altitude = gps_pose_->altitude;
-        RCLCPP_WARN(node_ptr_->get_logger(), "Careful, using GPS pose as origin");
-        RCLCPP_INFO(
-          node_ptr_->get_logger(), "Origin set to %f, %f, %f", origin_lat_, origin_lon_,
-          origin_alt_);
-      }
-
-      RCLCPP_INFO(
-        node_ptr_->get_logger(), "GPS Callback: Map GPS pose set to %f, %f, %f",
-        gps_pose_->latitude, gps_pose_->longitude, gps_pose_->altitude);
-
-      generate_map_frame_from_gps(*origin_, *gps_pose_);
-    }
-  }
 };
 
 }  // namespace raw_odometry
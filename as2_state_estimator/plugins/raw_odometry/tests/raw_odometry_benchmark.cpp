@@ -0,0 +1,80 @@
+// Copyright 2024 Universidad Politécnica de Madrid
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the Universidad Politécnica de Madrid nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+* @file raw_odometry_benchmark.cpp
+*
+* Raw odometry plugin benchmark: odometry input to estimator twist output, in process
+*
+* @authors Rafael Pérez Seguí
+*/
+
+#include <nav_msgs/msg/odometry.hpp>
+#include <geometry_msgs/msg/twist_stamped.hpp>
+#include <as2_core/names/topics.hpp>
+
+#include "plugin_pipeline_benchmark.hpp"
+#include "raw_odometry.hpp"
+
+namespace
+{
+
+using RawOdometryPipeline = as2_state_estimator::PluginPipeline<
+  raw_odometry::Plugin, nav_msgs::msg::Odometry, geometry_msgs::msg::TwistStamped>;
+
+as2_state_estimator::PluginPipelineConfig<nav_msgs::msg::Odometry> makeConfig()
+{
+  as2_state_estimator::PluginPipelineConfig<nav_msgs::msg::Odometry> config;
+  config.parameters = {{"use_gps", false}};
+  config.source_name = "odometry_source";
+  config.input_topic = as2_names::topics::sensor_measurements::odom;
+  config.input_qos = as2_names::topics::sensor_measurements::qos;
+  config.output_topic = as2_names::topics::self_localization::twist;
+  config.output_qos = as2_names::topics::self_localization::qos;
+  config.init_input = [](as2::Node & node, nav_msgs::msg::Odometry & msg) {
+      msg.header.frame_id = as2::tf::generateTfName(&node, "odom");
+      msg.child_frame_id = as2::tf::generateTfName(&node, "base_link");
+      msg.pose.pose.orientation.w = 1.0;
+    };
+  config.next_input = [](as2::Node & node, nav_msgs::msg::Odometry & msg) {
+      msg.header.stamp = node.now();
+      msg.pose.pose.position.x += 0.01;
+      msg.twist.twist.linear.x = 1.0;
+    };
+  return config;
+}
+
+}  // namespace
+
+static void BM_RawOdometryCallbackToPublish(benchmark::State & state)
+{
+  as2_state_estimator::runCallbackToPublish<RawOdometryPipeline>(state, makeConfig());
+}
+PLUGIN_PIPELINE_BENCHMARK(BM_RawOdometryCallbackToPublish);
+
+PLUGIN_PIPELINE_BENCHMARK_MAIN()
@@ -0,0 +1,173 @@
+// Copyright 2024 Universidad Politécnica de Madrid
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the Universidad Politécnica de Madrid nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+* @file gps_origin_handler.cpp
+*
+* GPS origin and map fix handling on its own callback group and worker thread
+*
+* @authors Rafael Pérez Seguí
+*          Javier Melero Deza
+*/
+
+#include "as2_state_estimator/gps_origin_handler.hpp"
+
+#include <utility>
+
+#include <as2_core/names/services.hpp>
+#include <as2_core/names/topics.hpp>
+#include <as2_core/utils/gps_utils.hpp>
+
+namespace as2_state_estimator
+{
+
+GpsOriginHandler::GpsOriginHandler(as2::Node * node, MapFixCallback map_fix_callback)
+: node_(node), map_fix_callback_(std::move(map_fix_callback))
+{
+  node_->get_parameter("set_origin_on_start", set_origin_on_start_);
+  if (set_origin_on_start_ && node_->has_parameter("set_origin.lat") &&
+    node_->has_parameter("set_origin.lon") &&
+    node_->has_parameter("set_origin.alt"))
+  {
+    origin_ = std::make_unique<geographic_msgs::msg::GeoPoint>();
+    node_->get_parameter("set_origin.lat", origin_->latitude);
+    node_->get_parameter("set_origin.lon", origin_->longitude);
+    node_->get_parameter("set_origin.alt", origin_->altitude);
+    RCLCPP_INFO(
+      node_->get_logger(), "Origin set to %f, %f, %f", origin_->latitude, origin_->longitude,
+      origin_->altitude);
+  } else {
+    RCLCPP_INFO(node_->get_logger(), "Waiting for origin to be set");
+  }
+
+  // Not added to the node executor, the worker thread spins it
+  callback_group_ =
+    node_->create_callback_group(rclcpp::CallbackGroupType::MutuallyExclusive, false);
+
+  rclcpp::SubscriptionOptions sub_options;
+  sub_options.callback_group = callback_group_;
+  gps_sub_ = node_->create_subscription<sensor_msgs::msg::NavSatFix>(
+    as2_names::topics::sensor_measurements::gps, as2_names::topics::sensor_measurements::qos,
+    std::bind(&GpsOriginHandler::gpsCallback, this, std::placeholders::_1), sub_options);
+  set_origin_srv_ = node_->create_service<as2_msgs::srv::SetOrigin>(
+    as2_names::services::gps::set_origin,
+    std::bind(
+      &GpsOriginHandler::setOriginCallback, this, std::placeholders::_1,
+      std::placeholders::_2),
+    rmw_qos_profile_services_default, callback_group_);
+  get_origin_srv_ = node_->create_service<as2_msgs::srv::GetOrigin>(
+    as2_names::services::gps::get_origin,
+    std::bind(
+      &GpsOriginHandler::getOriginCallback, this, std::placeholders::_1,
+      std::placeholders::_2),
+    rmw_qos_profile_services_default, callback_group_);
+
+  executor_.add_callback_group(callback_group_, node_->get_node_base_interface());
+  worker_ = std::thread([this]() {executor_.spin();});
+}
+
+GpsOriginHandler::~GpsOriginHandler()
+{
+  executor_.cancel();
+  if (worker_.joinable()) {
+    worker_.join();
+  }
+}
+
+void GpsOriginHandler::gpsCallback(const sensor_msgs::msg::NavSatFix::SharedPtr msg)
+{
+  // Only the first fix is used, it places the map frame
+  if (map_fix_) {
+    gps_sub_.reset();
+    return;
+  }
+  map_fix_ = std::make_unique<sensor_msgs::msg::NavSatFix>(*msg);
+  RCLCPP_INFO(
+    node_->get_logger(), "GPS Callback: Map GPS pose set to %f, %f, %f",
+    map_fix_->latitude, map_fix_->longitude, map_fix_->altitude);
+
+  if (!origin_) {
+    if (!set_origin_on_start_) {
+      return;
+    }
+    origin_ = std::make_unique<geographic_msgs::msg::GeoPoint>();
+    origin_->latitude = map_fix_->latitude;
+    origin_->longitude = map_fix_->longitude;
+    origin_->altitude = map_fix_->altitude;
+    RCLCPP_WARN(node_->get_logger(), "Careful, using GPS pose as origin");
+    RCLCPP_INFO(
+      node_->get_logger(), "Origin set to %f, %f, %f", origin_->latitude, origin_->longitude,
+      origin_->altitude);
+  }
+  generateMapFix();
+}
+
+void GpsOriginHandler::setOriginCallback(
+  const as2_msgs::srv::SetOrigin::Request::SharedPtr request,
+  as2_msgs::srv::SetOrigin::Response::SharedPtr response)
+{
+  if (origin_) {
+    RCLCPP_WARN(node_->get_logger(), "Origin already set");
+    response->success = false;
+    return;
+  }
+  origin_ = std::make_unique<geographic_msgs::msg::GeoPoint>(request->origin);
+  RCLCPP_INFO(
+    node_->get_logger(), "Origin set to %f, %f, %f", origin_->latitude, origin_->longitude,
+    origin_->altitude);
+  response->success = true;
+  if (map_fix_) {
+    generateMapFix();
+  } else {
+    RCLCPP_INFO(node_->get_logger(), "Waiting for the first GPS fix to place the map frame");
+  }
+}
+
+void GpsOriginHandler::getOriginCallback(
+  const as2_msgs::srv::GetOrigin::Request::SharedPtr request,
+  as2_msgs::srv::GetOrigin::Response::SharedPtr response)
+{
+  if (origin_) {
+    response->origin = *origin_;
+    response->success = true;
+  } else {
+    RCLCPP_WARN(node_->get_logger(), "Origin not set");
+    response->success = false;
+  }
+}
+
+void GpsOriginHandler::generateMapFix()
+{
+  as2::gps::GpsHandler gps_handler;
+  gps_handler.setOrigin(origin_->latitude, origin_->longitude, origin_->altitude);
+  double x, y, z;
+  gps_handler.LatLon2Local(map_fix_->latitude, map_fix_->longitude, map_fix_->altitude, x, y, z);
+  map_fix_callback_(*origin_, *map_fix_, tf2::Vector3(x, y, z));
+}
+
+}  // namespace as2_state_estimator
@@ -0,0 +1,108 @@
+// Copyright 2024 Universidad Politécnica de Madrid
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the Universidad Politécnica de Madrid nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+* @file imu_propagator.cpp
+*
+* Propagation of the estimated state with IMU samples between absolute updates implementation
+*
+* @authors Rafael Pérez Seguí
+*          Miguel Fernández Cortizas
+*/
+
+#include "imu_propagator.hpp"
+
+namespace as2_state_estimator
+{
+
+void ImuPropagator::setMaxPropagationTime(const double max_propagation_time)
+{
+  max_propagation_time_ = max_propagation_time;
+}
+
+void ImuPropagator::reset()
+{
+  state_ = PropagatedState();
+  has_pose_ = false;
+  has_twist_ = false;
+}
+
+void ImuPropagator::updatePose(
+  const double stamp, const Eigen::Vector3d & position,
+  const Eigen::Quaterniond & orientation)
+{
+  // Keep the earth frame velocity, it is updated with the twist of the same measurement
+  state_.stamp = stamp;
+  state_.position = position;
+  state_.orientation = orientation.normalized();
+  last_update_stamp_ = stamp;
+  has_pose_ = true;
+}
+
+void ImuPropagator::updateTwist(
+  const double stamp, const Eigen::Vector3d & linear_velocity,
+  const Eigen::Vector3d & angular_velocity)
+{
+  state_.velocity = state_.orientation * linear_velocity;
+  state_.angular_velocity = angular_velocity;
+  if (stamp > last_update_stamp_) {
+    last_update_stamp_ = stamp;
+  }
+  has_twist_ = true;
+}
+
+bool ImuPropagator::propagate(
+  const double stamp, const Eigen::Vector3d & angular_velocity,
+  const Eigen::Vector3d & linear_acceleration)
+{
+  if (!isInitialized()) {
+    return false;
+  }
+  const double dt = stamp - state_.stamp;
+  if (dt <= 0.0 || stamp - last_update_stamp_ > max_propagation_time_) {
+    return false;
+  }
+
+  // Acceleration in the earth frame with the attitude at the start of the interval
+  const Eigen::Vector3d acceleration = state_.orientation * linear_acceleration + gravity_;
+  state_.position += state_.velocity * dt + 0.5 * acceleration * dt * dt;
+  state_.velocity += acceleration * dt;
+
+  const Eigen::Vector3d rotation = angular_velocity * dt;
+  const double angle = rotation.norm();
+  if (angle > 0.0) {
+    state_.orientation =
+      (state_.orientation * Eigen::Quaterniond(Eigen::AngleAxisd(angle, rotation / angle)))
+      .normalized();
+  }
+  state_.angular_velocity = angular_velocity;
+  state_.stamp = stamp;
+  return true;
+}
+
+}  // namespace as2_state_estimator
@@ -0,0 +1,120 @@
+// Copyright 2024 Universidad Politécnica de Madrid
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the Universidad Politécnica de Madrid nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+* @file imu_propagator_gtest.cpp
+*
+* IMU propagation gtest
+*
+* @authors Rafael Pérez Seguí
+*/
+
+#include <gtest/gtest.h>
+
+#include "imu_propagator.hpp"
+
+using as2_state_estimator::ImuPropagator;
+
+namespace
+{
+const Eigen::Vector3d kHoverSpecificForce(0.0, 0.0, 9.81);
+
+void initialize(ImuPropagator & propagator, const double stamp)
+{
+  propagator.updatePose(stamp, Eigen::Vector3d(1.0, 2.0, 3.0), Eigen::Quaterniond::Identity());
+  propagator.updateTwist(stamp, Eigen::Vector3d::Zero(), Eigen::Vector3d::Zero());
+}
+}  // namespace
+
+TEST(ImuPropagatorGTest, RequiresPoseAndTwist) {
+  ImuPropagator propagator;
+  EXPECT_FALSE(propagator.propagate(0.1, Eigen::Vector3d::Zero(), kHoverSpecificForce));
+  propagator.updatePose(0.0, Eigen::Vector3d::Zero(), Eigen::Quaterniond::Identity());
+  EXPECT_FALSE(propagator.propagate(0.1, Eigen::Vector3d::Zero(), kHoverSpecificForce));
+  propagator.updateTwist(0.0, Eigen::Vector3d::Zero(), Eigen::Vector3d::Zero());
+  EXPECT_TRUE(propagator.propagate(0.1, Eigen::Vector3d::Zero(), kHoverSpecificForce));
+}
+
+TEST(ImuPropagatorGTest, HoverKeepsState) {
+  ImuPropagator propagator;
+  initialize(propagator, 0.0);
+  for (int i = 1; i <= 100; i++) {
+    EXPECT_TRUE(propagator.propagate(i * 0.001, Eigen::Vector3d::Zero(), kHoverSpecificForce));
+  }
+  EXPECT_TRUE(propagator.getState().position.isApprox(Eigen::Vector3d(1.0, 2.0, 3.0)));
+  EXPECT_NEAR(propagator.getState().velocity.norm(), 0.0, 1e-9);
+}
+
+TEST(ImuPropagatorGTest, IntegratesConstantAcceleration) {
+  ImuPropagator propagator;
+  initialize(propagator, 0.0);
+  const Eigen::Vector3d acceleration(1.0, -0.5, 0.2);
+  for (int i = 1; i <= 100; i++) {
+    propagator.propagate(i * 0.001, Eigen::Vector3d::Zero(), kHoverSpecificForce + acceleration);
+  }
+  const double t = 0.1;
+  const Eigen::Vector3d expected = Eigen::Vector3d(1.0, 2.0, 3.0) + 0.5 * acceleration * t * t;
+  EXPECT_NEAR((propagator.getState().position - expected).norm(), 0.0, 1e-9);
+  EXPECT_NEAR((propagator.getState().velocity - acceleration * t).norm(), 0.0, 1e-9);
+}
+
+TEST(ImuPropagatorGTest, IntegratesAngularVelocity) {
+  ImuPropagator propagator;
+  propagator.setMaxPropagationTime(2.0);
+  initialize(propagator, 0.0);
+  const Eigen::Vector3d angular_velocity(0.0, 0.0, M_PI_2);
+  for (int i = 1; i <= 1000; i++) {
+    propagator.propagate(i * 0.001, angular_velocity, kHoverSpecificForce);
+  }
+  const Eigen::Quaterniond expected(Eigen::AngleAxisd(M_PI_2, Eigen::Vector3d::UnitZ()));
+  EXPECT_NEAR(propagator.getState().orientation.angularDistance(expected), 0.0, 1e-9);
+  EXPECT_TRUE(propagator.getState().angular_velocity.isApprox(angular_velocity));
+}
+
+TEST(ImuPropagatorGTest, TwistIsRotatedToEarthFrame) {
+  ImuPropagator propagator;
+  const Eigen::Quaterniond yaw_90(Eigen::AngleAxisd(M_PI_2, Eigen::Vector3d::UnitZ()));
+  propagator.updatePose(0.0, Eigen::Vector3d::Zero(), yaw_90);
+  propagator.updateTwist(0.0, Eigen::Vector3d(1.0, 0.0, 0.0), Eigen::Vector3d::Zero());
+  EXPECT_TRUE(propagator.getState().velocity.isApprox(Eigen::Vector3d(0.0, 1.0, 0.0)));
+  EXPECT_TRUE(propagator.getBodyVelocity().isApprox(Eigen::Vector3d(1.0, 0.0, 0.0)));
+}
+
+TEST(ImuPropagatorGTest, StopsWithoutAbsoluteUpdates) {
+  ImuPropagator propagator;
+  propagator.setMaxPropagationTime(0.05);
+  initialize(propagator, 0.0);
+  EXPECT_TRUE(propagator.propagate(0.04, Eigen::Vector3d::Zero(), kHoverSpecificForce));
+  EXPECT_FALSE(propagator.propagate(0.06, Eigen::Vector3d::Zero(), kHoverSpecificForce));
+
+  // Old samples are discarded, a new update resumes the propagation
+  initialize(propagator, 0.1);
+  EXPECT_FALSE(propagator.propagate(0.09, Eigen::Vector3d::Zero(), kHoverSpecificForce));
+  EXPECT_TRUE(propagator.propagate(0.11, Eigen::Vector3d::Zero(), kHoverSpecificForce));
+  EXPECT_DOUBLE_EQ(propagator.getState().stamp, 0.11);
+}
@@ -0,0 +1,165 @@
+// Copyright 2024 Universidad Politécnica de Madrid
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the Universidad Politécnica de Madrid nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+* @file measurement_buffer_gtest.cpp
+*
+* Measurement buffer gtest
+*
+* @authors Rafael Pérez Seguí
+*/
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+#include "measurement_buffer.hpp"
+
+namespace
+{
+
+// State records the stamps applied, in order, so replay results can be compared
+using Buffer = as2_state_estimator::MeasurementBuffer<double, std::vector<double>>;
+
+void record(const Buffer::Measurement & measurement, std::vector<double> & state)
+{
+  state.push_back(measurement.data);
+}
+
+}  // namespace
+
+TEST(MeasurementBuffer, AppliesInStampOrder) {
+  Buffer buffer(16, 8);
+  const uint8_t source = buffer.addSource("test");
+  buffer.push(source, 0.3, 0.3, 0.3);
+  buffer.push(source, 0.1, 0.3, 0.1);
+  buffer.push(source, 0.2, 0.3, 0.2);
+  EXPECT_EQ(buffer.process(1.0, record), 3u);
+  EXPECT_EQ(buffer.getState(), (std::vector<double>{0.1, 0.2, 0.3}));
+  EXPECT_DOUBLE_EQ(buffer.getLastAppliedStamp(), 0.3);
+}
+
+TEST(MeasurementBuffer, ReorderDelayHoldsRecentMeasurements) {
+  Buffer buffer(16, 8, 0.1);
+  const uint8_t source = buffer.addSource("test");
+  buffer.push(source, 1.0, 1.0, 1.0);
+  EXPECT_EQ(buffer.process(1.05, record), 0u);
+  buffer.push(source, 0.98, 1.06, 0.98);
+  EXPECT_EQ(buffer.process(1.1, record), 2u);
+  EXPECT_EQ(buffer.getState(), (std::vector<double>{0.98, 1.0}));
+}
+
+TEST(MeasurementBuffer, SourceClockAheadIsNotHeld) {
+  // Without reorder delay, stamps ahead of now are applied right away
+  Buffer buffer(16, 8);
+  const uint8_t source = buffer.addSource("test");
+  buffer.push(source, 1.01, 1.0, 1.01);
+  EXPECT_EQ(buffer.process(1.0, record), 1u);
+  EXPECT_EQ(buffer.getLatencyStats(source).ahead, 1u);
+
+  // With reorder delay, they wait for it from their arrival
+  Buffer delayed(16, 8, 0.1);
+  const uint8_t delayed_source = delayed.addSource("test");
+  delayed.push(delayed_source, 1.5, 1.0, 1.5);
+  EXPECT_EQ(delayed.process(1.05, record), 0u);
+  EXPECT_EQ(delayed.process(1.1, record), 1u);
+  EXPECT_EQ(delayed.getState(), (std::vector<double>{1.5}));
+}
+
+TEST(MeasurementBuffer, LateMeasurementIsReplayed) {
+  Buffer buffer(16, 8);
+  const uint8_t fast = buffer.addSource("fast");
+  const uint8_t slow = buffer.addSource("slow");
+  for (int i = 1; i <= 4; i++) {
+    buffer.push(fast, i, i, i);
+    buffer.process(i, record);
+  }
+  buffer.push(slow, 2.5, 4.5, 2.5);
+  EXPECT_EQ(buffer.process(4.5, record), 3u);
+  EXPECT_EQ(buffer.getState(), (std::vector<double>{1.0, 2.0, 2.5, 3.0, 4.0}));
+  EXPECT_EQ(buffer.getLatencyStats(slow).late, 1u);
+  EXPECT_EQ(buffer.getLatencyStats(slow).dropped, 0u);
+  EXPECT_NEAR(buffer.getLatencyStats(slow).last_latency, 2.0, 1e-9);
+  EXPECT_EQ(buffer.getLatencyStats(fast).count, 4u);
+  EXPECT_EQ(buffer.getLatencyStats(fast).late, 0u);
+}
+
+TEST(MeasurementBuffer, MeasurementOlderThanWindowIsDropped) {
+  Buffer buffer(16, 2);
+  const uint8_t source = buffer.addSource("test");
+  for (int i = 1; i <= 4; i++) {
+    buffer.push(source, i, i, i);
+  }
+  buffer.process(10.0, record);
+  buffer.push(source, 1.5, 10.0, 1.5);
+  EXPECT_EQ(buffer.process(10.0, record), 0u);
+  EXPECT_EQ(buffer.getState(), (std::vector<double>{1.0, 2.0, 3.0, 4.0}));
+  EXPECT_EQ(buffer.getLatencyStats(source).dropped, 1u);
+
+  // Inside the window: rolled back to the state kept before the evicted entries
+  buffer.push(source, 3.5, 10.0, 3.5);
+  EXPECT_EQ(buffer.process(10.0, record), 2u);
+  EXPECT_EQ(buffer.getState(), (std::vector<double>{1.0, 2.0, 3.0, 3.5, 4.0}));
+}
+
+TEST(MeasurementBuffer, FullBufferRejectsPush) {
+  Buffer buffer(4, 4);
+  const uint8_t source = buffer.addSource("test");
+  for (int i = 0; i < 4; i++) {
+    EXPECT_TRUE(buffer.push(source, i, i, i));
+  }
+  EXPECT_FALSE(buffer.push(source, 4.0, 4.0, 4.0));
+  EXPECT_EQ(buffer.getOverflowCount(), 1u);
+  EXPECT_EQ(buffer.process(10.0, record), 4u);
+  EXPECT_TRUE(buffer.push(source, 5.0, 5.0, 5.0));
+}
+
+TEST(MeasurementBuffer, ConcurrentProducers) {
+  Buffer buffer(1024, 16);
+  const uint8_t first = buffer.addSource("first");
+  const uint8_t second = buffer.addSource("second");
+  auto produce = [&buffer](const uint8_t source, const double offset) {
+      for (int i = 0; i < 200; i++) {
+        const double stamp = i * 0.01 + offset;
+        while (!buffer.push(source, stamp, stamp, stamp)) {
+          std::this_thread::yield();
+        }
+      }
+    };
+  std::thread first_thread(produce, first, 0.0);
+  std::thread second_thread(produce, second, 0.005);
+  first_thread.join();
+  second_thread.join();
+  buffer.process(10.0, record);
+
+  const std::vector<double> & state = buffer.getState();
+  ASSERT_EQ(state.size(), 400u);
+  EXPECT_TRUE(std::is_sorted(state.begin(), state.end()));
+}
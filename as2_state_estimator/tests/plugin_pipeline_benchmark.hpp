@@ -0,0 +1,222 @@
+// Copyright 2024 Universidad Politécnica de Madrid
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the Universidad Politécnica de Madrid nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+* @file plugin_pipeline_benchmark.hpp
+*
+* In process pipeline shared by the plugin benchmarks: one input message to one estimator
+* output, measuring the callback to publish latency
+*
+* @authors Rafael Pérez Seguí
+*/
+
+#ifndef PLUGIN_PIPELINE_BENCHMARK_HPP_
+#define PLUGIN_PIPELINE_BENCHMARK_HPP_
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <rclcpp/rclcpp.hpp>
+#include <as2_core/node.hpp>
+#include <as2_core/utils/tf_utils.hpp>
+
+namespace as2_state_estimator
+{
+
+constexpr char kBenchmarkNamespace[] = "benchmark_drone";
+constexpr auto kStepTimeout = std::chrono::milliseconds(100);
+constexpr int kWarmUpSteps = 50;
+
+/**
+ * @brief Plugin specific part of a pipeline: extra parameters, topics and input messages
+ */
+template<typename InputT>
+struct PluginPipelineConfig
+{
+  std::vector<rclcpp::Parameter> parameters;  // Added to the common frame parameters
+  std::string source_name;
+  std::string input_topic;
+  rclcpp::QoS input_qos = rclcpp::QoS(10);
+  std::string output_topic;
+  rclcpp::QoS output_qos = rclcpp::QoS(10);
+  // Fills the first input message, once the estimator node exists
+  std::function<void(as2::Node &, InputT &)> init_input;
+  // Stamps and advances the input message before each step
+  std::function<void(as2::Node &, InputT &)> next_input;
+};
+
+/**
+ * @brief Plugin running on its own node, fed by a source node that also listens to the
+ * estimator output
+ */
+template<typename PluginT, typename InputT, typename OutputT>
+class PluginPipeline
+{
+public:
+  PluginPipeline(bool intra_process, const PluginPipelineConfig<InputT> & config)
+  : next_input_(config.next_input)
+  {
+    std::vector<rclcpp::Parameter> parameters = {
+      {"base_frame", "base_link"}, {"global_ref_frame", "earth"}, {"odom_frame", "odom"},
+      {"map_frame", "map"}};
+    parameters.insert(parameters.end(), config.parameters.begin(), config.parameters.end());
+    node_ = std::make_shared<as2::Node>(
+      "state_estimator", kBenchmarkNamespace,
+      rclcpp::NodeOptions()
+      .parameter_overrides(parameters)
+      .allow_undeclared_parameters(true)
+      .automatically_declare_parameters_from_overrides(true)
+      .use_intra_process_comms(intra_process));
+    plugin_ = std::make_shared<PluginT>();
+    plugin_->setup(
+      node_.get(), std::make_shared<as2::tf::TfHandler>(node_.get()),
+      std::make_shared<tf2_ros::TransformBroadcaster>(node_.get()),
+      std::make_shared<tf2_ros::StaticTransformBroadcaster>(node_.get()));
+
+    source_ = std::make_shared<rclcpp::Node>(
+      config.source_name, kBenchmarkNamespace,
+      rclcpp::NodeOptions().use_intra_process_comms(intra_process));
+    input_pub_ = source_->create_publisher<InputT>(config.input_topic, config.input_qos);
+    output_sub_ = source_->create_subscription<OutputT>(
+      config.output_topic, config.output_qos,
+      [this](const typename OutputT::SharedPtr) {
+        received_time_ = std::chrono::steady_clock::now();
+        received_++;
+      });
+
+    executor_.add_node(node_);
+    executor_.add_node(source_);
+
+    if (config.init_input) {
+      config.init_input(*node_, input_msg_);
+    }
+  }
+
+  // Steps until publisher and subscriptions are matched
+  bool warmUp()
+  {
+    std::chrono::nanoseconds latency;
+    for (int i = 0; i < kWarmUpSteps; ++i) {
+      if (step(latency)) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Publishes one input message and spins until the estimator output is received
+  bool step(std::chrono::nanoseconds & latency)
+  {
+    const uint64_t expected = received_ + 1;
+    next_input_(*node_, input_msg_);
+
+    const auto start = std::chrono::steady_clock::now();
+    input_pub_->publish(input_msg_);
+    while (received_ < expected) {
+      executor_.spin_some();
+      if (std::chrono::steady_clock::now() - start > kStepTimeout) {
+        return false;
+      }
+    }
+    latency = received_time_ - start;
+    return true;
+  }
+
+private:
+  std::function<void(as2::Node &, InputT &)> next_input_;
+  std::shared_ptr<as2::Node> node_;
+  std::shared_ptr<PluginT> plugin_;
+  std::shared_ptr<rclcpp::Node> source_;
+  typename rclcpp::Publisher<InputT>::SharedPtr input_pub_;
+  typename rclcpp::Subscription<OutputT>::SharedPtr output_sub_;
+  rclcpp::executors::SingleThreadedExecutor executor_;
+  InputT input_msg_;
+  uint64_t received_ = 0;
+  std::chrono::steady_clock::time_point received_time_;
+};
+
+/**
+ * @brief Callback to publish benchmark body, the range 0 argument enables intra process
+ * communication. Reports mean and max latency and the steps with no output
+ */
+template<typename PipelineT, typename ConfigT>
+void runCallbackToPublish(benchmark::State & state, const ConfigT & config)
+{
+  PipelineT pipeline(state.range(0) != 0, config);
+  if (!pipeline.warmUp()) {
+    state.SkipWithError("Estimator output not received");
+    return;
+  }
+
+  std::chrono::nanoseconds latency;
+  double total_latency = 0.0;
+  double max_latency = 0.0;
+  int64_t lost = 0;
+  for (auto _ : state) {
+    if (!pipeline.step(latency)) {
+      lost++;
+      continue;
+    }
+    const double latency_us = std::chrono::duration<double, std::micro>(latency).count();
+    total_latency += latency_us;
+    max_latency = std::max(max_latency, latency_us);
+  }
+  state.SetItemsProcessed(state.iterations() - lost);
+  state.counters["latency_us"] = benchmark::Counter(
+    total_latency / std::max<int64_t>(state.iterations() - lost, 1));
+  state.counters["max_latency_us"] = max_latency;
+  state.counters["lost"] = static_cast<double>(lost);
+}
+
+}  // namespace as2_state_estimator
+
+// Registers a callback to publish benchmark, with and without intra process communication
+#define PLUGIN_PIPELINE_BENCHMARK(func) \
+  BENCHMARK(func) \
+  ->ArgName("intra_process")->Arg(0)->Arg(1) \
+  ->UseRealTime()->Unit(benchmark::kMicrosecond)
+
+// Benchmark main with the rclcpp context the pipelines need
+#define PLUGIN_PIPELINE_BENCHMARK_MAIN() \
+  int main(int argc, char ** argv) \
+  { \
+    rclcpp::init(argc, argv); \
+    benchmark::Initialize(&argc, argv); \
+    benchmark::RunSpecifiedBenchmarks(); \
+    benchmark::Shutdown(); \
+    rclcpp::shutdown(); \
+    return 0; \
+  }
+
+#endif  // PLUGIN_PIPELINE_BENCHMARK_HPP_
@@ -0,0 +1,167 @@
+// Copyright 2024 Universidad Politécnica de Madrid
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the Universidad Politécnica de Madrid nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+* @file sensor_synchronizer_gtest.cpp
+*
+* Sensor synchronizer gtest
+*
+* @authors Rafael Pérez Seguí
+*/
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <tuple>
+
+#include "sensor_synchronizer.hpp"
+
+namespace
+{
+
+using as2_state_estimator::GpsSample;
+using as2_state_estimator::ImuSample;
+using as2_state_estimator::PoseSample;
+using as2_state_estimator::SampleRing;
+using as2_state_estimator::SensorSynchronizer;
+
+ImuSample imuSample(const double value)
+{
+  ImuSample sample;
+  sample.angular_velocity = Eigen::Vector3d::Constant(value);
+  sample.linear_acceleration = Eigen::Vector3d(0.0, 0.0, value);
+  return sample;
+}
+
+GpsSample gpsSample(const double altitude)
+{
+  GpsSample sample;
+  sample.latitude = 40.0;
+  sample.longitude = -3.0;
+  sample.altitude = altitude;
+  return sample;
+}
+
+}  // namespace
+
+TEST(SampleRing, InterpolatesBetweenSamples) {
+  SampleRing<double> ring(8);
+  EXPECT_TRUE(ring.push(1.0, 10.0));
+  EXPECT_TRUE(ring.push(2.0, 20.0));
+  double value = 0.0;
+  EXPECT_TRUE(ring.sample(1.25, 0.0, value));
+  EXPECT_DOUBLE_EQ(value, 12.5);
+  EXPECT_TRUE(ring.sample(2.0, 0.0, value));
+  EXPECT_DOUBLE_EQ(value, 20.0);
+  EXPECT_FALSE(ring.sample(0.5, 0.0, value));
+}
+
+TEST(SampleRing, KeepsStampOrder) {
+  SampleRing<double> ring(4);
+  ring.push(3.0, 3.0);
+  ring.push(1.0, 1.0);
+  ring.push(2.0, 2.0);
+  ring.push(2.0, 5.0);  // Replaces the sample at the same stamp
+  EXPECT_EQ(ring.size(), 3u);
+  EXPECT_DOUBLE_EQ(ring.oldestStamp(), 1.0);
+  EXPECT_DOUBLE_EQ(ring.newestStamp(), 3.0);
+  double value = 0.0;
+  EXPECT_TRUE(ring.sample(2.0, 0.0, value));
+  EXPECT_DOUBLE_EQ(value, 5.0);
+}
+
+TEST(SampleRing, OverwritesOldestWhenFull) {
+  SampleRing<double> ring(3);
+  for (int i = 0; i < 5; i++) {
+    EXPECT_TRUE(ring.push(i, i));
+  }
+  EXPECT_EQ(ring.size(), 3u);
+  EXPECT_DOUBLE_EQ(ring.oldestStamp(), 2.0);
+  // Older than everything kept in a full ring
+  EXPECT_FALSE(ring.push(1.0, 1.0));
+  // Late but inside the window, the oldest one is dropped
+  EXPECT_TRUE(ring.push(3.5, 3.5));
+  EXPECT_DOUBLE_EQ(ring.oldestStamp(), 3.0);
+  double value = 0.0;
+  EXPECT_TRUE(ring.sample(3.75, 0.0, value));
+  EXPECT_DOUBLE_EQ(value, 3.75);
+}
+
+TEST(SensorSynchronizer, SnapshotInterpolatesAllStreams) {
+  SensorSynchronizer<ImuSample, GpsSample> synchronizer({64, 8}, 0.0);
+  for (int i = 0; i <= 10; i++) {
+    synchronizer.push<0>(0.1 * i, imuSample(i));
+  }
+  synchronizer.push<1>(0.0, gpsSample(100.0));
+  synchronizer.push<1>(1.0, gpsSample(110.0));
+
+  SensorSynchronizer<ImuSample, GpsSample>::Snapshot snapshot;
+  ASSERT_TRUE(synchronizer.getSnapshot(0.55, snapshot));
+  EXPECT_NEAR(std::get<0>(snapshot).angular_velocity.x(), 5.5, 1e-9);
+  EXPECT_NEAR(std::get<1>(snapshot).altitude, 105.5, 1e-9);
+  EXPECT_FALSE(synchronizer.getSnapshot(-0.1, snapshot));
+}
+
+TEST(SensorSynchronizer, MaxLagHoldsSlowStreams) {
+  SensorSynchronizer<ImuSample, GpsSample> synchronizer({64, 8}, 0.2);
+  synchronizer.push<1>(0.0, gpsSample(100.0));
+  for (int i = 0; i <= 5; i++) {
+    synchronizer.push<0>(0.1 * i, imuSample(i));
+  }
+
+  SensorSynchronizer<ImuSample, GpsSample>::Snapshot snapshot;
+  // GPS held for max_lag after its last fix
+  EXPECT_TRUE(synchronizer.getSnapshot(0.15, snapshot));
+  EXPECT_DOUBLE_EQ(std::get<1>(snapshot).altitude, 100.0);
+  EXPECT_FALSE(synchronizer.getSnapshot(0.3, snapshot));
+
+  // Latest stamp limited by the slowest stream
+  double stamp = 0.0;
+  ASSERT_TRUE(synchronizer.getLatestSnapshot(stamp, snapshot));
+  EXPECT_DOUBLE_EQ(stamp, 0.2);
+  EXPECT_NEAR(std::get<0>(snapshot).angular_velocity.x(), 2.0, 1e-9);
+
+  // Now the IMU is the slowest one, held as well
+  synchronizer.push<1>(1.0, gpsSample(110.0));
+  EXPECT_NEAR(synchronizer.getLatestStamp(), 0.7, 1e-9);
+}
+
+TEST(SensorSynchronizer, EmptyStreamHasNoSnapshot) {
+  SensorSynchronizer<PoseSample, double> synchronizer({8, 8}, 1.0);
+  synchronizer.push<0>(0.0, PoseSample());
+  SensorSynchronizer<PoseSample, double>::Snapshot snapshot;
+  double stamp = 0.0;
+  EXPECT_FALSE(synchronizer.getLatestSnapshot(stamp, snapshot));
+  EXPECT_TRUE(std::isnan(synchronizer.getLatestStamp()));
+  EXPECT_FALSE(synchronizer.getSnapshot(0.0, snapshot));
+
+  synchronizer.push<1>(0.0, 1.0);
+  EXPECT_TRUE(synchronizer.getSnapshot(0.0, snapshot));
+  synchronizer.clear();
+  EXPECT_EQ(synchronizer.size<0>(), 0u);
+}
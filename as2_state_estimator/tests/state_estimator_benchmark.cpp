@@ -0,0 +1,164 @@
+// Copyright 2024 Universidad Politécnica de Madrid
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//
+//    * Redistributions of source code must retain the above copyright
+//      notice, this list of conditions and the following disclaimer.
+//
+//    * Redistributions in binary form must reproduce the above copyright
+//      notice, this list of conditions and the following disclaimer in the
+//      documentation and/or other materials provided with the distribution.
+//
+//    * Neither the name of the Universidad Politécnica de Madrid nor the names of its
+//      contributors may be used to endorse or promote products derived from
+//      this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+// AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+// IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+// ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE
+// LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+// CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+// SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+// INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+// CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+// ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+// POSSIBILITY OF SUCH DAMAGE.
+
+/**
+* @file state_estimator_benchmark.cpp
+*
+* State estimator core benchmarks: frame helpers, IMU propagation and measurement buffer
+*
+* @authors Rafael Pérez Seguí
+*/
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+#include "imu_propagator.hpp"
+#include "measurement_buffer.hpp"
+#include "plugin_base.hpp"
+
+// Exposes the frame helpers of the plugin base
+class BenchmarkEstimator : public as2_state_estimator_plugin_base::StateEstimatorBase
+{
+public:
+  void on_setup() override {}
+  using StateEstimatorBase::convert_earth_to_baselink_2_odom_to_baselink_transform;
+  using StateEstimatorBase::convert_odom_to_baselink_2_earth_to_baselink_transform;
+};
+
+static void BM_ConvertEarthToBaselinkToOdomToBaselink(benchmark::State & state)
+{
+  BenchmarkEstimator estimator;
+  const tf2::Transform earth_to_map(
+    tf2::Quaternion(0, 0, 0.38268, 0.92388), tf2::Vector3(1, 2, 0));
+  const tf2::Transform map_to_odom(tf2::Quaternion(0, 0, 0, 1), tf2::Vector3(0.5, 0, 0));
+  tf2::Transform earth_to_baselink(tf2::Quaternion(0, 0, 0.1, 0.995), tf2::Vector3(3, 4, 5));
+  tf2::Transform odom_to_baselink;
+  for (auto _ : state) {
+    estimator.convert_earth_to_baselink_2_odom_to_baselink_transform(
+      earth_to_baselink, odom_to_baselink, earth_to_map, map_to_odom);
+    benchmark::DoNotOptimize(odom_to_baselink);
+    benchmark::ClobberMemory();
+  }
+}
+BENCHMARK(BM_ConvertEarthToBaselinkToOdomToBaselink);
+
+static void BM_ConvertOdomToBaselinkToEarthToBaselink(benchmark::State & state)
+{
+  BenchmarkEstimator estimator;
+  const tf2::Transform earth_to_map(
+    tf2::Quaternion(0, 0, 0.38268, 0.92388), tf2::Vector3(1, 2, 0));
+  const tf2::Transform map_to_odom(tf2::Quaternion(0, 0, 0, 1), tf2::Vector3(0.5, 0, 0));
+  tf2::Transform odom_to_baselink(tf2::Quaternion(0, 0, 0.1, 0.995), tf2::Vector3(3, 4, 5));
+  tf2::Transform earth_to_baselink;
+  for (auto _ : state) {
+    estimator.convert_odom_to_baselink_2_earth_to_baselink_transform(
+      odom_to_baselink, earth_to_baselink, earth_to_map, map_to_odom);
+    benchmark::DoNotOptimize(earth_to_baselink);
+    benchmark::ClobberMemory();
+  }
+}
+BENCHMARK(BM_ConvertOdomToBaselinkToEarthToBaselink);
+
+// One IMU sample at 200 Hz on top of the last plugin update
+static void BM_ImuPropagatorPropagate(benchmark::State & state)
+{
+  as2_state_estimator::ImuPropagator propagator;
+  propagator.setMaxPropagationTime(1e9);
+  propagator.updatePose(0.0, Eigen::Vector3d(1, 2, 3), Eigen::Quaterniond::Identity());
+  propagator.updateTwist(0.0, Eigen::Vector3d(0.5, 0, 0), Eigen::Vector3d(0, 0, 0.1));
+  const Eigen::Vector3d angular_velocity(0.01, -0.02, 0.1);
+  const Eigen::Vector3d linear_acceleration(0.1, 0.0, 9.81);
+  double stamp = 0.0;
+  for (auto _ : state) {
+    stamp += 0.005;
+    benchmark::DoNotOptimize(propagator.propagate(stamp, angular_velocity, linear_acceleration));
+  }
+}
+BENCHMARK(BM_ImuPropagatorPropagate);
+
+struct BenchmarkState
+{
+  double position = 0.0;
+  double velocity = 0.0;
+  double stamp = 0.0;
+};
+
+using BenchmarkBuffer = as2_state_estimator::MeasurementBuffer<double, BenchmarkState>;
+
+static void apply_measurement(const BenchmarkBuffer::Measurement & measurement, BenchmarkState & s)
+{
+  const double dt = measurement.stamp - s.stamp;
+  if (dt > 0.0) {
+    s.velocity = 0.9 * s.velocity + 0.1 * (measurement.data - s.position) / dt;
+  }
+  s.position = measurement.data;
+  s.stamp = measurement.stamp;
+}
+
+// Measurement pushed and applied on arrival, as the plugins do in their callbacks
+static void BM_MeasurementBufferInOrder(benchmark::State & state)
+{
+  BenchmarkBuffer buffer(64, state.range(0));
+  const uint8_t source = buffer.addSource("benchmark");
+  double stamp = 0.0;
+  for (auto _ : state) {
+    stamp += 0.004;
+    buffer.push(source, stamp, stamp, stamp);
+    benchmark::DoNotOptimize(buffer.process(stamp, apply_measurement));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_MeasurementBufferInOrder)->ArgName("replay_size")->Arg(0)->Arg(20)->Arg(100);
+
+// Every tenth measurement arrives late by the given number of periods and is replayed
+static void BM_MeasurementBufferLateReplay(benchmark::State & state)
+{
+  const int delay = state.range(0);
+  BenchmarkBuffer buffer(64, 100);
+  const uint8_t fast = buffer.addSource("fast");
+  const uint8_t slow = buffer.addSource("slow");
+  double stamp = 0.0;
+  int64_t step = 0;
+  int64_t replayed = 0;
+  for (auto _ : state) {
+    stamp += 0.004;
+    buffer.push(fast, stamp, stamp, stamp);
+    if (++step % 10 == 0) {
+      const double late_stamp = stamp - delay * 0.004 - 0.001;
+      buffer.push(slow, late_stamp, stamp, late_stamp);
+    }
+    replayed += buffer.process(stamp, apply_measurement);
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.counters["applied_per_step"] =
+    benchmark::Counter(static_cast<double>(replayed), benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_MeasurementBufferLateReplay)->ArgName("delay_periods")->Arg(1)->Arg(10)->Arg(50);
+
+BENCHMARK_MAIN();
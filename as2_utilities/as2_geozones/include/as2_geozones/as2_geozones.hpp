@@ -39,6 +39,7 @@
 
 #include <limits>
 #include <algorithm>
+#include <cmath>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
@@ -121,14 +121,28 @@ void Geozones::loadGeozones(const std::string path)
           setupGPS();
           origin_set_ = true;
         }
+        // Whole polygon converted at once
+        std::vector<double> lat, lon;
         for (const auto & point : yaml_polygon) {
-          std::array<double, 2> point_to_load{
-            point[0].as<double>(), point[1].as<double>()};
-          double z;
-          gps_handler->LatLon2Local(
-            point_to_load[0], point_to_load[1], 0.0, point_to_load[0], point_to_load[1],
-            z);
-          polygon.push_back(point_to_load);
+          lat.push_back(point[0].as<double>());
+          lon.push_back(point[1].as<double>());
+        }
+        const std::vector<double> h(lat.size(), 0.0);
+        std::vector<double> x, y, z;
+        gps_handler->LatLon2Local(lat, lon, h, x, y, z, as2::gps::BatchMode::LocalTangentPlane);
+        // Tangent plane only inside its documented bound (5 mm within 5 km of an origin below
+        // 60 deg of latitude and 500 m of height), exact conversion otherwise
+        double origin_lat, origin_lon, origin_h;
+        gps_handler->getOrigin(origin_lat, origin_lon, origin_h);
+        bool tangent_plane_valid = std::abs(origin_lat) <= 60.0 && std::abs(origin_h) <= 500.0;
+        for (std::size_t i = 0; i < x.size() && tangent_plane_valid; ++i) {
+          tangent_plane_valid = std::hypot(x[i], y[i]) <= 5000.0;
+        }
+        if (!tangent_plane_valid) {
+          gps_handler->LatLon2Local(lat, lon, h, x, y, z);
+        }
+        for (std::size_t i = 0; i < x.size(); ++i) {
+          polygon.push_back({x[i], y[i]});
         }
       } else {
         for (const auto & point : yaml_polygon) {